@@ -0,0 +1,103 @@
+# Copyright © 2024 Apple Inc.
+
+import argparse
+
+import mlx.core as mx
+from time_utils import time_fn
+
+
+def loop(fn, *args):
+    # Apply fn to each batch element and stack the results
+    outs = [fn(*(a[i] for a in args)) for i in range(args[0].shape[0])]
+    if isinstance(outs[0], tuple):
+        return tuple(mx.stack(o) for o in zip(*outs))
+    return mx.stack(outs)
+
+
+def time_gather():
+    x = mx.random.normal((64, 4096, 64))
+    idx = mx.random.randint(0, 4096, (64, 1024))
+    mx.eval(x, idx)
+
+    take = lambda x, idx: x[idx]
+    vmapped = mx.vmap(take)
+    batched = lambda x, idx: x[mx.arange(x.shape[0])[:, None], idx]
+
+    time_fn(vmapped, x, idx, msg="vmap gather")
+    time_fn(batched, x, idx, msg="batched gather")
+    time_fn(loop, take, x, idx, msg="looped gather")
+
+
+def time_scatter():
+    x = mx.zeros((64, 4096, 64))
+    idx = mx.random.randint(0, 4096, (64, 1024))
+    updates = mx.random.normal((64, 1024, 64))
+    mx.eval(x, idx, updates)
+
+    add = lambda x, idx, u: x.at[idx].add(u)
+    vmapped = mx.vmap(add)
+    batched = lambda x, idx, u: x.at[mx.arange(x.shape[0])[:, None], idx].add(u)
+
+    time_fn(vmapped, x, idx, updates, msg="vmap scatter")
+    time_fn(batched, x, idx, updates, msg="batched scatter")
+    time_fn(loop, add, x, idx, updates, msg="looped scatter")
+
+
+def time_conv():
+    x = mx.random.normal((16, 8, 64, 64, 32))
+    w = mx.random.normal((16, 32, 3, 3, 32))
+    mx.eval(x, w)
+
+    conv = lambda x, w: mx.conv2d(x, w, padding=1)
+    vmapped = mx.vmap(conv)
+
+    def batched(x, w):
+        B, N, H, W, C = x.shape
+        x = x.transpose(1, 2, 3, 0, 4).reshape(N, H, W, B * C)
+        w = w.reshape(-1, *w.shape[2:])
+        y = mx.conv2d(x, w, padding=1, groups=B)
+        return y.reshape(N, H, W, B, -1).moveaxis(3, 0)
+
+    time_fn(vmapped, x, w, msg="vmap conv, batched weights")
+    time_fn(batched, x, w, msg="grouped conv, batched weights")
+    time_fn(loop, conv, x, w, msg="looped conv, batched weights")
+
+    time_fn(mx.vmap(conv, in_axes=(0, None)), x, w[0], msg="vmap conv")
+    time_fn(conv, x.reshape(-1, *x.shape[2:]), w[0], msg="folded conv")
+
+
+def time_per_example_grads():
+    x = mx.random.normal((64, 128, 16))
+    w = mx.random.normal((32, 5, 16))
+    v = mx.random.normal((32, 16))
+    idx = mx.random.randint(0, 128, (64, 8))
+    mx.eval(x, w, v, idx)
+
+    def loss(w, v, x, idx):
+        h = mx.conv1d(x[None], w, padding=2)[0]
+        h = mx.maximum(h[idx], 0.0)
+        return (h @ v).square().mean()
+
+    grad_fn = mx.grad(loss, argnums=(0, 1))
+    vmapped = mx.vmap(grad_fn, in_axes=(None, None, 0, 0))
+
+    def looped(w, v, x, idx):
+        outs = [grad_fn(w, v, x[i], idx[i]) for i in range(x.shape[0])]
+        return tuple(mx.stack(o) for o in zip(*outs))
+
+    time_fn(vmapped, w, v, x, idx, msg="vmap per example grads")
+    time_fn(looped, w, v, x, idx, msg="looped per example grads")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser("vmap benchmarks.")
+    parser.add_argument("--cpu", action="store_true", help="Use the CPU.")
+    args = parser.parse_args()
+
+    if args.cpu:
+        mx.set_default_device(mx.cpu)
+
+    time_gather()
+    time_scatter()
+    time_conv()
+    time_per_example_grads()
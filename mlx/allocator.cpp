@@ -1,9 +1,14 @@
 // Copyright © 2023 Apple Inc.
 
+#include <cstddef>
 #include <cstdlib>
 #include <sstream>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include "mlx/allocator.h"
+#include "mlx/numa.h"
 #include "mlx/scheduler.h"
 
 namespace mlx::core::allocator {
@@ -22,12 +27,63 @@ void free(Buffer buffer) {
   return allocator().free(buffer);
 }
 
+// Allocations at least this large get their own mapping bound to the NUMA
+// node of the stream making them. Smaller ones are mostly recycled by malloc
+// and binding them would change the policy of pages malloc hands out again.
+constexpr size_t numa_bind_min_size = 1 << 20;
+
+// Every buffer is preceded by the size of its mapping, or zero if it comes
+// from malloc. The header keeps the alignment of malloc.
+constexpr size_t header_size = alignof(std::max_align_t);
+
+size_t page_size() {
+  static size_t page = sysconf(_SC_PAGESIZE);
+  return page;
+}
+
 Buffer CommonAllocator::malloc(size_t size, bool) {
-  return Buffer{std::malloc(size)};
+  int node = numa::current_affinity().numa_node;
+  char* ptr;
+  size_t mapped = 0;
+  if (node >= 0 && size >= numa_bind_min_size) {
+    // The header goes at the end of the first page so the data is page
+    // aligned
+    size_t page = page_size();
+    mapped = (size + 2 * page - 1) / page * page;
+    void* map = mmap(
+        nullptr,
+        mapped,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (map == MAP_FAILED) {
+      return Buffer{nullptr};
+    }
+    numa::bind_memory(map, mapped, node);
+    ptr = static_cast<char*>(map) + page - header_size;
+  } else {
+    ptr = static_cast<char*>(std::malloc(size + header_size));
+    if (!ptr) {
+      return Buffer{nullptr};
+    }
+  }
+  *reinterpret_cast<size_t*>(ptr) = mapped;
+  return Buffer{ptr + header_size};
 }
 
 void CommonAllocator::free(Buffer buffer) {
-  std::free(buffer.raw_ptr());
+  auto ptr = static_cast<char*>(buffer.raw_ptr());
+  if (!ptr) {
+    return;
+  }
+  ptr -= header_size;
+  size_t mapped = *reinterpret_cast<size_t*>(ptr);
+  if (mapped) {
+    munmap(ptr + header_size - page_size(), mapped);
+  } else {
+    std::free(ptr);
+  }
 }
 
 Buffer malloc_or_wait(size_t size) {
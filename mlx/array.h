@@ -251,9 +251,13 @@ class array {
     return array_desc_->inputs;
   }
 
-  /** True indicates the arrays buffer is safe to reuse */
-  bool is_donatable() const {
-    return array_desc_.use_count() == 1 && (array_desc_->data.use_count() == 1);
+  /** True indicates the arrays buffer is safe to reuse. Each output of a
+   * multi-output primitive holds its own reference to the inputs so an input
+   * of such a primitive is only referenced by it when it has as many
+   * references as the primitive has outputs. */
+  bool is_donatable(int num_refs = 1) const {
+    return array_desc_.use_count() == num_refs &&
+        (array_desc_->data.use_count() == 1);
   }
 
   /** The array's siblings. */
@@ -17,15 +17,18 @@ namespace {
 std::tuple<bool, size_t, array> check_transpose(const array& arr) {
   auto stx = arr.strides()[arr.ndim() - 2];
   auto sty = arr.strides()[arr.ndim() - 1];
-  if (stx == arr.shape(-1) && sty == 1) {
-    return std::make_tuple(false, stx, arr);
-  } else if (stx == 1 && sty == arr.shape(-2)) {
-    return std::make_tuple(true, sty, arr);
+  size_t rows = arr.shape(-2);
+  size_t cols = arr.shape(-1);
+  // The stride of an axis of size one is never read so a single row or
+  // column, broadcast or not, is used in place
+  if ((sty == 1 || cols == 1) && (stx == cols || rows == 1)) {
+    return std::make_tuple(false, cols, arr);
+  } else if ((stx == 1 || rows == 1) && (sty == rows || cols == 1)) {
+    return std::make_tuple(true, rows, arr);
   } else {
     array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
     copy(arr, arr_copy, CopyType::General);
-    size_t stx = arr.shape(-1);
-    return std::make_tuple(false, stx, arr_copy);
+    return std::make_tuple(false, cols, arr_copy);
   }
 }
 
@@ -54,21 +57,42 @@ inline void matmul_cblas_general(
     return;
   }
 
-  for (int i = 0; i < (a.size() / (M * K)); ++i) {
+  // Fold the inner batch axes along which b is broadcast into the rows of a
+  // when the matrices of a follow each other. Grouped query heads sharing
+  // one key head then run as a single GEMM which reads the keys once.
+  int batch_ndim = a.ndim() - 2;
+  size_t rows = M;
+  while (batch_ndim > 0 && !a_transposed) {
+    int ax = batch_ndim - 1;
+    if (a.shape(ax) != 1 &&
+        (b.strides()[ax] != 0 || a.strides()[ax] != rows * lda)) {
+      break;
+    }
+    rows *= a.shape(ax);
+    batch_ndim--;
+  }
+  std::vector<int> batch_shape(
+      a.shape().begin(), a.shape().begin() + batch_ndim);
+  std::vector<size_t> a_strides(
+      a.strides().begin(), a.strides().begin() + batch_ndim);
+  std::vector<size_t> b_strides(
+      b.strides().begin(), b.strides().begin() + batch_ndim);
+
+  for (int i = 0; i < (out.size() / (rows * N)); ++i) {
     cblas_sgemm(
         CblasRowMajor,
         a_transposed ? CblasTrans : CblasNoTrans, // transA
         b_transposed ? CblasTrans : CblasNoTrans, // transB
-        M,
+        rows,
         N,
         K,
         alpha, // alpha
-        a.data<float>() + elem_to_loc(M * K * i, a.shape(), a.strides()),
+        a.data<float>() + elem_to_loc(i, batch_shape, a_strides),
         lda,
-        b.data<float>() + elem_to_loc(K * N * i, b.shape(), b.strides()),
+        b.data<float>() + elem_to_loc(i, batch_shape, b_strides),
         ldb,
         beta, // beta
-        out.data<float>() + M * N * i,
+        out.data<float>() + rows * N * i,
         out.shape(-1) // ldc
     );
   }
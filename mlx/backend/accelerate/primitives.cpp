@@ -36,6 +36,7 @@ DEFAULT(BlockSparseMM)
 DEFAULT(BlockSparseQMM)
 DEFAULT(Broadcast)
 DEFAULT(Ceil)
+DEFAULT(Clip)
 DEFAULT(Concatenate)
 DEFAULT(Conjugate)
 DEFAULT(Copy)
@@ -54,6 +55,7 @@ DEFAULT(GreaterEqual)
 DEFAULT(Less)
 DEFAULT(LessEqual)
 DEFAULT(Load)
+DEFAULT_MULTI(LoadQuantized)
 DEFAULT(LogicalNot)
 DEFAULT(LogicalAnd)
 DEFAULT(LogicalOr)
@@ -63,6 +65,8 @@ DEFAULT(Minimum)
 DEFAULT(NotEqual)
 DEFAULT(Pad)
 DEFAULT(Partition)
+DEFAULT(Pooling)
+DEFAULT(PoolingVJP)
 DEFAULT_MULTI(QRF)
 DEFAULT(RandomBits)
 DEFAULT(Reshape)
@@ -76,9 +80,12 @@ DEFAULT(Slice)
 DEFAULT(SliceUpdate)
 DEFAULT_MULTI(Split)
 DEFAULT(Sort)
+DEFAULT(SparseMatmul)
 DEFAULT(StopGradient)
 DEFAULT_MULTI(SVD)
 DEFAULT(Transpose)
+DEFAULT(Upsample)
+DEFAULT(UpsampleVJP)
 DEFAULT(Inverse)
 DEFAULT(Cholesky)
 
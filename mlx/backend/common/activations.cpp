@@ -0,0 +1,261 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <cassert>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/ops.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/fast_primitives.h"
+
+namespace mlx::core::fast {
+
+namespace {
+
+using detail::bit_select;
+using detail::fast_erf;
+using detail::fast_exp;
+
+constexpr float sqrt_1_2 = 0.7071067811865476f;
+constexpr float sqrt_2_over_pi = 0.7978845608028654f;
+constexpr float inv_sqrt_2pi = 0.3989422804014327f;
+constexpr float gelu_approx_coeff = 0.044715f;
+
+// tanh(x) = 1 - 2 / (exp(2x) + 1), exact at the saturation points because
+// fast_exp clamps its argument
+inline float fast_tanh(float x) {
+  return 1.0f - 2.0f / (fast_exp(2.0f * x) + 1.0f);
+}
+
+inline float sigmoid(float x) {
+  return 1.0f / (1.0f + fast_exp(-x));
+}
+
+// tanh(softplus(x)) = n / (n + 2) with n = e^x (e^x + 2). Past 20 the result
+// is 1 in single precision and clamping keeps n finite.
+inline float tanh_softplus(float x) {
+  float e = fast_exp(bit_select(x > 20.0f, 20.0f, x));
+  float n = e * (e + 2.0f);
+  return n / (n + 2.0f);
+}
+
+struct Gelu {
+  float operator()(float x) {
+    return 0.5f * x * (1.0f + fast_erf(x * sqrt_1_2));
+  }
+};
+
+struct GeluApprox {
+  float operator()(float x) {
+    float u = sqrt_2_over_pi * (x + gelu_approx_coeff * x * x * x);
+    return 0.5f * x * (1.0f + fast_tanh(u));
+  }
+};
+
+struct SiLU {
+  float operator()(float x) {
+    return x * sigmoid(x);
+  }
+};
+
+struct Mish {
+  float operator()(float x) {
+    return x * tanh_softplus(x);
+  }
+};
+
+struct GeluVJP {
+  float operator()(float x, float g) {
+    float cdf = 0.5f * (1.0f + fast_erf(x * sqrt_1_2));
+    float pdf = inv_sqrt_2pi * fast_exp(-0.5f * x * x);
+    return g * (cdf + x * pdf);
+  }
+};
+
+struct GeluApproxVJP {
+  float operator()(float x, float g) {
+    float x2 = x * x;
+    float t = fast_tanh(sqrt_2_over_pi * (x + gelu_approx_coeff * x2 * x));
+    float du = sqrt_2_over_pi * (1.0f + 3.0f * gelu_approx_coeff * x2);
+    return g * (0.5f * (1.0f + t) + 0.5f * x * (1.0f - t * t) * du);
+  }
+};
+
+struct SiLUVJP {
+  float operator()(float x, float g) {
+    float s = sigmoid(x);
+    return g * s * (1.0f + x * (1.0f - s));
+  }
+};
+
+struct MishVJP {
+  float operator()(float x, float g) {
+    float t = tanh_softplus(x);
+    return g * (t + x * (1.0f - t * t) * sigmoid(x));
+  }
+};
+
+array ensure_row_contiguous(const array& arr) {
+  if (arr.flags().row_contiguous) {
+    return arr;
+  }
+  array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+  copy(arr, arr_copy, CopyType::General);
+  return arr_copy;
+}
+
+// Run op over [0, n) in blocks spread over the threads. The loops are kept
+// plain, and separate from the dispatch in binary.h, so the op is inlined
+// and vectorized.
+template <typename F>
+void for_each_block(size_t n, F f) {
+  constexpr size_t block = 16384;
+  int n_blocks = (n + block - 1) / block;
+  parallel_for(n_blocks, 4, [&](int b_begin, int b_end) {
+    size_t begin = b_begin * block;
+    size_t end = std::min(b_end * block, n);
+    f(begin, end);
+  });
+}
+
+template <typename T, typename Op>
+void activation_op(const array& x, array& out, Op op) {
+  // Contiguous inputs keep their layout, the output takes their strides.
+  // Copying the handle adds a reference so donation is checked on x.
+  bool contiguous = x.flags().contiguous;
+  bool donatable = !contiguous || x.is_donatable();
+  auto in = contiguous ? x : ensure_row_contiguous(x);
+  if (donatable && in.itemsize() == out.itemsize()) {
+    out.copy_shared_buffer(in);
+  } else {
+    out.set_data(
+        allocator::malloc_or_wait(in.data_size() * out.itemsize()),
+        in.data_size(),
+        in.strides(),
+        in.flags());
+  }
+  const T* src = in.data<T>();
+  T* dst = out.data<T>();
+  for_each_block(in.data_size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[i] = static_cast<T>(op(static_cast<float>(src[i])));
+    }
+  });
+}
+
+template <typename T, typename Op>
+void activation_vjp_op(const array& x, const array& g, array& out, Op op) {
+  // Copies made here can always be donated, otherwise the inputs are
+  // checked before their handles are copied
+  bool x_donatable = !x.flags().row_contiguous || x.is_donatable();
+  bool g_donatable = !g.flags().row_contiguous || g.is_donatable();
+  auto x_in = ensure_row_contiguous(x);
+  auto g_in = ensure_row_contiguous(g);
+  if (g_donatable) {
+    out.copy_shared_buffer(g_in);
+  } else if (x_donatable) {
+    out.copy_shared_buffer(x_in);
+  } else {
+    out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  }
+  const T* x_ptr = x_in.data<T>();
+  const T* g_ptr = g_in.data<T>();
+  T* dst = out.data<T>();
+  for_each_block(out.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[i] = static_cast<T>(op(
+          static_cast<float>(x_ptr[i]), static_cast<float>(g_ptr[i])));
+    }
+  });
+}
+
+template <typename T>
+void activation(Activation::Kind kind, const array& x, array& out) {
+  switch (kind) {
+    case Activation::Gelu:
+      activation_op<T>(x, out, Gelu{});
+      break;
+    case Activation::GeluApprox:
+      activation_op<T>(x, out, GeluApprox{});
+      break;
+    case Activation::SiLU:
+      activation_op<T>(x, out, SiLU{});
+      break;
+    case Activation::Mish:
+      activation_op<T>(x, out, Mish{});
+      break;
+  }
+}
+
+template <typename T>
+void activation_vjp(
+    Activation::Kind kind,
+    const array& x,
+    const array& g,
+    array& out) {
+  switch (kind) {
+    case Activation::Gelu:
+      activation_vjp_op<T>(x, g, out, GeluVJP{});
+      break;
+    case Activation::GeluApprox:
+      activation_vjp_op<T>(x, g, out, GeluApproxVJP{});
+      break;
+    case Activation::SiLU:
+      activation_vjp_op<T>(x, g, out, SiLUVJP{});
+      break;
+    case Activation::Mish:
+      activation_vjp_op<T>(x, g, out, MishVJP{});
+      break;
+  }
+}
+
+} // namespace
+
+void Activation::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 1);
+  auto& x = inputs[0];
+  auto& out = outputs[0];
+  switch (out.dtype()) {
+    case float32:
+      activation<float>(kind_, x, out);
+      break;
+    case float16:
+      activation<float16_t>(kind_, x, out);
+      break;
+    case bfloat16:
+      activation<bfloat16_t>(kind_, x, out);
+      break;
+    default:
+      throw std::runtime_error(
+          "[Activation::eval_cpu] Only floating point inputs are supported.");
+  }
+}
+
+void ActivationVJP::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 2);
+  auto& x = inputs[0];
+  auto& g = inputs[1];
+  auto& out = outputs[0];
+  switch (out.dtype()) {
+    case float32:
+      activation_vjp<float>(kind_, x, g, out);
+      break;
+    case float16:
+      activation_vjp<float16_t>(kind_, x, g, out);
+      break;
+    case bfloat16:
+      activation_vjp<bfloat16_t>(kind_, x, g, out);
+      break;
+    default:
+      throw std::runtime_error(
+          "[ActivationVJP::eval_cpu] Only floating point inputs are "
+          "supported.");
+  }
+}
+
+} // namespace mlx::core::fast
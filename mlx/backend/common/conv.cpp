@@ -10,6 +10,7 @@
 #endif
 
 #include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
 #include "mlx/primitives.h"
 #include "mlx/utils.h"
 
@@ -114,10 +115,13 @@ void slow_conv_2D(
   const int oH = out.shape(1); // Output spatial dim
   const int oW = out.shape(2); // Output spatial dim
   const int O = wt.shape(0); // Out channels
-  const int C = wt.shape(3); // In channels
+  const int C = wt.shape(3); // In channels per group
   const int wH = wt.shape(1); // Weight spatial dim
   const int wW = wt.shape(2); // Weight spatial dim
 
+  const int groups = in.shape(3) / C;
+  const int O_per_group = O / groups;
+
   const size_t in_stride_N = in.strides()[0];
   const size_t in_stride_H = in.strides()[1];
   const size_t in_stride_W = in.strides()[2];
@@ -152,7 +156,8 @@ void slow_conv_2D(
               int iw = iw_base + ww_flip * wt_dilation[1];
 
               const T* wt_ptr_pt = wt_ptr + wh * wt_stride_H + ww * wt_stride_W;
-              const T* in_ptr_pt = in_ptr + ih * in_stride_H + iw * in_stride_W;
+              const T* in_ptr_pt = in_ptr + ih * in_stride_H +
+                  iw * in_stride_W + (o / O_per_group) * C * in_stride_C;
 
               for (int c = 0; c < C; ++c) {
                 r += static_cast<float>(in_ptr_pt[0]) *
@@ -236,8 +241,8 @@ void slow_conv_2D(
                 int ih_dil = !is_idil_one ? (ih / in_dilation[0]) : ih;
                 int iw_dil = !is_idil_one ? (iw / in_dilation[1]) : iw;
 
-                const T* in_ptr_pt =
-                    in_ptr + ih_dil * in_stride_H + iw_dil * in_stride_W;
+                const T* in_ptr_pt = in_ptr + ih_dil * in_stride_H +
+                    iw_dil * in_stride_W + (o / O_per_group) * C * in_stride_C;
 
                 for (int c = 0; c < C; ++c) {
                   r += static_cast<float>(in_ptr_pt[0]) *
@@ -672,6 +677,155 @@ void dispatch_slow_conv_3D(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Depthwise conv
+///////////////////////////////////////////////////////////////////////////////
+
+// Depthwise convolution (groups == C_in == C_out) on N x H x W x C inputs. The
+// weights are repacked into a float wH x wW x C buffer so that, like the
+// channels-last input and output, the innermost channel loop is contiguous
+// and vectorizes. Rows of the output are split across threads.
+template <typename T>
+void depthwise_conv_2D(
+    const array& in,
+    const array& wt,
+    array out,
+    const std::vector<int>& padding,
+    const std::vector<int>& wt_strides,
+    const std::vector<int>& wt_dilation,
+    bool flip) {
+  const int N = in.shape(0); // Batch size, should be the same as out.shape(0)
+  const int iH = in.shape(1); // Input spatial dim
+  const int iW = in.shape(2); // Input spatial dim
+  const int C = in.shape(3); // Channels
+  const int oH = out.shape(1); // Output spatial dim
+  const int oW = out.shape(2); // Output spatial dim
+  const int wH = wt.shape(1); // Weight spatial dim
+  const int wW = wt.shape(2); // Weight spatial dim
+
+  std::vector<float> wt_packed(wH * wW * C);
+  const T* wt_ptr = wt.data<T>();
+  for (int c = 0; c < C; ++c) {
+    for (int wh = 0; wh < wH; ++wh) {
+      for (int ww = 0; ww < wW; ++ww) {
+        int wh_src = flip ? wH - wh - 1 : wh;
+        int ww_src = flip ? wW - ww - 1 : ww;
+        wt_packed[(wh * wW + ww) * C + c] = static_cast<float>(
+            wt_ptr
+                [c * wt.strides()[0] + wh_src * wt.strides()[1] +
+                 ww_src * wt.strides()[2]]);
+      }
+    }
+  }
+
+  const size_t in_stride_N = in.strides()[0];
+  const size_t in_stride_H = in.strides()[1];
+  const size_t in_stride_W = in.strides()[2];
+
+  const T* in_ptr = in.data<T>();
+  T* out_ptr = out.data<T>();
+
+  auto conv_rows = [&](int begin, int end) {
+    std::vector<float> acc(C);
+    for (int row = begin; row < end; ++row) {
+      int n = row / oH;
+      int oh = row % oH;
+      T* out_row = out_ptr + static_cast<size_t>(row) * oW * C;
+      const T* in_n = in_ptr + n * in_stride_N;
+
+      for (int ow = 0; ow < oW; ++ow) {
+        std::fill(acc.begin(), acc.end(), 0.0f);
+
+        for (int wh = 0; wh < wH; ++wh) {
+          int ih = oh * wt_strides[0] - padding[0] + wh * wt_dilation[0];
+          if (ih < 0 || ih >= iH) {
+            continue;
+          }
+          for (int ww = 0; ww < wW; ++ww) {
+            int iw = ow * wt_strides[1] - padding[1] + ww * wt_dilation[1];
+            if (iw < 0 || iw >= iW) {
+              continue;
+            }
+            const T* x = in_n + ih * in_stride_H + iw * in_stride_W;
+            const float* w = wt_packed.data() + (wh * wW + ww) * C;
+            for (int c = 0; c < C; ++c) {
+              acc[c] += static_cast<float>(x[c]) * w[c];
+            }
+          } // ww
+        } // wh
+
+        T* y = out_row + ow * C;
+        for (int c = 0; c < C; ++c) {
+          y[c] = static_cast<T>(acc[c]);
+        }
+      } // ow
+    } // row
+  };
+
+  int work_per_row = std::max(1, oW * C * wH * wW);
+  parallel_for(N * oH, (1 << 16) / work_per_row, conv_rows);
+}
+
+void dispatch_depthwise_conv_2D(
+    const array& in,
+    const array& wt,
+    array out,
+    const std::vector<int>& padding,
+    const std::vector<int>& wt_strides,
+    const std::vector<int>& wt_dilation,
+    bool flip) {
+  // The kernel needs unit channel strides for the input
+  auto in_c = in;
+  if (in.strides()[3] != 1) {
+    in_c = array(in.shape(), in.dtype(), nullptr, {});
+    copy(in, in_c, CopyType::General);
+  }
+
+  if (in.dtype() == float32) {
+    return depthwise_conv_2D<float>(
+        in_c, wt, out, padding, wt_strides, wt_dilation, flip);
+  } else if (in.dtype() == float16) {
+    return depthwise_conv_2D<float16_t>(
+        in_c, wt, out, padding, wt_strides, wt_dilation, flip);
+  } else if (in.dtype() == bfloat16) {
+    return depthwise_conv_2D<bfloat16_t>(
+        in_c, wt, out, padding, wt_strides, wt_dilation, flip);
+  } else {
+    throw std::invalid_argument(
+        "[Convolution::eval] got unsupported data type.");
+  }
+}
+
+// 1D depthwise convolutions run as 2D ones with a unit height
+void dispatch_depthwise_conv_1D(
+    const array& in,
+    const array& wt,
+    array out,
+    const std::vector<int>& padding,
+    const std::vector<int>& wt_strides,
+    const std::vector<int>& wt_dilation,
+    bool flip) {
+  auto view_2D = [](const array& x) {
+    array x_2D(
+        {x.shape(0), 1, x.shape(1), x.shape(2)}, x.dtype(), nullptr, {});
+    x_2D.copy_shared_buffer(
+        x,
+        {x.strides()[0], x.strides()[0], x.strides()[1], x.strides()[2]},
+        x.flags(),
+        x.data_size());
+    return x_2D;
+  };
+
+  dispatch_depthwise_conv_2D(
+      view_2D(in),
+      view_2D(wt),
+      view_2D(out),
+      {0, padding[0]},
+      {1, wt_strides[0]},
+      {1, wt_dilation[0]},
+      flip);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Explicit gemm conv
 ///////////////////////////////////////////////////////////////////////////////
@@ -799,6 +953,7 @@ void explicit_gemm_conv_2D_cpu(
     const array& wt,
     array out,
     const std::vector<int>& padding,
+    const std::vector<int>& padding_hi,
     const std::vector<int>& wt_strides,
     const std::vector<int>& wt_dilation) {
   const int N = in.shape(0); // Batch size, should be the same as out.shape(0)
@@ -807,15 +962,19 @@ void explicit_gemm_conv_2D_cpu(
   const int oH = out.shape(1); // Output spatial dim
   const int oW = out.shape(2); // Output spatial dim
   const int O = wt.shape(0); // Out channels
-  const int C = wt.shape(3); // In channels
+  const int C = in.shape(3); // In channels
   const int wH = wt.shape(1); // Weight spatial dim
   const int wW = wt.shape(2); // Weight spatial dim
 
-  auto conv_dtype = out.dtype();
+  const int groups = C / wt.shape(3);
+  const int C_per_group = wt.shape(3);
+  const int O_per_group = O / groups;
+
+  auto conv_dtype = float32;
 
   // Pad input
   std::vector<int> padded_shape = {
-      N, iH + 2 * padding[0], iW + 2 * padding[1], C};
+      N, iH + padding[0] + padding_hi[0], iW + padding[1] + padding_hi[1], C};
   array in_padded(padded_shape, conv_dtype, nullptr, {});
 
   // Fill with zeros
@@ -835,13 +994,15 @@ void explicit_gemm_conv_2D_cpu(
   // Copy input values into the slice
   copy_inplace(in, in_padded_slice, CopyType::GeneralGeneral);
 
-  // Make strided view
-  std::vector<int> strided_shape = {N, oH, oW, wH, wW, C};
+  // Make strided view, splitting the channels into groups so that each
+  // group's patches are contiguous rows of wH * wW * C_per_group
+  std::vector<int> strided_shape = {N, oH, oW, groups, wH, wW, C_per_group};
 
   std::vector<size_t> strided_strides = {
       in_padded.strides()[0],
       in_padded.strides()[1] * wt_strides[0],
       in_padded.strides()[2] * wt_strides[1],
+      in_padded.strides()[3] * C_per_group,
       in_padded.strides()[1],
       in_padded.strides()[2],
       in_padded.strides()[3]};
@@ -872,23 +1033,35 @@ void explicit_gemm_conv_2D_cpu(
     gemm_out.set_data(allocator::malloc_or_wait(gemm_out.nbytes()));
   }
 
-  // Perform gemm
-  cblas_sgemm(
-      CblasRowMajor,
-      CblasNoTrans, // no trans A
-      CblasTrans, // transB
-      strided_reshape[0], // M
-      O, // N
-      strided_reshape[1], // K
-      1.0f, // alpha
-      in_strided.data<float>(),
-      strided_reshape[1], // lda
-      gemm_wt.data<float>(),
-      strided_reshape[1], // ldb
-      0.0f, // beta
-      gemm_out.data<float>(),
-      O // ldc
-  );
+  // Perform one gemm per group, spreading the groups over threads when
+  // there are many of them
+  const int K = wH * wW * C_per_group;
+  auto group_gemm = [&](int g_begin, int g_end) {
+    for (int g = g_begin; g < g_end; ++g) {
+      cblas_sgemm(
+          CblasRowMajor,
+          CblasNoTrans, // no trans A
+          CblasTrans, // transB
+          strided_reshape[0], // M
+          O_per_group, // N
+          K, // K
+          1.0f, // alpha
+          in_strided.data<float>() + g * K, // A
+          strided_reshape[1], // lda
+          gemm_wt.data<float>() + g * O_per_group * K, // B
+          K, // ldb
+          0.0f, // beta
+          gemm_out.data<float>() + g * O_per_group, // C
+          O // ldc
+      );
+    }
+  };
+
+  if (groups == 1) {
+    group_gemm(0, 1);
+  } else {
+    parallel_for(groups, 1, group_gemm);
+  }
 
   // Copy results if needed
   if (out.dtype() != float32) {
@@ -1021,6 +1194,187 @@ void explicit_gemm_conv_ND_cpu(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Scatter gemm conv
+///////////////////////////////////////////////////////////////////////////////
+
+// Convolution with input dilation (transposed convolutions and the input
+// gradient of strided convolutions) in its scatter form. Every undilated input
+// pixel is multiplied by all kernel taps with a single gemm,
+//
+//   cols[n][pixel, (tap, o)] = sum_c in[n][pixel, c] * wt[o, tap, c]
+//
+// and each (pixel, tap) row of O values is then accumulated into the output
+// position it lands on (col2im). The zeros inserted by the input dilation are
+// never read or multiplied.
+void scatter_gemm_conv_ND_cpu(
+    const array& in,
+    const array& wt,
+    array out,
+    const std::vector<int>& padding,
+    const std::vector<int>& wt_strides,
+    const std::vector<int>& wt_dilation,
+    const std::vector<int>& in_dilation,
+    bool flip) {
+  const int N = in.shape(0); // Batch size, should be the same as out.shape(0)
+  const int C = in.shape(-1); // In channels
+  const int O = wt.shape(0); // Out channels
+  const int n_dims = in.ndim() - 2;
+
+  int in_pixels = 1;
+  int out_pixels = 1;
+  int taps = 1;
+  for (int i = 0; i < n_dims; ++i) {
+    in_pixels *= in.shape(i + 1);
+    out_pixels *= out.shape(i + 1);
+    taps *= wt.shape(i + 1);
+  }
+
+  // For each spatial dim, the output position that input position i and tap
+  // k contribute to or -1 if it falls in the padding or between strides
+  std::vector<std::vector<int>> dst(n_dims);
+  for (int d = 0; d < n_dims; ++d) {
+    const int iD = in.shape(d + 1);
+    const int wD = wt.shape(d + 1);
+    const int oD = out.shape(d + 1);
+    dst[d].resize(iD * wD);
+    for (int i = 0; i < iD; ++i) {
+      for (int k = 0; k < wD; ++k) {
+        int k_flip = flip ? wD - k - 1 : k;
+        int pos = i * in_dilation[d] + padding[d] - k_flip * wt_dilation[d];
+        int o = pos / wt_strides[d];
+        bool valid = pos >= 0 && pos % wt_strides[d] == 0 && o < oD;
+        dst[d][i * wD + k] = valid ? o : -1;
+      }
+    }
+  }
+
+  // Input as a contiguous float32 matrix of (N * in_pixels) x C
+  array in_f(in.shape(), float32, nullptr, {});
+  copy(
+      in,
+      in_f,
+      in.flags().row_contiguous ? CopyType::Vector : CopyType::General);
+
+  // Weights as a (taps * O) x C matrix so that the O values of a tap are
+  // contiguous in cols
+  std::vector<int> wt_t_shape(wt.ndim());
+  std::vector<size_t> wt_t_strides(wt.ndim());
+  for (int d = 0; d < n_dims; ++d) {
+    wt_t_shape[d] = wt.shape(d + 1);
+    wt_t_strides[d] = wt.strides()[d + 1];
+  }
+  wt_t_shape[n_dims] = O;
+  wt_t_strides[n_dims] = wt.strides()[0];
+  wt_t_shape.back() = C;
+  wt_t_strides.back() = wt.strides().back();
+  array wt_t(wt_t_shape, wt.dtype(), nullptr, {});
+  wt_t.copy_shared_buffer(wt, wt_t_strides, wt.flags(), wt.data_size());
+  array gemm_wt(wt_t_shape, float32, nullptr, {});
+  copy(wt_t, gemm_wt, CopyType::General);
+
+  // Accumulate in float32 directly into the output if we can
+  auto gemm_out = out;
+  if (out.dtype() != float32) {
+    gemm_out = array(out.shape(), float32, nullptr, {});
+    gemm_out.set_data(allocator::malloc_or_wait(gemm_out.nbytes()));
+  }
+  std::fill_n(gemm_out.data<float>(), gemm_out.size(), 0.0f);
+
+  auto conv_batch = [&](int n_begin, int n_end) {
+    std::vector<float> cols(static_cast<size_t>(in_pixels) * taps * O);
+    std::vector<int> in_pos(n_dims);
+    std::vector<int> tap_pos(n_dims);
+
+    for (int n = n_begin; n < n_end; ++n) {
+      cblas_sgemm(
+          CblasRowMajor,
+          CblasNoTrans, // no trans A
+          CblasTrans, // transB
+          in_pixels, // M
+          taps * O, // N
+          C, // K
+          1.0f, // alpha
+          in_f.data<float>() + static_cast<size_t>(n) * in_pixels * C, // A
+          C, // lda
+          gemm_wt.data<float>(), // B
+          C, // ldb
+          0.0f, // beta
+          cols.data(), // C
+          taps * O // ldc
+      );
+
+      // col2im
+      float* out_n =
+          gemm_out.data<float>() + static_cast<size_t>(n) * out_pixels * O;
+      const float* col = cols.data();
+      std::fill(in_pos.begin(), in_pos.end(), 0);
+      for (int p = 0; p < in_pixels; ++p) {
+        std::fill(tap_pos.begin(), tap_pos.end(), 0);
+        for (int t = 0; t < taps; ++t, col += O) {
+          int o_loc = 0;
+          for (int d = 0; d < n_dims; ++d) {
+            int o = dst[d][in_pos[d] * wt.shape(d + 1) + tap_pos[d]];
+            if (o < 0) {
+              o_loc = -1;
+              break;
+            }
+            o_loc = o_loc * out.shape(d + 1) + o;
+          }
+
+          if (o_loc >= 0) {
+            float* y = out_n + static_cast<size_t>(o_loc) * O;
+            for (int o = 0; o < O; ++o) {
+              y[o] += col[o];
+            }
+          }
+
+          // Next tap
+          for (int d = n_dims - 1; d >= 0; --d) {
+            if (++tap_pos[d] < wt.shape(d + 1)) {
+              break;
+            }
+            tap_pos[d] = 0;
+          }
+        } // t
+
+        // Next input pixel
+        for (int d = n_dims - 1; d >= 0; --d) {
+          if (++in_pos[d] < in.shape(d + 1)) {
+            break;
+          }
+          in_pos[d] = 0;
+        }
+      } // p
+    } // n
+  };
+
+  // Every batch element writes to its own output slice
+  parallel_for(N, 1, conv_batch);
+
+  // Copy results if needed
+  if (out.dtype() != float32) {
+    copy(gemm_out, out, CopyType::Vector);
+  }
+}
+
+bool use_scatter_gemm_conv(
+    const array& in,
+    const array& wt,
+    const std::vector<int>& in_dilation,
+    bool flip) {
+  // Only ungrouped convolutions with dilated inputs or flipped kernels, the
+  // rest are better served by im2col
+  if (in.shape(-1) != wt.shape(-1)) {
+    return false;
+  }
+  bool is_idil_one = true;
+  for (auto d : in_dilation) {
+    is_idil_one &= d == 1;
+  }
+  return !is_idil_one || flip;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Conv routing
 ///////////////////////////////////////////////////////////////////////////////
@@ -1034,6 +1388,18 @@ void conv_1D_cpu(
     const std::vector<int>& wt_dilation,
     const std::vector<int>& in_dilation,
     bool flip) {
+  const int groups = in.shape(2) / wt.shape(2);
+  if (in_dilation[0] == 1 && groups > 1 && wt.shape(2) == 1 &&
+      wt.shape(0) == groups) {
+    return dispatch_depthwise_conv_1D(
+        in, wt, out, padding, wt_strides, wt_dilation, flip);
+  }
+
+  if (use_scatter_gemm_conv(in, wt, in_dilation, flip)) {
+    return scatter_gemm_conv_ND_cpu(
+        in, wt, out, padding, wt_strides, wt_dilation, in_dilation, flip);
+  }
+
   if (wt_dilation[0] == 1 && in_dilation[0] == 1 && !flip) {
     return explicit_gemm_conv_1D_cpu(
         in, wt, out, padding, wt_strides, wt_dilation);
@@ -1048,10 +1414,28 @@ void conv_2D_cpu(
     const array& wt,
     array out,
     const std::vector<int>& padding,
+    const std::vector<int>& padding_hi,
     const std::vector<int>& wt_strides,
     const std::vector<int>& wt_dilation,
     const std::vector<int>& in_dilation,
     bool flip) {
+  const int groups = in.shape(3) / wt.shape(3);
+  if (in_dilation[0] == 1 && in_dilation[1] == 1 && groups > 1) {
+    if (wt.shape(3) == 1 && wt.shape(0) == groups) {
+      return dispatch_depthwise_conv_2D(
+          in, wt, out, padding, wt_strides, wt_dilation, flip);
+    }
+    if (wt_dilation[0] == 1 && wt_dilation[1] == 1 && !flip) {
+      return explicit_gemm_conv_2D_cpu(
+          in, wt, out, padding, padding_hi, wt_strides, wt_dilation);
+    }
+  }
+
+  if (use_scatter_gemm_conv(in, wt, in_dilation, flip)) {
+    return scatter_gemm_conv_ND_cpu(
+        in, wt, out, padding, wt_strides, wt_dilation, in_dilation, flip);
+  }
+
   return dispatch_slow_conv_2D(
       in, wt, out, padding, wt_strides, wt_dilation, in_dilation, flip);
 }
@@ -1065,6 +1449,11 @@ void conv_3D_cpu(
     const std::vector<int>& wt_dilation,
     const std::vector<int>& in_dilation,
     bool flip) {
+  if (use_scatter_gemm_conv(in, wt, in_dilation, flip)) {
+    return scatter_gemm_conv_ND_cpu(
+        in, wt, out, padding, wt_strides, wt_dilation, in_dilation, flip);
+  }
+
   return dispatch_slow_conv_3D(
       in, wt, out, padding, wt_strides, wt_dilation, in_dilation, flip);
 }
@@ -1096,6 +1485,7 @@ void Convolution::eval(const std::vector<array>& inputs, array& out) {
         wt,
         out,
         padding_,
+        padding_hi_,
         kernel_strides_,
         kernel_dilation_,
         input_dilation_,
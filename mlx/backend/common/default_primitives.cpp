@@ -7,6 +7,8 @@
 #endif
 
 #include <cstring>
+#include <limits>
+#include <vector>
 
 #include "mlx/array.h"
 #include "mlx/backend/common/copy.h"
@@ -47,6 +49,7 @@ DEFAULT(BlockSparseMM)
 DEFAULT(BlockSparseQMM)
 DEFAULT_MULTI(DivMod)
 DEFAULT(Ceil)
+DEFAULT(Clip)
 DEFAULT(Concatenate)
 DEFAULT(Conjugate)
 DEFAULT(Convolution)
@@ -72,6 +75,7 @@ DEFAULT(GreaterEqual)
 DEFAULT(Less)
 DEFAULT(LessEqual)
 DEFAULT(Load)
+DEFAULT_MULTI(LoadQuantized)
 DEFAULT(Log)
 DEFAULT(Log1p)
 DEFAULT(LogicalNot)
@@ -85,6 +89,8 @@ DEFAULT(Negative)
 DEFAULT(NotEqual)
 DEFAULT(Pad)
 DEFAULT(Partition)
+DEFAULT(Pooling)
+DEFAULT(PoolingVJP)
 DEFAULT(Power)
 DEFAULT_MULTI(QRF)
 DEFAULT(QuantizedMatmul)
@@ -103,6 +109,7 @@ DEFAULT(Slice)
 DEFAULT(SliceUpdate)
 DEFAULT(Softmax)
 DEFAULT(Sort)
+DEFAULT(SparseMatmul)
 DEFAULT_MULTI(Split)
 DEFAULT(Square)
 DEFAULT(Sqrt)
@@ -112,34 +119,72 @@ DEFAULT_MULTI(SVD)
 DEFAULT(Tan)
 DEFAULT(Tanh)
 DEFAULT(Transpose)
+DEFAULT(Upsample)
+DEFAULT(UpsampleVJP)
 DEFAULT(Inverse)
 DEFAULT(Cholesky)
 
 namespace {
 
-inline void matmul_common_general(
-    const array& a_pre,
-    const array& b_pre,
-    array& out,
-    float alpha = 1.0f,
-    float beta = 0.0f) {
-  auto check_transpose = [](const array& arr) {
+// How a matrix given by the last two axes of an array is passed to BLAS
+struct GemmOperand {
+  bool transposed;
+  size_t ld;
+  // Layouts BLAS cannot describe are gathered one matrix at a time
+  bool gather;
+};
+
+inline GemmOperand check_transpose(const array& arr) {
+  auto stx = arr.strides()[arr.ndim() - 2];
+  auto sty = arr.strides()[arr.ndim() - 1];
+  size_t rows = arr.shape(-2);
+  size_t cols = arr.shape(-1);
+  // The stride of an axis of size one is never read so a single row or
+  // column, broadcast or not, is used in place. Rows or columns may be
+  // further apart than their length as in slices of a larger matrix.
+  if ((sty == 1 || cols == 1) && (rows == 1 || stx >= cols)) {
+    return {false, rows == 1 ? cols : stx, false};
+  } else if ((stx == 1 || rows == 1) && (cols == 1 || sty >= rows)) {
+    return {true, cols == 1 ? rows : sty, false};
+  } else {
+    return {false, cols, true};
+  }
+}
+
+// A row contiguous copy of one matrix of an operand BLAS cannot read. The
+// copy is kept while consecutive batches share the matrix.
+struct GatheredMatrix {
+  std::vector<float> buffer;
+  size_t offset = std::numeric_limits<size_t>::max();
+
+  const float* get(const array& arr, size_t new_offset) {
+    if (new_offset == offset) {
+      return buffer.data();
+    }
+    offset = new_offset;
     auto stx = arr.strides()[arr.ndim() - 2];
     auto sty = arr.strides()[arr.ndim() - 1];
-    if (stx == arr.shape(-1) && sty == 1) {
-      return std::make_tuple(false, stx, arr);
-    } else if (stx == 1 && sty == arr.shape(-2)) {
-      return std::make_tuple(true, sty, arr);
-    } else {
-      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
-      copy(arr, arr_copy, CopyType::General);
-      size_t stx = arr.shape(-1);
-      return std::make_tuple(false, stx, arr_copy);
+    size_t rows = arr.shape(-2);
+    size_t cols = arr.shape(-1);
+    buffer.resize(rows * cols);
+    const float* src = arr.data<float>() + offset;
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        buffer[i * cols + j] = src[i * stx + j * sty];
+      }
     }
-  };
+    return buffer.data();
+  }
+};
 
-  auto [a_transposed, lda, a] = check_transpose(a_pre);
-  auto [b_transposed, ldb, b] = check_transpose(b_pre);
+inline void matmul_common_general(
+    const array& a,
+    const array& b,
+    array& out,
+    float alpha = 1.0f,
+    float beta = 0.0f) {
+  auto [a_transposed, lda, a_gather] = check_transpose(a);
+  auto [b_transposed, ldb, b_gather] = check_transpose(b);
   size_t M = a.shape(-2);
   size_t N = b.shape(-1);
   size_t K = a.shape(-1);
@@ -151,21 +196,48 @@ inline void matmul_common_general(
     return;
   }
 
-  for (int i = 0; i < (a.size() / (M * K)); ++i) {
+  // Fold the inner batch axes along which b is broadcast into the rows of a
+  // when the matrices of a follow each other. Grouped query heads sharing
+  // one key head then run as a single GEMM which reads the keys once.
+  int batch_ndim = a.ndim() - 2;
+  size_t rows = M;
+  while (batch_ndim > 0 && !a_transposed && !a_gather) {
+    int ax = batch_ndim - 1;
+    if (a.shape(ax) != 1 &&
+        (b.strides()[ax] != 0 || a.strides()[ax] != rows * lda)) {
+      break;
+    }
+    rows *= a.shape(ax);
+    batch_ndim--;
+  }
+  std::vector<int> batch_shape(
+      a.shape().begin(), a.shape().begin() + batch_ndim);
+  std::vector<size_t> a_strides(
+      a.strides().begin(), a.strides().begin() + batch_ndim);
+  std::vector<size_t> b_strides(
+      b.strides().begin(), b.strides().begin() + batch_ndim);
+
+  // Batch axes are walked through their strides so broadcast operands are
+  // never expanded
+  GatheredMatrix a_gathered;
+  GatheredMatrix b_gathered;
+  for (int i = 0; i < (out.size() / (rows * N)); ++i) {
+    size_t a_offset = elem_to_loc(i, batch_shape, a_strides);
+    size_t b_offset = elem_to_loc(i, batch_shape, b_strides);
     cblas_sgemm(
         CblasRowMajor,
         a_transposed ? CblasTrans : CblasNoTrans, // transA
         b_transposed ? CblasTrans : CblasNoTrans, // transB
-        M,
+        rows,
         N,
         K,
         alpha, // alpha
-        a.data<float>() + elem_to_loc(M * K * i, a.shape(), a.strides()),
+        a_gather ? a_gathered.get(a, a_offset) : a.data<float>() + a_offset,
         lda,
-        b.data<float>() + elem_to_loc(K * N * i, b.shape(), b.strides()),
+        b_gather ? b_gathered.get(b, b_offset) : b.data<float>() + b_offset,
         ldb,
         beta, // beta
-        out.data<float>() + M * N * i,
+        out.data<float>() + rows * N * i,
         out.shape(-1) // ldc
     );
   }
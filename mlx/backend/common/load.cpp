@@ -2,9 +2,20 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <utility>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MLX_LOAD_SSSE3
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
 #include "mlx/io/load.h"
 #include "mlx/primitives.h"
 
@@ -12,8 +23,14 @@ namespace mlx::core {
 
 namespace {
 
+// Number of elements converted at a time when the stored type differs
+constexpr size_t chunk_size = 1 << 20;
+
+// Bytes read at a time, each chunk is byte swapped while it is in cache
+constexpr size_t read_chunk_bytes = 1 << 23;
+
 template <const uint8_t scalar_size>
-void swap_endianness(uint8_t* data_bytes, size_t N) {
+void swap_endianness_scalar(uint8_t* data_bytes, size_t N) {
   struct Elem {
     uint8_t bytes[scalar_size];
   };
@@ -27,26 +44,252 @@ void swap_endianness(uint8_t* data_bytes, size_t N) {
   }
 }
 
+// The vector versions swap 16 bytes at a time and return the number of
+// elements done, the rest is left to the scalar loop
+#ifdef MLX_LOAD_SSSE3
+template <const uint8_t scalar_size>
+__attribute__((target("ssse3"))) size_t swap_endianness_ssse3(
+    uint8_t* data,
+    size_t N) {
+  alignas(16) uint8_t order[16];
+  for (int i = 0; i < 16; i++) {
+    order[i] = (i / scalar_size) * scalar_size + scalar_size - 1 -
+        i % scalar_size;
+  }
+  auto mask = _mm_load_si128(reinterpret_cast<const __m128i*>(order));
+  size_t n_bytes = N * scalar_size;
+  size_t i = 0;
+  for (; i + 16 <= n_bytes; i += 16) {
+    auto p = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+  }
+  return i / scalar_size;
+}
+#endif
+
+#ifdef __ARM_NEON
+template <const uint8_t scalar_size>
+size_t swap_endianness_neon(uint8_t* data, size_t N) {
+  size_t n_bytes = N * scalar_size;
+  size_t i = 0;
+  for (; i + 16 <= n_bytes; i += 16) {
+    auto v = vld1q_u8(data + i);
+    if constexpr (scalar_size == 2) {
+      v = vrev16q_u8(v);
+    } else if constexpr (scalar_size == 4) {
+      v = vrev32q_u8(v);
+    } else {
+      v = vrev64q_u8(v);
+    }
+    vst1q_u8(data + i, v);
+  }
+  return i / scalar_size;
+}
+#endif
+
+template <const uint8_t scalar_size>
+void swap_endianness(uint8_t* data, size_t N) {
+  size_t done = 0;
+#if defined(__ARM_NEON)
+  done = swap_endianness_neon<scalar_size>(data, N);
+#elif defined(MLX_LOAD_SSSE3)
+  static bool has_ssse3 = __builtin_cpu_supports("ssse3");
+  if (has_ssse3) {
+    done = swap_endianness_ssse3<scalar_size>(data, N);
+  }
+#endif
+  swap_endianness_scalar<scalar_size>(data + done * scalar_size, N - done);
+}
+
+void swap_endianness(uint8_t* data, size_t N, size_t itemsize) {
+  switch (itemsize) {
+    case 2:
+      swap_endianness<2>(data, N);
+      break;
+    case 4:
+      swap_endianness<4>(data, N);
+      break;
+    case 8:
+      swap_endianness<8>(data, N);
+      break;
+  }
+}
+
+// A contiguous 1D view of n elements of a starting at element offset
+array view(const array& a, size_t offset, size_t n) {
+  array v({static_cast<int>(n)}, a.dtype(), nullptr, {});
+  auto flags = a.flags();
+  flags.contiguous = flags.row_contiguous = flags.col_contiguous = true;
+  v.copy_shared_buffer(a, {1}, flags, n, offset);
+  return v;
+}
+
+array alloc_staging(size_t n, Dtype dtype) {
+  array a({static_cast<int>(n)}, dtype, nullptr, {});
+  a.set_data(allocator::malloc_or_wait(a.nbytes()));
+  return a;
+}
+
+// Quantize n_groups consecutive groups following quantize() in ops.cpp. Every
+// intermediate is rounded to T so the results match the graph version.
+template <typename T>
+void quantize_groups(
+    const T* w,
+    uint32_t* wq,
+    T* scales,
+    T* biases,
+    size_t n_groups,
+    int group_size,
+    int bits) {
+  auto r = [](float x) { return static_cast<float>(static_cast<T>(x)); };
+  float n_bins = (1 << bits) - 1;
+  float eps = r(1e-7);
+  int el_per_int = 32 / bits;
+  for (size_t g = 0; g < n_groups; ++g) {
+    float w_max = w[0];
+    float w_min = w[0];
+    for (int j = 1; j < group_size; ++j) {
+      w_max = std::max(w_max, static_cast<float>(w[j]));
+      w_min = std::min(w_min, static_cast<float>(w[j]));
+    }
+    bool mask = std::abs(w_min) > std::abs(w_max);
+    float scale = std::max(r(r(w_max - w_min) / n_bins), eps);
+    scale = mask ? scale : -scale;
+    float edge = mask ? w_min : w_max;
+    float q0 = std::rint(r(edge / scale));
+    scale = q0 != 0 ? r(edge / q0) : scale;
+    float bias = q0 == 0 ? 0 : edge;
+
+    for (int j = 0; j < group_size; j += el_per_int) {
+      uint32_t packed = 0;
+      for (int k = 0; k < el_per_int; ++k) {
+        float q = std::rint(r(r(static_cast<float>(w[j + k]) - bias) / scale));
+        q = std::min(std::max(q, 0.0f), n_bins);
+        packed |= static_cast<uint32_t>(q) << (bits * k);
+      }
+      *wq++ = packed;
+    }
+    *scales++ = static_cast<T>(scale);
+    *biases++ = static_cast<T>(bias);
+    w += group_size;
+  }
+}
+
 } // namespace
 
 void Load::eval(const std::vector<array>& inputs, array& out) {
   assert(inputs.size() == 0);
   out.set_data(allocator::malloc_or_wait(out.nbytes()));
 
-  reader_->seek(offset_, std::ios_base::beg);
-  reader_->read(out.data<char>(), out.nbytes());
+  auto stored_dtype = stored_dtype_.value_or(out.dtype());
+  if (stored_dtype == out.dtype()) {
+    // Read in large chunks, from several threads if the reader supports it,
+    // and swap each chunk right after it is read
+    auto data = out.data<char>();
+    size_t nbytes = out.nbytes();
+    int n_chunks = (nbytes + read_chunk_bytes - 1) / read_chunk_bytes;
+    auto read_chunks = [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        size_t start = i * read_chunk_bytes;
+        size_t n = std::min(read_chunk_bytes, nbytes - start);
+        reader_->read(data + start, n, offset_ + start);
+        if (swap_endianness_) {
+          swap_endianness(
+              reinterpret_cast<uint8_t*>(data + start),
+              n / out.itemsize(),
+              out.itemsize());
+        }
+      }
+    };
+    if (n_chunks > 1 && reader_->concurrent_reads()) {
+      parallel_for(n_chunks, 1, read_chunks);
+    } else {
+      read_chunks(0, n_chunks);
+    }
+    return;
+  }
+
+  // Convert through a small staging buffer so the stored copy of the whole
+  // array never exists in memory
+  auto staging = alloc_staging(std::min(out.size(), chunk_size), stored_dtype);
+  for (size_t i = 0; i < out.size(); i += chunk_size) {
+    size_t n = std::min(chunk_size, out.size() - i);
+    auto src = view(staging, 0, n);
+    reader_->read(
+        src.data<char>(), src.nbytes(), offset_ + i * stored_dtype.size);
+    if (swap_endianness_) {
+      swap_endianness(src.data<uint8_t>(), n, stored_dtype.size);
+    }
+    auto dst = view(out, i, n);
+    copy_inplace(src, dst, CopyType::Vector);
+  }
+}
+
+void LoadQuantized::eval(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 0);
+  auto& wq = outputs[0];
+  auto& scales = outputs[1];
+  auto& biases = outputs[2];
+  for (auto& out : outputs) {
+    out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  }
+
+  // Read whole rows at a time, quantizing each chunk as it arrives
+  size_t groups_per_row = scales.shape(-1);
+  size_t row_size = groups_per_row * group_size_;
+  size_t n_rows = scales.size() / groups_per_row;
+  size_t chunk_rows = std::max<size_t>(1, chunk_size / row_size);
+  chunk_rows = std::min(chunk_rows, n_rows);
+  int row_words = row_size * bits_ / 32;
+
+  auto compute_dtype = scales.dtype();
+  auto staging = alloc_staging(chunk_rows * row_size, stored_dtype_);
+  auto w = stored_dtype_ == compute_dtype
+      ? staging
+      : alloc_staging(chunk_rows * row_size, compute_dtype);
+
+  for (size_t i = 0; i < n_rows; i += chunk_rows) {
+    size_t rows = std::min(chunk_rows, n_rows - i);
+    size_t n = rows * row_size;
+    auto src = view(staging, 0, n);
+    reader_->read(
+        src.data<char>(),
+        src.nbytes(),
+        offset_ + i * row_size * stored_dtype_.size);
+    if (swap_endianness_) {
+      swap_endianness(src.data<uint8_t>(), n, stored_dtype_.size);
+    }
+    if (stored_dtype_ != compute_dtype) {
+      auto dst = view(w, 0, n);
+      copy_inplace(src, dst, CopyType::Vector);
+    }
 
-  if (swap_endianness_) {
-    switch (out.itemsize()) {
-      case 2:
-        swap_endianness<2>(out.data<uint8_t>(), out.data_size());
+    auto quantize = [&](auto type_tag) {
+      using T = decltype(type_tag);
+      quantize_groups<T>(
+          w.data<T>(),
+          wq.data<uint32_t>() + i * row_words,
+          scales.data<T>() + i * groups_per_row,
+          biases.data<T>() + i * groups_per_row,
+          rows * groups_per_row,
+          group_size_,
+          bits_);
+    };
+    switch (compute_dtype) {
+      case float32:
+        quantize(float{});
         break;
-      case 4:
-        swap_endianness<4>(out.data<uint8_t>(), out.data_size());
+      case float16:
+        quantize(float16_t{});
         break;
-      case 8:
-        swap_endianness<8>(out.data<uint8_t>(), out.data_size());
+      case bfloat16:
+        quantize(bfloat16_t{});
         break;
+      default:
+        throw std::invalid_argument(
+            "[LoadQuantized] Only real floating types can be quantized.");
     }
   }
 }
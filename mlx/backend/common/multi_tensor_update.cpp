@@ -0,0 +1,231 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/fast_primitives.h"
+
+namespace mlx::core::fast {
+
+namespace {
+
+using Hyperparameters = MultiTensorUpdate::Hyperparameters;
+
+// Pointers to one parameter, its gradient and its optimizer states. The new
+// parameter and states are written in place when the inputs were donated.
+template <typename T>
+struct UpdateSpan {
+  const T* p;
+  const T* g;
+  const T* s0;
+  const T* s1;
+  T* p_out;
+  T* s0_out;
+  T* s1_out;
+};
+
+template <typename T>
+void sgd(
+    const UpdateSpan<T>& u,
+    size_t n,
+    float lr,
+    const Hyperparameters& h) {
+  for (size_t i = 0; i < n; ++i) {
+    float p = static_cast<float>(u.p[i]);
+    float g = static_cast<float>(u.g[i]);
+    if (h.weight_decay != 0) {
+      g += h.weight_decay * p;
+    }
+    if (h.momentum <= 0) {
+      u.p_out[i] = static_cast<T>(p - lr * g);
+      continue;
+    }
+    float v = h.momentum * static_cast<float>(u.s0[i]) +
+        (h.dampening > 0 ? (1 - h.dampening) * g : g);
+    float update = h.nesterov ? g + h.momentum * v : v;
+    u.s0_out[i] = static_cast<T>(v);
+    u.p_out[i] = static_cast<T>(p - lr * update);
+  }
+}
+
+template <typename T>
+void adam(
+    const UpdateSpan<T>& u,
+    size_t n,
+    float lr,
+    const Hyperparameters& h) {
+  float decay = 1 - lr * h.weight_decay;
+  for (size_t i = 0; i < n; ++i) {
+    float g = static_cast<float>(u.g[i]);
+    float m = h.beta1 * static_cast<float>(u.s0[i]) + (1 - h.beta1) * g;
+    float v = h.beta2 * static_cast<float>(u.s1[i]) + (1 - h.beta2) * g * g;
+    float p = static_cast<float>(u.p[i]) * decay;
+    u.s0_out[i] = static_cast<T>(m);
+    u.s1_out[i] = static_cast<T>(v);
+    u.p_out[i] = static_cast<T>(p - lr * m / (std::sqrt(v) + h.eps));
+  }
+}
+
+template <typename T>
+void lion(
+    const UpdateSpan<T>& u,
+    size_t n,
+    float lr,
+    const Hyperparameters& h) {
+  float decay = h.weight_decay > 0 ? 1 - lr * h.weight_decay : 1.0f;
+  for (size_t i = 0; i < n; ++i) {
+    float g = static_cast<float>(u.g[i]);
+    float m = static_cast<float>(u.s0[i]);
+    float c = h.beta1 * m + (1 - h.beta1) * g;
+    float sign_c = (c > 0) - (c < 0);
+    u.s0_out[i] = static_cast<T>(h.beta2 * m + (1 - h.beta2) * g);
+    u.p_out[i] =
+        static_cast<T>(static_cast<float>(u.p[i]) * decay - lr * sign_c);
+  }
+}
+
+template <typename T>
+void update_range(
+    MultiTensorUpdate::Kind kind,
+    const std::vector<const array*>& tensors,
+    const std::vector<array*>& outs,
+    size_t begin,
+    size_t end,
+    float lr,
+    const Hyperparameters& h) {
+  // tensors holds (p, g, s0, s1) and outs (p, s0, s1) with missing states
+  // left as null
+  auto ptr = [begin](const array* a) {
+    return a ? a->data<T>() + begin : nullptr;
+  };
+  auto out_ptr = [begin](array* a) {
+    return a ? a->data<T>() + begin : nullptr;
+  };
+  UpdateSpan<T> u{
+      ptr(tensors[0]),
+      ptr(tensors[1]),
+      ptr(tensors[2]),
+      ptr(tensors[3]),
+      out_ptr(outs[0]),
+      out_ptr(outs[1]),
+      out_ptr(outs[2])};
+  size_t n = end - begin;
+  switch (kind) {
+    case MultiTensorUpdate::SGD:
+      sgd(u, n, lr, h);
+      break;
+    case MultiTensorUpdate::Adam:
+      adam(u, n, lr, h);
+      break;
+    case MultiTensorUpdate::Lion:
+      lion(u, n, lr, h);
+      break;
+  }
+}
+
+} // namespace
+
+void MultiTensorUpdate::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  // Inputs are the learning rate followed by the parameters, the gradients
+  // and every state for each parameter. Outputs are the new parameters
+  // followed by the new states.
+  int n_states = num_states();
+  int n = outputs.size() / (1 + n_states);
+  assert(inputs.size() == 1 + n * (2 + n_states));
+  float lr = inputs[0].item<float>();
+
+  // Reuse the buffers of the old parameters and states when nothing but
+  // this primitive holds them so the update happens in place
+  int num_refs = outputs.size();
+  auto donate_or_alloc = [num_refs](const array& in, array& out) {
+    if (in.is_donatable(num_refs) && in.flags().row_contiguous &&
+        in.dtype() == out.dtype()) {
+      out.copy_shared_buffer(in);
+    } else {
+      out.set_data(allocator::malloc_or_wait(out.nbytes()));
+    }
+  };
+  auto ensure_row_contiguous = [](const array& arr) {
+    if (arr.flags().row_contiguous) {
+      return arr;
+    }
+    array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+    copy(arr, arr_copy, CopyType::General);
+    return arr_copy;
+  };
+
+  auto input = [&](int group, int i) -> const array& {
+    return inputs[1 + group * n + i];
+  };
+  for (int i = 0; i < n; ++i) {
+    donate_or_alloc(input(0, i), outputs[i]);
+    for (int k = 0; k < n_states; ++k) {
+      donate_or_alloc(input(2 + k, i), outputs[(1 + k) * n + i]);
+    }
+  }
+
+  // Contiguous views of the inputs. A donated buffer is shared with its
+  // output so reading and writing the same element in one pass is safe.
+  std::vector<array> ins;
+  ins.reserve(inputs.size() - 1);
+  for (int j = 1; j < inputs.size(); ++j) {
+    ins.push_back(ensure_row_contiguous(inputs[j]));
+  }
+
+  // Split the concatenation of all the parameters into chunks so small and
+  // large tensors alike are spread over the threads
+  std::vector<size_t> offsets(n + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    offsets[i + 1] = offsets[i] + outputs[i].size();
+  }
+  constexpr int block = 4096;
+  int n_blocks = (offsets[n] + block - 1) / block;
+
+  parallel_for(n_blocks, 4, [&](int b_begin, int b_end) {
+    size_t begin = static_cast<size_t>(b_begin) * block;
+    size_t end = std::min(static_cast<size_t>(b_end) * block, offsets[n]);
+    int i = std::upper_bound(offsets.begin(), offsets.end(), begin) -
+        offsets.begin() - 1;
+    for (; i < n && offsets[i] < end; ++i) {
+      size_t lo = std::max(begin, offsets[i]) - offsets[i];
+      size_t hi = std::min(end, offsets[i + 1]) - offsets[i];
+      if (lo >= hi) {
+        continue;
+      }
+      std::vector<const array*> tensors = {
+          &ins[i],
+          &ins[n + i],
+          n_states > 0 ? &ins[2 * n + i] : nullptr,
+          n_states > 1 ? &ins[3 * n + i] : nullptr};
+      std::vector<array*> outs = {
+          &outputs[i],
+          n_states > 0 ? &outputs[n + i] : nullptr,
+          n_states > 1 ? &outputs[2 * n + i] : nullptr};
+      switch (outputs[i].dtype()) {
+        case float32:
+          update_range<float>(kind_, tensors, outs, lo, hi, lr, hparams_);
+          break;
+        case float16:
+          update_range<float16_t>(
+              kind_, tensors, outs, lo, hi, lr, hparams_);
+          break;
+        case bfloat16:
+          update_range<bfloat16_t>(
+              kind_, tensors, outs, lo, hi, lr, hparams_);
+          break;
+        default:
+          throw std::runtime_error(
+              "[MultiTensorUpdate::eval_cpu] Only floating point "
+              "parameters are supported.");
+      }
+    }
+  });
+}
+
+} // namespace mlx::core::fast
@@ -16,92 +16,135 @@ typedef union {
   float f;
 } IntOrFloat;
 
+// The helpers below avoid branches and library calls, special values are
+// patched in with bit_select, so the element wise loops calling them can be
+// vectorized by the compiler.
+
+// Pick a or b with integer operations. A conditional on floats computed by
+// possibly trapping arithmetic would be left as a branch.
+inline float bit_select(bool c, float a, float b) {
+  IntOrFloat x, y;
+  x.f = a;
+  y.f = b;
+  int mask = -static_cast<int>(c);
+  x.i = (x.i & mask) | (y.i & ~mask);
+  return x.f;
+}
+
 inline float fast_exp(float x) {
-  if (x == -std::numeric_limits<float>::infinity()) {
-    return 0.0f;
-  } else if (x == std::numeric_limits<float>::infinity() || std::isnan(x)) {
-    return x;
-  }
-  x *= 1.442695; // multiply with log_2(e)
-  float ipart, fpart;
-  IntOrFloat epart;
-  x = std::max(-80.f, std::min(x, 80.f));
-  ipart = std::floor(x + 0.5);
-  fpart = x - ipart;
-
-  x = 1.535336188319500e-4f;
-  x = x * fpart + 1.339887440266574e-3f;
-  x = x * fpart + 9.618437357674640e-3f;
-  x = x * fpart + 5.550332471162809e-2f;
-  x = x * fpart + 2.402264791363012e-1f;
-  x = x * fpart + 6.931472028550421e-1f;
-  x = x * fpart + 1.000000000000000f;
+  float y = x * 1.442695f; // multiply with log_2(e)
+  y = bit_select(y > 80.f, 80.f, y);
+  y = bit_select(y < -80.f, -80.f, y);
+  // NaN passes both clamps and converting it to int is undefined, it is
+  // put back at the end
+  y = bit_select(y != y, 0.0f, y);
+  // y + 80.5 is positive so truncating it is the same as flooring
+  float ipart = static_cast<float>(static_cast<int>(y + 80.5f)) - 80.0f;
+  float fpart = y - ipart;
+
+  float p = 1.535336188319500e-4f;
+  p = p * fpart + 1.339887440266574e-3f;
+  p = p * fpart + 9.618437357674640e-3f;
+  p = p * fpart + 5.550332471162809e-2f;
+  p = p * fpart + 2.402264791363012e-1f;
+  p = p * fpart + 6.931472028550421e-1f;
+  p = p * fpart + 1.000000000000000f;
 
   // generate 2**ipart in the floating point representation using integer
   // bitshifting
-  epart.i = (int(ipart) + 127) << 23;
+  IntOrFloat epart;
+  epart.i = (static_cast<int>(ipart) + 127) << 23;
+
+  float r = epart.f * p;
+  r = bit_select(x == -inf, 0.0f, r);
+  return bit_select((x == inf) | (x != x), x, r);
+}
 
-  return epart.f * x;
+// Natural logarithm of normal floats from the series of atanh around the
+// mantissa
+inline float fast_log(float x) {
+  IntOrFloat bits;
+  bits.f = x;
+  float e = static_cast<float>(((bits.i >> 23) & 0xff) - 127);
+  IntOrFloat mantissa;
+  mantissa.i = (bits.i & 0x007fffff) | 0x3f800000;
+  float m = mantissa.f;
+  // Keep the mantissa in [sqrt(1/2), sqrt(2)) so the series stays short
+  bool high = m > 1.41421356f;
+  m = bit_select(high, 0.5f * m, m);
+  e = bit_select(high, e + 1.0f, e);
+
+  float z = (m - 1.0f) / (m + 1.0f);
+  float z2 = z * z;
+  float p = 1.0f / 9.0f;
+  p = p * z2 + 1.0f / 7.0f;
+  p = p * z2 + 1.0f / 5.0f;
+  p = p * z2 + 1.0f / 3.0f;
+  p = p * z2 + 1.0f;
+
+  float r = e * 0.693147180559945f + 2.0f * z * p;
+  r = bit_select(x == 0.0f, -inf, r);
+  r = bit_select(
+      (x < 0.0f) | (x != x), std::numeric_limits<float>::quiet_NaN(), r);
+  return bit_select(x == inf, inf, r);
 }
 
 inline float fast_erf(float a) {
-  float r, s, t, u;
+  float r, s, t, u, v;
   t = std::abs(a);
   s = a * a;
-  if (t > 0.927734375f) {
-    // maximum error 0.99527 ulp
-    r = std::fma(
-        -1.72853470e-5f, t, 3.83197126e-4f); // -0x1.220000p-16,0x1.91cfb2p-12
-    u = std::fma(
-        -3.88396438e-3f, t, 2.42546219e-2f); // -0x1.fd1438p-9, 0x1.8d6342p-6
-    r = std::fma(r, s, u);
-    r = std::fma(r, t, -1.06777877e-1f); // -0x1.b55cb8p-4
-    r = std::fma(r, t, -6.34846687e-1f); // -0x1.450aa0p-1
-    r = std::fma(r, t, -1.28717512e-1f); // -0x1.079d0cp-3
-    r = std::fma(r, t, -t);
-    // TODO, replace with expm1 when implemented
-    r = 1.0f - std::exp(r);
-    r = std::copysign(r, a);
-  } else {
-    // maximum error 0.98929 ulp
-    r = -5.96761703e-4f; // -0x1.38e000p-11
-    r = std::fma(r, s, 4.99119423e-3f); //  0x1.471a58p-8
-    r = std::fma(r, s, -2.67681349e-2f); // -0x1.b691b2p-6
-    r = std::fma(r, s, 1.12819925e-1f); //  0x1.ce1c44p-4
-    r = std::fma(r, s, -3.76125336e-1f); // -0x1.812700p-2
-    r = std::fma(r, s, 1.28379166e-1f); //  0x1.06eba8p-3
-    r = std::fma(r, a, a);
-  }
-  return r;
+
+  // maximum error 0.99527 ulp for |a| > 0.927734375
+  r = -1.72853470e-5f * t + 3.83197126e-4f; // -0x1.220000p-16,0x1.91cfb2p-12
+  u = -3.88396438e-3f * t + 2.42546219e-2f; // -0x1.fd1438p-9, 0x1.8d6342p-6
+  r = r * s + u;
+  r = r * t - 1.06777877e-1f; // -0x1.b55cb8p-4
+  r = r * t - 6.34846687e-1f; // -0x1.450aa0p-1
+  r = r * t - 1.28717512e-1f; // -0x1.079d0cp-3
+  r = r * t - t;
+  r = 1.0f - fast_exp(r);
+  r = std::copysign(r, a);
+
+  // maximum error 0.98929 ulp otherwise
+  v = -5.96761703e-4f; // -0x1.38e000p-11
+  v = v * s + 4.99119423e-3f; //  0x1.471a58p-8
+  v = v * s - 2.67681349e-2f; // -0x1.b691b2p-6
+  v = v * s + 1.12819925e-1f; //  0x1.ce1c44p-4
+  v = v * s - 3.76125336e-1f; // -0x1.812700p-2
+  v = v * s + 1.28379166e-1f; //  0x1.06eba8p-3
+  v = v * a + a;
+
+  return bit_select(t > 0.927734375f, r, v);
 }
 
 inline float fast_erfinv(float a) {
-  auto t = std::fma(a, 0.0f - a, 1.0f);
-  t = std::log(t);
-  float p;
-  if (std::abs(t) > 6.125f) { // maximum ulp error = 2.35793
-    p = 3.03697567e-10f; //  0x1.4deb44p-32
-    p = std::fma(p, t, 2.93243101e-8f); //  0x1.f7c9aep-26
-    p = std::fma(p, t, 1.22150334e-6f); //  0x1.47e512p-20
-    p = std::fma(p, t, 2.84108955e-5f); //  0x1.dca7dep-16
-    p = std::fma(p, t, 3.93552968e-4f); //  0x1.9cab92p-12
-    p = std::fma(p, t, 3.02698812e-3f); //  0x1.8cc0dep-9
-    p = std::fma(p, t, 4.83185798e-3f); //  0x1.3ca920p-8
-    p = std::fma(p, t, -2.64646143e-1f); // -0x1.0eff66p-2
-    p = std::fma(p, t, 8.40016484e-1f); //  0x1.ae16a4p-1
-  } else { // maximum ulp error = 2.35002
-    p = 5.43877832e-9f; //  0x1.75c000p-28
-    p = std::fma(p, t, 1.43285448e-7f); //  0x1.33b402p-23
-    p = std::fma(p, t, 1.22774793e-6f); //  0x1.499232p-20
-    p = std::fma(p, t, 1.12963626e-7f); //  0x1.e52cd2p-24
-    p = std::fma(p, t, -5.61530760e-5f); // -0x1.d70bd0p-15
-    p = std::fma(p, t, -1.47697632e-4f); // -0x1.35be90p-13
-    p = std::fma(p, t, 2.31468678e-3f); //  0x1.2f6400p-9
-    p = std::fma(p, t, 1.15392581e-2f); //  0x1.7a1e50p-7
-    p = std::fma(p, t, -2.32015476e-1f); // -0x1.db2aeep-3
-    p = std::fma(p, t, 8.86226892e-1f); //  0x1.c5bf88p-1
-  }
-  return a * p;
+  float t = fast_log(1.0f - a * a);
+  float p, q;
+
+  // maximum ulp error = 2.35793 for |t| > 6.125
+  p = 3.03697567e-10f; //  0x1.4deb44p-32
+  p = p * t + 2.93243101e-8f; //  0x1.f7c9aep-26
+  p = p * t + 1.22150334e-6f; //  0x1.47e512p-20
+  p = p * t + 2.84108955e-5f; //  0x1.dca7dep-16
+  p = p * t + 3.93552968e-4f; //  0x1.9cab92p-12
+  p = p * t + 3.02698812e-3f; //  0x1.8cc0dep-9
+  p = p * t + 4.83185798e-3f; //  0x1.3ca920p-8
+  p = p * t - 2.64646143e-1f; // -0x1.0eff66p-2
+  p = p * t + 8.40016484e-1f; //  0x1.ae16a4p-1
+
+  // maximum ulp error = 2.35002 otherwise
+  q = 5.43877832e-9f; //  0x1.75c000p-28
+  q = q * t + 1.43285448e-7f; //  0x1.33b402p-23
+  q = q * t + 1.22774793e-6f; //  0x1.499232p-20
+  q = q * t + 1.12963626e-7f; //  0x1.e52cd2p-24
+  q = q * t - 5.61530760e-5f; // -0x1.d70bd0p-15
+  q = q * t - 1.47697632e-4f; // -0x1.35be90p-13
+  q = q * t + 2.31468678e-3f; //  0x1.2f6400p-9
+  q = q * t + 1.15392581e-2f; //  0x1.7a1e50p-7
+  q = q * t - 2.32015476e-1f; // -0x1.db2aeep-3
+  q = q * t + 8.86226892e-1f; //  0x1.c5bf88p-1
+
+  return a * bit_select(std::abs(t) > 6.125f, p, q);
 }
 
 struct Abs {
@@ -0,0 +1,360 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/primitives.h"
+
+namespace mlx::core {
+
+namespace {
+
+// Describes the windows of a pooling of a row contiguous (N, ..., C) input.
+// The work is split over the batch and over blocks of channels so that no
+// two tasks write the same elements, even when the windows overlap.
+struct PoolGeometry {
+  int batch;
+  int channels;
+  std::vector<int> in_shape;
+  std::vector<int> out_shape;
+  std::vector<size_t> in_strides;
+  std::vector<int> kernel;
+  std::vector<int> stride;
+  std::vector<int> padding;
+  size_t in_spatial;
+  size_t out_spatial;
+  int channel_block;
+  int n_channel_blocks;
+
+  PoolGeometry(
+      const array& in,
+      const array& out,
+      const std::vector<int>& kernel,
+      const std::vector<int>& stride,
+      const std::vector<int>& padding)
+      : batch(in.shape(0)),
+        channels(in.shape(-1)),
+        in_shape(in.shape().begin() + 1, in.shape().end() - 1),
+        out_shape(out.shape().begin() + 1, out.shape().end() - 1),
+        kernel(kernel),
+        stride(stride),
+        padding(padding) {
+    int n = in_shape.size();
+    in_strides.resize(n);
+    size_t st = channels;
+    for (int i = n - 1; i >= 0; --i) {
+      in_strides[i] = st;
+      st *= in_shape[i];
+    }
+    in_spatial = st / channels;
+    out_spatial = 1;
+    for (auto o : out_shape) {
+      out_spatial *= o;
+    }
+
+    // Split the channels only when there are too few images to keep every
+    // thread busy. Blocks keep at least 16 channels for the inner loops.
+    int n_threads = max_threads();
+    int blocks = batch >= n_threads ? 1 : (n_threads + batch - 1) / batch;
+    blocks = std::max(1, std::min(blocks, channels / 16));
+    channel_block = (channels + blocks - 1) / blocks;
+    n_channel_blocks = (channels + channel_block - 1) / channel_block;
+  }
+
+  // Call fn(offset) with the offset of the first channel of every input
+  // position inside the window of the given output position. Positions in
+  // the padding are skipped.
+  template <typename F>
+  void for_each_in_window(size_t out_pos, F&& fn) const {
+    int n = in_shape.size();
+    int start[8];
+    int lo[8];
+    int hi[8];
+    for (int i = n - 1; i >= 0; --i) {
+      int o = out_pos % out_shape[i];
+      out_pos /= out_shape[i];
+      start[i] = o * stride[i] - padding[i];
+      lo[i] = std::max(0, -start[i]);
+      hi[i] = std::min(kernel[i], in_shape[i] - start[i]);
+      if (lo[i] >= hi[i]) {
+        return;
+      }
+    }
+    int k[8];
+    size_t offset = 0;
+    for (int i = 0; i < n; ++i) {
+      k[i] = lo[i];
+      offset += (start[i] + lo[i]) * in_strides[i];
+    }
+    while (true) {
+      fn(offset);
+      int i = n - 1;
+      for (; i >= 0; --i) {
+        if (++k[i] < hi[i]) {
+          offset += in_strides[i];
+          break;
+        }
+        offset -= (hi[i] - lo[i] - 1) * in_strides[i];
+        k[i] = lo[i];
+      }
+      if (i < 0) {
+        return;
+      }
+    }
+  }
+
+  template <typename F>
+  void parallel_over_blocks(F&& fn) const {
+    parallel_for(batch * n_channel_blocks, 1, [&](int begin, int end) {
+      for (int task = begin; task < end; ++task) {
+        int b = task / n_channel_blocks;
+        int c0 = (task % n_channel_blocks) * channel_block;
+        int c1 = std::min(c0 + channel_block, channels);
+        fn(b, c0, c1);
+      }
+    });
+  }
+};
+
+// Positions in the padding of a max pooling act as -inf
+template <typename T>
+T lowest() {
+  if constexpr (std::is_integral_v<T>) {
+    return std::numeric_limits<T>::lowest();
+  } else {
+    return static_cast<T>(-std::numeric_limits<float>::infinity());
+  }
+}
+
+template <typename T>
+void max_pool(const array& in, array& out, const PoolGeometry& g) {
+  const T* in_ptr = in.data<T>();
+  T* out_ptr = out.data<T>();
+  g.parallel_over_blocks([&](int b, int c0, int c1) {
+    const T* x = in_ptr + b * g.in_spatial * g.channels;
+    T* y = out_ptr + b * g.out_spatial * g.channels;
+    for (size_t o = 0; o < g.out_spatial; ++o) {
+      T* acc = y + o * g.channels;
+      std::fill(acc + c0, acc + c1, lowest<T>());
+      g.for_each_in_window(o, [&](size_t offset) {
+        const T* xi = x + offset;
+        for (int c = c0; c < c1; ++c) {
+          acc[c] = (xi[c] > acc[c]) ? xi[c] : acc[c];
+        }
+      });
+    }
+  });
+}
+
+template <typename T>
+void avg_pool(const array& in, array& out, const PoolGeometry& g) {
+  const T* in_ptr = in.data<T>();
+  T* out_ptr = out.data<T>();
+  float window = 1;
+  for (auto k : g.kernel) {
+    window *= k;
+  }
+  // The padding counts as zeros so every window has the same size
+  float norm = 1.0f / window;
+  g.parallel_over_blocks([&](int b, int c0, int c1) {
+    const T* x = in_ptr + b * g.in_spatial * g.channels;
+    T* y = out_ptr + b * g.out_spatial * g.channels;
+    std::vector<float> acc(c1 - c0);
+    for (size_t o = 0; o < g.out_spatial; ++o) {
+      std::fill(acc.begin(), acc.end(), 0.0f);
+      g.for_each_in_window(o, [&](size_t offset) {
+        const T* xi = x + offset + c0;
+        for (int c = 0; c < c1 - c0; ++c) {
+          acc[c] += static_cast<float>(xi[c]);
+        }
+      });
+      T* yo = y + o * g.channels + c0;
+      for (int c = 0; c < c1 - c0; ++c) {
+        yo[c] = static_cast<T>(acc[c] * norm);
+      }
+    }
+  });
+}
+
+// Gradients of overlapping windows add up so they are accumulated in float
+// and written out at the end.
+template <typename T>
+void max_pool_vjp(
+    const array& in,
+    const array& cotan,
+    array& out,
+    const PoolGeometry& g) {
+  const T* in_ptr = in.data<T>();
+  const T* cotan_ptr = cotan.data<T>();
+  T* out_ptr = out.data<T>();
+  g.parallel_over_blocks([&](int b, int c0, int c1) {
+    int nc = c1 - c0;
+    const T* x = in_ptr + b * g.in_spatial * g.channels;
+    const T* dy = cotan_ptr + b * g.out_spatial * g.channels;
+    std::vector<float> dx(g.in_spatial * nc, 0.0f);
+    std::vector<T> best(nc);
+    std::vector<int64_t> arg(nc);
+    for (size_t o = 0; o < g.out_spatial; ++o) {
+      std::fill(best.begin(), best.end(), lowest<T>());
+      std::fill(arg.begin(), arg.end(), -1);
+      g.for_each_in_window(o, [&](size_t offset) {
+        const T* xi = x + offset + c0;
+        int64_t pos = offset / g.channels;
+        for (int c = 0; c < nc; ++c) {
+          if (arg[c] < 0 || xi[c] > best[c]) {
+            best[c] = xi[c];
+            arg[c] = pos;
+          }
+        }
+      });
+      const T* dyo = dy + o * g.channels + c0;
+      for (int c = 0; c < nc; ++c) {
+        if (arg[c] >= 0) {
+          dx[arg[c] * nc + c] += static_cast<float>(dyo[c]);
+        }
+      }
+    }
+    T* y = out_ptr + b * g.in_spatial * g.channels + c0;
+    for (size_t i = 0; i < g.in_spatial; ++i) {
+      for (int c = 0; c < nc; ++c) {
+        y[i * g.channels + c] = static_cast<T>(dx[i * nc + c]);
+      }
+    }
+  });
+}
+
+template <typename T>
+void avg_pool_vjp(const array& cotan, array& out, const PoolGeometry& g) {
+  const T* cotan_ptr = cotan.data<T>();
+  T* out_ptr = out.data<T>();
+  float window = 1;
+  for (auto k : g.kernel) {
+    window *= k;
+  }
+  float norm = 1.0f / window;
+  g.parallel_over_blocks([&](int b, int c0, int c1) {
+    int nc = c1 - c0;
+    const T* dy = cotan_ptr + b * g.out_spatial * g.channels;
+    std::vector<float> dx(g.in_spatial * nc, 0.0f);
+    std::vector<float> grad(nc);
+    for (size_t o = 0; o < g.out_spatial; ++o) {
+      const T* dyo = dy + o * g.channels + c0;
+      for (int c = 0; c < nc; ++c) {
+        grad[c] = static_cast<float>(dyo[c]) * norm;
+      }
+      g.for_each_in_window(o, [&](size_t offset) {
+        float* dxi = dx.data() + (offset / g.channels) * nc;
+        for (int c = 0; c < nc; ++c) {
+          dxi[c] += grad[c];
+        }
+      });
+    }
+    T* y = out_ptr + b * g.in_spatial * g.channels + c0;
+    for (size_t i = 0; i < g.in_spatial; ++i) {
+      for (int c = 0; c < nc; ++c) {
+        y[i * g.channels + c] = static_cast<T>(dx[i * nc + c]);
+      }
+    }
+  });
+}
+
+array ensure_row_contiguous(const array& arr) {
+  if (arr.flags().row_contiguous) {
+    return arr;
+  } else {
+    array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+    copy(arr, arr_copy, CopyType::General);
+    return arr_copy;
+  }
+}
+
+} // namespace
+
+void Pooling::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 1);
+  auto in = ensure_row_contiguous(inputs[0]);
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+  PoolGeometry g(in, out, kernel_size_, stride_, padding_);
+
+  if (pool_type_ == Avg) {
+    switch (out.dtype()) {
+      case float32:
+        return avg_pool<float>(in, out, g);
+      case float16:
+        return avg_pool<float16_t>(in, out, g);
+      case bfloat16:
+        return avg_pool<bfloat16_t>(in, out, g);
+      default:
+        throw std::runtime_error(
+            "[Pooling::eval] Average pooling needs a floating point type.");
+    }
+  }
+
+  switch (out.dtype()) {
+    case bool_:
+      return max_pool<bool>(in, out, g);
+    case uint8:
+      return max_pool<uint8_t>(in, out, g);
+    case uint16:
+      return max_pool<uint16_t>(in, out, g);
+    case uint32:
+      return max_pool<uint32_t>(in, out, g);
+    case uint64:
+      return max_pool<uint64_t>(in, out, g);
+    case int8:
+      return max_pool<int8_t>(in, out, g);
+    case int16:
+      return max_pool<int16_t>(in, out, g);
+    case int32:
+      return max_pool<int32_t>(in, out, g);
+    case int64:
+      return max_pool<int64_t>(in, out, g);
+    case float16:
+      return max_pool<float16_t>(in, out, g);
+    case float32:
+      return max_pool<float>(in, out, g);
+    case bfloat16:
+      return max_pool<bfloat16_t>(in, out, g);
+    case complex64:
+      throw std::runtime_error(
+          "[Pooling::eval] Max pooling is not supported for complex types.");
+  }
+}
+
+void PoolingVJP::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 2);
+  auto in = ensure_row_contiguous(inputs[0]);
+  auto cotan = ensure_row_contiguous(inputs[1]);
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+  PoolGeometry g(in, cotan, kernel_size_, stride_, padding_);
+
+  bool is_max = pool_type_ == Pooling::Max;
+  switch (out.dtype()) {
+    case float32:
+      return is_max ? max_pool_vjp<float>(in, cotan, out, g)
+                    : avg_pool_vjp<float>(cotan, out, g);
+    case float16:
+      return is_max ? max_pool_vjp<float16_t>(in, cotan, out, g)
+                    : avg_pool_vjp<float16_t>(cotan, out, g);
+    case bfloat16:
+      return is_max ? max_pool_vjp<bfloat16_t>(in, cotan, out, g)
+                    : avg_pool_vjp<bfloat16_t>(cotan, out, g);
+    default:
+      throw std::runtime_error(
+          "[PoolingVJP::eval] Pooling gradients need a floating point type.");
+  }
+}
+
+} // namespace mlx::core
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <numeric>
 #include <sstream>
 
@@ -11,6 +12,7 @@
 #include "mlx/backend/common/binary.h"
 #include "mlx/backend/common/copy.h"
 #include "mlx/backend/common/ops.h"
+#include "mlx/backend/common/threading.h"
 #include "mlx/backend/common/threefry.h"
 #include "mlx/backend/common/unary.h"
 #include "mlx/backend/common/utils.h"
@@ -19,6 +21,103 @@
 
 namespace mlx::core {
 
+namespace {
+
+// Split the region of the row contiguous out with the given shape, starting
+// at element offset, into runs that are contiguous in out. Call
+// fn(out_offset, region_offset, n) for each run, spread over threads.
+template <typename F>
+void for_each_run(
+    const array& out,
+    const std::vector<int>& shape,
+    size_t offset,
+    F fn) {
+  if (shape.empty()) {
+    fn(offset, 0, 1);
+    return;
+  }
+  // Trailing axes covering whole rows of out extend the run
+  int j = shape.size() - 1;
+  while (j > 0 && shape[j] == out.shape(j)) {
+    j--;
+  }
+  size_t run = shape[j] * out.strides()[j];
+  std::vector<int> outer(shape.begin(), shape.begin() + j);
+  std::vector<size_t> outer_strides(
+      out.strides().begin(), out.strides().begin() + j);
+  size_t rows = std::accumulate(
+      outer.begin(), outer.end(), size_t(1), std::multiplies<size_t>());
+  if (rows * run == 0) {
+    return;
+  }
+  int min_rows = std::max<size_t>(1, (1 << 16) / run);
+  parallel_for(rows, min_rows, [&](int begin, int end) {
+    for (int r = begin; r < end; r++) {
+      fn(offset + elem_to_loc(r, outer, outer_strides), r * run, run);
+    }
+  });
+}
+
+// Copy src into the region of out with its shape starting at offset
+void copy_into_region(const array& src, array& out, size_t offset) {
+  if (!src.flags().row_contiguous || src.dtype() != out.dtype()) {
+    array out_slice(src.shape(), out.dtype(), nullptr, {});
+    auto flags = out.flags();
+    flags.row_contiguous = false;
+    flags.col_contiguous = false;
+    flags.contiguous = false;
+    out_slice.copy_shared_buffer(
+        out, out.strides(), flags, out_slice.size(), offset);
+    copy_inplace(src, out_slice, CopyType::GeneralGeneral);
+    return;
+  }
+  auto src_ptr = src.data<char>();
+  auto dst_ptr = out.data<char>();
+  auto size = out.itemsize();
+  for_each_run(out, src.shape(), offset, [&](size_t o, size_t i, size_t n) {
+    std::memcpy(dst_ptr + o * size, src_ptr + i * size, n * size);
+  });
+}
+
+template <typename T>
+void fill_region(
+    const array& val,
+    array& out,
+    const std::vector<int>& shape,
+    size_t offset) {
+  T v;
+  std::memcpy(&v, val.data<char>(), sizeof(T));
+  auto dst = out.data<T>();
+  for_each_run(out, shape, offset, [&](size_t o, size_t, size_t n) {
+    std::fill_n(dst + o, n, v);
+  });
+}
+
+// Fill the region of out with the given shape starting at offset with the
+// scalar val
+void fill_region(
+    const array& val,
+    array& out,
+    const std::vector<int>& shape,
+    size_t offset) {
+  switch (out.itemsize()) {
+    case 1:
+      fill_region<uint8_t>(val, out, shape, offset);
+      break;
+    case 2:
+      fill_region<uint16_t>(val, out, shape, offset);
+      break;
+    case 4:
+      fill_region<uint32_t>(val, out, shape, offset);
+      break;
+    case 8:
+      fill_region<uint64_t>(val, out, shape, offset);
+      break;
+  }
+}
+
+} // namespace
+
 void Abs::eval(const std::vector<array>& inputs, array& out) {
   assert(inputs.size() == 1);
   auto& in = inputs[0];
@@ -134,17 +233,9 @@ void Concatenate::eval(const std::vector<array>& inputs, array& out) {
 
   out.set_data(allocator::malloc_or_wait(out.nbytes()));
 
-  auto strides = out.strides();
-  auto flags = out.flags();
-  flags.row_contiguous = false;
-  flags.col_contiguous = false;
-  flags.contiguous = false;
+  // Each input is copied into its slice as whole contiguous runs
   for (int i = 0; i < inputs.size(); i++) {
-    array out_slice(inputs[i].shape(), out.dtype(), nullptr, {});
-    size_t data_offset = strides[axis_] * sizes[i];
-    out_slice.copy_shared_buffer(
-        out, strides, flags, out_slice.size(), data_offset);
-    copy_inplace(inputs[i], out_slice, CopyType::GeneralGeneral);
+    copy_into_region(inputs[i], out, out.strides()[axis_] * sizes[i]);
   }
 }
 
@@ -345,23 +436,32 @@ void Pad::eval(const std::vector<array>& inputs, array& out) {
   // Padding value, input and output must be of the same type
   assert(val.dtype() == in.dtype() && in.dtype() == out.dtype());
 
-  // Fill output with val
-  copy(val, out, CopyType::Scalar);
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
 
-  // Find offset for start of input values
+  // Fill only the border. For each padded axis fill the slabs below and
+  // above the input, restricted to the input along the axes done before so
+  // that nothing is written twice.
+  auto shape = out.shape();
   size_t data_offset = 0;
   for (int i = 0; i < axes_.size(); i++) {
     auto ax = axes_[i] < 0 ? out.ndim() + axes_[i] : axes_[i];
-    data_offset += out.strides()[ax] * low_pad_size_[i];
+    auto stride = out.strides()[ax];
+    int low = low_pad_size_[i];
+    int high = out.shape(ax) - low - in.shape(ax);
+    if (low > 0) {
+      shape[ax] = low;
+      fill_region(val, out, shape, data_offset);
+    }
+    if (high > 0) {
+      shape[ax] = high;
+      fill_region(val, out, shape, data_offset + stride * (low + in.shape(ax)));
+    }
+    shape[ax] = in.shape(ax);
+    data_offset += stride * low;
   }
 
-  // Extract slice from output where input will be pasted
-  array out_slice(in.shape(), out.dtype(), nullptr, {});
-  out_slice.copy_shared_buffer(
-      out, out.strides(), out.flags(), out_slice.size(), data_offset);
-
-  // Copy input values into the slice
-  copy_inplace(in, out_slice, CopyType::GeneralGeneral);
+  // Copy input values into the interior
+  copy_into_region(in, out, data_offset);
 }
 
 void RandomBits::eval(const std::vector<array>& inputs, array& out) {
@@ -1,7 +1,19 @@
 // Copyright © 2023 Apple Inc.
 
+#include <algorithm>
 #include <cassert>
-
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MLX_QMM_VNNI
+#include <immintrin.h>
+#endif
+#if defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#endif
+
+#include "mlx/backend/common/threading.h"
 #include "mlx/backend/metal/copy.h"
 #include "mlx/primitives.h"
 
@@ -328,6 +340,231 @@ void _bs_qmm_dispatch(
   }
 }
 
+// Dynamically quantized activations with 8 bit weights (W8A8).
+//
+// Every row of x is quantized to int8 with a single scale s_x. A group of
+// weights w = s * q + b with q in [0, 255] then contributes
+// s_x * (s * sum(x_q * q) + b * sum(x_q)) to the output, so the inner loop
+// is an integer product of unsigned and signed bytes accumulated in int32.
+
+// The integer dot products of a row of weights with a row of activations,
+// one per group.
+using GroupDotsFn = void (*)(
+    const uint8_t* w,
+    const int8_t* x,
+    int group_size,
+    int n_groups,
+    int32_t* out);
+
+void group_dots(
+    const uint8_t* w,
+    const int8_t* x,
+    int group_size,
+    int n_groups,
+    int32_t* out) {
+  for (int g = 0; g < n_groups; g++, w += group_size, x += group_size) {
+    int32_t acc = 0;
+    for (int k = 0; k < group_size; k++) {
+      acc += static_cast<int32_t>(w[k]) * static_cast<int32_t>(x[k]);
+    }
+    out[g] = acc;
+  }
+}
+
+#ifdef MLX_QMM_VNNI
+// vpdpbusd multiplies unsigned bytes with signed bytes and adds each four
+// products to an int32 lane which is exactly the product we need.
+__attribute__((target("avx2,avx512f,avx512vl,avx512vnni")))
+void group_dots_vnni(
+    const uint8_t* w,
+    const int8_t* x,
+    int group_size,
+    int n_groups,
+    int32_t* out) {
+  for (int g = 0; g < n_groups; g++, w += group_size, x += group_size) {
+    __m256i acc = _mm256_setzero_si256();
+    for (int k = 0; k < group_size; k += 32) {
+      auto wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k));
+      auto xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k));
+      acc = _mm256_dpbusd_epi32(acc, wv, xv);
+    }
+    __m128i sum = _mm_add_epi32(
+        _mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    out[g] = _mm_cvtsi128_si32(sum);
+  }
+}
+#endif
+
+#ifdef __ARM_FEATURE_DOTPROD
+// sdot only multiplies signed bytes so the weights are shifted to q - 128 and
+// 128 * sum(x_q) is added back.
+void group_dots_neon(
+    const uint8_t* w,
+    const int8_t* x,
+    int group_size,
+    int n_groups,
+    int32_t* out) {
+  const uint8x16_t offset = vdupq_n_u8(0x80);
+  const int8x16_t ones = vdupq_n_s8(1);
+  for (int g = 0; g < n_groups; g++, w += group_size, x += group_size) {
+    int32x4_t acc = vdupq_n_s32(0);
+    int32x4_t x_sum = vdupq_n_s32(0);
+    for (int k = 0; k < group_size; k += 16) {
+      int8x16_t wv = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(w + k), offset));
+      int8x16_t xv = vld1q_s8(x + k);
+      acc = vdotq_s32(acc, wv, xv);
+      x_sum = vdotq_s32(x_sum, ones, xv);
+    }
+    out[g] = vaddvq_s32(acc) + 128 * vaddvq_s32(x_sum);
+  }
+}
+#endif
+
+GroupDotsFn select_group_dots() {
+#ifdef MLX_QMM_VNNI
+  if (__builtin_cpu_supports("avx512vnni") &&
+      __builtin_cpu_supports("avx512vl")) {
+    return group_dots_vnni;
+  }
+#endif
+#ifdef __ARM_FEATURE_DOTPROD
+  return group_dots_neon;
+#endif
+  return group_dots;
+}
+
+template <typename T>
+void _qmm_t_int8(
+    T* result,
+    const T* x,
+    const uint32_t* w,
+    const T* scales,
+    const T* biases,
+    int M,
+    int N,
+    int K,
+    int group_size) {
+  static const GroupDotsFn dots_fn = select_group_dots();
+  const int n_groups = K / group_size;
+
+  // Quantize the activations with one scale per row and keep the per group
+  // sums for the bias term
+  std::vector<int8_t> x_q(static_cast<size_t>(M) * K);
+  std::vector<float> x_scales(M);
+  std::vector<int32_t> x_sums(static_cast<size_t>(M) * n_groups);
+  parallel_for(M, 1, [&](int begin, int end) {
+    for (int m = begin; m < end; m++) {
+      const T* x_row = x + static_cast<size_t>(m) * K;
+      int8_t* q_row = x_q.data() + static_cast<size_t>(m) * K;
+      float amax = 0.0f;
+      for (int k = 0; k < K; k++) {
+        amax = std::max(amax, std::abs(static_cast<float>(x_row[k])));
+      }
+      float inv_scale = (amax > 0.0f) ? 127.0f / amax : 0.0f;
+      x_scales[m] = amax / 127.0f;
+      for (int k = 0; k < K; k++) {
+        q_row[k] = static_cast<int8_t>(
+            std::round(static_cast<float>(x_row[k]) * inv_scale));
+      }
+      for (int g = 0; g < n_groups; g++) {
+        int32_t sum = 0;
+        for (int k = g * group_size; k < (g + 1) * group_size; k++) {
+          sum += q_row[k];
+        }
+        x_sums[static_cast<size_t>(m) * n_groups + g] = sum;
+      }
+    }
+  });
+
+  // 8 bit weights are packed four to a uint32 starting from the lowest byte
+  // so on little endian machines they can be read as bytes.
+  auto w_bytes = reinterpret_cast<const uint8_t*>(w);
+  // Each row of w costs M * K multiply adds, which can overflow an int
+  int64_t row_work = std::max<int64_t>(1, static_cast<int64_t>(M) * K);
+  int min_chunk = std::max<int64_t>(1, (int64_t(1) << 16) / row_work);
+  parallel_for(N, min_chunk, [&](int begin, int end) {
+    std::vector<int32_t> dots(n_groups);
+    for (int n = begin; n < end; n++) {
+      const uint8_t* w_row = w_bytes + static_cast<size_t>(n) * K;
+      const T* scales_row = scales + static_cast<size_t>(n) * n_groups;
+      const T* biases_row = biases + static_cast<size_t>(n) * n_groups;
+      for (int m = 0; m < M; m++) {
+        dots_fn(
+            w_row,
+            x_q.data() + static_cast<size_t>(m) * K,
+            group_size,
+            n_groups,
+            dots.data());
+        const int32_t* sums =
+            x_sums.data() + static_cast<size_t>(m) * n_groups;
+        float acc = 0.0f;
+        for (int g = 0; g < n_groups; g++) {
+          acc += static_cast<float>(scales_row[g]) * dots[g] +
+              static_cast<float>(biases_row[g]) * sums[g];
+        }
+        result[static_cast<size_t>(m) * N + n] =
+            static_cast<T>(acc * x_scales[m]);
+      }
+    }
+  });
+}
+
+void _qmm_int8_dispatch(
+    array& out,
+    const array& x,
+    const array& w,
+    const array& scales,
+    const array& biases,
+    int group_size) {
+  int K = x.shape(-1);
+  int M = x.size() / K;
+  int N = out.shape(-1);
+
+  switch (x.dtype()) {
+    case float32:
+      _qmm_t_int8<float>(
+          out.data<float>(),
+          x.data<float>(),
+          w.data<uint32_t>(),
+          scales.data<float>(),
+          biases.data<float>(),
+          M,
+          N,
+          K,
+          group_size);
+      break;
+    case float16:
+      _qmm_t_int8<float16_t>(
+          out.data<float16_t>(),
+          x.data<float16_t>(),
+          w.data<uint32_t>(),
+          scales.data<float16_t>(),
+          biases.data<float16_t>(),
+          M,
+          N,
+          K,
+          group_size);
+      break;
+    case bfloat16:
+      _qmm_t_int8<bfloat16_t>(
+          out.data<bfloat16_t>(),
+          x.data<bfloat16_t>(),
+          w.data<uint32_t>(),
+          scales.data<bfloat16_t>(),
+          biases.data<bfloat16_t>(),
+          M,
+          N,
+          K,
+          group_size);
+      break;
+    default:
+      throw std::invalid_argument(
+          "[quantized_matmul] only floating types are supported");
+  }
+}
+
 } // namespace
 
 void QuantizedMatmul::eval(const std::vector<array>& inputs, array& out) {
@@ -354,7 +591,11 @@ void QuantizedMatmul::eval(const std::vector<array>& inputs, array& out) {
   auto biases = ensure_row_contiguous(biases_pre);
 
   out.set_data(allocator::malloc_or_wait(out.nbytes()));
-  _qmm_dispatch(out, x, w, scales, biases, group_size_, bits_, transpose_);
+  if (quantize_activations_) {
+    _qmm_int8_dispatch(out, x, w, scales, biases, group_size_);
+  } else {
+    _qmm_dispatch(out, x, w, scales, biases, group_size_, bits_, transpose_);
+  }
 }
 
 void BlockSparseQMM::eval(const std::vector<array>& inputs, array& out) {
@@ -0,0 +1,508 @@
+// Copyright © 2024 Apple Inc.
+
+#ifdef ACCELERATE_NEW_LAPACK
+#include <Accelerate/Accelerate.h>
+#else
+#include <cblas.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/fast_primitives.h"
+
+namespace mlx::core::fast {
+
+namespace {
+
+// The recurrences run in float32 whatever the input type so the step GEMMs
+// can go to BLAS. Inputs are converted once and outputs once at the end.
+template <typename T>
+std::vector<float> to_float(const array& a) {
+  std::vector<float> out(a.size());
+  const T* ptr = a.data<T>();
+  for (size_t i = 0; i < a.size(); ++i) {
+    out[i] = static_cast<float>(ptr[i]);
+  }
+  return out;
+}
+
+template <typename T>
+void from_float(const std::vector<float>& in, array& out) {
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  T* ptr = out.data<T>();
+  for (size_t i = 0; i < in.size(); ++i) {
+    ptr[i] = static_cast<T>(in[i]);
+  }
+}
+
+inline float sigmoid(float x) {
+  return 1.0f / (1.0f + std::exp(-x));
+}
+
+// c = a @ b (+ c when accumulate) with row major operands
+void gemm(
+    const float* a,
+    int lda,
+    bool a_transposed,
+    const float* b,
+    int ldb,
+    bool b_transposed,
+    float* c,
+    int ldc,
+    int M,
+    int N,
+    int K,
+    bool accumulate) {
+  cblas_sgemm(
+      CblasRowMajor,
+      a_transposed ? CblasTrans : CblasNoTrans,
+      b_transposed ? CblasTrans : CblasNoTrans,
+      M,
+      N,
+      K,
+      1.0f,
+      a,
+      lda,
+      b,
+      ldb,
+      accumulate ? 1.0f : 0.0f,
+      c,
+      ldc);
+}
+
+// Run the elementwise work of one time step over the batch rows. Tiny
+// problems stay on the calling thread.
+void for_each_row(int N, int H, const std::function<void(int)>& fn) {
+  int min_chunk = std::max(1, 16384 / std::max(H, 1));
+  parallel_for(N, min_chunk, [&](int begin, int end) {
+    for (int n = begin; n < end; ++n) {
+      fn(n);
+    }
+  });
+}
+
+// The hidden state fed into every step, (N, L, H) with h0 first
+std::vector<float> previous_states(
+    const std::vector<float>& h0,
+    const std::vector<float>& hs,
+    int N,
+    int L,
+    int H) {
+  std::vector<float> prev(static_cast<size_t>(N) * L * H);
+  for (int n = 0; n < N; ++n) {
+    float* dst = prev.data() + static_cast<size_t>(n) * L * H;
+    std::copy_n(h0.data() + n * H, H, dst);
+    std::copy_n(
+        hs.data() + static_cast<size_t>(n) * L * H,
+        static_cast<size_t>(L - 1) * H,
+        dst + H);
+  }
+  return prev;
+}
+
+template <typename T>
+void lstm_forward(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  int N = inputs[0].shape(0);
+  int L = inputs[0].shape(1);
+  int H = inputs[1].shape(0);
+  int G = 4 * H;
+
+  auto x = to_float<T>(inputs[0]);
+  auto w_h = to_float<T>(inputs[1]);
+  auto h = to_float<T>(inputs[2]);
+  auto c = to_float<T>(inputs[3]);
+  std::vector<float> hs(static_cast<size_t>(N) * L * H);
+  std::vector<float> cs(hs.size());
+  std::vector<float> gates(static_cast<size_t>(N) * G);
+
+  for (int t = 0; t < L; ++t) {
+    // gates = x_t + h @ W_h
+    for (int n = 0; n < N; ++n) {
+      std::copy_n(
+          x.data() + (static_cast<size_t>(n) * L + t) * G,
+          G,
+          gates.data() + static_cast<size_t>(n) * G);
+    }
+    gemm(
+        h.data(),
+        H,
+        false,
+        w_h.data(),
+        G,
+        false,
+        gates.data(),
+        G,
+        N,
+        G,
+        H,
+        true);
+
+    for_each_row(N, H, [&](int n) {
+      const float* g = gates.data() + static_cast<size_t>(n) * G;
+      float* h_n = h.data() + static_cast<size_t>(n) * H;
+      float* c_n = c.data() + static_cast<size_t>(n) * H;
+      size_t offset = (static_cast<size_t>(n) * L + t) * H;
+      for (int j = 0; j < H; ++j) {
+        float i_g = sigmoid(g[j]);
+        float f_g = sigmoid(g[H + j]);
+        float g_g = std::tanh(g[2 * H + j]);
+        float o_g = sigmoid(g[3 * H + j]);
+        c_n[j] = f_g * c_n[j] + i_g * g_g;
+        h_n[j] = o_g * std::tanh(c_n[j]);
+        hs[offset + j] = h_n[j];
+        cs[offset + j] = c_n[j];
+      }
+    });
+  }
+
+  from_float<T>(hs, outputs[0]);
+  from_float<T>(cs, outputs[1]);
+}
+
+template <typename T>
+void lstm_backward(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  int N = inputs[0].shape(0);
+  int L = inputs[0].shape(1);
+  int H = inputs[1].shape(0);
+  int G = 4 * H;
+  int NL = N * L;
+
+  auto x = to_float<T>(inputs[0]);
+  auto w_h = to_float<T>(inputs[1]);
+  auto h0 = to_float<T>(inputs[2]);
+  auto c0 = to_float<T>(inputs[3]);
+  auto hs = to_float<T>(inputs[4]);
+  auto cs = to_float<T>(inputs[5]);
+  auto d_hs = to_float<T>(inputs[6]);
+  auto d_cs = to_float<T>(inputs[7]);
+
+  // Every step's gates at once from the saved hidden states
+  auto h_prev = previous_states(h0, hs, N, L, H);
+  auto c_prev = previous_states(c0, cs, N, L, H);
+  auto& gates = x;
+  gemm(
+      h_prev.data(),
+      H,
+      false,
+      w_h.data(),
+      G,
+      false,
+      gates.data(),
+      G,
+      NL,
+      G,
+      H,
+      true);
+
+  std::vector<float> d_gates(static_cast<size_t>(NL) * G);
+  std::vector<float> d_h(static_cast<size_t>(N) * H, 0.0f);
+  std::vector<float> d_c(static_cast<size_t>(N) * H, 0.0f);
+  for (int t = L - 1; t >= 0; --t) {
+    for_each_row(N, H, [&](int n) {
+      size_t row = static_cast<size_t>(n) * L + t;
+      const float* g = gates.data() + row * G;
+      float* dg = d_gates.data() + row * G;
+      float* d_h_n = d_h.data() + static_cast<size_t>(n) * H;
+      float* d_c_n = d_c.data() + static_cast<size_t>(n) * H;
+      for (int j = 0; j < H; ++j) {
+        float i_g = sigmoid(g[j]);
+        float f_g = sigmoid(g[H + j]);
+        float g_g = std::tanh(g[2 * H + j]);
+        float o_g = sigmoid(g[3 * H + j]);
+        float tanh_c = std::tanh(cs[row * H + j]);
+
+        float dh = d_hs[row * H + j] + d_h_n[j];
+        float dc = d_cs[row * H + j] + d_c_n[j] +
+            dh * o_g * (1.0f - tanh_c * tanh_c);
+        dg[j] = dc * g_g * i_g * (1.0f - i_g);
+        dg[H + j] = dc * c_prev[row * H + j] * f_g * (1.0f - f_g);
+        dg[2 * H + j] = dc * i_g * (1.0f - g_g * g_g);
+        dg[3 * H + j] = dh * tanh_c * o_g * (1.0f - o_g);
+        d_c_n[j] = dc * f_g;
+      }
+    });
+    // The gradient flowing into the previous hidden state
+    gemm(
+        d_gates.data() + static_cast<size_t>(t) * G,
+        L * G,
+        false,
+        w_h.data(),
+        G,
+        true,
+        d_h.data(),
+        H,
+        N,
+        H,
+        G,
+        false);
+  }
+
+  std::vector<float> d_w_h(static_cast<size_t>(H) * G);
+  gemm(
+      h_prev.data(),
+      H,
+      true,
+      d_gates.data(),
+      G,
+      false,
+      d_w_h.data(),
+      G,
+      H,
+      G,
+      NL,
+      false);
+
+  from_float<T>(d_gates, outputs[0]);
+  from_float<T>(d_w_h, outputs[1]);
+  from_float<T>(d_h, outputs[2]);
+  from_float<T>(d_c, outputs[3]);
+}
+
+template <typename T>
+void gru_forward(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs,
+    bool has_hidden) {
+  int N = inputs[0].shape(0);
+  int L = inputs[0].shape(1);
+  int H = inputs[1].shape(0);
+  int G = 3 * H;
+
+  auto x = to_float<T>(inputs[0]);
+  auto w_h = to_float<T>(inputs[1]);
+  auto b_hn = to_float<T>(inputs[2]);
+  auto h = to_float<T>(inputs[3]);
+  std::vector<float> hs(static_cast<size_t>(N) * L * H);
+  std::vector<float> h_proj(static_cast<size_t>(N) * G);
+
+  for (int t = 0; t < L; ++t) {
+    gemm(
+        h.data(),
+        H,
+        false,
+        w_h.data(),
+        G,
+        false,
+        h_proj.data(),
+        G,
+        N,
+        G,
+        H,
+        false);
+    // Without an initial state the first step has no hidden projection
+    bool use_bias = has_hidden || t > 0;
+
+    for_each_row(N, H, [&](int n) {
+      const float* x_t = x.data() + (static_cast<size_t>(n) * L + t) * G;
+      const float* hp = h_proj.data() + static_cast<size_t>(n) * G;
+      float* h_n = h.data() + static_cast<size_t>(n) * H;
+      float* out = hs.data() + (static_cast<size_t>(n) * L + t) * H;
+      for (int j = 0; j < H; ++j) {
+        float r = sigmoid(x_t[j] + hp[j]);
+        float z = sigmoid(x_t[H + j] + hp[H + j]);
+        float hp_n = hp[2 * H + j] + (use_bias ? b_hn[j] : 0.0f);
+        float n_g = std::tanh(x_t[2 * H + j] + r * hp_n);
+        h_n[j] = (1.0f - z) * n_g + z * h_n[j];
+        out[j] = h_n[j];
+      }
+    });
+  }
+
+  from_float<T>(hs, outputs[0]);
+}
+
+template <typename T>
+void gru_backward(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs,
+    bool has_hidden) {
+  int N = inputs[0].shape(0);
+  int L = inputs[0].shape(1);
+  int H = inputs[1].shape(0);
+  int G = 3 * H;
+  int NL = N * L;
+
+  auto x = to_float<T>(inputs[0]);
+  auto w_h = to_float<T>(inputs[1]);
+  auto b_hn = to_float<T>(inputs[2]);
+  auto h0 = to_float<T>(inputs[3]);
+  auto hs = to_float<T>(inputs[4]);
+  auto d_hs = to_float<T>(inputs[5]);
+
+  // Every step's hidden projection at once from the saved hidden states
+  auto h_prev = previous_states(h0, hs, N, L, H);
+  std::vector<float> h_proj(static_cast<size_t>(NL) * G);
+  gemm(
+      h_prev.data(),
+      H,
+      false,
+      w_h.data(),
+      G,
+      false,
+      h_proj.data(),
+      G,
+      NL,
+      G,
+      H,
+      false);
+
+  std::vector<float> d_x(static_cast<size_t>(NL) * G);
+  std::vector<float> d_h_proj(static_cast<size_t>(NL) * G);
+  std::vector<float> d_h(static_cast<size_t>(N) * H, 0.0f);
+  std::vector<float> d_b_hn(H, 0.0f);
+  for (int t = L - 1; t >= 0; --t) {
+    bool use_bias = has_hidden || t > 0;
+    for_each_row(N, H, [&](int n) {
+      size_t row = static_cast<size_t>(n) * L + t;
+      const float* x_t = x.data() + row * G;
+      const float* hp = h_proj.data() + row * G;
+      float* dx = d_x.data() + row * G;
+      float* dhp = d_h_proj.data() + row * G;
+      float* d_h_n = d_h.data() + static_cast<size_t>(n) * H;
+      for (int j = 0; j < H; ++j) {
+        float r = sigmoid(x_t[j] + hp[j]);
+        float z = sigmoid(x_t[H + j] + hp[H + j]);
+        float hp_n = hp[2 * H + j] + (use_bias ? b_hn[j] : 0.0f);
+        float n_g = std::tanh(x_t[2 * H + j] + r * hp_n);
+
+        float dh = d_hs[row * H + j] + d_h_n[j];
+        float dn = dh * (1.0f - z) * (1.0f - n_g * n_g);
+        float dr = dn * hp_n * r * (1.0f - r);
+        float dz = dh * (h_prev[row * H + j] - n_g) * z * (1.0f - z);
+        dx[j] = dhp[j] = dr;
+        dx[H + j] = dhp[H + j] = dz;
+        dx[2 * H + j] = dn;
+        dhp[2 * H + j] = dn * r;
+        d_h_n[j] = dh * z;
+      }
+    });
+    if (use_bias) {
+      for (int n = 0; n < N; ++n) {
+        const float* dhp =
+            d_h_proj.data() + (static_cast<size_t>(n) * L + t) * G + 2 * H;
+        for (int j = 0; j < H; ++j) {
+          d_b_hn[j] += dhp[j];
+        }
+      }
+    }
+    gemm(
+        d_h_proj.data() + static_cast<size_t>(t) * G,
+        L * G,
+        false,
+        w_h.data(),
+        G,
+        true,
+        d_h.data(),
+        H,
+        N,
+        H,
+        G,
+        true);
+  }
+
+  std::vector<float> d_w_h(static_cast<size_t>(H) * G);
+  gemm(
+      h_prev.data(),
+      H,
+      true,
+      d_h_proj.data(),
+      G,
+      false,
+      d_w_h.data(),
+      G,
+      H,
+      G,
+      NL,
+      false);
+
+  from_float<T>(d_x, outputs[0]);
+  from_float<T>(d_w_h, outputs[1]);
+  from_float<T>(d_b_hn, outputs[2]);
+  from_float<T>(d_h, outputs[3]);
+}
+
+std::vector<array> ensure_row_contiguous(const std::vector<array>& inputs) {
+  std::vector<array> out;
+  for (auto& arr : inputs) {
+    if (arr.flags().row_contiguous) {
+      out.push_back(arr);
+    } else {
+      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+      copy(arr, arr_copy, CopyType::General);
+      out.push_back(arr_copy);
+    }
+  }
+  return out;
+}
+
+template <typename F>
+void dispatch_float(Dtype dtype, const char* tag, F&& f) {
+  switch (dtype) {
+    case float32:
+      f(float{});
+      break;
+    case float16:
+      f(float16_t{});
+      break;
+    case bfloat16:
+      f(bfloat16_t{});
+      break;
+    default:
+      throw std::runtime_error(
+          std::string(tag) + " Only floating point types are supported.");
+  }
+}
+
+} // namespace
+
+void LSTM::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 4);
+  auto ins = ensure_row_contiguous(inputs);
+  dispatch_float(outputs[0].dtype(), "[LSTM::eval_cpu]", [&](auto t) {
+    lstm_forward<decltype(t)>(ins, outputs);
+  });
+}
+
+void LSTMVJP::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 8);
+  auto ins = ensure_row_contiguous(inputs);
+  dispatch_float(outputs[0].dtype(), "[LSTMVJP::eval_cpu]", [&](auto t) {
+    lstm_backward<decltype(t)>(ins, outputs);
+  });
+}
+
+void GRU::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 4);
+  auto ins = ensure_row_contiguous(inputs);
+  dispatch_float(outputs[0].dtype(), "[GRU::eval_cpu]", [&](auto t) {
+    gru_forward<decltype(t)>(ins, outputs, has_hidden_);
+  });
+}
+
+void GRUVJP::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 6);
+  auto ins = ensure_row_contiguous(inputs);
+  dispatch_float(outputs[0].dtype(), "[GRUVJP::eval_cpu]", [&](auto t) {
+    gru_backward<decltype(t)>(ins, outputs, has_hidden_);
+  });
+}
+
+} // namespace mlx::core::fast
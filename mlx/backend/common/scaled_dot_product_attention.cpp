@@ -0,0 +1,576 @@
+// Copyright © 2024 Apple Inc.
+
+#ifdef ACCELERATE_NEW_LAPACK
+#include <Accelerate/Accelerate.h>
+#else
+#include <cblas.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/fast_primitives.h"
+
+namespace mlx::core::fast {
+
+namespace {
+
+// A quantized key or value cache of shape (B, H, S, D * bits / 32). Only the
+// last axis needs to be contiguous so slices of a larger preallocated cache
+// are read in place.
+template <typename T>
+struct QuantizedRows {
+  const uint32_t* w;
+  const T* scales;
+  const T* biases;
+  std::array<size_t, 3> w_strides;
+  std::array<size_t, 3> s_strides;
+  std::array<size_t, 3> b_strides;
+
+  QuantizedRows(const array& w_, const array& scales_, const array& biases_)
+      : w(w_.data<uint32_t>()),
+        scales(scales_.data<T>()),
+        biases(biases_.data<T>()) {
+    for (int i = 0; i < 3; ++i) {
+      w_strides[i] = w_.strides()[i];
+      s_strides[i] = scales_.strides()[i];
+      b_strides[i] = biases_.strides()[i];
+    }
+  }
+
+  const uint32_t* w_row(int b, int h, int s) const {
+    return w + b * w_strides[0] + h * w_strides[1] + s * w_strides[2];
+  }
+  const T* scales_row(int b, int h, int s) const {
+    return scales + b * s_strides[0] + h * s_strides[1] + s * s_strides[2];
+  }
+  const T* biases_row(int b, int h, int s) const {
+    return biases + b * b_strides[0] + h * b_strides[1] + s * b_strides[2];
+  }
+};
+
+// q . dequantize(k) for one key row. The bias of every group multiplies the
+// sum of the matching queries so only the integer part is expanded.
+template <typename T, int bits, int group_size>
+float quantized_dot(
+    const float* q,
+    const float* q_sums,
+    const uint32_t* w,
+    const T* scales,
+    const T* biases,
+    int groups) {
+  constexpr uint32_t bitmask = (1 << bits) - 1;
+  constexpr int pack_factor = 32 / bits;
+  constexpr int packs_in_group = group_size / pack_factor;
+  float result = 0;
+  for (int g = 0; g < groups; ++g) {
+    float acc = 0;
+    for (int p = 0; p < packs_in_group; ++p) {
+      uint32_t wi = *w++;
+      for (int j = 0; j < pack_factor; ++j) {
+        acc += (*q++) * static_cast<float>(wi & bitmask);
+        wi >>= bits;
+      }
+    }
+    result += static_cast<float>(scales[g]) * acc +
+        static_cast<float>(biases[g]) * q_sums[g];
+  }
+  return result;
+}
+
+// out += p * dequantize(v) for one value row.
+template <typename T, int bits, int group_size>
+void quantized_axpy(
+    float p,
+    float* out,
+    const uint32_t* w,
+    const T* scales,
+    const T* biases,
+    int groups) {
+  constexpr uint32_t bitmask = (1 << bits) - 1;
+  constexpr int pack_factor = 32 / bits;
+  constexpr int packs_in_group = group_size / pack_factor;
+  for (int g = 0; g < groups; ++g) {
+    float scale = p * static_cast<float>(scales[g]);
+    float bias = p * static_cast<float>(biases[g]);
+    for (int n = 0; n < packs_in_group; ++n) {
+      uint32_t wi = *w++;
+      for (int j = 0; j < pack_factor; ++j) {
+        *out++ += scale * static_cast<float>(wi & bitmask) + bias;
+        wi >>= bits;
+      }
+    }
+  }
+}
+
+template <typename T, int bits, int group_size>
+void quantized_sdpa(
+    const array& q,
+    const QuantizedRows<T>& k,
+    const QuantizedRows<T>& v,
+    const std::optional<array>& mask,
+    array& out,
+    int n_kv_heads,
+    int S,
+    float scale) {
+  int B = q.shape(0);
+  int n_q_heads = q.shape(1);
+  int L = q.shape(2);
+  int D = q.shape(3);
+  int Dv = out.shape(3);
+  int n_repeats = n_q_heads / n_kv_heads;
+
+  const T* q_ptr = q.data<T>();
+  T* out_ptr = out.data<T>();
+  const T* mask_ptr = mask ? mask->data<T>() : nullptr;
+  std::array<size_t, 4> mask_strides{};
+  if (mask) {
+    std::copy(
+        mask->strides().begin(), mask->strides().end(), mask_strides.begin());
+  }
+  int k_groups = D / group_size;
+  int v_groups = Dv / group_size;
+
+  parallel_for(B * n_q_heads * L, 1, [&](int begin, int end) {
+    // Per thread buffers reused across the rows of the chunk
+    std::vector<float> qf(D);
+    std::vector<float> q_sums(k_groups);
+    std::vector<float> scores(S);
+    std::vector<float> acc(Dv);
+
+    for (int task = begin; task < end; ++task) {
+      int l = task % L;
+      int h = (task / L) % n_q_heads;
+      int b = task / (L * n_q_heads);
+      int kv_h = h / n_repeats;
+
+      const T* q_row = q_ptr + static_cast<size_t>(task) * D;
+      for (int i = 0; i < D; ++i) {
+        qf[i] = scale * static_cast<float>(q_row[i]);
+      }
+      for (int g = 0; g < k_groups; ++g) {
+        float sum = 0;
+        for (int i = 0; i < group_size; ++i) {
+          sum += qf[g * group_size + i];
+        }
+        q_sums[g] = sum;
+      }
+
+      float max_score = -std::numeric_limits<float>::infinity();
+      for (int s = 0; s < S; ++s) {
+        float score = quantized_dot<T, bits, group_size>(
+            qf.data(),
+            q_sums.data(),
+            k.w_row(b, kv_h, s),
+            k.scales_row(b, kv_h, s),
+            k.biases_row(b, kv_h, s),
+            k_groups);
+        if (mask_ptr) {
+          score += static_cast<float>(
+              mask_ptr
+                  [b * mask_strides[0] + h * mask_strides[1] +
+                   l * mask_strides[2] + s * mask_strides[3]]);
+        }
+        scores[s] = score;
+        max_score = std::max(max_score, score);
+      }
+
+      std::fill(acc.begin(), acc.end(), 0.0f);
+      float normalizer = 0;
+      for (int s = 0; s < S; ++s) {
+        float p = std::exp(scores[s] - max_score);
+        normalizer += p;
+        quantized_axpy<T, bits, group_size>(
+            p,
+            acc.data(),
+            v.w_row(b, kv_h, s),
+            v.scales_row(b, kv_h, s),
+            v.biases_row(b, kv_h, s),
+            v_groups);
+      }
+
+      T* out_row = out_ptr + static_cast<size_t>(task) * Dv;
+      for (int i = 0; i < Dv; ++i) {
+        out_row[i] = static_cast<T>(acc[i] / normalizer);
+      }
+    }
+  });
+}
+
+template <typename T, int bits>
+void dispatch_group_size(
+    const array& q,
+    const QuantizedRows<T>& k,
+    const QuantizedRows<T>& v,
+    const std::optional<array>& mask,
+    array& out,
+    int n_kv_heads,
+    int S,
+    float scale,
+    int group_size) {
+  switch (group_size) {
+    case 32:
+      quantized_sdpa<T, bits, 32>(q, k, v, mask, out, n_kv_heads, S, scale);
+      break;
+    case 64:
+      quantized_sdpa<T, bits, 64>(q, k, v, mask, out, n_kv_heads, S, scale);
+      break;
+    case 128:
+      quantized_sdpa<T, bits, 128>(q, k, v, mask, out, n_kv_heads, S, scale);
+      break;
+  }
+}
+
+template <typename T>
+void dispatch_bits(
+    const std::vector<array>& inputs,
+    const std::optional<array>& mask,
+    array& out,
+    float scale,
+    int group_size,
+    int bits) {
+  const auto& q = inputs[0];
+  QuantizedRows<T> k(inputs[1], inputs[2], inputs[3]);
+  QuantizedRows<T> v(inputs[4], inputs[5], inputs[6]);
+  int n_kv_heads = inputs[1].shape(1);
+  int S = inputs[1].shape(2);
+  if (bits == 4) {
+    dispatch_group_size<T, 4>(
+        q, k, v, mask, out, n_kv_heads, S, scale, group_size);
+  } else {
+    dispatch_group_size<T, 8>(
+        q, k, v, mask, out, n_kv_heads, S, scale, group_size);
+  }
+}
+
+// Rows of a (B, H, S, D) query, key or value array. Only the last axis has
+// to be contiguous so transposed and broadcast views are read in place.
+template <typename T>
+struct StridedRows {
+  const T* ptr;
+  std::array<size_t, 3> strides;
+
+  explicit StridedRows(const array& a) : ptr(a.data<T>()) {
+    for (int i = 0; i < 3; ++i) {
+      strides[i] = a.strides()[i];
+    }
+  }
+
+  const T* row(int b, int h, int s) const {
+    return ptr + b * strides[0] + h * strides[1] + s * strides[2];
+  }
+};
+
+// A block of n rows of width d as a float32 matrix with leading dimension
+// ld. Float32 rows with a usable stride are handed to BLAS as they are and
+// anything else is converted into buffer.
+template <typename T>
+const float* load_rows(
+    const StridedRows<T>& rows,
+    int b,
+    int h,
+    int s,
+    int n,
+    int d,
+    std::vector<float>& buffer,
+    int& ld) {
+  if constexpr (std::is_same_v<T, float>) {
+    if (rows.strides[2] >= d) {
+      ld = rows.strides[2];
+      return rows.row(b, h, s);
+    }
+  }
+  ld = d;
+  for (int i = 0; i < n; ++i) {
+    const T* src = rows.row(b, h, s + i);
+    std::copy(src, src + d, buffer.data() + i * d);
+  }
+  return buffer.data();
+}
+
+template <typename T>
+void sdpa(
+    const array& q_,
+    const array& k_,
+    const array& v_,
+    const std::optional<array>& mask,
+    array& out,
+    float scale,
+    bool causal) {
+  int B = q_.shape(0);
+  int n_q_heads = q_.shape(1);
+  int L = q_.shape(2);
+  int D = q_.shape(3);
+  int n_kv_heads = k_.shape(1);
+  int S = k_.shape(2);
+  int Dv = v_.shape(3);
+  int n_repeats = n_q_heads / n_kv_heads;
+
+  // Query i sees the keys up to i + offset when masking causally
+  int offset = S - L;
+
+  // The queries of all the heads sharing a key head are stacked so each key
+  // and value block feeds one GEMM of about 64 rows
+  constexpr int key_block = 128;
+  int query_block = std::max(1, 64 / n_repeats);
+  int n_query_blocks = (L + query_block - 1) / query_block;
+  int max_rows = n_repeats * std::min(query_block, L);
+
+  StridedRows<T> q(q_);
+  StridedRows<T> k(k_);
+  StridedRows<T> v(v_);
+  T* out_ptr = out.data<T>();
+  const T* mask_ptr = mask ? mask->data<T>() : nullptr;
+  std::array<size_t, 4> mask_strides{};
+  if (mask) {
+    std::copy(
+        mask->strides().begin(), mask->strides().end(), mask_strides.begin());
+  }
+
+  int n_tasks = B * n_kv_heads * n_query_blocks;
+  parallel_for(n_tasks, 1, [&](int begin, int end) {
+    // Per thread buffers reused across the tasks of the chunk
+    std::vector<float> qf(max_rows * D);
+    std::vector<float> kf(key_block * D);
+    std::vector<float> vf(key_block * Dv);
+    std::vector<float> scores(max_rows * key_block);
+    std::vector<float> acc(max_rows * Dv);
+    std::vector<float> row_max(max_rows);
+    std::vector<float> row_sum(max_rows);
+
+    for (int task = begin; task < end; ++task) {
+      int l_block = task % n_query_blocks;
+      int kv_h = (task / n_query_blocks) % n_kv_heads;
+      int b = task / (n_query_blocks * n_kv_heads);
+      int l_begin = l_block * query_block;
+      int nq = std::min(query_block, L - l_begin);
+      int rows = n_repeats * nq;
+
+      // Row r is query l_begin + r % nq of head kv_h * n_repeats + r / nq
+      for (int r = 0; r < rows; ++r) {
+        const T* src = q.row(b, kv_h * n_repeats + r / nq, l_begin + r % nq);
+        for (int i = 0; i < D; ++i) {
+          qf[r * D + i] = scale * static_cast<float>(src[i]);
+        }
+      }
+      std::fill(acc.begin(), acc.begin() + rows * Dv, 0.0f);
+      std::fill(
+          row_max.begin(),
+          row_max.begin() + rows,
+          -std::numeric_limits<float>::infinity());
+      std::fill(row_sum.begin(), row_sum.begin() + rows, 0.0f);
+
+      // Key blocks past the last visible key of the block are never read
+      int s_end = causal ? std::clamp(l_begin + nq + offset, 0, S) : S;
+      for (int s_begin = 0; s_begin < s_end; s_begin += key_block) {
+        int nk = std::min(key_block, s_end - s_begin);
+        int ldk, ldv;
+        const float* kp = load_rows(k, b, kv_h, s_begin, nk, D, kf, ldk);
+        const float* vp = load_rows(v, b, kv_h, s_begin, nk, Dv, vf, ldv);
+
+        cblas_sgemm(
+            CblasRowMajor,
+            CblasNoTrans,
+            CblasTrans,
+            rows,
+            nk,
+            D,
+            1.0f,
+            qf.data(),
+            D,
+            kp,
+            ldk,
+            0.0f,
+            scores.data(),
+            key_block);
+
+        // Mask the scores and fold the block into the running softmax of
+        // every row
+        for (int r = 0; r < rows; ++r) {
+          int h = kv_h * n_repeats + r / nq;
+          int l = l_begin + r % nq;
+          float* score = scores.data() + r * key_block;
+          if (mask_ptr) {
+            const T* m = mask_ptr + b * mask_strides[0] +
+                h * mask_strides[1] + l * mask_strides[2] +
+                s_begin * mask_strides[3];
+            for (int j = 0; j < nk; ++j) {
+              score[j] += static_cast<float>(m[j * mask_strides[3]]);
+            }
+          }
+          if (causal) {
+            for (int j = std::max(0, l + offset - s_begin + 1); j < nk; ++j) {
+              score[j] = -std::numeric_limits<float>::infinity();
+            }
+          }
+          float new_max = row_max[r];
+          for (int j = 0; j < nk; ++j) {
+            new_max = std::max(new_max, score[j]);
+          }
+          if (new_max == -std::numeric_limits<float>::infinity()) {
+            std::fill(score, score + nk, 0.0f);
+            continue;
+          }
+          float factor = std::exp(row_max[r] - new_max);
+          float sum = 0;
+          for (int j = 0; j < nk; ++j) {
+            score[j] = std::exp(score[j] - new_max);
+            sum += score[j];
+          }
+          row_max[r] = new_max;
+          row_sum[r] = row_sum[r] * factor + sum;
+          if (factor != 1.0f) {
+            float* a = acc.data() + r * Dv;
+            for (int i = 0; i < Dv; ++i) {
+              a[i] *= factor;
+            }
+          }
+        }
+
+        cblas_sgemm(
+            CblasRowMajor,
+            CblasNoTrans,
+            CblasNoTrans,
+            rows,
+            Dv,
+            nk,
+            1.0f,
+            scores.data(),
+            key_block,
+            vp,
+            ldv,
+            1.0f,
+            acc.data(),
+            Dv);
+      }
+
+      for (int r = 0; r < rows; ++r) {
+        int h = kv_h * n_repeats + r / nq;
+        int l = l_begin + r % nq;
+        size_t out_row = (static_cast<size_t>(b) * n_q_heads + h) * L + l;
+        T* dst = out_ptr + out_row * Dv;
+        const float* a = acc.data() + r * Dv;
+        for (int i = 0; i < Dv; ++i) {
+          dst[i] = static_cast<T>(a[i] / row_sum[r]);
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+void ScaledDotProductAttention::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 3 + needs_mask_);
+  auto& out = outputs[0];
+
+  auto ensure_last_contiguous = [](const array& arr) {
+    if (arr.strides()[arr.ndim() - 1] == 1) {
+      return arr;
+    } else {
+      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+      copy(arr, arr_copy, CopyType::General);
+      return arr_copy;
+    }
+  };
+  auto q = ensure_last_contiguous(inputs[0]);
+  auto k = ensure_last_contiguous(inputs[1]);
+  auto v = ensure_last_contiguous(inputs[2]);
+  std::optional<array> mask = std::nullopt;
+  if (needs_mask_) {
+    mask = inputs[3];
+  }
+
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+
+  switch (out.dtype()) {
+    case float32:
+      sdpa<float>(q, k, v, mask, out, scale_, causal_);
+      break;
+    case float16:
+      sdpa<float16_t>(q, k, v, mask, out, scale_, causal_);
+      break;
+    case bfloat16:
+      sdpa<bfloat16_t>(q, k, v, mask, out, scale_, causal_);
+      break;
+    default:
+      throw std::runtime_error(
+          "[ScaledDotProductAttention::eval_cpu] Only floating point types "
+          "are supported.");
+  }
+}
+
+void QuantizedScaledDotProductAttention::eval_cpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  assert(inputs.size() == 7 + needs_mask_);
+  auto& out = outputs[0];
+
+  auto ensure_row_contiguous = [](const array& arr) {
+    if (arr.flags().row_contiguous) {
+      return arr;
+    } else {
+      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+      copy(arr, arr_copy, CopyType::General);
+      return arr_copy;
+    }
+  };
+
+  // The caches are read through their strides as long as the quantized rows
+  // themselves are contiguous.
+  auto ensure_last_contiguous = [](const array& arr) {
+    if (arr.strides()[arr.ndim() - 1] == 1) {
+      return arr;
+    } else {
+      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+      copy(arr, arr_copy, CopyType::General);
+      return arr_copy;
+    }
+  };
+
+  std::vector<array> ins = {ensure_row_contiguous(inputs[0])};
+  for (int i = 1; i < 7; ++i) {
+    ins.push_back(ensure_last_contiguous(inputs[i]));
+  }
+  std::optional<array> mask = std::nullopt;
+  if (needs_mask_) {
+    mask = inputs[7];
+  }
+
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+
+  switch (out.dtype()) {
+    case float32:
+      dispatch_bits<float>(ins, mask, out, scale_, group_size_, bits_);
+      break;
+    case float16:
+      dispatch_bits<float16_t>(ins, mask, out, scale_, group_size_, bits_);
+      break;
+    case bfloat16:
+      dispatch_bits<bfloat16_t>(ins, mask, out, scale_, group_size_, bits_);
+      break;
+    default:
+      throw std::runtime_error(
+          "[QuantizedScaledDotProductAttention::eval_cpu] Only floating "
+          "point types are supported.");
+  }
+}
+
+} // namespace mlx::core::fast
@@ -1,7 +1,10 @@
 // Copyright © 2023 Apple Inc.
 
 #include <cassert>
+#include <cstring>
+#include <type_traits>
 
+#include "mlx/backend/common/binary.h"
 #include "mlx/backend/common/ternary.h"
 #include "mlx/primitives.h"
 
@@ -9,6 +12,74 @@ namespace mlx::core {
 
 namespace {
 
+template <int N>
+using UnsignedOfSize = std::conditional_t<
+    N == 1,
+    uint8_t,
+    std::conditional_t<
+        N == 2,
+        uint16_t,
+        std::conditional_t<N == 4, uint32_t, uint64_t>>>;
+
+// Blend with an integer mask as wide as T. Unlike condition ? x : y this
+// vectorizes when T is wider than the bool condition.
+struct Blend {
+  template <typename T>
+  T operator()(bool condition, T x, T y) {
+    using U = UnsignedOfSize<sizeof(T)>;
+    U ux, uy;
+    std::memcpy(&ux, &x, sizeof(T));
+    std::memcpy(&uy, &y, sizeof(T));
+    U mask = -static_cast<U>(condition);
+    U r = (ux & mask) | (uy & ~mask);
+    T out = x;
+    std::memcpy(&out, &r, sizeof(T));
+    return out;
+  }
+};
+
+// Same results as maximum(x, lo) and minimum(x, hi), a NaN in x or in the
+// bound propagates
+struct ClipLow {
+  template <typename T>
+  T operator()(T x, T lo) {
+    if constexpr (std::is_integral_v<T>) {
+      return x > lo ? x : lo;
+    } else {
+      return (x > lo) | (x != x) ? x : lo;
+    }
+  }
+};
+
+struct ClipHigh {
+  template <typename T>
+  T operator()(T x, T hi) {
+    if constexpr (std::is_integral_v<T>) {
+      return x < hi ? x : hi;
+    } else {
+      return (x < hi) | (x != x) ? x : hi;
+    }
+  }
+};
+
+struct ClipBoth {
+  template <typename T>
+  T operator()(T x, T lo, T hi) {
+    return ClipHigh()(ClipLow()(x, lo), hi);
+  }
+};
+
+template <typename T>
+void clip_op(const std::vector<array>& inputs, array& out, bool has_min) {
+  if (inputs.size() == 3) {
+    ternary_op<T, T, T, T>(inputs[0], inputs[1], inputs[2], out, ClipBoth());
+  } else if (has_min) {
+    binary_op<T>(inputs[0], inputs[1], out, ClipLow());
+  } else {
+    binary_op<T>(inputs[0], inputs[1], out, ClipHigh());
+  }
+}
+
 template <typename Op>
 void select_op(
     const array& a,
@@ -66,7 +137,52 @@ void Select::eval(const std::vector<array>& inputs, array& out) {
   const auto& condition = inputs[0];
   const auto& a = inputs[1];
   const auto& b = inputs[2];
-  select_op(condition, a, b, out, detail::Select());
+  select_op(condition, a, b, out, Blend());
+}
+
+void Clip::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 1 + has_min_ + has_max_);
+  switch (out.dtype()) {
+    case bool_:
+      clip_op<bool>(inputs, out, has_min_);
+      break;
+    case uint8:
+      clip_op<uint8_t>(inputs, out, has_min_);
+      break;
+    case uint16:
+      clip_op<uint16_t>(inputs, out, has_min_);
+      break;
+    case uint32:
+      clip_op<uint32_t>(inputs, out, has_min_);
+      break;
+    case uint64:
+      clip_op<uint64_t>(inputs, out, has_min_);
+      break;
+    case int8:
+      clip_op<int8_t>(inputs, out, has_min_);
+      break;
+    case int16:
+      clip_op<int16_t>(inputs, out, has_min_);
+      break;
+    case int32:
+      clip_op<int32_t>(inputs, out, has_min_);
+      break;
+    case int64:
+      clip_op<int64_t>(inputs, out, has_min_);
+      break;
+    case float16:
+      clip_op<float16_t>(inputs, out, has_min_);
+      break;
+    case float32:
+      clip_op<float>(inputs, out, has_min_);
+      break;
+    case bfloat16:
+      clip_op<bfloat16_t>(inputs, out, has_min_);
+      break;
+    case complex64:
+      throw std::invalid_argument(
+          "[clip] Clip is not supported for complex arrays.");
+  }
 }
 
 } // namespace mlx::core
@@ -0,0 +1,213 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/primitives.h"
+
+namespace mlx::core {
+
+namespace {
+
+// Below this many entries per thread the partial outputs cost more than the
+// work they split.
+constexpr int min_nnz_per_thread = 4096;
+
+// CSR without transpose: every output row is a combination of rows of b
+// given by the entries of the matching sparse row, so rows are independent.
+template <typename T>
+void csr_matmul(
+    const T* values,
+    const uint32_t* row_ptr,
+    const uint32_t* cols,
+    const T* b,
+    T* out,
+    int rows,
+    int n) {
+  parallel_for(rows, 16, [&](int begin, int end) {
+    std::vector<float> acc(n);
+    for (int i = begin; i < end; ++i) {
+      std::fill(acc.begin(), acc.end(), 0.0f);
+      for (auto k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+        float v = static_cast<float>(values[k]);
+        const T* b_row = b + static_cast<size_t>(cols[k]) * n;
+        for (int j = 0; j < n; ++j) {
+          acc[j] += v * static_cast<float>(b_row[j]);
+        }
+      }
+      T* out_row = out + static_cast<size_t>(i) * n;
+      for (int j = 0; j < n; ++j) {
+        out_row[j] = static_cast<T>(acc[j]);
+      }
+    }
+  });
+}
+
+// COO, or CSR with transpose: every entry adds a scaled row of b to some
+// output row. Wide outputs are split by columns so threads never write the
+// same element. Narrow ones (e.g. matrix-vector products) split the entries
+// and sum per thread partial outputs.
+template <typename T>
+void scatter_matmul(
+    const T* values,
+    const uint32_t* rows,
+    const uint32_t* cols,
+    const T* b,
+    T* out,
+    bool csr,
+    bool transpose,
+    int sparse_rows,
+    int nnz,
+    int out_rows,
+    int n) {
+  auto accumulate = [&](int k0, int k1, int j0, int j1, float* acc) {
+    // rows holds the row offsets for CSR so find the row of the first entry
+    int r = 0;
+    if (csr) {
+      r = std::upper_bound(rows, rows + sparse_rows + 1, k0) - rows - 1;
+    }
+    for (int k = k0; k < k1; ++k) {
+      int row;
+      if (csr) {
+        while (rows[r + 1] <= k) {
+          ++r;
+        }
+        row = r;
+      } else {
+        row = rows[k];
+      }
+      int col = cols[k];
+      int src = transpose ? row : col;
+      int dst = transpose ? col : row;
+      float v = static_cast<float>(values[k]);
+      const T* b_row = b + static_cast<size_t>(src) * n;
+      float* acc_row = acc + static_cast<size_t>(dst) * n;
+      for (int j = j0; j < j1; ++j) {
+        acc_row[j] += v * static_cast<float>(b_row[j]);
+      }
+    }
+  };
+
+  size_t out_size = static_cast<size_t>(out_rows) * n;
+  std::vector<float> acc(out_size, 0.0f);
+  int n_threads = max_threads();
+  int n_parts = std::min(n_threads, std::max(1, nnz / min_nnz_per_thread));
+  if (n >= 16 * n_threads || n_parts == 1) {
+    parallel_for(n, 16, [&](int j0, int j1) {
+      accumulate(0, nnz, j0, j1, acc.data());
+    });
+  } else {
+    std::vector<std::vector<float>> partials(n_parts - 1);
+    parallel_for(n_parts, 1, [&](int begin, int end) {
+      for (int p = begin; p < end; ++p) {
+        float* dst = acc.data();
+        if (p > 0) {
+          partials[p - 1].assign(out_size, 0.0f);
+          dst = partials[p - 1].data();
+        }
+        int k0 = static_cast<int64_t>(nnz) * p / n_parts;
+        int k1 = static_cast<int64_t>(nnz) * (p + 1) / n_parts;
+        accumulate(k0, k1, 0, n, dst);
+      }
+    });
+    // Split the sum by rows since the number of elements may not fit an int
+    parallel_for(out_rows, std::max(1, 4096 / n), [&](int r0, int r1) {
+      size_t begin = static_cast<size_t>(r0) * n;
+      size_t end = static_cast<size_t>(r1) * n;
+      for (auto& partial : partials) {
+        for (size_t i = begin; i < end; ++i) {
+          acc[i] += partial[i];
+        }
+      }
+    });
+  }
+  std::transform(acc.begin(), acc.end(), out, [](float v) {
+    return static_cast<T>(v);
+  });
+}
+
+template <typename T>
+void sparse_matmul(
+    const array& values,
+    const array& rows,
+    const array& cols,
+    const array& b,
+    array& out,
+    bool csr,
+    bool transpose,
+    int sparse_rows) {
+  int n = out.shape(1);
+  if (csr && !transpose) {
+    csr_matmul(
+        values.data<T>(),
+        rows.data<uint32_t>(),
+        cols.data<uint32_t>(),
+        b.data<T>(),
+        out.data<T>(),
+        out.shape(0),
+        n);
+  } else {
+    scatter_matmul(
+        values.data<T>(),
+        rows.data<uint32_t>(),
+        cols.data<uint32_t>(),
+        b.data<T>(),
+        out.data<T>(),
+        csr,
+        transpose,
+        sparse_rows,
+        values.size(),
+        out.shape(0),
+        n);
+  }
+}
+
+} // namespace
+
+void SparseMatmul::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 4);
+
+  auto ensure_row_contiguous = [](const array& arr) {
+    if (arr.flags().row_contiguous) {
+      return arr;
+    } else {
+      array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+      copy(arr, arr_copy, CopyType::General);
+      return arr_copy;
+    }
+  };
+
+  auto values = ensure_row_contiguous(inputs[0]);
+  auto rows = ensure_row_contiguous(inputs[1]);
+  auto cols = ensure_row_contiguous(inputs[2]);
+  auto b = ensure_row_contiguous(inputs[3]);
+
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+
+  bool csr = format_ == CSR;
+  switch (out.dtype()) {
+    case float32:
+      sparse_matmul<float>(values, rows, cols, b, out, csr, transpose_, rows_);
+      break;
+    case float16:
+      sparse_matmul<float16_t>(
+          values, rows, cols, b, out, csr, transpose_, rows_);
+      break;
+    case bfloat16:
+      sparse_matmul<bfloat16_t>(
+          values, rows, cols, b, out, csr, transpose_, rows_);
+      break;
+    default:
+      throw std::runtime_error(
+          "[SparseMatmul::eval] Only floating point types are supported.");
+  }
+}
+
+} // namespace mlx::core
@@ -4,6 +4,7 @@
 #include "mlx/allocator.h"
 #include "mlx/array.h"
 #include "mlx/backend/common/ops.h"
+#include "mlx/backend/common/threading.h"
 #include "mlx/backend/common/utils.h"
 namespace mlx::core {
 
@@ -12,14 +13,21 @@ namespace {
 // TODO: Add support for more combinations of input types.
 enum class TernaryOpType {
   ScalarScalarScalar,
+  // Every input is a scalar or row contiguous so one flat loop covers it
+  Contiguous,
   General,
 };
 
 TernaryOpType
 get_ternary_op_type(const array& a, const array& b, const array& c) {
+  auto flat = [](const array& x) {
+    return x.data_size() == 1 || x.flags().row_contiguous;
+  };
   TernaryOpType topt;
   if (a.data_size() == 1 && b.data_size() == 1 && c.data_size() == 1) {
     topt = TernaryOpType::ScalarScalarScalar;
+  } else if (flat(a) && flat(b) && flat(c)) {
+    topt = TernaryOpType::Contiguous;
   } else {
     topt = TernaryOpType::General;
   }
@@ -33,17 +41,185 @@ void set_ternary_op_output_data(
     array& out,
     TernaryOpType topt,
     bool donate_with_move = false) {
+  auto donate = [&out](const array& x) {
+    if (x.data_size() == out.size() && x.flags().row_contiguous &&
+        x.itemsize() == out.itemsize() && x.is_donatable()) {
+      out.copy_shared_buffer(x);
+      return true;
+    }
+    return false;
+  };
   switch (topt) {
     case TernaryOpType::ScalarScalarScalar:
       out.set_data(
           allocator::malloc_or_wait(out.itemsize()), 1, b.strides(), b.flags());
       break;
+    case TernaryOpType::Contiguous:
+      if (donate(b) || donate(c)) {
+        break;
+      }
+      out.set_data(allocator::malloc_or_wait(out.nbytes()));
+      break;
     case TernaryOpType::General:
       out.set_data(allocator::malloc_or_wait(out.nbytes()));
       break;
   }
 }
 
+// A run of n outputs where each input is either read in order or, when it
+// is a scalar, held in a register. The scalar cases are separate
+// instantiations so the loop is a plain blend the compiler vectorizes.
+template <
+    bool AScalar,
+    bool BScalar,
+    bool CScalar,
+    typename T1,
+    typename T2,
+    typename T3,
+    typename U,
+    typename Op>
+void ternary_op_run(
+    const T1* a,
+    const T2* b,
+    const T3* c,
+    U* dst,
+    size_t n,
+    Op op) {
+  T1 a_scalar = *a;
+  T2 b_scalar = *b;
+  T3 c_scalar = *c;
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = op(
+        AScalar ? a_scalar : a[i],
+        BScalar ? b_scalar : b[i],
+        CScalar ? c_scalar : c[i]);
+  }
+}
+
+template <typename T1, typename T2, typename T3, typename U, typename Op>
+void ternary_op_run(
+    const T1* a,
+    bool a_scalar,
+    const T2* b,
+    bool b_scalar,
+    const T3* c,
+    bool c_scalar,
+    U* dst,
+    size_t n,
+    Op op) {
+  int scalars = (a_scalar << 2) | (b_scalar << 1) | c_scalar;
+  switch (scalars) {
+    case 0:
+      ternary_op_run<false, false, false>(a, b, c, dst, n, op);
+      break;
+    case 1:
+      ternary_op_run<false, false, true>(a, b, c, dst, n, op);
+      break;
+    case 2:
+      ternary_op_run<false, true, false>(a, b, c, dst, n, op);
+      break;
+    case 3:
+      ternary_op_run<false, true, true>(a, b, c, dst, n, op);
+      break;
+    case 4:
+      ternary_op_run<true, false, false>(a, b, c, dst, n, op);
+      break;
+    case 5:
+      ternary_op_run<true, false, true>(a, b, c, dst, n, op);
+      break;
+    case 6:
+      ternary_op_run<true, true, false>(a, b, c, dst, n, op);
+      break;
+    default:
+      ternary_op_run<true, true, true>(a, b, c, dst, n, op);
+      break;
+  }
+}
+
+// Flat inputs are split into blocks spread over the threads
+template <typename T1, typename T2, typename T3, typename U, typename Op>
+void ternary_op_contiguous(
+    const array& a,
+    const array& b,
+    const array& c,
+    array& out,
+    Op op) {
+  const T1* a_ptr = a.data<T1>();
+  const T2* b_ptr = b.data<T2>();
+  const T3* c_ptr = c.data<T3>();
+  U* dst = out.data<U>();
+  bool a_scalar = a.data_size() == 1;
+  bool b_scalar = b.data_size() == 1;
+  bool c_scalar = c.data_size() == 1;
+  size_t n = out.size();
+  constexpr size_t block = 16384;
+  int n_blocks = (n + block - 1) / block;
+  parallel_for(n_blocks, 4, [&](int b_begin, int b_end) {
+    size_t begin = b_begin * block;
+    size_t end = std::min(b_end * block, n);
+    ternary_op_run(
+        a_ptr + (a_scalar ? 0 : begin),
+        a_scalar,
+        b_ptr + (b_scalar ? 0 : begin),
+        b_scalar,
+        c_ptr + (c_scalar ? 0 : begin),
+        c_scalar,
+        dst + begin,
+        end - begin,
+        op);
+  });
+}
+
+// Broadcast inputs whose innermost collapsed axis is contiguous or
+// broadcast, e.g. a (L, S) mask applied to (B, H, L, S) scores, run one row
+// at a time with the rows spread over the threads. Returns false when the
+// rows are too short or strided.
+template <typename T1, typename T2, typename T3, typename U, typename Op>
+bool ternary_op_rows(
+    const array& a,
+    const array& b,
+    const array& c,
+    array& out,
+    Op op) {
+  if (out.size() > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  std::vector<int> shape;
+  std::vector<std::vector<size_t>> strides;
+  std::tie(shape, strides) = collapse_contiguous_dims(a, b, c, out);
+  int row = shape.back();
+  for (auto& st : strides) {
+    if (st.back() > 1) {
+      return false;
+    }
+  }
+  if (row < 16) {
+    return false;
+  }
+  const T1* a_ptr = a.data<T1>();
+  const T2* b_ptr = b.data<T2>();
+  const T3* c_ptr = c.data<T3>();
+  U* dst = out.data<U>();
+  int n_rows = out.size() / row;
+  int min_rows = std::max(1, 4096 / row);
+  parallel_for(n_rows, min_rows, [&](int r_begin, int r_end) {
+    for (int r = r_begin; r < r_end; ++r) {
+      int elem = r * row;
+      ternary_op_run(
+          a_ptr + elem_to_loc(elem, shape, strides[0]),
+          strides[0].back() == 0,
+          b_ptr + elem_to_loc(elem, shape, strides[1]),
+          strides[1].back() == 0,
+          c_ptr + elem_to_loc(elem, shape, strides[2]),
+          strides[2].back() == 0,
+          dst + elem,
+          row,
+          op);
+    }
+  });
+  return true;
+}
+
 template <typename T1, typename T2, typename T3, typename U, typename Op>
 void ternary_op_dims1(
     const array& a,
@@ -218,6 +394,15 @@ void ternary_op(
     return;
   }
 
+  if (topt == TernaryOpType::Contiguous) {
+    ternary_op_contiguous<T1, T2, T3, U>(a, b, c, out, op);
+    return;
+  }
+
+  if (ternary_op_rows<T1, T2, T3, U>(a, b, c, out, op)) {
+    return;
+  }
+
   ternary_op_dispatch_dims<T1, T2, T3, U>(a, b, c, out, op);
 }
 
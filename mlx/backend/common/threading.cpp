@@ -0,0 +1,209 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mlx/backend/common/threading.h"
+#include "mlx/numa.h"
+
+namespace mlx::core {
+
+namespace {
+
+thread_local bool in_worker = false;
+
+class ThreadPool {
+ public:
+  explicit ThreadPool(int n_threads, CpuAffinity affinity = {})
+      : affinity_(std::move(affinity)) {
+    for (int i = 1; i < n_threads; ++i) {
+      workers_.emplace_back(&ThreadPool::worker_fn, this);
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto& t : workers_) {
+      t.join();
+    }
+  }
+
+  int size() const {
+    return workers_.size() + 1;
+  }
+
+  // Run task(i) for i in [0, n_tasks). Returns false without running anything
+  // if the pool is busy with another job.
+  bool try_run(int n_tasks, const std::function<void(int)>& task) {
+    std::unique_lock<std::mutex> run_lk(run_mtx_, std::try_to_lock);
+    if (!run_lk.owns_lock()) {
+      return false;
+    }
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      task_ = &task;
+      n_tasks_ = n_tasks;
+      next_ = 0;
+      done_ = 0;
+      generation_++;
+    }
+    cond_.notify_all();
+
+    in_worker = true;
+    work(task, n_tasks);
+    in_worker = false;
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    done_cond_.wait(lk, [this] { return done_ == n_tasks_ && active_ == 0; });
+    task_ = nullptr;
+    return true;
+  }
+
+ private:
+  void work(const std::function<void(int)>& task, int n_tasks) {
+    int i;
+    while ((i = next_.fetch_add(1)) < n_tasks) {
+      task(i);
+      if (done_.fetch_add(1) + 1 == n_tasks) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        done_cond_.notify_all();
+      }
+    }
+  }
+
+  void worker_fn() {
+    if (!affinity_.cores.empty()) {
+      numa::bind_current_thread(affinity_);
+    }
+    in_worker = true;
+    size_t seen = 0;
+    while (true) {
+      const std::function<void(int)>* task;
+      int n_tasks;
+      {
+        std::unique_lock<std::mutex> lk(mtx_);
+        cond_.wait(lk, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+        // Only join a job that still has work left, otherwise its caller may
+        // already have returned.
+        if (task_ == nullptr || next_ >= n_tasks_) {
+          continue;
+        }
+        task = task_;
+        n_tasks = n_tasks_;
+        active_++;
+      }
+      work(*task, n_tasks);
+      {
+        std::unique_lock<std::mutex> lk(mtx_);
+        active_--;
+        done_cond_.notify_all();
+      }
+    }
+  }
+
+  CpuAffinity affinity_;
+  std::vector<std::thread> workers_;
+  std::mutex run_mtx_;
+  std::mutex mtx_;
+  std::condition_variable cond_;
+  std::condition_variable done_cond_;
+  const std::function<void(int)>* task_{nullptr};
+  int n_tasks_{0};
+  std::atomic<int> next_{0};
+  std::atomic<int> done_{0};
+  int active_{0};
+  size_t generation_{0};
+  bool stop_{false};
+};
+
+int default_num_threads() {
+  if (auto env = std::getenv("MLX_CPU_THREADS")) {
+    return std::max(1, std::atoi(env));
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Threads pinned to a set of cores get a pool of workers on the same cores
+ThreadPool& thread_pool() {
+  auto& affinity = numa::current_affinity();
+  if (affinity.cores.empty()) {
+    static ThreadPool pool(default_num_threads());
+    return pool;
+  }
+
+  static std::mutex mtx;
+  static std::map<std::vector<int>, std::unique_ptr<ThreadPool>> pools;
+  std::unique_lock<std::mutex> lk(mtx);
+  auto& pool = pools[affinity.cores];
+  if (!pool) {
+    int n_threads = std::min<int>(default_num_threads(), affinity.cores.size());
+    pool = std::make_unique<ThreadPool>(n_threads, affinity);
+  }
+  return *pool;
+}
+
+} // namespace
+
+int max_threads() {
+  return thread_pool().size();
+}
+
+void parallel_for(
+    int n,
+    int min_chunk,
+    const std::function<void(int, int)>& fn) {
+  if (n <= 0) {
+    return;
+  }
+  min_chunk = std::max(min_chunk, 1);
+  int n_chunks = std::min((n + min_chunk - 1) / min_chunk, max_threads());
+  if (n_chunks <= 1 || in_worker) {
+    fn(0, n);
+    return;
+  }
+
+  // Exceptions must not escape a worker, the first one is rethrown on the
+  // calling thread once every chunk is done
+  std::exception_ptr error;
+  std::mutex error_mtx;
+  int chunk = (n + n_chunks - 1) / n_chunks;
+  auto task = [&](int i) {
+    int begin = i * chunk;
+    int end = std::min(n, begin + chunk);
+    if (begin >= end) {
+      return;
+    }
+    try {
+      fn(begin, end);
+    } catch (...) {
+      std::unique_lock<std::mutex> lk(error_mtx);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+  if (!thread_pool().try_run(n_chunks, task)) {
+    fn(0, n);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace mlx::core
@@ -0,0 +1,22 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include <functional>
+
+namespace mlx::core {
+
+// Split [0, n) into contiguous chunks of at least min_chunk elements and run
+// fn(begin, end) on each of them using a shared pool of worker threads. The
+// calling thread takes part in the work and the call returns when every chunk
+// is done. Calls made from inside a worker run serially. If fn throws, the
+// first exception is rethrown on the calling thread.
+void parallel_for(
+    int n,
+    int min_chunk,
+    const std::function<void(int, int)>& fn);
+
+// The number of threads (including the caller) used by parallel_for.
+int max_threads();
+
+} // namespace mlx::core
@@ -0,0 +1,253 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/backend/common/threading.h"
+#include "mlx/primitives.h"
+
+namespace mlx::core {
+
+namespace {
+
+// A linear map along one axis stored by rows. Output position i is the sum
+// of the input positions indices[offsets[i]:offsets[i + 1]] scaled by the
+// matching weights.
+struct AxisMap {
+  int in_size;
+  int out_size;
+  std::vector<int> offsets;
+  std::vector<int> indices;
+  std::vector<float> weights;
+
+  AxisMap(const Upsample::Taps& taps, int in_size, int out_size)
+      : in_size(in_size),
+        out_size(out_size),
+        offsets(out_size + 1),
+        indices(taps.indices),
+        weights(taps.weights) {
+    for (int i = 0; i <= out_size; ++i) {
+      offsets[i] = i * taps.size;
+    }
+  }
+
+  // The adjoint map which sends every output position back to the input
+  // positions it was made of
+  AxisMap transpose() const {
+    AxisMap t;
+    t.in_size = out_size;
+    t.out_size = in_size;
+    t.offsets.assign(in_size + 1, 0);
+    for (auto j : indices) {
+      t.offsets[j + 1]++;
+    }
+    for (int j = 0; j < in_size; ++j) {
+      t.offsets[j + 1] += t.offsets[j];
+    }
+    t.indices.resize(indices.size());
+    t.weights.resize(weights.size());
+    std::vector<int> fill(t.offsets.begin(), t.offsets.end() - 1);
+    for (int i = 0; i < out_size; ++i) {
+      for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+        int pos = fill[indices[k]]++;
+        t.indices[pos] = i;
+        t.weights[pos] = weights[k];
+      }
+    }
+    return t;
+  }
+
+ private:
+  AxisMap() = default;
+};
+
+// Apply a map to the middle axis of a row contiguous (outer, in_size, inner)
+// array. Rows of the output are independent so they are split over threads.
+template <typename InT, typename OutT>
+void apply_axis_map(
+    const InT* in,
+    OutT* out,
+    size_t outer,
+    size_t inner,
+    const AxisMap& map) {
+  int rows = outer * map.out_size;
+  int min_rows = std::max<int>(1, 4096 / inner);
+  parallel_for(rows, min_rows, [&](int begin, int end) {
+    std::vector<float> acc(inner);
+    for (int r = begin; r < end; ++r) {
+      int o = r / map.out_size;
+      int i = r % map.out_size;
+      std::fill(acc.begin(), acc.end(), 0.0f);
+      for (int k = map.offsets[i]; k < map.offsets[i + 1]; ++k) {
+        size_t pos = static_cast<size_t>(o) * map.in_size + map.indices[k];
+        const InT* src = in + pos * inner;
+        float w = map.weights[k];
+        for (size_t c = 0; c < inner; ++c) {
+          acc[c] += w * static_cast<float>(src[c]);
+        }
+      }
+      OutT* dst = out + static_cast<size_t>(r) * inner;
+      for (size_t c = 0; c < inner; ++c) {
+        dst[c] = static_cast<OutT>(acc[c]);
+      }
+    }
+  });
+}
+
+// Apply one map per spatial axis of a (N, ..., C) input. The passes between
+// the first and the last go through float buffers.
+template <typename T>
+void apply_axis_maps(
+    const array& in,
+    array& out,
+    const std::vector<AxisMap>& maps) {
+  int n = maps.size();
+  std::vector<size_t> shape(in.shape().begin(), in.shape().end());
+  std::vector<float> src_buffer;
+  std::vector<float> dst_buffer;
+  for (int d = 0; d < n; ++d) {
+    size_t outer = 1;
+    for (int i = 0; i <= d; ++i) {
+      outer *= shape[i];
+    }
+    size_t inner = 1;
+    for (int i = d + 2; i < shape.size(); ++i) {
+      inner *= shape[i];
+    }
+    shape[d + 1] = maps[d].out_size;
+    bool first = d == 0;
+    bool last = d == n - 1;
+    if (!last) {
+      dst_buffer.resize(outer * maps[d].out_size * inner);
+    }
+    if (first && last) {
+      apply_axis_map(in.data<T>(), out.data<T>(), outer, inner, maps[d]);
+    } else if (first) {
+      apply_axis_map(in.data<T>(), dst_buffer.data(), outer, inner, maps[d]);
+    } else if (last) {
+      apply_axis_map(src_buffer.data(), out.data<T>(), outer, inner, maps[d]);
+    } else {
+      apply_axis_map(
+          src_buffer.data(), dst_buffer.data(), outer, inner, maps[d]);
+    }
+    std::swap(src_buffer, dst_buffer);
+  }
+}
+
+// Nearest neighbor upsampling copies whole channel vectors so it works on
+// the raw bytes of any type.
+void nearest(const array& in, array& out, const std::vector<AxisMap>& maps) {
+  int n = maps.size();
+  size_t row_bytes = in.shape(-1) * in.itemsize();
+  std::vector<size_t> in_strides(n);
+  size_t in_spatial = 1;
+  size_t out_spatial = 1;
+  for (int d = n - 1; d >= 0; --d) {
+    in_strides[d] = in_spatial;
+    in_spatial *= maps[d].in_size;
+    out_spatial *= maps[d].out_size;
+  }
+  const char* in_ptr = in.data<char>();
+  char* out_ptr = out.data<char>();
+  int rows = in.shape(0) * out_spatial;
+  int min_rows = std::max<int>(1, 16384 / row_bytes);
+  parallel_for(rows, min_rows, [&](int begin, int end) {
+    for (int r = begin; r < end; ++r) {
+      size_t b = r / out_spatial;
+      size_t pos = r % out_spatial;
+      size_t src = b * in_spatial;
+      for (int d = n - 1; d >= 0; --d) {
+        src += maps[d].indices[pos % maps[d].out_size] * in_strides[d];
+        pos /= maps[d].out_size;
+      }
+      std::memcpy(
+          out_ptr + static_cast<size_t>(r) * row_bytes,
+          in_ptr + src * row_bytes,
+          row_bytes);
+    }
+  });
+}
+
+array ensure_row_contiguous(const array& arr) {
+  if (arr.flags().row_contiguous) {
+    return arr;
+  } else {
+    array arr_copy(arr.shape(), arr.dtype(), nullptr, {});
+    copy(arr, arr_copy, CopyType::General);
+    return arr_copy;
+  }
+}
+
+std::vector<AxisMap> axis_maps(
+    const Upsample& upsample,
+    const array& in,
+    const array& out) {
+  std::vector<AxisMap> maps;
+  for (int d = 0; d < in.ndim() - 2; ++d) {
+    int in_size = in.shape(d + 1);
+    int out_size = out.shape(d + 1);
+    maps.emplace_back(upsample.taps(d, in_size, out_size), in_size, out_size);
+  }
+  return maps;
+}
+
+} // namespace
+
+void Upsample::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 1);
+  auto in = ensure_row_contiguous(inputs[0]);
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+  auto maps = axis_maps(*this, in, out);
+  if (mode_ == Nearest) {
+    return nearest(in, out, maps);
+  }
+  switch (out.dtype()) {
+    case float32:
+      return apply_axis_maps<float>(in, out, maps);
+    case float16:
+      return apply_axis_maps<float16_t>(in, out, maps);
+    case bfloat16:
+      return apply_axis_maps<bfloat16_t>(in, out, maps);
+    default:
+      throw std::runtime_error(
+          "[Upsample::eval] Interpolation needs a floating point type.");
+  }
+}
+
+void UpsampleVJP::eval(const std::vector<array>& inputs, array& out) {
+  assert(inputs.size() == 1);
+  auto cotan = ensure_row_contiguous(inputs[0]);
+  out.set_data(allocator::malloc_or_wait(out.nbytes()));
+  if (out.size() == 0) {
+    return;
+  }
+
+  // The gradient applies the adjoint of every axis map. The maps act on
+  // different axes so their order does not matter.
+  Upsample upsample(stream(), mode_, scale_factor_, align_corners_);
+  std::vector<AxisMap> maps;
+  for (auto& map : axis_maps(upsample, out, cotan)) {
+    maps.push_back(map.transpose());
+  }
+  switch (out.dtype()) {
+    case float32:
+      return apply_axis_maps<float>(cotan, out, maps);
+    case float16:
+      return apply_axis_maps<float16_t>(cotan, out, maps);
+    case bfloat16:
+      return apply_axis_maps<bfloat16_t>(cotan, out, maps);
+    default:
+      throw std::runtime_error(
+          "[UpsampleVJP::eval] Upsampling gradients need a floating point "
+          "type.");
+  }
+}
+
+} // namespace mlx::core
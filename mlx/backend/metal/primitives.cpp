@@ -690,6 +690,12 @@ void Load::eval_gpu(const std::vector<array>& inputs, array& out) {
   eval(inputs, out);
 }
 
+void LoadQuantized::eval_gpu(
+    const std::vector<array>& inputs,
+    std::vector<array>& outputs) {
+  eval(inputs, outputs);
+}
+
 void Log::eval_gpu(const std::vector<array>& inputs, array& out) {
   switch (base_) {
     case Base::e:
@@ -750,6 +756,10 @@ void Ceil::eval_gpu(const std::vector<array>& inputs, array& out) {
   unary_op(inputs, out, "ceil");
 }
 
+void Clip::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[Clip::eval_gpu] Lowered to maximum and minimum.");
+}
+
 void Multiply::eval_gpu(const std::vector<array>& inputs, array& out) {
   binary_op(inputs, out, "mul");
 }
@@ -797,6 +807,14 @@ void Pad::eval_gpu(const std::vector<array>& inputs, array& out) {
   copy_gpu_inplace(in, out_slice, CopyType::GeneralGeneral, stream());
 }
 
+void Pooling::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[Pooling::eval_gpu] Metal pooling NYI.");
+}
+
+void PoolingVJP::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[PoolingVJP::eval_gpu] Metal pooling NYI.");
+}
+
 void Power::eval_gpu(const std::vector<array>& inputs, array& out) {
   binary_op(inputs, out, "pow");
 }
@@ -996,12 +1014,24 @@ void Transpose::eval_gpu(const std::vector<array>& inputs, array& out) {
   eval(inputs, out);
 }
 
+void Upsample::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[Upsample::eval_gpu] Metal upsampling NYI.");
+}
+
+void UpsampleVJP::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[UpsampleVJP::eval_gpu] Metal upsampling NYI.");
+}
+
 void QRF::eval_gpu(
     const std::vector<array>& inputs,
     std::vector<array>& outputs) {
   throw std::runtime_error("[QRF::eval_gpu] Metal QR factorization NYI.");
 }
 
+void SparseMatmul::eval_gpu(const std::vector<array>& inputs, array& out) {
+  throw std::runtime_error("[SparseMatmul::eval_gpu] Metal sparse matmul NYI.");
+}
+
 void SVD::eval_gpu(
     const std::vector<array>& inputs,
     std::vector<array>& outputs) {
@@ -1,5 +1,6 @@
 // Copyright © 2024 Apple Inc.
 
+#include "mlx/fast_primitives.h"
 #include "mlx/primitives.h"
 
 #define NO_CPU_MULTI(func)                                             \
@@ -36,6 +37,7 @@ NO_CPU(BlockMaskedMM)
 NO_CPU(BlockSparseMM)
 NO_CPU(Broadcast)
 NO_CPU(Ceil)
+NO_CPU(Clip)
 NO_CPU(Concatenate)
 NO_CPU(Conjugate)
 NO_CPU(Convolution)
@@ -62,6 +64,7 @@ NO_CPU(GreaterEqual)
 NO_CPU(Less)
 NO_CPU(LessEqual)
 NO_CPU(Load)
+NO_CPU_MULTI(LoadQuantized)
 NO_CPU(Log)
 NO_CPU(Log1p)
 NO_CPU(LogicalNot)
@@ -76,6 +79,8 @@ NO_CPU(Negative)
 NO_CPU(NotEqual)
 NO_CPU(Pad)
 NO_CPU(Partition)
+NO_CPU(Pooling)
+NO_CPU(PoolingVJP)
 NO_CPU(Power)
 NO_CPU_MULTI(QRF)
 NO_CPU(QuantizedMatmul)
@@ -94,6 +99,7 @@ NO_CPU(Slice)
 NO_CPU(SliceUpdate)
 NO_CPU(Softmax)
 NO_CPU(Sort)
+NO_CPU(SparseMatmul)
 NO_CPU_MULTI(Split)
 NO_CPU(Square)
 NO_CPU(Sqrt)
@@ -103,6 +109,20 @@ NO_CPU_MULTI(SVD)
 NO_CPU(Tan)
 NO_CPU(Tanh)
 NO_CPU(Transpose)
+NO_CPU(Upsample)
+NO_CPU(UpsampleVJP)
 NO_CPU(Inverse)
 
+namespace fast {
+NO_CPU_MULTI(Activation)
+NO_CPU_MULTI(ActivationVJP)
+NO_CPU_MULTI(GRU)
+NO_CPU_MULTI(GRUVJP)
+NO_CPU_MULTI(LSTM)
+NO_CPU_MULTI(LSTMVJP)
+NO_CPU_MULTI(MultiTensorUpdate)
+NO_CPU_MULTI(QuantizedScaledDotProductAttention)
+NO_CPU_MULTI(ScaledDotProductAttention)
+} // namespace fast
+
 } // namespace mlx::core
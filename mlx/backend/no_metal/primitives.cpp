@@ -38,6 +38,7 @@ NO_GPU(BlockSparseMM)
 NO_GPU(BlockSparseQMM)
 NO_GPU(Broadcast)
 NO_GPU(Ceil)
+NO_GPU(Clip)
 NO_GPU_MULTI(Compiled)
 NO_GPU(Concatenate)
 NO_GPU(Conjugate)
@@ -65,6 +66,7 @@ NO_GPU(GreaterEqual)
 NO_GPU(Less)
 NO_GPU(LessEqual)
 NO_GPU(Load)
+NO_GPU_MULTI(LoadQuantized)
 NO_GPU(Log)
 NO_GPU(Log1p)
 NO_GPU(LogicalNot)
@@ -79,6 +81,8 @@ NO_GPU(Negative)
 NO_GPU(NotEqual)
 NO_GPU(Pad)
 NO_GPU(Partition)
+NO_GPU(Pooling)
+NO_GPU(PoolingVJP)
 NO_GPU(Power)
 NO_GPU_MULTI(QRF)
 NO_GPU(QuantizedMatmul)
@@ -97,6 +101,7 @@ NO_GPU(Slice)
 NO_GPU(SliceUpdate)
 NO_GPU(Softmax)
 NO_GPU(Sort)
+NO_GPU(SparseMatmul)
 NO_GPU_MULTI(Split)
 NO_GPU(Square)
 NO_GPU(Sqrt)
@@ -106,6 +111,8 @@ NO_GPU_MULTI(SVD)
 NO_GPU(Tan)
 NO_GPU(Tanh)
 NO_GPU(Transpose)
+NO_GPU(Upsample)
+NO_GPU(UpsampleVJP)
 NO_GPU(Inverse)
 NO_GPU(Cholesky)
 
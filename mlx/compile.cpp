@@ -2,12 +2,14 @@
 
 #include <cstdlib>
 #include <map>
+#include <numeric>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "mlx/allocator.h"
 #include "mlx/compile.h"
 #include "mlx/compile_impl.h"
+#include "mlx/fast_primitives.h"
 #include "mlx/primitives.h"
 #include "mlx/transforms.h"
 #include "mlx/transforms_impl.h"
@@ -76,7 +78,9 @@ bool allows_shapeless(const Primitive& p) {
       is_noop(p) || is_reduction(p) || typeid(p) == typeid(Softmax) ||
       typeid(p) == typeid(Sort) || typeid(p) == typeid(ArgSort) ||
       typeid(p) == typeid(ArgPartition) || typeid(p) == typeid(Partition) ||
-      typeid(p) == typeid(Select) || typeid(p) == typeid(NumberOfElements);
+      typeid(p) == typeid(Select) || typeid(p) == typeid(NumberOfElements) ||
+      typeid(p) == typeid(Clip) || typeid(p) == typeid(fast::Activation) ||
+      typeid(p) == typeid(fast::ActivationVJP);
 }
 
 Compiled::Compiled(
@@ -344,6 +348,217 @@ std::pair<std::vector<array>, ParentsMap> compile_dfs(
   return {tape, parents_map};
 }
 
+// Evaluate once the constant sub-graphs (the ones that don't depend on the
+// inputs) which feed into the rest of the graph. Returns true if anything was
+// folded. Constant sub-graphs that only produce outputs are left as they are.
+bool compile_fold_constants(
+    const std::vector<array>& tape,
+    const std::vector<array>& inputs) {
+  std::unordered_set<std::uintptr_t> variable;
+  for (auto& in : inputs) {
+    variable.insert(in.id());
+  }
+
+  std::vector<array> to_fold;
+  std::unordered_set<std::uintptr_t> to_fold_ids;
+  for (auto& a : tape) {
+    if (!a.has_primitive()) {
+      continue;
+    }
+    bool is_variable = false;
+    for (auto& in : a.inputs()) {
+      is_variable |= variable.find(in.id()) != variable.end();
+    }
+    if (!is_variable) {
+      continue;
+    }
+    for (auto& s : a.outputs()) {
+      variable.insert(s.id());
+    }
+    for (auto in : a.inputs()) {
+      if (variable.find(in.id()) != variable.end()) {
+        continue;
+      }
+      // Don't materialize broadcasts, they are free to fuse
+      while (in.has_primitive() && is_broadcast(in.primitive())) {
+        auto next = in.inputs()[0];
+        in = std::move(next);
+      }
+      if (in.has_primitive() && to_fold_ids.insert(in.id()).second) {
+        to_fold.push_back(in);
+      }
+    }
+  }
+
+  if (to_fold.empty()) {
+    return false;
+  }
+
+  // Evaluation detaches the arrays so they become constants of the tape
+  eval(to_fold);
+  return true;
+}
+
+// Compose two permutations, the result applies `first` and then `second`
+std::vector<int> compose_axes(
+    const std::vector<int>& first,
+    const std::vector<int>& second) {
+  std::vector<int> axes(second.size());
+  for (int i = 0; i < second.size(); ++i) {
+    axes[i] = first[second[i]];
+  }
+  return axes;
+}
+
+bool is_identity_axes(const std::vector<int>& axes) {
+  for (int i = 0; i < axes.size(); ++i) {
+    if (axes[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check if the array is a view of its input with the same shape and layout
+bool is_identity_view(const array& a) {
+  if (!a.has_primitive() || a.inputs().size() != 1) {
+    return false;
+  }
+  auto& p = a.primitive();
+  auto& in = a.inputs()[0];
+  if (typeid(p) == typeid(Transpose)) {
+    return is_identity_axes(static_cast<const Transpose&>(p).state());
+  }
+  if (typeid(p) == typeid(Reshape) || typeid(p) == typeid(Broadcast)) {
+    return in.shape() == a.shape() && in.dtype() == a.dtype();
+  }
+  return false;
+}
+
+// Swap the last two axes of the array, cancelling out with transposes that
+// produced it where possible
+array swap_last_axes(const array& a, Stream stream) {
+  std::vector<int> axes(a.ndim());
+  std::iota(axes.begin(), axes.end(), 0);
+  std::swap(axes[a.ndim() - 1], axes[a.ndim() - 2]);
+
+  auto in = a;
+  if (a.has_primitive() && typeid(a.primitive()) == typeid(Transpose)) {
+    axes = compose_axes(
+        static_cast<const Transpose&>(a.primitive()).state(), axes);
+    in = a.inputs()[0];
+    if (is_identity_axes(axes)) {
+      return in;
+    }
+  }
+
+  std::vector<int> shape(axes.size());
+  for (int i = 0; i < axes.size(); ++i) {
+    shape[i] = in.shape(axes[i]);
+  }
+  return array(
+      std::move(shape),
+      in.dtype(),
+      std::make_shared<Transpose>(stream, std::move(axes)),
+      {in});
+}
+
+// Algebraic rewrites of the graph. The arrays of the tape are modified in
+// place so the outputs keep their identity:
+//  - Constant sub-graphs feeding the computation are folded.
+//  - Identity transposes, reshapes and broadcasts are bypassed.
+//  - Chains of transposes, reshapes or broadcasts collapse into one.
+//  - Transposing the last two axes of a matmul output is pushed into the
+//    matmul operands, (A B)^T = B^T A^T, where the transposes are free
+//    strided views.
+// The tape and the parents map are rebuilt afterwards since the rewrites can
+// orphan arrays.
+void compile_rewrite(
+    std::vector<array>& tape,
+    ParentsMap& parents_map,
+    const std::vector<array>& inputs,
+    const std::vector<array>& outputs,
+    bool shapeless) {
+  bool changed = false;
+
+  // Constant shapes would be baked in by the folding
+  if (!shapeless) {
+    changed |= compile_fold_constants(tape, inputs);
+  }
+
+  std::unordered_set<std::uintptr_t> output_set;
+  for (auto& o : outputs) {
+    output_set.insert(o.id());
+  }
+  auto single_use = [&](const array& a) {
+    auto parents = parents_map.find(a.id());
+    return output_set.find(a.id()) == output_set.end() &&
+        parents != parents_map.end() && parents->second.size() == 1;
+  };
+
+  for (auto& a : tape) {
+    if (!a.has_primitive()) {
+      continue;
+    }
+
+    // Skip identity views
+    for (auto& in : a.inputs()) {
+      while (is_identity_view(in)) {
+        auto next = in.inputs()[0];
+        in = std::move(next);
+        changed = true;
+      }
+    }
+
+    if (!a.siblings().empty() || a.inputs().size() != 1) {
+      continue;
+    }
+
+    auto& p = a.primitive();
+    auto in = a.inputs()[0];
+    if (!in.has_primitive()) {
+      continue;
+    }
+    auto& in_p = in.primitive();
+
+    if (typeid(p) == typeid(Transpose) && typeid(in_p) == typeid(Transpose)) {
+      auto axes = compose_axes(
+          static_cast<const Transpose&>(in_p).state(),
+          static_cast<const Transpose&>(p).state());
+      a.primitive_ptr() = std::make_shared<Transpose>(p.stream(), axes);
+      a.inputs() = {in.inputs()[0]};
+      changed = true;
+    } else if (
+        (typeid(p) == typeid(Reshape) && typeid(in_p) == typeid(Reshape)) ||
+        (typeid(p) == typeid(Broadcast) && typeid(in_p) == typeid(Broadcast))) {
+      // Both primitives hold the final shape so they apply to the source
+      a.inputs() = {in.inputs()[0]};
+      changed = true;
+    } else if (
+        typeid(p) == typeid(Transpose) && typeid(in_p) == typeid(Matmul) &&
+        single_use(in) && a.ndim() >= 2) {
+      auto& axes = static_cast<const Transpose&>(p).state();
+      int n = axes.size();
+      bool swaps_last = axes[n - 1] == n - 2 && axes[n - 2] == n - 1;
+      for (int i = 0; i < n - 2 && swaps_last; ++i) {
+        swaps_last = axes[i] == i;
+      }
+      auto& lhs = in.inputs()[0];
+      auto& rhs = in.inputs()[1];
+      if (swaps_last && lhs.ndim() == n && rhs.ndim() == n) {
+        auto stream = in_p.stream();
+        a.inputs() = {swap_last_axes(rhs, stream), swap_last_axes(lhs, stream)};
+        a.primitive_ptr() = in.primitive_ptr();
+        changed = true;
+      }
+    }
+  }
+
+  if (changed) {
+    std::tie(tape, parents_map) = compile_dfs(inputs, outputs);
+  }
+}
+
 // Simplify the tape. Note, this function modifies in-place both the tape and
 // the parents map to remove orphaned arrays
 void compile_simplify(
@@ -833,6 +1048,8 @@ std::function<std::vector<array>(const std::vector<array>&)> compile(
 
       // Simplify the tape
       if (compile_mode() != CompileMode::no_simplify) {
+        compile_rewrite(
+            entry.tape, parents_map, entry.inputs, entry.outputs, shapeless);
         compile_simplify(
             entry.tape, parents_map, entry.outputs, /* passes */ 3);
       }
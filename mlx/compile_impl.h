@@ -2,10 +2,17 @@
 
 #pragma once
 
+#include "mlx/array.h"
 #include "mlx/device.h"
 
 namespace mlx::core::detail {
 
 bool compile_available_for_device(const Device& device);
 
+// Run the function on placeholder tracers with the shapes and types of the
+// given inputs. Returns the tracers and the outputs of the function.
+std::pair<std::vector<array>, std::vector<array>> compile_trace(
+    const std::function<std::vector<array>(const std::vector<array>&)>& fun,
+    const std::vector<array>& inputs);
+
 }
@@ -0,0 +1,62 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include <memory>
+
+#include "mlx/array.h"
+
+namespace mlx::core::distributed {
+
+/** Check if a communication backend is available. */
+bool is_available();
+
+/**
+ * A distributed::Group represents a group of independent mlx processes that
+ * can communicate. The processes of a group are arranged in a ring ordered
+ * by rank.
+ */
+struct Group {
+  Group(std::shared_ptr<void> group, int rank, int size)
+      : group_(std::move(group)), rank_(rank), size_(size) {}
+
+  int rank() const {
+    return rank_;
+  }
+
+  int size() const {
+    return size_;
+  }
+
+  /**
+   * Access the backend specific communicator. It is null for groups with a
+   * single process.
+   */
+  const std::shared_ptr<void>& raw_group() const {
+    return group_;
+  }
+
+ private:
+  std::shared_ptr<void> group_{nullptr};
+  int rank_{0};
+  int size_{1};
+};
+
+/**
+ * Initialize the communication backend and return the global communication
+ * group. The group is configured with the environment variables:
+ *
+ *  - ``MLX_WORLD_SIZE`` and ``MLX_RANK``: the number of processes and the rank
+ *    of this one. Without them the group contains only this process.
+ *  - ``MLX_DISTRIBUTED_BACKEND``: ``shm`` (default) to communicate through
+ *    POSIX shared memory between processes on one host, or ``tcp``.
+ *  - ``MLX_DISTRIBUTED_HOSTS``: for ``tcp``, a comma separated ``host:port``
+ *    list with the address of every rank. Defaults to consecutive ports on
+ *    the localhost starting from ``MLX_DISTRIBUTED_PORT`` (default 32323).
+ *    For ``shm`` the port names the shared memory segment.
+ *
+ * Subsequent calls return the same group.
+ */
+Group init();
+
+} // namespace mlx::core::distributed
@@ -0,0 +1,27 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include "mlx/distributed/distributed.h"
+
+namespace mlx::core::distributed::detail {
+
+/** The stream the communication primitives run on by default. */
+Stream communication_stream();
+
+/** Sum the row contiguous input across the group into the output. */
+void all_sum(const Group& group, const array& input, array& output);
+
+/** Concatenate the row contiguous inputs of the group into the output. */
+void all_gather(const Group& group, const array& input, array& output);
+
+/**
+ * Sum the row contiguous input across the group and keep the block of rows
+ * corresponding to this rank in the output.
+ */
+void reduce_scatter(const Group& group, const array& input, array& output);
+
+/** Copy the row contiguous input of the root rank to the output. */
+void broadcast(const Group& group, const array& input, array& output, int root);
+
+} // namespace mlx::core::distributed::detail
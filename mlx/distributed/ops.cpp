@@ -0,0 +1,116 @@
+// Copyright © 2024 Apple Inc.
+
+#include <sstream>
+
+#include "mlx/distributed/distributed_impl.h"
+#include "mlx/distributed/ops.h"
+#include "mlx/distributed/primitives.h"
+
+namespace mlx::core::distributed {
+
+namespace {
+
+Group to_group(std::optional<Group> group) {
+  if (group.has_value()) {
+    return group.value();
+  } else {
+    return distributed::init();
+  }
+}
+
+Stream to_comm_stream(StreamOrDevice s, const std::string& name) {
+  if (std::holds_alternative<std::monostate>(s)) {
+    return detail::communication_stream();
+  }
+  auto stream = to_stream(s);
+  if (stream.device != Device::cpu) {
+    throw std::invalid_argument(
+        "[" + name + "] Communication ops can only run on the CPU.");
+  }
+  return stream;
+}
+
+} // namespace
+
+array all_sum(const array& x, std::optional<Group> group_, StreamOrDevice s) {
+  auto group = to_group(group_);
+  if (group.size() == 1) {
+    return x;
+  }
+  return array(
+      x.shape(),
+      x.dtype(),
+      std::make_shared<AllReduce>(to_comm_stream(s, "all_sum"), group),
+      {x});
+}
+
+array all_gather(
+    const array& x,
+    std::optional<Group> group_,
+    StreamOrDevice s) {
+  auto group = to_group(group_);
+  if (group.size() == 1) {
+    return x;
+  }
+  if (x.ndim() == 0) {
+    throw std::invalid_argument(
+        "[all_gather] Cannot gather scalars, the array needs an axis to "
+        "concatenate along.");
+  }
+  auto out_shape = x.shape();
+  out_shape[0] *= group.size();
+  return array(
+      std::move(out_shape),
+      x.dtype(),
+      std::make_shared<AllGather>(to_comm_stream(s, "all_gather"), group),
+      {x});
+}
+
+array reduce_scatter(
+    const array& x,
+    std::optional<Group> group_,
+    StreamOrDevice s) {
+  auto group = to_group(group_);
+  if (group.size() == 1) {
+    return x;
+  }
+  if (x.ndim() == 0 || x.shape(0) % group.size() != 0) {
+    std::ostringstream msg;
+    msg << "[reduce_scatter] The first axis of the array with shape "
+        << x.shape() << " must be divisible by the group size "
+        << group.size() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  auto out_shape = x.shape();
+  out_shape[0] /= group.size();
+  return array(
+      std::move(out_shape),
+      x.dtype(),
+      std::make_shared<ReduceScatter>(
+          to_comm_stream(s, "reduce_scatter"), group),
+      {x});
+}
+
+array broadcast(
+    const array& x,
+    int root,
+    std::optional<Group> group_,
+    StreamOrDevice s) {
+  auto group = to_group(group_);
+  if (root < 0 || root >= group.size()) {
+    std::ostringstream msg;
+    msg << "[broadcast] Invalid root " << root << " for a group of size "
+        << group.size() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (group.size() == 1) {
+    return x;
+  }
+  return array(
+      x.shape(),
+      x.dtype(),
+      std::make_shared<Broadcast>(to_comm_stream(s, "broadcast"), group, root),
+      {x});
+}
+
+} // namespace mlx::core::distributed
@@ -0,0 +1,47 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include <optional>
+
+#include "mlx/distributed/distributed.h"
+#include "mlx/utils.h"
+
+namespace mlx::core::distributed {
+
+/**
+ * The ops below run on the CPU. Unless a stream is given they use a dedicated
+ * communication stream so they can overlap with computation on other streams.
+ */
+
+/** Sum the array across all processes of the group. */
+array all_sum(
+    const array& x,
+    std::optional<Group> group = std::nullopt,
+    StreamOrDevice s = {});
+
+/** Concatenate the arrays of all processes of the group along the first
+ * axis. */
+array all_gather(
+    const array& x,
+    std::optional<Group> group = std::nullopt,
+    StreamOrDevice s = {});
+
+/**
+ * Sum the array across all processes of the group and split the result along
+ * the first axis. Each process gets the block matching its rank. The first
+ * axis must be divisible by the size of the group.
+ */
+array reduce_scatter(
+    const array& x,
+    std::optional<Group> group = std::nullopt,
+    StreamOrDevice s = {});
+
+/** Copy the array of the root process to all processes of the group. */
+array broadcast(
+    const array& x,
+    int root = 0,
+    std::optional<Group> group = std::nullopt,
+    StreamOrDevice s = {});
+
+} // namespace mlx::core::distributed
@@ -0,0 +1,123 @@
+// Copyright © 2024 Apple Inc.
+
+#include <cassert>
+
+#include "mlx/distributed/primitives.h"
+#include "mlx/allocator.h"
+#include "mlx/backend/common/copy.h"
+#include "mlx/distributed/distributed_impl.h"
+#include "mlx/distributed/ops.h"
+#include "mlx/ops.h"
+
+namespace mlx::core::distributed {
+
+namespace {
+
+array ensure_row_contiguous(const array& x) {
+  if (x.flags().row_contiguous) {
+    return x;
+  }
+  array x_copy(x.shape(), x.dtype(), nullptr, {});
+  copy(x, x_copy, CopyType::General);
+  return x_copy;
+}
+
+} // namespace
+
+void AllReduce::eval_cpu(const std::vector<array>& inputs, array& output) {
+  assert(inputs.size() == 1);
+  output.set_data(allocator::malloc_or_wait(output.nbytes()));
+  detail::all_sum(group(), ensure_row_contiguous(inputs[0]), output);
+}
+
+std::pair<std::vector<array>, std::vector<int>> AllReduce::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  return {{all_sum(inputs[0], group(), stream())}, axes};
+}
+
+std::vector<array> AllReduce::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  return {all_sum(tangents[0], group(), stream())};
+}
+
+std::vector<array> AllReduce::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  return {all_sum(cotangents[0], group(), stream())};
+}
+
+void AllGather::eval_cpu(const std::vector<array>& inputs, array& output) {
+  assert(inputs.size() == 1);
+  output.set_data(allocator::malloc_or_wait(output.nbytes()));
+  detail::all_gather(group(), ensure_row_contiguous(inputs[0]), output);
+}
+
+std::vector<array> AllGather::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  return {all_gather(tangents[0], group(), stream())};
+}
+
+std::vector<array> AllGather::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  // Every rank may use the whole gathered array so the cotangents of this
+  // rank's slice are summed over the group
+  return {reduce_scatter(cotangents[0], group(), stream())};
+}
+
+void ReduceScatter::eval_cpu(const std::vector<array>& inputs, array& output) {
+  assert(inputs.size() == 1);
+  output.set_data(allocator::malloc_or_wait(output.nbytes()));
+  detail::reduce_scatter(group(), ensure_row_contiguous(inputs[0]), output);
+}
+
+std::vector<array> ReduceScatter::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  return {reduce_scatter(tangents[0], group(), stream())};
+}
+
+std::vector<array> ReduceScatter::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  return {all_gather(cotangents[0], group(), stream())};
+}
+
+void Broadcast::eval_cpu(const std::vector<array>& inputs, array& output) {
+  assert(inputs.size() == 1);
+  output.set_data(allocator::malloc_or_wait(output.nbytes()));
+  detail::broadcast(group(), ensure_row_contiguous(inputs[0]), output, root_);
+}
+
+std::vector<array> Broadcast::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  return {broadcast(tangents[0], root_, group(), stream())};
+}
+
+std::vector<array> Broadcast::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  // Only the root's input reaches the outputs. Every rank takes part in the
+  // sum and the other ranks mask it out.
+  auto cotan = all_sum(cotangents[0], group(), stream());
+  bool is_root = group().rank() == root_;
+  return {multiply(cotan, array(is_root, cotan.dtype()), stream())};
+}
+
+} // namespace mlx::core::distributed
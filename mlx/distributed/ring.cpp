@@ -0,0 +1,554 @@
+// Copyright © 2024 Apple Inc.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "mlx/distributed/distributed_impl.h"
+#include "mlx/types/complex.h"
+#include "mlx/types/half_types.h"
+
+// Collective communication for processes arranged in a ring. The backends only
+// implement a point to point exchange with the neighbours of the ring and the
+// collectives are built on top of it with the usual ring algorithms, which
+// send every byte at most twice regardless of the number of processes.
+
+namespace mlx::core::distributed {
+
+namespace {
+
+constexpr int default_port = 32323;
+constexpr auto connect_timeout = std::chrono::seconds(60);
+
+class Communicator {
+ public:
+  Communicator(int rank, int size) : rank_(rank), size_(size) {}
+  virtual ~Communicator() = default;
+
+  // Send n_send bytes to the next rank while receiving n_recv bytes from the
+  // previous rank. Every send must be matched by a receive of the same size.
+  virtual void exchange(
+      const char* send,
+      size_t n_send,
+      char* recv,
+      size_t n_recv) = 0;
+
+  int rank() const {
+    return rank_;
+  }
+
+  int size() const {
+    return size_;
+  }
+
+ private:
+  int rank_;
+  int size_;
+};
+
+int get_env_int(const char* name, int default_value) {
+  if (auto v = std::getenv(name)) {
+    return std::atoi(v);
+  }
+  return default_value;
+}
+
+[[noreturn]] void throw_errno(const std::string& msg) {
+  throw std::runtime_error(
+      "[distributed] " + msg + ": " + std::string(std::strerror(errno)));
+}
+
+/**
+ * TCP backend. Each rank listens on its own address, connects to the next
+ * rank and accepts the connection of the previous one.
+ */
+class TCPCommunicator : public Communicator {
+ public:
+  TCPCommunicator(int rank, int size) : Communicator(rank, size) {
+    auto addresses = parse_hosts(size);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+      throw_errno("Failed to create a socket");
+    }
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    auto own = resolve(addresses[rank]);
+    own.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(listen_fd, (sockaddr*)&own, sizeof(own)) < 0 ||
+        listen(listen_fd, 1) < 0) {
+      close(listen_fd);
+      throw_errno("Failed to listen on " + addresses[rank]);
+    }
+
+    // Connect to the next rank, retrying while it starts up
+    auto next = resolve(addresses[(rank + 1) % size]);
+    auto deadline = std::chrono::steady_clock::now() + connect_timeout;
+    while (true) {
+      send_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+      if (connect(send_fd_, (sockaddr*)&next, sizeof(next)) == 0) {
+        break;
+      }
+      close(send_fd_);
+      if (std::chrono::steady_clock::now() > deadline) {
+        close(listen_fd);
+        throw_errno(
+            "Failed to connect to " + addresses[(rank + 1) % size]);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    setsockopt(send_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    recv_fd_ = accept(listen_fd, nullptr, nullptr);
+    close(listen_fd);
+    if (recv_fd_ < 0) {
+      close(send_fd_);
+      throw_errno("Failed to accept the connection of the previous rank");
+    }
+  }
+
+  ~TCPCommunicator() {
+    close(send_fd_);
+    close(recv_fd_);
+  }
+
+  void exchange(const char* send, size_t n_send, char* recv, size_t n_recv)
+      override {
+    while (n_send > 0 || n_recv > 0) {
+      pollfd fds[2] = {
+          {send_fd_, static_cast<short>(n_send > 0 ? POLLOUT : 0), 0},
+          {recv_fd_, static_cast<short>(n_recv > 0 ? POLLIN : 0), 0}};
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw_errno("Failed to poll the sockets");
+      }
+      if (fds[0].revents & (POLLOUT | POLLERR | POLLHUP)) {
+        auto n = ::send(send_fd_, send, n_send, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+          throw_errno("Failed to send to the next rank");
+        }
+        if (n > 0) {
+          send += n;
+          n_send -= n;
+        }
+      }
+      if (fds[1].revents & (POLLIN | POLLERR | POLLHUP)) {
+        auto n = ::recv(recv_fd_, recv, n_recv, MSG_DONTWAIT);
+        if (n == 0) {
+          throw std::runtime_error(
+              "[distributed] The previous rank closed the connection.");
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+          throw_errno("Failed to receive from the previous rank");
+        }
+        if (n > 0) {
+          recv += n;
+          n_recv -= n;
+        }
+      }
+    }
+  }
+
+ private:
+  static std::vector<std::string> parse_hosts(int size) {
+    std::vector<std::string> addresses;
+    if (auto hosts = std::getenv("MLX_DISTRIBUTED_HOSTS")) {
+      std::istringstream ss(hosts);
+      std::string address;
+      while (std::getline(ss, address, ',')) {
+        addresses.push_back(address);
+      }
+      if (addresses.size() != size) {
+        throw std::invalid_argument(
+            "[distributed] MLX_DISTRIBUTED_HOSTS must contain one address "
+            "per rank.");
+      }
+    } else {
+      int port = get_env_int("MLX_DISTRIBUTED_PORT", default_port);
+      for (int i = 0; i < size; ++i) {
+        addresses.push_back("127.0.0.1:" + std::to_string(port + i));
+      }
+    }
+    return addresses;
+  }
+
+  static sockaddr_in resolve(const std::string& address) {
+    auto colon = address.rfind(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument(
+          "[distributed] Invalid address " + address + ", expected host:port");
+    }
+    auto host = address.substr(0, colon);
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* info;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &info) != 0) {
+      throw std::invalid_argument("[distributed] Cannot resolve " + host);
+    }
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in*>(info->ai_addr);
+    freeaddrinfo(info);
+    addr.sin_port = htons(std::stoi(address.substr(colon + 1)));
+    return addr;
+  }
+
+  int send_fd_;
+  int recv_fd_;
+};
+
+/**
+ * Shared memory backend for processes on the same host. Every rank owns a
+ * mailbox in a POSIX shared memory segment which the next rank reads from.
+ * The mailboxes hold one chunk at a time, and the counters of written and read
+ * chunks synchronize the two sides.
+ */
+class SharedMemoryCommunicator : public Communicator {
+ public:
+  static constexpr size_t mailbox_size = 1 << 22;
+
+  SharedMemoryCommunicator(int rank, int size) : Communicator(rank, size) {
+    name_ = "/mlx_distributed_" +
+        std::to_string(get_env_int("MLX_DISTRIBUTED_PORT", default_port));
+    bytes_ = sizeof(Header) + size * (sizeof(Mailbox) + mailbox_size);
+
+    int fd;
+    if (rank == 0) {
+      // Remove a segment left behind by a previous run
+      shm_unlink(name_.c_str());
+      fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd < 0 || ftruncate(fd, bytes_) < 0) {
+        throw_errno("Failed to create the shared memory segment " + name_);
+      }
+    } else {
+      auto deadline = std::chrono::steady_clock::now() + connect_timeout;
+      struct stat st;
+      while ((fd = shm_open(name_.c_str(), O_RDWR, 0600)) < 0 ||
+             fstat(fd, &st) < 0 || st.st_size != bytes_) {
+        if (fd >= 0) {
+          close(fd);
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+          throw_errno("Failed to open the shared memory segment " + name_);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    auto ptr = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      throw_errno("Failed to map the shared memory segment " + name_);
+    }
+    base_ = static_cast<char*>(ptr);
+
+    auto header = reinterpret_cast<Header*>(base_);
+    if (rank == 0) {
+      for (int i = 0; i < size; ++i) {
+        new (mailbox(i)) Mailbox();
+      }
+      new (header) Header();
+      header->ready.store(1, std::memory_order_release);
+    }
+    wait_for([&] { return header->ready.load(std::memory_order_acquire); });
+    header->attached.fetch_add(1);
+
+    // Everybody has the segment mapped so its name is no longer needed
+    if (rank == 0) {
+      wait_for([&] { return header->attached.load() == size; });
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  ~SharedMemoryCommunicator() {
+    munmap(base_, bytes_);
+  }
+
+  void exchange(const char* send, size_t n_send, char* recv, size_t n_recv)
+      override {
+    auto out = mailbox(rank());
+    auto in = mailbox((rank() + size() - 1) % size());
+    while (n_send > 0 || n_recv > 0) {
+      bool progress = false;
+      auto written = out->written.load(std::memory_order_relaxed);
+      if (n_send > 0 &&
+          out->read.load(std::memory_order_acquire) == written) {
+        size_t n = std::min(n_send, mailbox_size);
+        std::memcpy(data(out), send, n);
+        out->written.store(written + 1, std::memory_order_release);
+        send += n;
+        n_send -= n;
+        progress = true;
+      }
+      auto read = in->read.load(std::memory_order_relaxed);
+      if (n_recv > 0 && in->written.load(std::memory_order_acquire) > read) {
+        size_t n = std::min(n_recv, mailbox_size);
+        std::memcpy(recv, data(in), n);
+        in->read.store(read + 1, std::memory_order_release);
+        recv += n;
+        n_recv -= n;
+        progress = true;
+      }
+      if (!progress) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+ private:
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  struct Header {
+    std::atomic<uint64_t> ready{0};
+    std::atomic<uint64_t> attached{0};
+  };
+
+  struct Mailbox {
+    alignas(64) std::atomic<uint64_t> written{0};
+    alignas(64) std::atomic<uint64_t> read{0};
+  };
+
+  template <typename F>
+  static void wait_for(F done) {
+    while (!done()) {
+      std::this_thread::yield();
+    }
+  }
+
+  Mailbox* mailbox(int i) {
+    return reinterpret_cast<Mailbox*>(
+        base_ + sizeof(Header) + i * (sizeof(Mailbox) + mailbox_size));
+  }
+
+  char* data(Mailbox* m) {
+    return reinterpret_cast<char*>(m + 1);
+  }
+
+  std::string name_;
+  size_t bytes_;
+  char* base_;
+};
+
+Communicator& communicator(const Group& group) {
+  return *static_cast<Communicator*>(group.raw_group().get());
+}
+
+template <typename T>
+void sum_inplace(char* dst_, const char* src_, size_t n) {
+  auto dst = reinterpret_cast<T*>(dst_);
+  auto src = reinterpret_cast<const T*>(src_);
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = dst[i] + src[i];
+  }
+}
+
+void sum_inplace(char* dst, const char* src, size_t n, Dtype dtype) {
+  switch (dtype) {
+    case bool_:
+      return sum_inplace<bool>(dst, src, n);
+    case uint8:
+      return sum_inplace<uint8_t>(dst, src, n);
+    case uint16:
+      return sum_inplace<uint16_t>(dst, src, n);
+    case uint32:
+      return sum_inplace<uint32_t>(dst, src, n);
+    case uint64:
+      return sum_inplace<uint64_t>(dst, src, n);
+    case int8:
+      return sum_inplace<int8_t>(dst, src, n);
+    case int16:
+      return sum_inplace<int16_t>(dst, src, n);
+    case int32:
+      return sum_inplace<int32_t>(dst, src, n);
+    case int64:
+      return sum_inplace<int64_t>(dst, src, n);
+    case float16:
+      return sum_inplace<float16_t>(dst, src, n);
+    case float32:
+      return sum_inplace<float>(dst, src, n);
+    case bfloat16:
+      return sum_inplace<bfloat16_t>(dst, src, n);
+    case complex64:
+      return sum_inplace<complex64_t>(dst, src, n);
+  }
+}
+
+// The buffer is split in one chunk per rank
+struct Chunks {
+  Chunks(size_t n, int size) : chunk((n + size - 1) / size), n(n) {}
+
+  size_t offset(int i) const {
+    return std::min(i * chunk, n);
+  }
+
+  size_t size(int i) const {
+    return offset(i + 1) - offset(i);
+  }
+
+  size_t chunk;
+  size_t n;
+};
+
+int wrap(int i, int size) {
+  return ((i % size) + size) % size;
+}
+
+// After the reduce scatter phase rank r holds the sum of chunk r + 1 + shift
+void ring_reduce_scatter(
+    Communicator& comm,
+    char* buf,
+    size_t n,
+    Dtype dtype,
+    int shift) {
+  int rank = comm.rank();
+  int size = comm.size();
+  size_t itemsize = size_of(dtype);
+  Chunks chunks(n, size);
+  std::vector<char> tmp(chunks.chunk * itemsize);
+  for (int s = 0; s < size - 1; ++s) {
+    int send = wrap(rank - s + shift, size);
+    int recv = wrap(rank - s - 1 + shift, size);
+    comm.exchange(
+        buf + chunks.offset(send) * itemsize,
+        chunks.size(send) * itemsize,
+        tmp.data(),
+        chunks.size(recv) * itemsize);
+    sum_inplace(
+        buf + chunks.offset(recv) * itemsize,
+        tmp.data(),
+        chunks.size(recv),
+        dtype);
+  }
+}
+
+// Starting with rank r holding chunk r + 1 + shift, circulate the chunks so
+// every rank has all of them
+void ring_all_gather(
+    Communicator& comm,
+    char* buf,
+    size_t n,
+    size_t itemsize,
+    int shift) {
+  int rank = comm.rank();
+  int size = comm.size();
+  Chunks chunks(n, size);
+  for (int s = 0; s < size - 1; ++s) {
+    int send = wrap(rank + 1 + shift - s, size);
+    int recv = wrap(rank + shift - s, size);
+    comm.exchange(
+        buf + chunks.offset(send) * itemsize,
+        chunks.size(send) * itemsize,
+        buf + chunks.offset(recv) * itemsize,
+        chunks.size(recv) * itemsize);
+  }
+}
+
+} // namespace
+
+bool is_available() {
+  return true;
+}
+
+Group init() {
+  static Group global_group = []() {
+    int size = get_env_int("MLX_WORLD_SIZE", 1);
+    int rank = get_env_int("MLX_RANK", 0);
+    if (size < 1 || rank < 0 || rank >= size) {
+      std::ostringstream msg;
+      msg << "[distributed] Invalid rank " << rank << " for world size "
+          << size << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    if (size == 1) {
+      return Group(nullptr, 0, 1);
+    }
+
+    std::string backend = "shm";
+    if (auto b = std::getenv("MLX_DISTRIBUTED_BACKEND")) {
+      backend = b;
+    }
+    std::shared_ptr<Communicator> comm;
+    if (backend == "shm") {
+      comm = std::make_shared<SharedMemoryCommunicator>(rank, size);
+    } else if (backend == "tcp") {
+      comm = std::make_shared<TCPCommunicator>(rank, size);
+    } else {
+      throw std::invalid_argument(
+          "[distributed] Unknown backend " + backend +
+          ", expected shm or tcp.");
+    }
+    return Group(comm, rank, size);
+  }();
+  return global_group;
+}
+
+namespace detail {
+
+Stream communication_stream() {
+  static Stream comm_stream = new_stream(Device::cpu);
+  return comm_stream;
+}
+
+void all_sum(const Group& group, const array& input, array& output) {
+  auto& comm = communicator(group);
+  auto buf = output.data<char>();
+  std::memcpy(buf, input.data<char>(), input.nbytes());
+  ring_reduce_scatter(comm, buf, input.size(), input.dtype(), 0);
+  ring_all_gather(comm, buf, input.size(), input.itemsize(), 0);
+}
+
+void all_gather(const Group& group, const array& input, array& output) {
+  auto& comm = communicator(group);
+  // The output has one chunk of the size of the input per rank
+  auto buf = output.data<char>();
+  std::memcpy(
+      buf + comm.rank() * input.nbytes(), input.data<char>(), input.nbytes());
+  ring_all_gather(comm, buf, output.size(), input.itemsize(), -1);
+}
+
+void reduce_scatter(const Group& group, const array& input, array& output) {
+  auto& comm = communicator(group);
+  std::vector<char> buf(input.nbytes());
+  std::memcpy(buf.data(), input.data<char>(), input.nbytes());
+  ring_reduce_scatter(comm, buf.data(), input.size(), input.dtype(), -1);
+  std::memcpy(
+      output.data<char>(),
+      buf.data() + comm.rank() * output.nbytes(),
+      output.nbytes());
+}
+
+void broadcast(
+    const Group& group,
+    const array& input,
+    array& output,
+    int root) {
+  auto& comm = communicator(group);
+  auto buf = output.data<char>();
+  size_t nbytes = output.nbytes();
+  int next = (comm.rank() + 1) % comm.size();
+  if (comm.rank() == root) {
+    std::memcpy(buf, input.data<char>(), nbytes);
+  } else {
+    comm.exchange(nullptr, 0, buf, nbytes);
+  }
+  if (next != root) {
+    comm.exchange(buf, nbytes, nullptr, 0);
+  }
+}
+
+} // namespace detail
+
+} // namespace mlx::core::distributed
@@ -0,0 +1,743 @@
+// Copyright © 2024 Apple Inc.
+
+#include <cstring>
+#include <sstream>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "mlx/allocator.h"
+#include "mlx/backend/common/utils.h"
+#include "mlx/compile_impl.h"
+#include "mlx/export.h"
+#include "mlx/fast_primitives.h"
+#include "mlx/io/load.h"
+#include "mlx/ops.h"
+#include "mlx/primitives.h"
+#include "mlx/transforms.h"
+#include "mlx/transforms_impl.h"
+
+namespace mlx::core {
+
+namespace {
+
+constexpr char graph_magic[] = "MLXGRAPH";
+constexpr uint32_t graph_version = 3;
+
+template <typename T>
+struct is_vector : std::false_type {};
+template <typename T>
+struct is_vector<std::vector<T>> : std::true_type {};
+
+template <typename T>
+struct is_pair_or_tuple : std::false_type {};
+template <typename... T>
+struct is_pair_or_tuple<std::pair<T...>> : std::true_type {};
+template <typename... T>
+struct is_pair_or_tuple<std::tuple<T...>> : std::true_type {};
+
+template <typename T, typename = void>
+struct has_state : std::false_type {};
+template <typename T>
+struct has_state<T, std::void_t<decltype(std::declval<const T&>().state())>>
+    : std::true_type {};
+
+// Primitives which override output_shapes so the shapes saved in a graph file
+// can be checked against the ones they infer
+template <typename T>
+inline constexpr bool infers_output_shapes = !std::is_same_v<
+    decltype(&T::output_shapes),
+    decltype(&Primitive::output_shapes)>;
+
+template <typename>
+inline constexpr bool dependent_false = false;
+
+Dtype dtype_from_val(int32_t val) {
+  constexpr Dtype dtypes[] = {
+      bool_,
+      uint8,
+      uint16,
+      uint32,
+      uint64,
+      int8,
+      int16,
+      int32,
+      int64,
+      float16,
+      float32,
+      bfloat16,
+      complex64};
+  for (auto& t : dtypes) {
+    if (static_cast<int32_t>(t.val) == val) {
+      return t;
+    }
+  }
+  throw std::invalid_argument("[import_function] Invalid dtype in graph file.");
+}
+
+// Check that n items of item_size bytes are left in the file before
+// allocating space for them
+void check_remaining(io::Reader& is, uint64_t n, size_t item_size) {
+  size_t pos = is.tell();
+  is.seek(0, std::ios_base::end);
+  size_t end = is.tell();
+  is.seek(pos);
+  if (!is.good() || pos > end || n > (end - pos) / item_size) {
+    throw std::invalid_argument(
+        "[import_function] Invalid or truncated graph file.");
+  }
+}
+
+void check_shape(const std::vector<int>& shape) {
+  for (auto s : shape) {
+    if (s < 0) {
+      throw std::invalid_argument(
+          "[import_function] Invalid shape in graph file.");
+    }
+  }
+}
+
+using Hyperparameters = fast::MultiTensorUpdate::Hyperparameters;
+
+template <typename T>
+void serialize(io::Writer& os, const T& v) {
+  if constexpr (std::is_same_v<T, std::nullptr_t>) {
+    // Custom primitives save nullptr in place of their fallback
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+  } else if constexpr (std::is_enum_v<T>) {
+    serialize(os, static_cast<int32_t>(v));
+  } else if constexpr (std::is_same_v<T, Dtype>) {
+    serialize(os, static_cast<int32_t>(v.val));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    serialize(os, static_cast<uint64_t>(v.size()));
+    os.write(v.data(), v.size());
+  } else if constexpr (is_vector<T>::value) {
+    serialize(os, static_cast<uint64_t>(v.size()));
+    for (auto& e : v) {
+      serialize(os, e);
+    }
+  } else if constexpr (is_pair_or_tuple<T>::value) {
+    std::apply([&os](auto&... e) { (serialize(os, e), ...); }, v);
+  } else if constexpr (std::is_same_v<T, Hyperparameters>) {
+    serialize(
+        os,
+        std::make_tuple(
+            v.beta1,
+            v.beta2,
+            v.eps,
+            v.momentum,
+            v.dampening,
+            v.weight_decay,
+            v.nesterov));
+  } else {
+    static_assert(dependent_false<T>, "Unsupported type for serialization.");
+  }
+}
+
+template <typename T>
+T deserialize(io::Reader& is);
+
+template <typename T, size_t... I>
+T deserialize_tuple(io::Reader& is, std::index_sequence<I...>) {
+  // Braced initialization guarantees the elements are read in order
+  return T{deserialize<std::tuple_element_t<I, T>>(is)...};
+}
+
+template <typename T>
+T deserialize(io::Reader& is) {
+  if constexpr (std::is_same_v<T, std::nullptr_t>) {
+    return nullptr;
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    T v;
+    is.read(reinterpret_cast<char*>(&v), sizeof(T));
+    return v;
+  } else if constexpr (std::is_enum_v<T>) {
+    return static_cast<T>(deserialize<int32_t>(is));
+  } else if constexpr (std::is_same_v<T, Dtype>) {
+    return dtype_from_val(deserialize<int32_t>(is));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    auto size = deserialize<uint64_t>(is);
+    check_remaining(is, size, 1);
+    std::string v(size, '\0');
+    is.read(v.data(), size);
+    return v;
+  } else if constexpr (is_vector<T>::value) {
+    using V = typename T::value_type;
+    auto size = deserialize<uint64_t>(is);
+    check_remaining(is, size, std::is_arithmetic_v<V> ? sizeof(V) : 1);
+    T v;
+    v.reserve(size);
+    for (uint64_t i = 0; i < size; ++i) {
+      v.push_back(deserialize<V>(is));
+    }
+    return v;
+  } else if constexpr (is_pair_or_tuple<T>::value) {
+    return deserialize_tuple<T>(
+        is, std::make_index_sequence<std::tuple_size_v<T>>{});
+  } else if constexpr (std::is_same_v<T, Hyperparameters>) {
+    auto [beta1, beta2, eps, momentum, dampening, weight_decay, nesterov] =
+        deserialize<
+            std::tuple<float, float, float, float, float, float, bool>>(is);
+    return {beta1, beta2, eps, momentum, dampening, weight_decay, nesterov};
+  } else {
+    static_assert(dependent_false<T>, "Unsupported type for serialization.");
+  }
+}
+
+using SerializeFn = void (*)(io::Writer&, const Primitive&);
+using DeserializeFn = std::shared_ptr<Primitive> (*)(io::Reader&, Stream);
+
+template <typename T>
+void serialize_primitive(io::Writer& os, const Primitive& p) {
+  if constexpr (has_state<T>::value) {
+    serialize(os, static_cast<const T&>(p).state());
+  }
+}
+
+template <typename T>
+std::shared_ptr<Primitive> deserialize_primitive(io::Reader& is, Stream s) {
+  if constexpr (has_state<T>::value) {
+    using State = std::decay_t<decltype(std::declval<const T&>().state())>;
+    auto state = deserialize<State>(is);
+    if constexpr (is_pair_or_tuple<State>::value) {
+      return std::apply(
+          [s](auto&&... args) { return std::make_shared<T>(s, args...); },
+          state);
+    } else {
+      return std::make_shared<T>(s, state);
+    }
+  } else {
+    return std::make_shared<T>(s);
+  }
+}
+
+// The number of inputs of primitives which take any number of inputs or a
+// number which depends on their parameters is checked from their state
+constexpr int variadic = -1;
+
+template <typename T>
+bool valid_num_inputs(const Primitive& p, int num_inputs, size_t n) {
+  [[maybe_unused]] auto& t = static_cast<const T&>(p);
+  if constexpr (std::is_same_v<T, Clip>) {
+    auto [has_min, has_max] = t.state();
+    return n == 1 + has_min + has_max;
+  } else if constexpr (std::is_same_v<T, Concatenate>) {
+    return n > 0;
+  } else if constexpr (std::is_same_v<T, Gather>) {
+    return n == 1 + t.state().first.size();
+  } else if constexpr (std::is_same_v<T, Scatter>) {
+    return n == 2 + t.state().second.size();
+  } else if constexpr (std::is_same_v<T, fast::ScaledDotProductAttention>) {
+    return n == 3 + std::get<2>(t.state());
+  } else if constexpr (std::is_same_v<
+                           T,
+                           fast::QuantizedScaledDotProductAttention>) {
+    return n == 7 + std::get<4>(t.state());
+  } else if constexpr (std::is_same_v<T, fast::MultiTensorUpdate>) {
+    // The learning rate then the parameters, gradients and states
+    size_t group = 2 + t.num_states();
+    return n > 1 && (n - 1) % group == 0;
+  } else {
+    return num_inputs != variadic && n == num_inputs;
+  }
+}
+
+// The primitives which can be exported. Primitives with parameters expose
+// them with a state() method matching the order of their constructor. Load
+// and LoadQuantized are not registered since arrays read from a file never
+// depend on the inputs and are always saved as constants.
+class PrimitiveFactory {
+ public:
+  PrimitiveFactory() {
+#define REGISTER_PRIMITIVE(name, num_inputs) add<name>(#name, num_inputs)
+    REGISTER_PRIMITIVE(Abs, 1);
+    REGISTER_PRIMITIVE(Add, 2);
+    REGISTER_PRIMITIVE(AddMM, 3);
+    REGISTER_PRIMITIVE(Arange, 0);
+    REGISTER_PRIMITIVE(ArcCos, 1);
+    REGISTER_PRIMITIVE(ArcCosh, 1);
+    REGISTER_PRIMITIVE(ArcSin, 1);
+    REGISTER_PRIMITIVE(ArcSinh, 1);
+    REGISTER_PRIMITIVE(ArcTan, 1);
+    REGISTER_PRIMITIVE(ArcTan2, 2);
+    REGISTER_PRIMITIVE(ArcTanh, 1);
+    REGISTER_PRIMITIVE(ArgPartition, 1);
+    REGISTER_PRIMITIVE(ArgReduce, 1);
+    REGISTER_PRIMITIVE(ArgSort, 1);
+    REGISTER_PRIMITIVE(AsType, 1);
+    REGISTER_PRIMITIVE(Broadcast, 1);
+    REGISTER_PRIMITIVE(Ceil, 1);
+    REGISTER_PRIMITIVE(Cholesky, 1);
+    REGISTER_PRIMITIVE(Clip, variadic);
+    REGISTER_PRIMITIVE(Concatenate, variadic);
+    REGISTER_PRIMITIVE(Conjugate, 1);
+    REGISTER_PRIMITIVE(Convolution, 2);
+    REGISTER_PRIMITIVE(Copy, 1);
+    REGISTER_PRIMITIVE(Cos, 1);
+    REGISTER_PRIMITIVE(Cosh, 1);
+    REGISTER_PRIMITIVE(DivMod, 2);
+    REGISTER_PRIMITIVE(Divide, 2);
+    REGISTER_PRIMITIVE(Equal, 2);
+    REGISTER_PRIMITIVE(Erf, 1);
+    REGISTER_PRIMITIVE(ErfInv, 1);
+    REGISTER_PRIMITIVE(Exp, 1);
+    REGISTER_PRIMITIVE(Expm1, 1);
+    REGISTER_PRIMITIVE(FFT, 1);
+    REGISTER_PRIMITIVE(Floor, 1);
+    REGISTER_PRIMITIVE(Full, 1);
+    REGISTER_PRIMITIVE(Gather, variadic);
+    REGISTER_PRIMITIVE(Greater, 2);
+    REGISTER_PRIMITIVE(GreaterEqual, 2);
+    REGISTER_PRIMITIVE(Inverse, 1);
+    REGISTER_PRIMITIVE(Less, 2);
+    REGISTER_PRIMITIVE(LessEqual, 2);
+    REGISTER_PRIMITIVE(Log, 1);
+    REGISTER_PRIMITIVE(Log1p, 1);
+    REGISTER_PRIMITIVE(LogAddExp, 2);
+    REGISTER_PRIMITIVE(LogicalAnd, 2);
+    REGISTER_PRIMITIVE(LogicalNot, 1);
+    REGISTER_PRIMITIVE(LogicalOr, 2);
+    REGISTER_PRIMITIVE(Matmul, 2);
+    REGISTER_PRIMITIVE(Maximum, 2);
+    REGISTER_PRIMITIVE(Minimum, 2);
+    REGISTER_PRIMITIVE(Multiply, 2);
+    REGISTER_PRIMITIVE(Negative, 1);
+    REGISTER_PRIMITIVE(NotEqual, 2);
+    REGISTER_PRIMITIVE(NumberOfElements, 1);
+    REGISTER_PRIMITIVE(Pad, 2);
+    REGISTER_PRIMITIVE(Partition, 1);
+    REGISTER_PRIMITIVE(Pooling, 1);
+    REGISTER_PRIMITIVE(PoolingVJP, 2);
+    REGISTER_PRIMITIVE(Power, 2);
+    REGISTER_PRIMITIVE(QuantizedMatmul, 4);
+    REGISTER_PRIMITIVE(RandomBits, 1);
+    REGISTER_PRIMITIVE(Reduce, 1);
+    REGISTER_PRIMITIVE(Remainder, 2);
+    REGISTER_PRIMITIVE(Reshape, 1);
+    REGISTER_PRIMITIVE(Round, 1);
+    REGISTER_PRIMITIVE(Scan, 1);
+    REGISTER_PRIMITIVE(Scatter, variadic);
+    REGISTER_PRIMITIVE(Select, 3);
+    REGISTER_PRIMITIVE(Sigmoid, 1);
+    REGISTER_PRIMITIVE(Sign, 1);
+    REGISTER_PRIMITIVE(Sin, 1);
+    REGISTER_PRIMITIVE(Sinh, 1);
+    REGISTER_PRIMITIVE(Slice, 1);
+    REGISTER_PRIMITIVE(SliceUpdate, 2);
+    REGISTER_PRIMITIVE(Softmax, 1);
+    REGISTER_PRIMITIVE(Sort, 1);
+    REGISTER_PRIMITIVE(SparseMatmul, 4);
+    REGISTER_PRIMITIVE(Split, 1);
+    REGISTER_PRIMITIVE(Sqrt, 1);
+    REGISTER_PRIMITIVE(Square, 1);
+    REGISTER_PRIMITIVE(StopGradient, 1);
+    REGISTER_PRIMITIVE(Subtract, 2);
+    REGISTER_PRIMITIVE(Tan, 1);
+    REGISTER_PRIMITIVE(Tanh, 1);
+    REGISTER_PRIMITIVE(Transpose, 1);
+    REGISTER_PRIMITIVE(Upsample, 1);
+    REGISTER_PRIMITIVE(UpsampleVJP, 1);
+#define REGISTER_FAST_PRIMITIVE(name, num_inputs) \
+  add<fast::name>("fast::" #name, num_inputs)
+    REGISTER_FAST_PRIMITIVE(Activation, 1);
+    REGISTER_FAST_PRIMITIVE(ActivationVJP, 2);
+    REGISTER_FAST_PRIMITIVE(GRU, 4);
+    REGISTER_FAST_PRIMITIVE(GRUVJP, 6);
+    REGISTER_FAST_PRIMITIVE(LSTM, 4);
+    REGISTER_FAST_PRIMITIVE(LSTMVJP, 8);
+    REGISTER_FAST_PRIMITIVE(LayerNorm, 3);
+    REGISTER_FAST_PRIMITIVE(LayerNormVJP, 4);
+    REGISTER_FAST_PRIMITIVE(MultiTensorUpdate, variadic);
+    REGISTER_FAST_PRIMITIVE(QuantizedScaledDotProductAttention, variadic);
+    REGISTER_FAST_PRIMITIVE(RMSNorm, 2);
+    REGISTER_FAST_PRIMITIVE(RMSNormVJP, 3);
+    REGISTER_FAST_PRIMITIVE(RoPE, 1);
+    REGISTER_FAST_PRIMITIVE(ScaledDotProductAttention, variadic);
+#undef REGISTER_FAST_PRIMITIVE
+#undef REGISTER_PRIMITIVE
+  }
+
+  void save(io::Writer& os, const Primitive& p) {
+    auto it = serializers_.find(typeid(p));
+    if (it == serializers_.end()) {
+      std::ostringstream msg;
+      msg << "[export_function] Unable to export primitive ";
+      const_cast<Primitive&>(p).print(msg);
+      msg << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    serialize(os, it->second.name);
+    it->second.serialize(os, p);
+  }
+
+  std::shared_ptr<Primitive> load(io::Reader& is, Stream s) {
+    auto name = deserialize<std::string>(is);
+    auto it = deserializers_.find(name);
+    if (it == deserializers_.end()) {
+      throw std::invalid_argument(
+          "[import_function] Unknown primitive " + name + " in graph file.");
+    }
+    return it->second(is, s);
+  }
+
+  bool valid_num_inputs(const Primitive& p, size_t n) {
+    auto& entry = serializers_.at(typeid(p));
+    return entry.valid_num_inputs(p, entry.num_inputs, n);
+  }
+
+  bool infers_output_shapes(const Primitive& p) {
+    return serializers_.at(typeid(p)).infers_output_shapes;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    SerializeFn serialize;
+    int num_inputs;
+    bool (*valid_num_inputs)(const Primitive&, int, size_t);
+    bool infers_output_shapes;
+  };
+
+  template <typename T>
+  void add(std::string name, int num_inputs) {
+    serializers_.emplace(
+        typeid(T),
+        Entry{
+            name,
+            serialize_primitive<T>,
+            num_inputs,
+            mlx::core::valid_num_inputs<T>,
+            mlx::core::infers_output_shapes<T>});
+    deserializers_.emplace(std::move(name), deserialize_primitive<T>);
+  }
+
+  std::unordered_map<std::type_index, Entry> serializers_;
+  std::unordered_map<std::string, DeserializeFn> deserializers_;
+};
+
+PrimitiveFactory& primitive_factory() {
+  static PrimitiveFactory factory;
+  return factory;
+}
+
+// The graph loaded from a file. Arrays are referred to by their position in
+// the list [inputs..., constants..., node outputs...].
+struct ImportedFunction {
+  struct Node {
+    std::shared_ptr<Primitive> primitive;
+    std::vector<uint64_t> inputs;
+    std::vector<std::vector<int>> shapes;
+    std::vector<Dtype> dtypes;
+    bool infers_output_shapes;
+  };
+
+  std::vector<std::vector<int>> input_shapes;
+  std::vector<Dtype> input_dtypes;
+  std::vector<array> constants;
+  std::vector<Node> nodes;
+  std::vector<uint64_t> outputs;
+
+  ~ImportedFunction() {
+    detail::compile_erase(reinterpret_cast<std::uintptr_t>(this));
+  }
+
+  std::vector<array> operator()(const std::vector<array>& args) const {
+    if (args.size() != input_shapes.size()) {
+      std::ostringstream msg;
+      msg << "[import_function] Expected " << input_shapes.size()
+          << " inputs but received " << args.size() << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    for (int i = 0; i < args.size(); ++i) {
+      if (args[i].shape() != input_shapes[i] ||
+          args[i].dtype() != input_dtypes[i]) {
+        std::ostringstream msg;
+        msg << "[import_function] Input " << i << " with shape "
+            << args[i].shape() << " and type " << args[i].dtype()
+            << " does not match the exported shape " << input_shapes[i]
+            << " and type " << input_dtypes[i] << ".";
+        throw std::invalid_argument(msg.str());
+      }
+    }
+
+    std::vector<array> values = args;
+    values.insert(values.end(), constants.begin(), constants.end());
+    for (int i = 0; i < nodes.size(); ++i) {
+      auto& node = nodes[i];
+      std::vector<array> inputs;
+      for (auto id : node.inputs) {
+        inputs.push_back(values[id]);
+      }
+      if (node.infers_output_shapes &&
+          node.primitive->output_shapes(inputs) != node.shapes) {
+        std::ostringstream msg;
+        msg << "[import_function] The output shapes of node " << i << " (";
+        node.primitive->print(msg);
+        msg << ") do not match the shapes of its inputs.";
+        throw std::invalid_argument(msg.str());
+      }
+      if (node.shapes.size() == 1) {
+        values.emplace_back(
+            node.shapes[0], node.dtypes[0], node.primitive, std::move(inputs));
+      } else {
+        auto outs = array::make_arrays(
+            node.shapes, node.dtypes, node.primitive, inputs);
+        values.insert(values.end(), outs.begin(), outs.end());
+      }
+    }
+
+    std::vector<array> outs;
+    for (auto id : outputs) {
+      outs.push_back(values[id]);
+    }
+    return outs;
+  }
+};
+
+} // namespace
+
+void export_function(
+    const std::string& file,
+    const std::function<std::vector<array>(const std::vector<array>&)>& fun,
+    const std::vector<array>& example_inputs) {
+  auto [inputs, outputs] = detail::compile_trace(fun, example_inputs);
+
+  // Find the arrays which depend on the inputs. The others were captured by
+  // the function and are saved as constants rather than traced into the
+  // graph which produced them.
+  std::unordered_map<std::uintptr_t, bool> depends;
+  for (auto& in : inputs) {
+    depends[in.id()] = true;
+  }
+  std::function<bool(const array&)> find_depends;
+  find_depends = [&](const array& a) {
+    if (auto it = depends.find(a.id()); it != depends.end()) {
+      return it->second;
+    }
+    bool d = false;
+    for (auto& in : a.inputs()) {
+      d |= find_depends(in);
+    }
+    depends[a.id()] = d;
+    return d;
+  };
+
+  // Topologically sort the graph
+  std::vector<array> tape;
+  std::vector<array> constants;
+  std::unordered_set<std::uintptr_t> cache;
+  for (auto& in : inputs) {
+    cache.insert(in.id());
+  }
+  std::function<void(const array&)> recurse;
+  recurse = [&](const array& a) {
+    if (cache.find(a.id()) != cache.end()) {
+      return;
+    }
+    cache.insert(a.id());
+    if (!find_depends(a)) {
+      constants.push_back(a);
+      return;
+    }
+    for (auto& in : a.inputs()) {
+      recurse(in);
+    }
+    for (auto& s : a.siblings()) {
+      cache.insert(s.id());
+    }
+    tape.push_back(a);
+  };
+  for (auto& out : outputs) {
+    recurse(out);
+  }
+  eval(constants);
+
+  io::FileWriter os(file);
+  if (!os.is_open()) {
+    throw std::runtime_error("[export_function] Failed to open " + file);
+  }
+  os.write(graph_magic, sizeof(graph_magic) - 1);
+  serialize(os, graph_version);
+
+  std::unordered_map<std::uintptr_t, uint64_t> ids;
+  auto add_id = [&ids](const array& a) { ids.emplace(a.id(), ids.size()); };
+  auto get_id = [&ids](const array& a) { return ids.at(a.id()); };
+
+  serialize(os, static_cast<uint64_t>(inputs.size()));
+  for (auto& in : inputs) {
+    serialize(os, in.shape());
+    serialize(os, in.dtype());
+    add_id(in);
+  }
+
+  serialize(os, static_cast<uint64_t>(constants.size()));
+  for (auto& c : constants) {
+    serialize(os, c.shape());
+    serialize(os, c.dtype());
+    if (c.flags().row_contiguous) {
+      os.write(c.data<char>(), c.nbytes());
+    } else {
+      // Views like broadcasts may not hold every element so they are copied
+      // one element at a time
+      std::vector<char> data(c.nbytes());
+      for (size_t i = 0; i < c.size(); ++i) {
+        std::memcpy(
+            data.data() + i * c.itemsize(),
+            c.data<char>() + elem_to_loc(i, c) * c.itemsize(),
+            c.itemsize());
+      }
+      os.write(data.data(), data.size());
+    }
+    add_id(c);
+  }
+
+  serialize(os, static_cast<uint64_t>(tape.size()));
+  for (auto& a : tape) {
+    auto& p = a.primitive();
+    serialize(os, static_cast<int32_t>(p.device().type));
+    primitive_factory().save(os, p);
+    std::vector<uint64_t> input_ids;
+    for (auto& in : a.inputs()) {
+      input_ids.push_back(get_id(in));
+    }
+    serialize(os, input_ids);
+    serialize(os, static_cast<uint64_t>(a.outputs().size()));
+    for (auto& out : a.outputs()) {
+      serialize(os, out.shape());
+      serialize(os, out.dtype());
+      add_id(out);
+    }
+  }
+
+  std::vector<uint64_t> output_ids;
+  for (auto& out : outputs) {
+    output_ids.push_back(get_id(out));
+  }
+  serialize(os, output_ids);
+
+  if (!os.good()) {
+    throw std::runtime_error("[export_function] Failed to write " + file);
+  }
+}
+
+std::function<std::vector<array>(const std::vector<array>&)> import_function(
+    const std::string& file) {
+  io::FileReader is(file);
+  if (!is.is_open()) {
+    throw std::runtime_error("[import_function] Failed to open " + file);
+  }
+  auto check = [&is, &file]() {
+    if (!is.good()) {
+      throw std::invalid_argument(
+          "[import_function] Invalid or truncated graph file " + file);
+    }
+  };
+
+  char magic[sizeof(graph_magic) - 1];
+  is.read(magic, sizeof(magic));
+  check();
+  if (std::string(magic, sizeof(magic)) != graph_magic ||
+      deserialize<uint32_t>(is) != graph_version) {
+    throw std::invalid_argument(
+        "[import_function] Unsupported graph file format in " + file);
+  }
+
+  auto fn = std::make_shared<ImportedFunction>();
+  uint64_t n_arrays = 0;
+
+  auto n_inputs = deserialize<uint64_t>(is);
+  check();
+  for (uint64_t i = 0; i < n_inputs; ++i) {
+    fn->input_shapes.push_back(deserialize<std::vector<int>>(is));
+    fn->input_dtypes.push_back(deserialize<Dtype>(is));
+    check();
+    check_shape(fn->input_shapes.back());
+  }
+  n_arrays += n_inputs;
+
+  auto n_constants = deserialize<uint64_t>(is);
+  check();
+  for (uint64_t i = 0; i < n_constants; ++i) {
+    auto shape = deserialize<std::vector<int>>(is);
+    auto dtype = deserialize<Dtype>(is);
+    check();
+    check_shape(shape);
+    uint64_t nbytes = size_of(dtype);
+    for (auto s : shape) {
+      check_remaining(is, nbytes, s == 0 ? 1 : s);
+      nbytes *= s;
+    }
+    check_remaining(is, nbytes, 1);
+    array c(allocator::malloc_or_wait(nbytes), std::move(shape), dtype);
+    is.read(c.data<char>(), nbytes);
+    check();
+    fn->constants.push_back(std::move(c));
+  }
+  n_arrays += n_constants;
+
+  auto n_nodes = deserialize<uint64_t>(is);
+  check();
+  for (uint64_t i = 0; i < n_nodes; ++i) {
+    auto device_type =
+        static_cast<Device::DeviceType>(deserialize<int32_t>(is));
+    check();
+    if (device_type != Device::cpu && device_type != Device::gpu) {
+      throw std::invalid_argument(
+          "[import_function] Invalid graph in file " + file);
+    }
+    ImportedFunction::Node node;
+    node.primitive =
+        primitive_factory().load(is, default_stream(Device(device_type)));
+    node.inputs = deserialize<std::vector<uint64_t>>(is);
+    auto n_outputs = deserialize<uint64_t>(is);
+    check();
+    if (n_outputs == 0) {
+      throw std::invalid_argument(
+          "[import_function] Invalid graph in file " + file);
+    }
+    for (auto id : node.inputs) {
+      if (id >= n_arrays) {
+        throw std::invalid_argument(
+            "[import_function] Invalid graph in file " + file);
+      }
+    }
+    if (!primitive_factory().valid_num_inputs(
+            *node.primitive, node.inputs.size())) {
+      std::ostringstream msg;
+      msg << "[import_function] Invalid number of inputs "
+          << node.inputs.size() << " for ";
+      node.primitive->print(msg);
+      msg << " in graph file " << file;
+      throw std::invalid_argument(msg.str());
+    }
+    node.infers_output_shapes =
+        primitive_factory().infers_output_shapes(*node.primitive);
+    for (uint64_t j = 0; j < n_outputs; ++j) {
+      node.shapes.push_back(deserialize<std::vector<int>>(is));
+      node.dtypes.push_back(deserialize<Dtype>(is));
+      check();
+      check_shape(node.shapes.back());
+    }
+    n_arrays += n_outputs;
+    fn->nodes.push_back(std::move(node));
+  }
+
+  fn->outputs = deserialize<std::vector<uint64_t>>(is);
+  check();
+  for (auto id : fn->outputs) {
+    if (id >= n_arrays) {
+      throw std::invalid_argument(
+          "[import_function] Invalid graph in file " + file);
+    }
+  }
+
+  auto fun_id = reinterpret_cast<std::uintptr_t>(fn.get());
+  return detail::compile(
+      [fn = std::move(fn)](const std::vector<array>& args) {
+        return (*fn)(args);
+      },
+      fun_id);
+}
+
+} // namespace mlx::core
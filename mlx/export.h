@@ -0,0 +1,28 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include "mlx/array.h"
+
+namespace mlx::core {
+
+/**
+ * Trace the function with inputs of the same shapes and types as the given
+ * example inputs and save the resulting graph to a file. The saved graph
+ * contains the primitives with their parameters, the shapes and types of
+ * every intermediate array and the constants captured by the function.
+ */
+void export_function(
+    const std::string& file,
+    const std::function<std::vector<array>(const std::vector<array>&)>& fun,
+    const std::vector<array>& example_inputs);
+
+/**
+ * Load a graph saved with ``export_function`` and return a compiled function
+ * which runs it. The function must be called with inputs of the same shapes
+ * and types as the example inputs used when exporting.
+ */
+std::function<std::vector<array>(const std::vector<array>&)> import_function(
+    const std::string& file);
+
+} // namespace mlx::core
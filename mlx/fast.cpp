@@ -1,6 +1,8 @@
 // Copyright © 2023-2024 Apple Inc.
 
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <numeric>
 
 #include "mlx/fast.h"
@@ -10,15 +12,31 @@
 
 namespace mlx::core::fast {
 
+namespace {
+
+// Custom primitives imported from a graph file are loaded without their
+// fallback so they can be evaluated but not transformed
+void check_fallback(
+    const std::function<std::vector<array>(std::vector<array>)>& fallback,
+    const std::string& name) {
+  if (!fallback) {
+    throw std::invalid_argument(
+        "[" + name + "] The fallback of an imported primitive is unavailable.");
+  }
+}
+
+} // namespace
+
 std::vector<array> Custom::vjp(
     const std::vector<array>& primals,
     const std::vector<array>& cotangents,
     const std::vector<int>& argnums,
     const std::vector<array>& outputs) {
+  check_fallback(fallback_, "Custom::vjp");
   auto [_, vjps] = mlx::core::vjp(fallback_, primals, cotangents);
   std::vector<array> vjp_outs;
   for (int i = 0, j = 0; i < vjps.size(); ++i) {
-    if (i < argnums.size() && i == argnums[j]) {
+    if (j < argnums.size() && i == argnums[j]) {
       vjp_outs.push_back(vjps[i]);
       j++;
     }
@@ -30,10 +48,11 @@ std::vector<array> Custom::jvp(
     const std::vector<array>& primals,
     const std::vector<array>& tangents,
     const std::vector<int>& argnums) {
+  check_fallback(fallback_, "Custom::jvp");
   auto [_, jvps] = mlx::core::jvp(fallback_, primals, tangents);
   std::vector<array> jvp_outs;
   for (int i = 0, j = 0; i < jvps.size(); ++i) {
-    if (i < argnums.size() && i == argnums[j]) {
+    if (j < argnums.size() && i == argnums[j]) {
       jvp_outs.push_back(jvps[i]);
       j++;
     }
@@ -44,6 +63,7 @@ std::vector<array> Custom::jvp(
 std::pair<std::vector<array>, std::vector<int>> Custom::vmap(
     const std::vector<array>& inputs,
     const std::vector<int>& axes) {
+  check_fallback(fallback_, "Custom::vmap");
   auto outputs = mlx::core::vmap(fallback_, axes)(inputs);
   auto out_axes = std::vector<int>(outputs.size(), 0);
   return {outputs, out_axes};
@@ -457,6 +477,17 @@ bool RoPE::is_equivalent(const Primitive& other) const {
       offset_ == a_other.offset_ && forward_ == a_other.forward_);
 }
 
+array scaled_dot_product_attention(
+    const array& queries,
+    const array& keys,
+    const array& values,
+    const float scale,
+    const std::optional<array>& mask /* = std::nullopt */,
+    StreamOrDevice s /* = {} */) {
+  return scaled_dot_product_attention(
+      queries, keys, values, scale, mask, /* causal= */ false, s);
+}
+
 /** Computes: O = softmax(Q @ K.T) @ V **/
 array scaled_dot_product_attention(
     const array& queries,
@@ -464,7 +495,8 @@ array scaled_dot_product_attention(
     const array& values,
     const float scale,
     const std::optional<array>& mask,
-    StreamOrDevice s) {
+    bool causal,
+    StreamOrDevice s /* = {} */) {
   for (const auto& tensor : {queries, keys, values}) {
     if (tensor.ndim() != 4) {
       std::ostringstream msg;
@@ -504,6 +536,16 @@ array scaled_dot_product_attention(
     throw std::invalid_argument(msg.str());
   }
 
+  // K, V must have matching sequence lengths, the kernels read one value
+  // row per key
+  if (keys.shape(-2) != values.shape(-2)) {
+    std::ostringstream msg;
+    msg << "[scaled_dot_product_attention] keys, values expected to have "
+        << "matching sequence length; found keys shape " << keys.shape()
+        << " for values shape " << values.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
   // n_heads % n_kv_heads == 0; n_heads >= 1, n_kv_heads >= 1.
   if (n_q_heads % n_kv_heads != 0) {
     std::ostringstream msg;
@@ -526,71 +568,1059 @@ array scaled_dot_product_attention(
 
   /* generic implementation for use cases that Metal implementation does not
    * support. For non-supported cases listed below, use MLX primitives:
-   * * CPU implementation
    * * batch size > 1
    * * query sequence length > 1
-   * * non-null mask
+   * * non-null mask or causal masking
    * * dtype is not fp32 or fp16
+   * The CPU always runs its own kernel.
    */
+  int B = q.shape(0);
+  int L = q.shape(2);
+  int S = k.shape(2);
   bool needs_mask = mask.has_value();
-  auto fallback = [scale, needs_mask, final_type, n_q_heads, n_kv_heads, &s](
+  auto stream = to_stream(s);
+  auto fallback = [scale, needs_mask, causal, n_q_heads, n_kv_heads, stream](
                       const std::vector<array>& inputs) {
-    auto q = multiply(array(scale, inputs[0].dtype()), inputs[0], s);
+    auto q = multiply(array(scale, inputs[0].dtype()), inputs[0], stream);
     int n_repeats = n_q_heads / n_kv_heads;
     int B = q.shape(0);
     int L = q.shape(2);
     auto k = inputs[1];
     auto v = inputs[2];
+    int S = k.shape(2);
     if (n_repeats > 1) {
-      q = reshape(q, {B, n_kv_heads, n_repeats, L, -1}, s);
-      k = expand_dims(k, 2, s);
-      v = expand_dims(v, 2, s);
+      q = reshape(q, {B, n_kv_heads, n_repeats, L, -1}, stream);
+      k = expand_dims(k, 2, stream);
+      v = expand_dims(v, 2, stream);
     }
-    auto scores = matmul(q, swapaxes(k, -1, -2, s), s);
+    auto scores = matmul(q, swapaxes(k, -1, -2, stream), stream);
     if (needs_mask) {
-      scores = add(scores, inputs[3], s);
+      auto mask = inputs[3];
+      if (n_repeats > 1 && mask.ndim() > 2) {
+        mask = broadcast_to(mask, {B, n_q_heads, L, S}, stream);
+        mask = reshape(mask, {B, n_kv_heads, n_repeats, L, S}, stream);
+      }
+      scores = add(scores, mask, stream);
+    }
+    if (causal) {
+      auto q_idx = arange(S - L, S, int32, stream);
+      auto k_idx = arange(S, int32, stream);
+      auto visible = greater_equal(
+          expand_dims(q_idx, 1, stream), expand_dims(k_idx, 0, stream), stream);
+      scores = where(
+          visible,
+          scores,
+          array(-std::numeric_limits<float>::infinity(), scores.dtype()),
+          stream);
     }
-    scores = softmax(scores, std::vector<int>{-1}, true, s);
-    auto out = matmul(scores, v, s);
+    scores = softmax(scores, std::vector<int>{-1}, true, stream);
+    auto out = matmul(scores, v, stream);
     if (n_repeats > 1) {
-      out = reshape(out, {B, n_q_heads, L, -1}, s);
+      out = reshape(out, {B, n_q_heads, L, -1}, stream);
     }
     return std::vector<array>{out};
   };
 
-  auto stream = to_stream(s);
+  std::vector<array> inputs = {q, k, v};
+  if (needs_mask) {
+    // Broadcasting only adjusts the strides, the kernels read the mask in
+    // place
+    inputs.push_back(broadcast_to(
+        astype(*mask, final_type, stream), {B, n_q_heads, L, S}, stream));
+  }
+  auto out_shape = std::vector<int>{B, n_q_heads, L, v.shape(-1)};
+
+  if (stream.device == Device::cpu) {
+    return array(
+        std::move(out_shape),
+        final_type,
+        std::make_shared<ScaledDotProductAttention>(
+            stream, fallback, scale, needs_mask, causal),
+        std::move(inputs));
+  }
+
   constexpr const int supported_head_dim = 128;
   const size_t query_head_dim = q.shape(-1);
-  const size_t query_sequence_length = q.shape(2);
-  bool implementation_supports_use_case = batch_dim == 1 &&
-      query_sequence_length == 1 && !mask.has_value() &&
-      query_head_dim == supported_head_dim && final_type != bfloat16 &&
-      stream.device == Device::gpu;
+  bool implementation_supports_use_case = batch_dim == 1 && L == 1 &&
+      !needs_mask && !causal && query_head_dim == supported_head_dim &&
+      final_type != bfloat16;
   // TODO, update routing conditions post further tuning
   implementation_supports_use_case &= false;
   if (implementation_supports_use_case) {
-    auto out_shape =
-        std::vector<int>({q.shape(0), q.shape(1), q.shape(2), v.shape(-1)});
-    auto out = array(
+    return array(
         std::move(out_shape),
         final_type,
         std::make_shared<ScaledDotProductAttention>(
             stream, fallback, scale, false),
         {q, k, v});
-    return out;
-  }
-
-  if (mask.has_value()) {
-    return fallback({q, k, v, mask.value()})[0];
-  } else {
-    return fallback({q, k, v})[0];
   }
+  return fallback(inputs)[0];
 }
 
 bool ScaledDotProductAttention::is_equivalent(const Primitive& other) const {
   const ScaledDotProductAttention& a_other =
       static_cast<const ScaledDotProductAttention&>(other);
-  return needs_mask_ == a_other.needs_mask_ && scale_ == a_other.scale_;
+  return needs_mask_ == a_other.needs_mask_ && scale_ == a_other.scale_ &&
+      causal_ == a_other.causal_;
+}
+
+array quantized_scaled_dot_product_attention(
+    const array& queries,
+    const array& keys,
+    const array& key_scales,
+    const array& key_biases,
+    const array& values,
+    const array& value_scales,
+    const array& value_biases,
+    const float scale,
+    const std::optional<array>& mask,
+    int group_size,
+    int bits,
+    StreamOrDevice s) {
+  const std::string tag = "[quantized_scaled_dot_product_attention]";
+  if (bits != 4 && bits != 8) {
+    std::ostringstream msg;
+    msg << tag << " Only 4 and 8 bit keys and values are supported but "
+        << bits << " bits were requested.";
+    throw std::invalid_argument(msg.str());
+  }
+  if (group_size != 32 && group_size != 64 && group_size != 128) {
+    std::ostringstream msg;
+    msg << tag << " The group size must be 32, 64 or 128 but got "
+        << group_size << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  for (const auto& tensor :
+       {queries,
+        keys,
+        key_scales,
+        key_biases,
+        values,
+        value_scales,
+        value_biases}) {
+    if (tensor.ndim() != 4) {
+      std::ostringstream msg;
+      msg << tag << " input with shape " << tensor.shape()
+          << " expected to be rank 4";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+  if (keys.dtype() != uint32 || values.dtype() != uint32) {
+    throw std::invalid_argument(
+        tag + " The keys and values should be given as uint32.");
+  }
+
+  // Shapes of the quantized triplets
+  int el_per_int = 32 / bits;
+  auto check_quantized = [&](const array& w,
+                             const array& scales,
+                             const array& biases,
+                             const std::string& name) {
+    auto wshape = w.shape();
+    auto sshape = scales.shape();
+    wshape.back() = -1;
+    sshape.back() = -1;
+    if (wshape != sshape || scales.shape() != biases.shape() ||
+        w.shape(-1) * el_per_int != scales.shape(-1) * group_size) {
+      std::ostringstream msg;
+      msg << tag << " The " << name << " with shape " << w.shape()
+          << " do not match their scales and biases with shapes "
+          << scales.shape() << " and " << biases.shape()
+          << " for group_size=" << group_size << " and bits=" << bits << ".";
+      throw std::invalid_argument(msg.str());
+    }
+  };
+  check_quantized(keys, key_scales, key_biases, "keys");
+  check_quantized(values, value_scales, value_biases, "values");
+
+  if (keys.shape(0) != queries.shape(0) ||
+      values.shape(0) != queries.shape(0)) {
+    std::ostringstream msg;
+    msg << tag << " mismatching batch dimension for queries with shape "
+        << queries.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (keys.shape(-1) * el_per_int != queries.shape(-1)) {
+    std::ostringstream msg;
+    msg << tag << " query, keys expected to have matching last dimension; "
+        << "found query shape " << queries.shape() << " for quantized keys "
+        << "shape " << keys.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (keys.shape(1) != values.shape(1) || keys.shape(2) != values.shape(2)) {
+    std::ostringstream msg;
+    msg << tag << " keys and values expected to have matching heads and "
+        << "sequence length; found keys shape " << keys.shape()
+        << " for values shape " << values.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  auto n_q_heads = queries.shape(1);
+  auto n_kv_heads = keys.shape(1);
+  if (n_q_heads % n_kv_heads != 0) {
+    std::ostringstream msg;
+    msg << tag << " n_heads must be a multiple of n_kv_heads, found n_heads "
+        << n_q_heads << " for n_kv_heads " << n_kv_heads << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  auto final_type = result_type(queries, key_scales, value_scales);
+  if (!issubdtype(final_type, floating)) {
+    std::ostringstream msg;
+    msg << tag << " Received unsupported type " << final_type << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  int B = queries.shape(0);
+  int L = queries.shape(2);
+  int S = keys.shape(2);
+  std::vector<array> inputs = {
+      astype(queries, final_type, s),
+      keys,
+      astype(key_scales, final_type, s),
+      astype(key_biases, final_type, s),
+      values,
+      astype(value_scales, final_type, s),
+      astype(value_biases, final_type, s)};
+  bool needs_mask = mask.has_value();
+  if (needs_mask) {
+    inputs.push_back(
+        broadcast_to(astype(*mask, final_type, s), {B, n_q_heads, L, S}, s));
+  }
+
+  auto stream = to_stream(s);
+  auto fallback = [scale, needs_mask, group_size, bits, stream](
+                      const std::vector<array>& inputs) {
+    auto k = dequantize(
+        inputs[1], inputs[2], inputs[3], group_size, bits, stream);
+    auto v = dequantize(
+        inputs[4], inputs[5], inputs[6], group_size, bits, stream);
+    std::optional<array> mask = std::nullopt;
+    if (needs_mask) {
+      mask = inputs[7];
+    }
+    return std::vector<array>{
+        scaled_dot_product_attention(
+            inputs[0], k, v, scale, mask, false, stream)};
+  };
+
+  // Only the CPU has a kernel that reads the quantized caches directly
+  if (stream.device != Device::cpu) {
+    return fallback(inputs)[0];
+  }
+  return array(
+      {B, n_q_heads, L, values.shape(-1) * el_per_int},
+      final_type,
+      std::make_shared<QuantizedScaledDotProductAttention>(
+          stream, fallback, scale, group_size, bits, needs_mask),
+      std::move(inputs));
+}
+
+std::vector<array> QuantizedScaledDotProductAttention::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  // Differentiate the fallback only with respect to the requested floating
+  // point inputs, the packed keys and values stay constant.
+  for (auto arg : argnums) {
+    if (arg == 1 || arg == 4) {
+      throw std::invalid_argument(
+          "[QuantizedScaledDotProductAttention::vjp] Cannot compute the "
+          "gradient with respect to the quantized keys or values.");
+    }
+  }
+  check_fallback(fallback_, "QuantizedScaledDotProductAttention::vjp");
+  auto fun = [this, &primals, &argnums](const std::vector<array>& args) {
+    auto inputs = primals;
+    for (int i = 0; i < argnums.size(); ++i) {
+      inputs[argnums[i]] = args[i];
+    }
+    return fallback_(inputs);
+  };
+  std::vector<array> args;
+  for (auto arg : argnums) {
+    args.push_back(primals[arg]);
+  }
+  return mlx::core::vjp(fun, args, cotangents).second;
+}
+
+bool QuantizedScaledDotProductAttention::is_equivalent(
+    const Primitive& other) const {
+  const QuantizedScaledDotProductAttention& a_other =
+      static_cast<const QuantizedScaledDotProductAttention&>(other);
+  return scale_ == a_other.scale_ && group_size_ == a_other.group_size_ &&
+      bits_ == a_other.bits_ && needs_mask_ == a_other.needs_mask_;
+}
+
+namespace {
+
+// Bring a recurrent input of shape (..., L, gates * H) and its optional
+// initial states to the (N, L, gates * H) and (N, H) layout of the kernels.
+struct RecurrentInputs {
+  std::vector<int> batch_shape;
+  int N;
+  int L;
+  int H;
+  Dtype dtype;
+};
+
+RecurrentInputs check_recurrent(
+    const std::string& tag,
+    const array& x,
+    const array& w_h,
+    int n_gates,
+    const std::vector<std::optional<array>>& states) {
+  if (x.ndim() < 2) {
+    std::ostringstream msg;
+    msg << tag << " The input must have shape (..., L, " << n_gates
+        << " * H) but got shape " << x.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (w_h.ndim() != 2 || w_h.shape(1) != n_gates * w_h.shape(0) ||
+      x.shape(-1) != w_h.shape(1)) {
+    std::ostringstream msg;
+    msg << tag << " The hidden weights must have shape (H, " << n_gates
+        << " * H) matching the input but got shape " << w_h.shape()
+        << " for an input of shape " << x.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  std::vector<int> batch_shape(x.shape().begin(), x.shape().end() - 2);
+  int N = 1;
+  for (auto d : batch_shape) {
+    N *= d;
+  }
+  int H = w_h.shape(0);
+
+  std::vector<array> arrays = {x, w_h};
+  for (auto& state : states) {
+    if (!state) {
+      continue;
+    }
+    if (state->ndim() == 0 || state->shape(-1) != H) {
+      std::ostringstream msg;
+      msg << tag << " The states must have shape (..., " << H
+          << ") but got shape " << state->shape() << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    arrays.push_back(*state);
+  }
+  auto dtype = result_type(arrays);
+  if (!issubdtype(dtype, floating)) {
+    std::ostringstream msg;
+    msg << tag << " Received unsupported type " << dtype << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  return {std::move(batch_shape), N, x.shape(-2), H, dtype};
+}
+
+// A state of shape (..., H) broadcast to (N, H) or zeros when missing
+array recurrent_state(
+    const std::optional<array>& state,
+    const RecurrentInputs& info,
+    StreamOrDevice s) {
+  if (!state) {
+    return zeros({info.N, info.H}, info.dtype, s);
+  }
+  auto shape = info.batch_shape;
+  shape.push_back(info.H);
+  auto out = broadcast_to(astype(*state, info.dtype, s), shape, s);
+  return reshape(out, {info.N, info.H}, s);
+}
+
+} // namespace
+
+std::vector<array> lstm(
+    const array& x,
+    const array& w_h,
+    const std::optional<array>& hidden /* = std::nullopt */,
+    const std::optional<array>& cell /* = std::nullopt */,
+    StreamOrDevice s /* = {} */) {
+  auto info = check_recurrent("[lstm]", x, w_h, 4, {hidden, cell});
+  int N = info.N;
+  int L = info.L;
+  int H = info.H;
+  auto out_shape = info.batch_shape;
+  out_shape.push_back(L);
+  out_shape.push_back(H);
+  if (N * L * H == 0) {
+    auto out = zeros(out_shape, info.dtype, s);
+    return {out, out};
+  }
+
+  std::vector<array> inputs = {
+      reshape(astype(x, info.dtype, s), {N, L, 4 * H}, s),
+      astype(w_h, info.dtype, s),
+      recurrent_state(hidden, info, s),
+      recurrent_state(cell, info, s)};
+
+  auto stream = to_stream(s);
+  auto fallback = [stream](const std::vector<array>& inputs) {
+    auto& x = inputs[0];
+    auto& w_h = inputs[1];
+    auto h = inputs[2];
+    auto c = inputs[3];
+    int N = x.shape(0);
+    int G = x.shape(2);
+    std::vector<array> hs;
+    std::vector<array> cs;
+    for (int t = 0; t < x.shape(1); ++t) {
+      auto x_t = reshape(
+          slice(x, {0, t, 0}, {N, t + 1, G}, stream), {N, G}, stream);
+      auto ifgo = split(add(x_t, matmul(h, w_h, stream), stream), 4, 1, stream);
+      auto i = sigmoid(ifgo[0], stream);
+      auto f = sigmoid(ifgo[1], stream);
+      auto g = tanh(ifgo[2], stream);
+      auto o = sigmoid(ifgo[3], stream);
+      c = add(multiply(f, c, stream), multiply(i, g, stream), stream);
+      h = multiply(o, tanh(c, stream), stream);
+      hs.push_back(h);
+      cs.push_back(c);
+    }
+    return std::vector<array>{stack(hs, 1, stream), stack(cs, 1, stream)};
+  };
+
+  // Only the CPU has a fused recurrence
+  auto outputs = stream.device == Device::cpu
+      ? array::make_arrays(
+            {{N, L, H}, {N, L, H}},
+            {info.dtype, info.dtype},
+            std::make_shared<LSTM>(stream, fallback),
+            std::move(inputs))
+      : fallback(inputs);
+  return {
+      reshape(outputs[0], out_shape, s), reshape(outputs[1], out_shape, s)};
+}
+
+std::vector<array> LSTM::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  assert(primals.size() == 4);
+  assert(outputs.size() == 2);
+  assert(cotangents.size() == 2);
+
+  auto s = stream();
+  auto fallback = [forward = fallback_](const std::vector<array>& inputs) {
+    check_fallback(forward, "LSTMVJP");
+    std::vector<array> primals(inputs.begin(), inputs.begin() + 4);
+    std::vector<array> cotangents(inputs.begin() + 6, inputs.end());
+    return mlx::core::vjp(forward, primals, cotangents).second;
+  };
+
+  std::vector<array> inputs = primals;
+  inputs.insert(inputs.end(), outputs.begin(), outputs.end());
+  inputs.insert(inputs.end(), cotangents.begin(), cotangents.end());
+  std::vector<std::vector<int>> shapes;
+  std::vector<Dtype> dtypes;
+  for (auto& p : primals) {
+    shapes.push_back(p.shape());
+    dtypes.push_back(p.dtype());
+  }
+  auto vjps = array::make_arrays(
+      std::move(shapes),
+      std::move(dtypes),
+      std::make_shared<LSTMVJP>(s, fallback),
+      std::move(inputs));
+
+  std::vector<array> returned_vjps;
+  for (auto& arg : argnums) {
+    returned_vjps.push_back(std::move(vjps[arg]));
+  }
+  return returned_vjps;
+}
+
+array gru(
+    const array& x,
+    const array& w_h,
+    const std::optional<array>& b_hn /* = std::nullopt */,
+    const std::optional<array>& hidden /* = std::nullopt */,
+    StreamOrDevice s /* = {} */) {
+  auto info = check_recurrent("[gru]", x, w_h, 3, {hidden});
+  int N = info.N;
+  int L = info.L;
+  int H = info.H;
+  if (b_hn && (b_hn->ndim() != 1 || b_hn->shape(0) != H)) {
+    std::ostringstream msg;
+    msg << "[gru] The hidden bias must have shape (" << H << ") but got "
+        << "shape " << b_hn->shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  auto out_shape = info.batch_shape;
+  out_shape.push_back(L);
+  out_shape.push_back(H);
+  if (N * L * H == 0) {
+    return zeros(out_shape, info.dtype, s);
+  }
+
+  bool has_hidden = hidden.has_value();
+  std::vector<array> inputs = {
+      reshape(astype(x, info.dtype, s), {N, L, 3 * H}, s),
+      astype(w_h, info.dtype, s),
+      b_hn ? astype(*b_hn, info.dtype, s) : zeros({H}, info.dtype, s),
+      recurrent_state(hidden, info, s)};
+
+  auto stream = to_stream(s);
+  auto fallback = [has_hidden, stream](const std::vector<array>& inputs) {
+    auto& x = inputs[0];
+    auto& w_h = inputs[1];
+    auto& b_hn = inputs[2];
+    auto h = inputs[3];
+    int N = x.shape(0);
+    int H = w_h.shape(0);
+    std::vector<array> hs;
+    for (int t = 0; t < x.shape(1); ++t) {
+      auto x_t = reshape(
+          slice(x, {0, t, 0}, {N, t + 1, 3 * H}, stream), {N, 3 * H}, stream);
+      auto x_rz = slice(x_t, {0, 0}, {N, 2 * H}, stream);
+      auto x_n = slice(x_t, {0, 2 * H}, {N, 3 * H}, stream);
+      auto h_proj = matmul(h, w_h, stream);
+      auto h_rz = slice(h_proj, {0, 0}, {N, 2 * H}, stream);
+      auto h_n = slice(h_proj, {0, 2 * H}, {N, 3 * H}, stream);
+      // Without an initial state the first step has no hidden projection
+      if (has_hidden || t > 0) {
+        h_n = add(h_n, b_hn, stream);
+      }
+      auto rz = split(sigmoid(add(x_rz, h_rz, stream), stream), 2, 1, stream);
+      auto n = tanh(add(x_n, multiply(rz[0], h_n, stream), stream), stream);
+      h = add(
+          multiply(subtract(array(1.0f, h.dtype()), rz[1], stream), n, stream),
+          multiply(rz[1], h, stream),
+          stream);
+      hs.push_back(h);
+    }
+    return std::vector<array>{stack(hs, 1, stream)};
+  };
+
+  // Only the CPU has a fused recurrence
+  auto out = stream.device == Device::cpu
+      ? array(
+            {N, L, H},
+            info.dtype,
+            std::make_shared<GRU>(stream, fallback, has_hidden),
+            std::move(inputs))
+      : fallback(inputs)[0];
+  return reshape(out, out_shape, s);
+}
+
+std::vector<array> GRU::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  assert(primals.size() == 4);
+  assert(outputs.size() == 1);
+  assert(cotangents.size() == 1);
+
+  auto s = stream();
+  auto fallback = [forward = fallback_](const std::vector<array>& inputs) {
+    check_fallback(forward, "GRUVJP");
+    std::vector<array> primals(inputs.begin(), inputs.begin() + 4);
+    return mlx::core::vjp(forward, primals, {inputs[5]}).second;
+  };
+
+  std::vector<std::vector<int>> shapes;
+  std::vector<Dtype> dtypes;
+  for (auto& p : primals) {
+    shapes.push_back(p.shape());
+    dtypes.push_back(p.dtype());
+  }
+  auto vjps = array::make_arrays(
+      std::move(shapes),
+      std::move(dtypes),
+      std::make_shared<GRUVJP>(s, fallback, has_hidden_),
+      {primals[0],
+       primals[1],
+       primals[2],
+       primals[3],
+       outputs[0],
+       cotangents[0]});
+
+  std::vector<array> returned_vjps;
+  for (auto& arg : argnums) {
+    returned_vjps.push_back(std::move(vjps[arg]));
+  }
+  return returned_vjps;
+}
+
+bool GRU::is_equivalent(const Primitive& other) const {
+  const GRU& g_other = static_cast<const GRU&>(other);
+  return has_hidden_ == g_other.has_hidden_;
+}
+
+bool GRUVJP::is_equivalent(const Primitive& other) const {
+  const GRUVJP& g_other = static_cast<const GRUVJP&>(other);
+  return has_hidden_ == g_other.has_hidden_;
+}
+
+namespace {
+
+using UpdateKind = MultiTensorUpdate::Kind;
+using UpdateHyperparameters = MultiTensorUpdate::Hyperparameters;
+
+// The update of a single parameter written with ops. Returns the new
+// parameter followed by its new states.
+std::vector<array> update_single(
+    UpdateKind kind,
+    const UpdateHyperparameters& h,
+    const array& learning_rate,
+    const array& p,
+    const array& g,
+    const std::vector<array>& states,
+    StreamOrDevice s) {
+  // Scalars take the type of the update like Python scalars would
+  std::vector<array> operands = {p, g};
+  operands.insert(operands.end(), states.begin(), states.end());
+  auto dtype = result_type(operands);
+  auto scalar = [dtype](float x) { return array(x, dtype); };
+  auto lr = astype(learning_rate, g.dtype(), s);
+  auto decayed = [&](const array& p) {
+    return multiply(
+        p, subtract(scalar(1), multiply(lr, scalar(h.weight_decay), s), s), s);
+  };
+  if (kind == MultiTensorUpdate::SGD) {
+    auto grad = g;
+    if (h.weight_decay != 0) {
+      grad = add(grad, multiply(scalar(h.weight_decay), p, s), s);
+    }
+    if (h.momentum <= 0) {
+      return {subtract(p, multiply(lr, grad, s), s)};
+    }
+    auto v = add(
+        multiply(scalar(h.momentum), states[0], s),
+        h.dampening > 0 ? multiply(scalar(1 - h.dampening), grad, s) : grad,
+        s);
+    auto update =
+        h.nesterov ? add(grad, multiply(scalar(h.momentum), v, s), s) : v;
+    return {subtract(p, multiply(lr, update, s), s), v};
+  } else if (kind == MultiTensorUpdate::Adam) {
+    auto m = add(
+        multiply(scalar(h.beta1), states[0], s),
+        multiply(scalar(1 - h.beta1), g, s),
+        s);
+    auto v = add(
+        multiply(scalar(h.beta2), states[1], s),
+        multiply(scalar(1 - h.beta2), square(g, s), s),
+        s);
+    auto param = h.weight_decay != 0 ? decayed(p) : p;
+    auto update =
+        divide(multiply(lr, m, s), add(sqrt(v, s), scalar(h.eps), s), s);
+    return {subtract(param, update, s), m, v};
+  } else {
+    auto& m = states[0];
+    auto c = add(
+        multiply(scalar(h.beta1), m, s),
+        multiply(scalar(1 - h.beta1), g, s),
+        s);
+    auto new_m = add(
+        multiply(scalar(h.beta2), m, s),
+        multiply(scalar(1 - h.beta2), g, s),
+        s);
+    auto param = h.weight_decay > 0 ? decayed(p) : p;
+    return {subtract(param, multiply(lr, sign(c, s), s), s), new_m};
+  }
+}
+
+// Apply an optimizer update to a list of parameters. The parameters whose
+// gradient and states share their floating point type are updated by a
+// single fused primitive on the CPU, the rest through update_single.
+std::vector<std::vector<array>> multi_tensor_update(
+    const std::string& tag,
+    UpdateKind kind,
+    const UpdateHyperparameters& h,
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<std::vector<array>>& states,
+    const array& learning_rate,
+    StreamOrDevice s) {
+  int n = params.size();
+  if (grads.size() != n) {
+    std::ostringstream msg;
+    msg << tag << " Expected one gradient per parameter but got "
+        << grads.size() << " gradients for " << n << " parameters.";
+    throw std::invalid_argument(msg.str());
+  }
+  for (auto& state : states) {
+    if (state.size() != n) {
+      std::ostringstream msg;
+      msg << tag << " Expected one state per parameter but got "
+          << state.size() << " states for " << n << " parameters.";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+  for (int i = 0; i < n; ++i) {
+    bool same_shape = grads[i].shape() == params[i].shape();
+    for (auto& state : states) {
+      same_shape &= state[i].shape() == params[i].shape();
+    }
+    if (!same_shape) {
+      std::ostringstream msg;
+      msg << tag << " The gradient and states of parameter " << i
+          << " must have the parameter's shape " << params[i].shape() << ".";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+  if (learning_rate.size() != 1) {
+    std::ostringstream msg;
+    msg << tag << " The learning rate must be a scalar but got shape "
+        << learning_rate.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  auto lr = astype(reshape(learning_rate, {}, s), float32, s);
+
+  int n_states = states.size();
+  std::vector<std::vector<array>> outputs(1 + n_states);
+  for (auto& out : outputs) {
+    out.reserve(n);
+  }
+
+  auto stream = to_stream(s);
+  std::vector<int> fused;
+  for (int i = 0; i < n; ++i) {
+    auto dtype = params[i].dtype();
+    bool fusable = stream.device == Device::cpu &&
+        issubdtype(dtype, floating) && grads[i].dtype() == dtype;
+    for (auto& state : states) {
+      fusable &= state[i].dtype() == dtype;
+    }
+    if (fusable) {
+      fused.push_back(i);
+      for (auto& out : outputs) {
+        // Placeholder until the fused outputs are made below
+        out.push_back(params[i]);
+      }
+      continue;
+    }
+    std::vector<array> param_states;
+    for (auto& state : states) {
+      param_states.push_back(state[i]);
+    }
+    auto updated =
+        update_single(kind, h, lr, params[i], grads[i], param_states, s);
+    for (int k = 0; k <= n_states; ++k) {
+      outputs[k].push_back(std::move(updated[k]));
+    }
+  }
+  // Every output of a primitive refers to all of its inputs and siblings so
+  // the parameters are updated in groups to bound the size of the graph
+  constexpr int max_group_size = 16;
+  for (int start = 0; start < fused.size(); start += max_group_size) {
+    std::vector<int> group(
+        fused.begin() + start,
+        fused.begin() + std::min<int>(start + max_group_size, fused.size()));
+    int n_group = group.size();
+
+    // The inputs are the learning rate followed by the parameters, the
+    // gradients and each state, the outputs by the parameters and each state
+    std::vector<array> inputs = {lr};
+    std::vector<std::vector<int>> shapes;
+    std::vector<Dtype> dtypes;
+    for (auto i : group) {
+      inputs.push_back(params[i]);
+    }
+    for (auto i : group) {
+      inputs.push_back(grads[i]);
+    }
+    for (int k = -1; k < n_states; ++k) {
+      for (auto i : group) {
+        if (k >= 0) {
+          inputs.push_back(states[k][i]);
+        }
+        shapes.push_back(params[i].shape());
+        dtypes.push_back(params[i].dtype());
+      }
+    }
+
+    auto fallback = [kind, h, n_group, n_states, stream](
+                        const std::vector<array>& inputs) {
+      std::vector<array> outputs((1 + n_states) * n_group, inputs[0]);
+      for (int i = 0; i < n_group; ++i) {
+        std::vector<array> param_states;
+        for (int k = 0; k < n_states; ++k) {
+          param_states.push_back(inputs[1 + (2 + k) * n_group + i]);
+        }
+        auto updated = update_single(
+            kind,
+            h,
+            inputs[0],
+            inputs[1 + i],
+            inputs[1 + n_group + i],
+            param_states,
+            stream);
+        for (int k = 0; k <= n_states; ++k) {
+          outputs[k * n_group + i] = std::move(updated[k]);
+        }
+      }
+      return outputs;
+    };
+
+    auto updated = array::make_arrays(
+        std::move(shapes),
+        std::move(dtypes),
+        std::make_shared<MultiTensorUpdate>(stream, fallback, kind, h),
+        std::move(inputs));
+    for (int k = 0; k <= n_states; ++k) {
+      for (int j = 0; j < n_group; ++j) {
+        outputs[k][group[j]] = std::move(updated[k * n_group + j]);
+      }
+    }
+  }
+  return outputs;
+}
+
+} // namespace
+
+std::vector<std::vector<array>> sgd_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& v,
+    const array& learning_rate,
+    float momentum /* = 0.0f */,
+    float weight_decay /* = 0.0f */,
+    float dampening /* = 0.0f */,
+    bool nesterov /* = false */,
+    StreamOrDevice s /* = {} */) {
+  if (nesterov && (momentum <= 0 || dampening != 0)) {
+    throw std::invalid_argument(
+        "[sgd_update] Nesterov momentum requires a momentum and zero "
+        "dampening.");
+  }
+  UpdateHyperparameters h;
+  h.momentum = momentum;
+  h.dampening = dampening;
+  h.weight_decay = weight_decay;
+  h.nesterov = nesterov;
+  std::vector<std::vector<array>> states;
+  if (momentum > 0) {
+    states.push_back(v);
+  }
+  return multi_tensor_update(
+      "[sgd_update]",
+      MultiTensorUpdate::SGD,
+      h,
+      params,
+      grads,
+      states,
+      learning_rate,
+      s);
+}
+
+std::vector<std::vector<array>> adam_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& m,
+    const std::vector<array>& v,
+    const array& learning_rate,
+    float beta1 /* = 0.9f */,
+    float beta2 /* = 0.999f */,
+    float eps /* = 1e-8f */,
+    float weight_decay /* = 0.0f */,
+    StreamOrDevice s /* = {} */) {
+  UpdateHyperparameters h;
+  h.beta1 = beta1;
+  h.beta2 = beta2;
+  h.eps = eps;
+  h.weight_decay = weight_decay;
+  return multi_tensor_update(
+      "[adam_update]",
+      MultiTensorUpdate::Adam,
+      h,
+      params,
+      grads,
+      {m, v},
+      learning_rate,
+      s);
+}
+
+std::vector<std::vector<array>> lion_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& m,
+    const array& learning_rate,
+    float beta1 /* = 0.9f */,
+    float beta2 /* = 0.99f */,
+    float weight_decay /* = 0.0f */,
+    StreamOrDevice s /* = {} */) {
+  UpdateHyperparameters h;
+  h.beta1 = beta1;
+  h.beta2 = beta2;
+  h.weight_decay = weight_decay;
+  return multi_tensor_update(
+      "[lion_update]",
+      MultiTensorUpdate::Lion,
+      h,
+      params,
+      grads,
+      {m},
+      learning_rate,
+      s);
+}
+
+bool MultiTensorUpdate::is_equivalent(const Primitive& other) const {
+  const MultiTensorUpdate& u_other =
+      static_cast<const MultiTensorUpdate&>(other);
+  const auto& h = hparams_;
+  const auto& h_other = u_other.hparams_;
+  return kind_ == u_other.kind_ && h.beta1 == h_other.beta1 &&
+      h.beta2 == h_other.beta2 && h.eps == h_other.eps &&
+      h.momentum == h_other.momentum && h.dampening == h_other.dampening &&
+      h.weight_decay == h_other.weight_decay && h.nesterov == h_other.nesterov;
+}
+
+namespace {
+
+// The activation written with ops
+array activation_ops(Activation::Kind kind, const array& x, StreamOrDevice s) {
+  auto dtype = x.dtype();
+  auto scalar = [dtype](float v) { return array(v, dtype); };
+  switch (kind) {
+    case Activation::Gelu:
+      return multiply(
+          multiply(scalar(0.5f), x, s),
+          add(scalar(1.0f), erf(multiply(scalar(M_SQRT1_2), x, s), s), s),
+          s);
+    case Activation::GeluApprox: {
+      auto x3 = multiply(square(x, s), x, s);
+      auto u = multiply(
+          scalar(std::sqrt(2.0 / M_PI)),
+          add(x, multiply(scalar(0.044715f), x3, s), s),
+          s);
+      return multiply(
+          multiply(scalar(0.5f), x, s), add(scalar(1.0f), tanh(u, s), s), s);
+    }
+    case Activation::SiLU:
+      return multiply(x, sigmoid(x, s), s);
+    default:
+      return multiply(x, tanh(logaddexp(x, scalar(0.0f), s), s), s);
+  }
+}
+
+// The cotangent times the derivative of the activation written with ops
+array activation_vjp_ops(
+    Activation::Kind kind,
+    const array& x,
+    const array& g,
+    StreamOrDevice s) {
+  auto dtype = x.dtype();
+  auto scalar = [dtype](float v) { return array(v, dtype); };
+  auto one = scalar(1.0f);
+  array d = x;
+  switch (kind) {
+    case Activation::Gelu: {
+      auto cdf = multiply(
+          scalar(0.5f),
+          add(one, erf(multiply(scalar(M_SQRT1_2), x, s), s), s),
+          s);
+      auto pdf = multiply(
+          scalar(0.5 * M_2_SQRTPI * M_SQRT1_2),
+          exp(multiply(scalar(-0.5f), square(x, s), s), s),
+          s);
+      d = add(cdf, multiply(x, pdf, s), s);
+      break;
+    }
+    case Activation::GeluApprox: {
+      auto c = scalar(std::sqrt(2.0 / M_PI));
+      auto x2 = square(x, s);
+      auto u = multiply(
+          c, add(x, multiply(scalar(0.044715f), multiply(x2, x, s), s), s), s);
+      auto t = tanh(u, s);
+      auto du = multiply(
+          c, add(one, multiply(scalar(3 * 0.044715f), x2, s), s), s);
+      d = add(
+          multiply(scalar(0.5f), add(one, t, s), s),
+          multiply(
+              multiply(scalar(0.5f), x, s),
+              multiply(subtract(one, square(t, s), s), du, s),
+              s),
+          s);
+      break;
+    }
+    case Activation::SiLU: {
+      auto sg = sigmoid(x, s);
+      d = multiply(sg, add(one, multiply(x, subtract(one, sg, s), s), s), s);
+      break;
+    }
+    default: {
+      auto t = tanh(logaddexp(x, scalar(0.0f), s), s);
+      d = add(
+          t,
+          multiply(
+              multiply(x, subtract(one, square(t, s), s), s),
+              sigmoid(x, s),
+              s),
+          s);
+      break;
+    }
+  }
+  return multiply(g, d, s);
+}
+
+array activation(Activation::Kind kind, const array& x, StreamOrDevice s) {
+  auto dtype = issubdtype(x.dtype(), floating) ? x.dtype() : float32;
+  auto stream = to_stream(s);
+  auto fallback = [kind, stream](const std::vector<array>& inputs) {
+    return std::vector<array>{activation_ops(kind, inputs[0], stream)};
+  };
+  auto in = astype(x, dtype, stream);
+  if (stream.device != Device::cpu) {
+    return fallback({in})[0];
+  }
+  return array(
+      in.shape(),
+      dtype,
+      std::make_shared<Activation>(stream, fallback, kind),
+      {in});
+}
+
+} // namespace
+
+array gelu(const array& x, StreamOrDevice s /* = {} */) {
+  return activation(Activation::Gelu, x, s);
+}
+
+array gelu_approx(const array& x, StreamOrDevice s /* = {} */) {
+  return activation(Activation::GeluApprox, x, s);
+}
+
+array silu(const array& x, StreamOrDevice s /* = {} */) {
+  return activation(Activation::SiLU, x, s);
+}
+
+array mish(const array& x, StreamOrDevice s /* = {} */) {
+  return activation(Activation::Mish, x, s);
+}
+
+std::vector<array> Activation::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>& outputs) {
+  assert(primals.size() == 1);
+  assert(cotangents.size() == 1);
+
+  auto s = stream();
+  auto kind = kind_;
+  auto fallback = [kind, s](const std::vector<array>& inputs) {
+    return std::vector<array>{
+        activation_vjp_ops(kind, inputs[0], inputs[1], s)};
+  };
+  auto& x = primals[0];
+  return {array(
+      x.shape(),
+      x.dtype(),
+      std::make_shared<ActivationVJP>(s, fallback, kind),
+      {x, astype(cotangents[0], x.dtype(), s)})};
+}
+
+bool Activation::is_equivalent(const Primitive& other) const {
+  const Activation& a_other = static_cast<const Activation&>(other);
+  return kind_ == a_other.kind_;
+}
+
+bool ActivationVJP::is_equivalent(const Primitive& other) const {
+  const ActivationVJP& a_other = static_cast<const ActivationVJP&>(other);
+  return kind_ == a_other.kind_;
 }
 
 } // namespace mlx::core::fast
@@ -39,4 +39,104 @@ array scaled_dot_product_attention(
     const std::optional<array>& mask = std::nullopt,
     StreamOrDevice s = {});
 
+/** Computes: O = softmax(Q @ K.T) @ V. With causal=true query i only sees
+ * keys 0 to i + S - L and the mask is never materialized. **/
+array scaled_dot_product_attention(
+    const array& queries,
+    const array& keys,
+    const array& values,
+    const float scale,
+    const std::optional<array>& mask,
+    bool causal,
+    StreamOrDevice s = {});
+
+/** Computes: O = softmax(Q @ K.T) @ V with K and V given as quantized
+ * (weights, scales, biases) triplets from quantize(). **/
+array quantized_scaled_dot_product_attention(
+    const array& queries,
+    const array& keys,
+    const array& key_scales,
+    const array& key_biases,
+    const array& values,
+    const array& value_scales,
+    const array& value_biases,
+    const float scale,
+    const std::optional<array>& mask = std::nullopt,
+    int group_size = 64,
+    int bits = 4,
+    StreamOrDevice s = {});
+
+/** Run an LSTM over the sequence axis of x, the input projection of shape
+ * (..., L, 4 * H) with the gates in (i, f, g, o) order. Returns the hidden
+ * and cell states of every step, both of shape (..., L, H). **/
+std::vector<array> lstm(
+    const array& x,
+    const array& w_h,
+    const std::optional<array>& hidden = std::nullopt,
+    const std::optional<array>& cell = std::nullopt,
+    StreamOrDevice s = {});
+
+/** Run a GRU over the sequence axis of x, the input projection of shape
+ * (..., L, 3 * H) with the gates in (r, z, n) order. The optional b_hn is
+ * added to the hidden projection of the candidate gate. Returns the hidden
+ * state of every step with shape (..., L, H). **/
+array gru(
+    const array& x,
+    const array& w_h,
+    const std::optional<array>& b_hn = std::nullopt,
+    const std::optional<array>& hidden = std::nullopt,
+    StreamOrDevice s = {});
+
+/** Element wise x * Phi(x) with Phi the Gaussian CDF. **/
+array gelu(const array& x, StreamOrDevice s = {});
+
+/** The tanh approximation of gelu(). **/
+array gelu_approx(const array& x, StreamOrDevice s = {});
+
+/** Element wise x * sigmoid(x). **/
+array silu(const array& x, StreamOrDevice s = {});
+
+/** Element wise x * tanh(softplus(x)). **/
+array mish(const array& x, StreamOrDevice s = {});
+
+/** Apply one step of SGD to a list of parameters, see optimizers.SGD. The
+ * momentum buffers v are only read when momentum is positive. Returns the new
+ * parameters followed, with momentum, by the new momentum buffers. **/
+std::vector<std::vector<array>> sgd_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& v,
+    const array& learning_rate,
+    float momentum = 0.0f,
+    float weight_decay = 0.0f,
+    float dampening = 0.0f,
+    bool nesterov = false,
+    StreamOrDevice s = {});
+
+/** Apply one step of Adam, or AdamW with a weight decay, to a list of
+ * parameters. Returns the new parameters and first and second moments. **/
+std::vector<std::vector<array>> adam_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& m,
+    const std::vector<array>& v,
+    const array& learning_rate,
+    float beta1 = 0.9f,
+    float beta2 = 0.999f,
+    float eps = 1e-8f,
+    float weight_decay = 0.0f,
+    StreamOrDevice s = {});
+
+/** Apply one step of Lion to a list of parameters. Returns the new
+ * parameters and momentum buffers. **/
+std::vector<std::vector<array>> lion_update(
+    const std::vector<array>& params,
+    const std::vector<array>& grads,
+    const std::vector<array>& m,
+    const array& learning_rate,
+    float beta1 = 0.9f,
+    float beta2 = 0.99f,
+    float weight_decay = 0.0f,
+    StreamOrDevice s = {});
+
 } // namespace mlx::core::fast
@@ -6,7 +6,8 @@ namespace mlx::core::fast {
 
 // Custom primitive accepts a fallback function which it uses for
 // transformations. Transformations are virtual so that derived classes may
-// override the default behavior.
+// override the default behavior. The fallback is not part of the state saved
+// by export_function, so imported custom primitives can't be transformed.
 class Custom : public Primitive {
  public:
   explicit Custom(
@@ -57,6 +58,10 @@ class RMSNorm : public Custom {
   DEFINE_PRINT(RMSNorm)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(nullptr, eps_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   float eps_;
@@ -80,6 +85,10 @@ class RMSNormVJP : public Custom {
   DEFINE_PRINT(RMSNormVJP)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(nullptr, eps_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   float eps_;
@@ -109,6 +118,10 @@ class LayerNorm : public Custom {
   DEFINE_PRINT(LayerNorm)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(nullptr, eps_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   float eps_;
@@ -132,6 +145,10 @@ class LayerNormVJP : public Custom {
   DEFINE_PRINT(LayerNormVJP)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(nullptr, eps_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   float eps_;
@@ -172,6 +189,11 @@ class RoPE : public Custom {
   DEFINE_PRINT(RoPE)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(
+        nullptr, dims_, traditional_, base_, scale_, offset_, forward_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   int dims_;
@@ -182,19 +204,24 @@ class RoPE : public Custom {
   bool forward_;
 };
 
+// The CPU kernel runs a tiled online softmax so the scores are only ever held
+// for one block of queries and keys. The queries of every head that shares a
+// key and value head go through the same GEMMs.
 class ScaledDotProductAttention : public Custom {
  public:
   explicit ScaledDotProductAttention(
       Stream stream,
       std::function<std::vector<array>(std::vector<array>)> fallback,
       const float scale,
-      const bool needs_mask)
-      : Custom(stream, fallback), scale_(scale), needs_mask_(needs_mask) {};
+      const bool needs_mask,
+      const bool causal = false)
+      : Custom(stream, fallback),
+        scale_(scale),
+        needs_mask_(needs_mask),
+        causal_(causal) {};
 
   void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
-      override {
-    throw std::runtime_error("NYI");
-  };
+      override;
 
   void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
       override {
@@ -206,10 +233,314 @@ class ScaledDotProductAttention : public Custom {
 
   DEFINE_PRINT(ScaledDotProductAttention);
 
+  auto state() const {
+    return std::make_tuple(nullptr, scale_, needs_mask_, causal_);
+  }
+
  private:
   std::function<std::vector<array>(std::vector<array>)> fallback_;
   float scale_;
   bool needs_mask_;
+  bool causal_;
+};
+
+// Attention with keys and values quantized as in quantize(). The CPU kernel
+// dequantizes one key or value row at a time inside the attention loop so
+// the full precision keys and values are never materialized.
+class QuantizedScaledDotProductAttention : public Custom {
+ public:
+  explicit QuantizedScaledDotProductAttention(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      const float scale,
+      const int group_size,
+      const int bits,
+      const bool needs_mask)
+      : Custom(stream, fallback),
+        fallback_(fallback),
+        scale_(scale),
+        group_size_(group_size),
+        bits_(bits),
+        needs_mask_(needs_mask) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  std::vector<array> vjp(
+      const std::vector<array>& primals,
+      const std::vector<array>& cotangents,
+      const std::vector<int>& argnums,
+      const std::vector<array>& outputs) override;
+
+  DEFINE_PRINT(QuantizedScaledDotProductAttention);
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(nullptr, scale_, group_size_, bits_, needs_mask_);
+  }
+
+ private:
+  std::function<std::vector<array>(std::vector<array>)> fallback_;
+  float scale_;
+  int group_size_;
+  int bits_;
+  bool needs_mask_;
+};
+
+// Recurrences over a whole sequence. The input projection of every step is
+// computed up front so the kernels only run the hidden state GEMM and the
+// fused gate math per step. The VJPs recompute the gates from the saved
+// states and backpropagate through time in a single kernel.
+class LSTM : public Custom {
+ public:
+  explicit LSTM(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback)
+      : Custom(stream, fallback), fallback_(fallback) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  std::vector<array> vjp(
+      const std::vector<array>& primals,
+      const std::vector<array>& cotangents,
+      const std::vector<int>& argnums,
+      const std::vector<array>& outputs) override;
+
+  DEFINE_PRINT(LSTM);
+  bool is_equivalent(const Primitive& other) const override {
+    return true;
+  };
+
+  auto state() const {
+    return std::make_tuple(nullptr);
+  }
+
+ private:
+  std::function<std::vector<array>(std::vector<array>)> fallback_;
+};
+
+class LSTMVJP : public Custom {
+ public:
+  explicit LSTMVJP(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback)
+      : Custom(stream, fallback) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  DEFINE_PRINT(LSTMVJP);
+  bool is_equivalent(const Primitive& other) const override {
+    return true;
+  };
+
+  auto state() const {
+    return std::make_tuple(nullptr);
+  }
+};
+
+class GRU : public Custom {
+ public:
+  explicit GRU(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      bool has_hidden)
+      : Custom(stream, fallback),
+        fallback_(fallback),
+        has_hidden_(has_hidden) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  std::vector<array> vjp(
+      const std::vector<array>& primals,
+      const std::vector<array>& cotangents,
+      const std::vector<int>& argnums,
+      const std::vector<array>& outputs) override;
+
+  DEFINE_PRINT(GRU);
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(nullptr, has_hidden_);
+  }
+
+ private:
+  std::function<std::vector<array>(std::vector<array>)> fallback_;
+  bool has_hidden_;
+};
+
+class GRUVJP : public Custom {
+ public:
+  explicit GRUVJP(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      bool has_hidden)
+      : Custom(stream, fallback), has_hidden_(has_hidden) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  DEFINE_PRINT(GRUVJP);
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(nullptr, has_hidden_);
+  }
+
+ private:
+  bool has_hidden_;
+};
+
+class MultiTensorUpdate : public Custom {
+ public:
+  enum Kind { SGD, Adam, Lion };
+
+  struct Hyperparameters {
+    float beta1 = 0.0f;
+    float beta2 = 0.0f;
+    float eps = 0.0f;
+    float momentum = 0.0f;
+    float dampening = 0.0f;
+    float weight_decay = 0.0f;
+    bool nesterov = false;
+  };
+
+  explicit MultiTensorUpdate(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      Kind kind,
+      const Hyperparameters& hparams)
+      : Custom(stream, fallback), kind_(kind), hparams_(hparams) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  DEFINE_PRINT(MultiTensorUpdate);
+  bool is_equivalent(const Primitive& other) const override;
+
+  // The number of optimizer states carried per parameter
+  int num_states() const {
+    switch (kind_) {
+      case Adam:
+        return 2;
+      case Lion:
+        return 1;
+      default:
+        return hparams_.momentum > 0 ? 1 : 0;
+    }
+  }
+
+  auto state() const {
+    return std::make_tuple(nullptr, kind_, hparams_);
+  }
+
+ private:
+  Kind kind_;
+  Hyperparameters hparams_;
+};
+
+// Element wise activations computed in a single pass over the input. The
+// VJP is a single pass over the input and the cotangent as well.
+class Activation : public Custom {
+ public:
+  enum Kind { Gelu, GeluApprox, SiLU, Mish };
+
+  explicit Activation(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      Kind kind)
+      : Custom(stream, fallback), kind_(kind) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  std::vector<array> vjp(
+      const std::vector<array>& primals,
+      const std::vector<array>& cotangents,
+      const std::vector<int>& argnums,
+      const std::vector<array>& outputs) override;
+
+  DEFINE_PRINT(Activation);
+  bool is_equivalent(const Primitive& other) const override;
+  std::vector<std::vector<int>> output_shapes(
+      const std::vector<array>& inputs) override {
+    return {inputs[0].shape()};
+  };
+
+  auto state() const {
+    return std::make_tuple(nullptr, kind_);
+  }
+
+ private:
+  Kind kind_;
+};
+
+class ActivationVJP : public Custom {
+ public:
+  explicit ActivationVJP(
+      Stream stream,
+      std::function<std::vector<array>(std::vector<array>)> fallback,
+      Activation::Kind kind)
+      : Custom(stream, fallback), kind_(kind) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override {
+    throw std::runtime_error("NYI");
+  };
+
+  DEFINE_PRINT(ActivationVJP);
+  bool is_equivalent(const Primitive& other) const override;
+  std::vector<std::vector<int>> output_shapes(
+      const std::vector<array>& inputs) override {
+    return {inputs[0].shape()};
+  };
+
+  auto state() const {
+    return std::make_tuple(nullptr, kind_);
+  }
+
+ private:
+  Activation::Kind kind_;
 };
 
 } // namespace mlx::core::fast
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <optional>
 #include <variant>
 
 #include "mlx/array.h"
@@ -19,6 +22,83 @@ using SafetensorsLoad = std::pair<
     std::unordered_map<std::string, array>,
     std::unordered_map<std::string, std::string>>;
 
+using TensorFilter = std::function<bool(const std::string&)>;
+
+/** Shape, type and byte range of a tensor stored in a checkpoint */
+struct TensorInfo {
+  std::vector<int> shape;
+  Dtype dtype;
+  size_t offset;
+  size_t nbytes;
+};
+
+/**
+ * A checkpoint opened without reading any tensor data. Arrays are only
+ * created for the requested tensors and read from the file when evaluated.
+ */
+class Checkpoint {
+ public:
+  Checkpoint(
+      std::shared_ptr<io::Reader> in_stream,
+      std::map<std::string, TensorInfo> tensors,
+      std::unordered_map<std::string, std::string> metadata = {})
+      : in_stream_(std::move(in_stream)),
+        tensors_(std::move(tensors)),
+        metadata_(std::move(metadata)) {}
+
+  /** The stored tensors sorted by name */
+  const std::map<std::string, TensorInfo>& tensors() const {
+    return tensors_;
+  }
+
+  const std::unordered_map<std::string, std::string>& metadata() const {
+    return metadata_;
+  }
+
+  bool contains(const std::string& key) const {
+    return tensors_.count(key) > 0;
+  }
+
+  /** Load a single tensor */
+  array load(const std::string& key, StreamOrDevice s = {}) const;
+
+  /** Load a single tensor converted to dtype while it is read */
+  array load(const std::string& key, Dtype dtype, StreamOrDevice s = {}) const;
+
+  /**
+   * Load a matrix quantized as with quantize() while it is read. The scales
+   * and biases have the given floating type, by default the stored one.
+   */
+  std::tuple<array, array, array> load_quantized(
+      const std::string& key,
+      int group_size = 64,
+      int bits = 4,
+      std::optional<Dtype> dtype = std::nullopt,
+      StreamOrDevice s = {}) const;
+
+  /** Load the given tensors */
+  std::unordered_map<std::string, array> load(
+      const std::vector<std::string>& keys,
+      StreamOrDevice s = {}) const;
+
+  /** Load the tensors whose name passes the filter */
+  std::unordered_map<std::string, array> load(
+      const TensorFilter& filter,
+      StreamOrDevice s = {}) const;
+
+  /** Load the tensors whose name starts with prefix */
+  std::unordered_map<std::string, array> load_prefix(
+      const std::string& prefix,
+      StreamOrDevice s = {}) const;
+
+ private:
+  const TensorInfo& info(const std::string& key) const;
+
+  std::shared_ptr<io::Reader> in_stream_;
+  std::map<std::string, TensorInfo> tensors_;
+  std::unordered_map<std::string, std::string> metadata_;
+};
+
 /** Save array to out stream in .npy format */
 void save(std::shared_ptr<io::Writer> out_stream, array a);
 
@@ -31,6 +111,24 @@ array load(std::shared_ptr<io::Reader> in_stream, StreamOrDevice s = {});
 /** Load array from file in .npy format */
 array load(std::string file, StreamOrDevice s = {});
 
+/** Load array map from .npz file format */
+std::unordered_map<std::string, array> load_npz(
+    std::shared_ptr<io::Reader> in_stream,
+    StreamOrDevice s = {});
+std::unordered_map<std::string, array> load_npz(
+    const std::string& file,
+    StreamOrDevice s = {});
+
+/** Save array map to .npz file format, deflating the arrays if compressed */
+void save_npz(
+    std::shared_ptr<io::Writer> out_stream,
+    std::unordered_map<std::string, array> array_map,
+    bool compressed = false);
+void save_npz(
+    std::string file,
+    std::unordered_map<std::string, array> array_map,
+    bool compressed = false);
+
 /** Load array map from .safetensors file format */
 SafetensorsLoad load_safetensors(
     std::shared_ptr<io::Reader> in_stream,
@@ -39,6 +137,10 @@ SafetensorsLoad load_safetensors(
     const std::string& file,
     StreamOrDevice s = {});
 
+/** Read the header of a .safetensors file without loading any tensor */
+Checkpoint open_safetensors(std::shared_ptr<io::Reader> in_stream);
+Checkpoint open_safetensors(const std::string& file);
+
 void save_safetensors(
     std::shared_ptr<io::Writer> in_stream,
     std::unordered_map<std::string, array>,
@@ -48,9 +150,14 @@ void save_safetensors(
     std::unordered_map<std::string, array>,
     std::unordered_map<std::string, std::string> metadata = {});
 
-/** Load array map and metadata from .gguf file format */
-
-GGUFLoad load_gguf(const std::string& file, StreamOrDevice s = {});
+/**
+ * Load array map and metadata from .gguf file format. If a filter is given
+ * only the tensors whose name passes it are read.
+ */
+GGUFLoad load_gguf(
+    const std::string& file,
+    StreamOrDevice s = {},
+    const TensorFilter& filter = nullptr);
 
 void save_gguf(
     std::string file,
@@ -0,0 +1,117 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "mlx/io/zip.h"
+
+namespace mlx::core::io::detail {
+
+namespace {
+
+// zlib counts bytes with 32 bit integers
+constexpr size_t max_chunk = 1 << 30;
+
+} // namespace
+
+uint32_t crc32(uint32_t crc, const char* data, size_t n) {
+  auto src = reinterpret_cast<const Bytef*>(data);
+  while (n > 0) {
+    auto len = std::min(n, max_chunk);
+    crc = ::crc32(crc, src, len);
+    src += len;
+    n -= len;
+  }
+  return crc;
+}
+
+std::vector<char> deflate(
+    const std::vector<std::pair<const char*, size_t>>& chunks) {
+  z_stream zs{};
+  // Negative window bits write a raw deflate stream as zip expects
+  if (deflateInit2(
+          &zs,
+          Z_DEFAULT_COMPRESSION,
+          Z_DEFLATED,
+          -MAX_WBITS,
+          8,
+          Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::runtime_error("[deflate] Failed to initialize zlib.");
+  }
+
+  size_t total = 0;
+  for (auto& [data, n] : chunks) {
+    total += n;
+  }
+  std::vector<char> out(total / 2 + 64);
+  size_t written = 0;
+
+  // Compress what is in the input window, growing the output as needed
+  auto run = [&](int flush) {
+    int ret;
+    do {
+      if (written == out.size()) {
+        out.resize(2 * out.size());
+      }
+      auto avail = std::min(out.size() - written, max_chunk);
+      zs.next_out = reinterpret_cast<Bytef*>(out.data() + written);
+      zs.avail_out = avail;
+      ret = ::deflate(&zs, flush);
+      written += avail - zs.avail_out;
+    } while (flush == Z_FINISH ? ret != Z_STREAM_END : zs.avail_in > 0);
+  };
+
+  for (auto [data, n] : chunks) {
+    while (n > 0) {
+      auto len = std::min(n, max_chunk);
+      zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+      zs.avail_in = len;
+      run(Z_NO_FLUSH);
+      data += len;
+      n -= len;
+    }
+  }
+  run(Z_FINISH);
+  deflateEnd(&zs);
+  out.resize(written);
+  return out;
+}
+
+void inflate(const char* src, size_t src_size, char* dst, size_t dst_size) {
+  z_stream zs{};
+  if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+    throw std::runtime_error("[inflate] Failed to initialize zlib.");
+  }
+  // Refill the input and output windows until the stream ends or stalls
+  auto can_refill = [&]() {
+    return (zs.avail_in == 0 && src_size > 0) ||
+        (zs.avail_out == 0 && dst_size > 0);
+  };
+  int ret;
+  do {
+    if (zs.avail_in == 0) {
+      auto len = std::min(src_size, max_chunk);
+      zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+      zs.avail_in = len;
+      src += len;
+      src_size -= len;
+    }
+    if (zs.avail_out == 0) {
+      auto len = std::min(dst_size, max_chunk);
+      zs.next_out = reinterpret_cast<Bytef*>(dst);
+      zs.avail_out = len;
+      dst += len;
+      dst_size -= len;
+    }
+    ret = ::inflate(&zs, Z_NO_FLUSH);
+  } while (ret == Z_OK || (ret == Z_BUF_ERROR && can_refill()));
+  bool done = ret == Z_STREAM_END && zs.avail_out == 0 && dst_size == 0;
+  inflateEnd(&zs);
+  if (!done) {
+    throw std::runtime_error("[inflate] Invalid or truncated deflate stream.");
+  }
+}
+
+} // namespace mlx::core::io::detail
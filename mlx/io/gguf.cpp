@@ -203,7 +203,9 @@ std::unordered_map<std::string, GGUFMetaData> load_metadata(gguf_ctx* ctx) {
   return metadata;
 }
 
-std::unordered_map<std::string, array> load_arrays(gguf_ctx* ctx) {
+std::unordered_map<std::string, array> load_arrays(
+    gguf_ctx* ctx,
+    const TensorFilter& filter) {
   std::unordered_map<std::string, array> array_map;
   gguf_tensor tensor;
 
@@ -218,6 +220,10 @@ std::unordered_map<std::string, array> load_arrays(gguf_ctx* ctx) {
 
   while (gguf_get_tensor(ctx, &tensor)) {
     std::string name(tensor.name, tensor.namelen);
+    // The file is memory mapped so skipped tensors are never read
+    if (filter && !filter(name)) {
+      continue;
+    }
     if (tensor.type == GGUF_TYPE_Q4_0 || tensor.type == GGUF_TYPE_Q4_1 ||
         tensor.type == GGUF_TYPE_Q8_0) {
       gguf_load_quantized(array_map, tensor);
@@ -232,13 +238,16 @@ std::unordered_map<std::string, array> load_arrays(gguf_ctx* ctx) {
   return array_map;
 }
 
-GGUFLoad load_gguf(const std::string& file, StreamOrDevice s) {
+GGUFLoad load_gguf(
+    const std::string& file,
+    StreamOrDevice s,
+    const TensorFilter& filter /* = nullptr */) {
   gguf_ctx* ctx = gguf_open(file.data());
   if (!ctx) {
     throw std::runtime_error("[load_gguf] gguf_init failed");
   }
   auto metadata = load_metadata(ctx);
-  auto arrays = load_arrays(ctx);
+  auto arrays = load_arrays(ctx, filter);
   gguf_close(ctx);
   return {arrays, metadata};
 }
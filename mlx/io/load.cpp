@@ -5,9 +5,16 @@
 #include <limits>
 #include <sstream>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mlx/io.h"
 #include "mlx/io/load.h"
+#include "mlx/io/zip.h"
 #include "mlx/ops.h"
 #include "mlx/primitives.h"
+#include "mlx/transforms.h"
 #include "mlx/utils.h"
 
 // Adapted from
@@ -26,13 +33,8 @@ constexpr uint8_t MAGIC[] = {
     0x59,
 };
 
-} // namespace
-
-/** Save array to out stream in .npy format */
-void save(std::shared_ptr<io::Writer> out_stream, array a) {
-  ////////////////////////////////////////////////////////
-  // Check array
-
+// Evaluate the array and make sure it is contiguous so it can be written
+array prepare_to_save(array a) {
   a.eval();
 
   if (a.nbytes() == 0) {
@@ -48,15 +50,11 @@ void save(std::shared_ptr<io::Writer> out_stream, array a) {
     throw std::invalid_argument(
         "[save] can only serialize row or col contiguous arrays");
   }
+  return a;
+}
 
-  ////////////////////////////////////////////////////////
-  // Check file
-  if (!out_stream->good() || !out_stream->is_open()) {
-    throw std::runtime_error("[save] Failed to open " + out_stream->label());
-  }
-
-  ////////////////////////////////////////////////////////
-  // Prepare header
+// The magic string, version, header length and header of a .npy file
+std::string npy_header(const array& a) {
   std::ostringstream magic_ver_len;
   magic_ver_len.write(reinterpret_cast<const char*>(MAGIC), 6);
 
@@ -104,11 +102,26 @@ void save(std::shared_ptr<io::Writer> out_stream, array a) {
       magic_ver_len.write(len_bytes, 1);
     }
   }
+  return magic_ver_len.str() + header.str();
+}
+
+} // namespace
+
+/** Save array to out stream in .npy format */
+void save(std::shared_ptr<io::Writer> out_stream, array a) {
+  a = prepare_to_save(a);
+
+  ////////////////////////////////////////////////////////
+  // Check file
+  if (!out_stream->good() || !out_stream->is_open()) {
+    throw std::runtime_error("[save] Failed to open " + out_stream->label());
+  }
+
   ////////////////////////////////////////////////////////
   // Serialize array
 
-  out_stream->write(magic_ver_len.str().c_str(), magic_ver_len.str().length());
-  out_stream->write(header.str().c_str(), header.str().length());
+  auto header = npy_header(a);
+  out_stream->write(header.c_str(), header.length());
   out_stream->write(a.data<char>(), a.nbytes());
 }
 
@@ -224,7 +237,267 @@ array load(std::shared_ptr<io::Reader> in_stream, StreamOrDevice s) {
 
 /** Load array from file in .npy format */
 array load(std::string file, StreamOrDevice s) {
-  return load(std::make_shared<io::FileReader>(std::move(file)), s);
+  return load(std::make_shared<io::ParallelFileReader>(std::move(file)), s);
 }
 
+const TensorInfo& Checkpoint::info(const std::string& key) const {
+  auto it = tensors_.find(key);
+  if (it == tensors_.end()) {
+    throw std::invalid_argument(
+        "[Checkpoint::load] No tensor named " + key + " in " +
+        in_stream_->label());
+  }
+  return it->second;
+}
+
+array Checkpoint::load(const std::string& key, StreamOrDevice s) const {
+  auto& info = this->info(key);
+  return load(key, info.dtype, s);
+}
+
+array Checkpoint::load(const std::string& key, Dtype dtype, StreamOrDevice s)
+    const {
+  auto& info = this->info(key);
+  return array(
+      info.shape,
+      dtype,
+      std::make_shared<Load>(
+          to_stream(s), in_stream_, info.offset, false, info.dtype),
+      std::vector<array>{});
+}
+
+std::tuple<array, array, array> Checkpoint::load_quantized(
+    const std::string& key,
+    int group_size /* = 64 */,
+    int bits /* = 4 */,
+    std::optional<Dtype> dtype /* = std::nullopt */,
+    StreamOrDevice s /* = {} */) const {
+  auto& info = this->info(key);
+  auto out_type = dtype.value_or(info.dtype);
+  if (group_size != 32 && group_size != 64 && group_size != 128) {
+    std::ostringstream msg;
+    msg << "[load_quantized] The requested group size " << group_size
+        << " is not supported. The supported group sizes are 32, 64 and 128.";
+    throw std::invalid_argument(msg.str());
+  }
+  if (bits != 2 && bits != 4 && bits != 8) {
+    std::ostringstream msg;
+    msg << "[load_quantized] The requested number of bits " << bits
+        << " is not supported. The supported bits are 2, 4 and 8.";
+    throw std::invalid_argument(msg.str());
+  }
+  if (out_type != float32 && out_type != float16 && out_type != bfloat16) {
+    std::ostringstream msg;
+    msg << "[load_quantized] Only real floating types are supported but "
+        << key << " would be quantized with type " << out_type << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (info.shape.size() < 2 || info.shape.back() % group_size != 0) {
+    std::ostringstream msg;
+    msg << "[load_quantized] Cannot quantize " << key << " with shape "
+        << info.shape << ". It needs at least 2 dimensions and the last one "
+        << "must be divisible by the group size " << group_size << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
+  auto wshape = info.shape;
+  auto sshape = info.shape;
+  wshape.back() = wshape.back() * bits / 32;
+  sshape.back() = sshape.back() / group_size;
+  auto outputs = array::make_arrays(
+      {wshape, sshape, sshape},
+      {uint32, out_type, out_type},
+      std::make_shared<LoadQuantized>(
+          to_stream(s), in_stream_, info.offset, info.dtype, group_size, bits),
+      {});
+  return {outputs[0], outputs[1], outputs[2]};
+}
+
+std::unordered_map<std::string, array> Checkpoint::load(
+    const std::vector<std::string>& keys,
+    StreamOrDevice s) const {
+  std::unordered_map<std::string, array> res;
+  for (auto& key : keys) {
+    res.insert({key, load(key, s)});
+  }
+  return res;
+}
+
+std::unordered_map<std::string, array> Checkpoint::load(
+    const TensorFilter& filter,
+    StreamOrDevice s) const {
+  std::unordered_map<std::string, array> res;
+  for (auto& [key, info] : tensors_) {
+    if (filter(key)) {
+      res.insert({key, load(key, s)});
+    }
+  }
+  return res;
+}
+
+std::unordered_map<std::string, array> Checkpoint::load_prefix(
+    const std::string& prefix,
+    StreamOrDevice s) const {
+  // The names are sorted so the matches are contiguous
+  std::unordered_map<std::string, array> res;
+  for (auto it = tensors_.lower_bound(prefix);
+       it != tensors_.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it) {
+    res.insert({it->first, load(it->first, s)});
+  }
+  return res;
+}
+
+/** Load array map from .npz file format */
+std::unordered_map<std::string, array> load_npz(
+    std::shared_ptr<io::Reader> in_stream,
+    StreamOrDevice s) {
+  if (!in_stream->good() || !in_stream->is_open()) {
+    throw std::runtime_error(
+        "[load_npz] Failed to open " + in_stream->label());
+  }
+  io::ZipReader zip(in_stream);
+  auto members = zip.open_all();
+
+  std::unordered_map<std::string, array> array_map;
+  for (int i = 0; i < members.size(); ++i) {
+    // Remove .npy from the member name if it is there
+    auto key = zip.entries()[i].name;
+    if (key.length() > 4 && key.substr(key.length() - 4, 4) == ".npy") {
+      key = key.substr(0, key.length() - 4);
+    }
+    array_map.insert({key, load(members[i], s)});
+  }
+  return array_map;
+}
+
+std::unordered_map<std::string, array> load_npz(
+    const std::string& file,
+    StreamOrDevice s) {
+  return load_npz(std::make_shared<io::ParallelFileReader>(file), s);
+}
+
+/** Save array map to .npz file format */
+void save_npz(
+    std::shared_ptr<io::Writer> out_stream,
+    std::unordered_map<std::string, array> array_map,
+    bool compressed) {
+  // Evaluate everything up front, the members are serialized in parallel
+  std::vector<array> arrays;
+  for (auto& [key, arr] : array_map) {
+    arrays.push_back(arr);
+  }
+  eval(arrays);
+
+  std::vector<std::string> headers;
+  std::vector<io::ZipMember> members;
+  headers.reserve(array_map.size());
+  for (auto& [key, arr] : array_map) {
+    arr = prepare_to_save(arr);
+    headers.push_back(npy_header(arr));
+    members.push_back(
+        {key + ".npy",
+         {{headers.back().data(), headers.back().size()},
+          {arr.data<char>(), arr.nbytes()}}});
+  }
+  io::write_zip(*out_stream, members, compressed);
+}
+
+void save_npz(
+    std::string file,
+    std::unordered_map<std::string, array> array_map,
+    bool compressed) {
+  // Add .npz to file name if it is not there
+  if (file.length() < 4 || file.substr(file.length() - 4, 4) != ".npz") {
+    file += ".npz";
+  }
+  save_npz(
+      std::make_shared<io::ParallelFileWriter>(std::move(file)),
+      std::move(array_map),
+      compressed);
+}
+
+namespace io {
+
+ParallelFileReader::ParallelFileReader(std::string file_path)
+    : fd_(open(file_path.c_str(), O_RDONLY)),
+      label_("file " + std::move(file_path)) {}
+
+ParallelFileReader::ParallelFileReader(int fd, std::string label)
+    : fd_(fd), label_(std::move(label)) {}
+
+ParallelFileReader::~ParallelFileReader() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void ParallelFileReader::seek(int64_t off, std::ios_base::seekdir way) {
+  if (way == std::ios_base::beg) {
+    pos_ = off;
+  } else if (way == std::ios_base::cur) {
+    pos_ += off;
+  } else {
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+      throw std::runtime_error("[read] Failed to stat " + label_);
+    }
+    pos_ = st.st_size + off;
+  }
+}
+
+void ParallelFileReader::read(char* data, size_t n, size_t offset) {
+  // pread may return fewer bytes than requested
+  while (n > 0) {
+    auto bytes = pread(fd_, data, std::min<size_t>(n, 1 << 30), offset);
+    if (bytes <= 0) {
+      throw std::runtime_error("[read] Unable to read from " + label_);
+    }
+    data += bytes;
+    offset += bytes;
+    n -= bytes;
+  }
+}
+
+ParallelFileWriter::ParallelFileWriter(std::string file_path)
+    : fd_(open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)),
+      label_("file " + std::move(file_path)) {}
+
+ParallelFileWriter::ParallelFileWriter(int fd, size_t offset, std::string label)
+    : fd_(fd), pos_(offset), label_(std::move(label)) {}
+
+ParallelFileWriter::~ParallelFileWriter() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void ParallelFileWriter::seek(int64_t off, std::ios_base::seekdir way) {
+  if (way == std::ios_base::beg) {
+    pos_ = off;
+  } else if (way == std::ios_base::cur) {
+    pos_ += off;
+  } else {
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+      throw std::runtime_error("[write] Failed to stat " + label_);
+    }
+    pos_ = st.st_size + off;
+  }
+}
+
+void ParallelFileWriter::write(const char* data, size_t n) {
+  while (n > 0) {
+    auto bytes = pwrite(fd_, data, std::min<size_t>(n, 1 << 30), pos_);
+    if (bytes <= 0) {
+      throw std::runtime_error("[write] Unable to write to " + label_);
+    }
+    data += bytes;
+    pos_ += bytes;
+    n -= bytes;
+  }
+}
+
+} // namespace io
+
 } // namespace mlx::core
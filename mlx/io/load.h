@@ -5,6 +5,7 @@
 #include <fstream>
 #include <istream>
 #include <memory>
+#include <string>
 
 namespace mlx::core {
 
@@ -19,7 +20,13 @@ class Reader {
       int64_t off,
       std::ios_base::seekdir way = std::ios_base::beg) = 0;
   virtual void read(char* data, size_t n) = 0;
+  // Read n bytes at offset without moving the read position
+  virtual void read(char* data, size_t n, size_t offset) = 0;
   virtual std::string label() const = 0;
+  // Whether reads at an offset may run from several threads at once
+  virtual bool concurrent_reads() const {
+    return false;
+  }
 };
 
 class Writer {
@@ -63,6 +70,13 @@ class FileReader : public Reader {
     is_.read(data, n);
   }
 
+  void read(char* data, size_t n, size_t offset) override {
+    auto pos = is_.tellg();
+    is_.seekg(offset);
+    is_.read(data, n);
+    is_.seekg(pos);
+  }
+
   std::string label() const override {
     return "file " + label_;
   }
@@ -72,6 +86,51 @@ class FileReader : public Reader {
   std::string label_;
 };
 
+// Reads a file descriptor with pread, so reads at an offset are thread safe
+// and never touch the Python interpreter when the descriptor comes from a
+// Python file object. The reader owns the descriptor.
+class ParallelFileReader : public Reader {
+ public:
+  explicit ParallelFileReader(std::string file_path);
+  ParallelFileReader(int fd, std::string label);
+  ~ParallelFileReader();
+
+  bool is_open() const override {
+    return fd_ >= 0;
+  }
+
+  bool good() const override {
+    return is_open();
+  }
+
+  size_t tell() override {
+    return pos_;
+  }
+
+  void seek(int64_t off, std::ios_base::seekdir way = std::ios_base::beg)
+      override;
+
+  void read(char* data, size_t n) override {
+    read(data, n, pos_);
+    pos_ += n;
+  }
+
+  void read(char* data, size_t n, size_t offset) override;
+
+  std::string label() const override {
+    return label_;
+  }
+
+  bool concurrent_reads() const override {
+    return true;
+  }
+
+ private:
+  int fd_;
+  size_t pos_{0};
+  std::string label_;
+};
+
 class FileWriter : public Writer {
  public:
   explicit FileWriter(std::ofstream os)
@@ -110,5 +169,40 @@ class FileWriter : public Writer {
   std::string label_;
 };
 
+// Writes a file descriptor with pwrite starting at a given offset. The writer
+// owns the descriptor.
+class ParallelFileWriter : public Writer {
+ public:
+  explicit ParallelFileWriter(std::string file_path);
+  ParallelFileWriter(int fd, size_t offset, std::string label);
+  ~ParallelFileWriter();
+
+  bool is_open() const override {
+    return fd_ >= 0;
+  }
+
+  bool good() const override {
+    return is_open();
+  }
+
+  size_t tell() override {
+    return pos_;
+  }
+
+  void seek(int64_t off, std::ios_base::seekdir way = std::ios_base::beg)
+      override;
+
+  void write(const char* data, size_t n) override;
+
+  std::string label() const override {
+    return label_;
+  }
+
+ private:
+  int fd_;
+  size_t pos_{0};
+  std::string label_;
+};
+
 } // namespace io
 } // namespace mlx::core
@@ -0,0 +1,39 @@
+// Copyright © 2024 Apple Inc.
+
+#include <array>
+#include <stdexcept>
+
+#include "mlx/io/zip.h"
+
+namespace mlx::core::io::detail {
+
+uint32_t crc32(uint32_t crc, const char* data, size_t n) {
+  static const auto table = []() {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+    return table;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < n; ++i) {
+    crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+std::vector<char> deflate(const std::vector<std::pair<const char*, size_t>>&) {
+  throw std::runtime_error(
+      "[deflate] Compile with zlib to write compressed zip archives.");
+}
+
+void inflate(const char*, size_t, char*, size_t) {
+  throw std::runtime_error(
+      "[inflate] Compile with zlib to read compressed zip archives.");
+}
+
+} // namespace mlx::core::io::detail
@@ -4,7 +4,7 @@
 
 namespace mlx::core {
 
-GGUFLoad load_gguf(const std::string&, StreamOrDevice s) {
+GGUFLoad load_gguf(const std::string&, StreamOrDevice, const TensorFilter&) {
   throw std::runtime_error(
       "[load_gguf] Compile with MLX_BUILD_GGUF=ON to enable GGUF support.");
 }
@@ -4,6 +4,18 @@
 
 namespace mlx::core {
 
+Checkpoint open_safetensors(std::shared_ptr<io::Reader>) {
+  throw std::runtime_error(
+      "[open_safetensors] Compile with MLX_BUILD_SAFETENSORS=ON "
+      "to enable safetensors support.");
+}
+
+Checkpoint open_safetensors(const std::string&) {
+  throw std::runtime_error(
+      "[open_safetensors] Compile with MLX_BUILD_SAFETENSORS=ON "
+      "to enable safetensors support.");
+}
+
 SafetensorsLoad load_safetensors(std::shared_ptr<io::Reader>, StreamOrDevice) {
   throw std::runtime_error(
       "[load_safetensors] Compile with MLX_BUILD_SAFETENSORS=ON "
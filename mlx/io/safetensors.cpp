@@ -94,10 +94,8 @@ Dtype dtype_from_safetensor_str(std::string_view str) {
   }
 }
 
-/** Load array from reader in safetensor format */
-SafetensorsLoad load_safetensors(
-    std::shared_ptr<io::Reader> in_stream,
-    StreamOrDevice s) {
+/** Read the tensor table of a reader in safetensor format */
+Checkpoint open_safetensors(std::shared_ptr<io::Reader> in_stream) {
   ////////////////////////////////////////////////////////
   // Open and check file
   if (!in_stream->good() || !in_stream->is_open()) {
@@ -121,8 +119,8 @@ SafetensorsLoad load_safetensors(
         "[load_safetensors] Invalid json metadata " + in_stream->label());
   }
   size_t offset = jsonHeaderLength + 8;
-  // Load the arrays using metadata
-  std::unordered_map<std::string, array> res;
+  // Collect the tensor locations, nothing else is read from the file
+  std::map<std::string, TensorInfo> tensors;
   std::unordered_map<std::string, std::string> metadata_map;
   for (const auto& item : metadata.items()) {
     if (item.key() == "__metadata__") {
@@ -135,19 +133,37 @@ SafetensorsLoad load_safetensors(
     const std::vector<int>& shape = item.value().at("shape");
     const std::vector<size_t>& data_offsets = item.value().at("data_offsets");
     Dtype type = dtype_from_safetensor_str(dtype);
-    auto loaded_array = array(
-        shape,
-        type,
-        std::make_shared<Load>(
-            to_stream(s), in_stream, offset + data_offsets.at(0), false),
-        std::vector<array>{});
-    res.insert({item.key(), loaded_array});
+    size_t nbytes = type.size;
+    for (auto d : shape) {
+      nbytes *= d;
+    }
+    if (data_offsets.size() != 2 ||
+        data_offsets[1] - data_offsets[0] != nbytes) {
+      throw std::runtime_error(
+          "[load_safetensors] Invalid data offsets for " + item.key() +
+          " in " + in_stream->label());
+    }
+    tensors.insert(
+        {item.key(), {shape, type, offset + data_offsets[0], nbytes}});
   }
-  return {res, metadata_map};
+  return Checkpoint(
+      std::move(in_stream), std::move(tensors), std::move(metadata_map));
+}
+
+Checkpoint open_safetensors(const std::string& file) {
+  return open_safetensors(std::make_shared<io::ParallelFileReader>(file));
+}
+
+/** Load array from reader in safetensor format */
+SafetensorsLoad load_safetensors(
+    std::shared_ptr<io::Reader> in_stream,
+    StreamOrDevice s) {
+  auto checkpoint = open_safetensors(std::move(in_stream));
+  return {checkpoint.load_prefix("", s), checkpoint.metadata()};
 }
 
 SafetensorsLoad load_safetensors(const std::string& file, StreamOrDevice s) {
-  return load_safetensors(std::make_shared<io::FileReader>(file), s);
+  return load_safetensors(std::make_shared<io::ParallelFileReader>(file), s);
 }
 
 void save_safetensors(
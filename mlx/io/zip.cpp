@@ -0,0 +1,497 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <ctime>
+#include <stdexcept>
+
+#include "mlx/backend/common/threading.h"
+#include "mlx/io/zip.h"
+
+namespace mlx::core::io {
+
+namespace {
+
+constexpr uint32_t local_header_sig = 0x04034b50;
+constexpr uint32_t central_header_sig = 0x02014b50;
+constexpr uint32_t end_of_central_dir_sig = 0x06054b50;
+constexpr uint32_t zip64_end_of_central_dir_sig = 0x06064b50;
+constexpr uint32_t zip64_locator_sig = 0x07064b50;
+constexpr uint16_t zip64_extra_id = 0x0001;
+
+constexpr size_t local_header_size = 30;
+constexpr size_t central_header_size = 46;
+constexpr size_t end_of_central_dir_size = 22;
+constexpr size_t zip64_end_of_central_dir_size = 56;
+constexpr size_t zip64_locator_size = 20;
+
+constexpr uint64_t max_u16 = 0xFFFF;
+constexpr uint64_t max_u32 = 0xFFFFFFFF;
+
+// Deflate expands data by at most this factor
+constexpr uint64_t max_deflate_ratio = 1032;
+
+// Zip archives are little endian regardless of the host
+template <typename T>
+T get(const char* p) {
+  T v = 0;
+  for (int i = sizeof(T) - 1; i >= 0; --i) {
+    v = (v << 8) | static_cast<uint8_t>(p[i]);
+  }
+  return v;
+}
+
+template <typename T>
+void put(std::string& s, T v) {
+  for (int i = 0; i < sizeof(T); ++i) {
+    s.push_back(static_cast<char>(v & 0xFF));
+    v >>= 8;
+  }
+}
+
+// The current local time in MS-DOS format
+std::pair<uint16_t, uint16_t> dos_time() {
+  std::time_t now = std::time(nullptr);
+  std::tm t;
+  localtime_r(&now, &t);
+  uint16_t time = (t.tm_hour << 11) | (t.tm_min << 5) | (t.tm_sec / 2);
+  uint16_t date = ((t.tm_year - 80) << 9) | ((t.tm_mon + 1) << 5) | t.tm_mday;
+  return {time, date};
+}
+
+// A stored member read in place from the archive
+class ZipMemberReader : public Reader {
+ public:
+  ZipMemberReader(
+      std::shared_ptr<Reader> in,
+      size_t offset,
+      size_t size,
+      std::string label)
+      : in_(std::move(in)),
+        offset_(offset),
+        size_(size),
+        label_(std::move(label)) {}
+
+  bool is_open() const override {
+    return in_->is_open();
+  }
+
+  bool good() const override {
+    return in_->good();
+  }
+
+  size_t tell() override {
+    return pos_;
+  }
+
+  void seek(int64_t off, std::ios_base::seekdir way = std::ios_base::beg)
+      override {
+    if (way == std::ios_base::beg) {
+      pos_ = off;
+    } else if (way == std::ios_base::cur) {
+      pos_ += off;
+    } else {
+      pos_ = size_ + off;
+    }
+  }
+
+  void read(char* data, size_t n) override {
+    read(data, n, pos_);
+    pos_ += n;
+  }
+
+  void read(char* data, size_t n, size_t offset) override {
+    if (offset + n > size_) {
+      throw std::runtime_error("[zip] Read past the end of " + label_);
+    }
+    in_->read(data, n, offset_ + offset);
+  }
+
+  std::string label() const override {
+    return label_;
+  }
+
+  bool concurrent_reads() const override {
+    return in_->concurrent_reads();
+  }
+
+ private:
+  std::shared_ptr<Reader> in_;
+  size_t offset_;
+  size_t size_;
+  size_t pos_{0};
+  std::string label_;
+};
+
+// A deflated member inflated into memory
+class MemoryReader : public Reader {
+ public:
+  MemoryReader(std::vector<char> data, std::string label)
+      : data_(std::move(data)), label_(std::move(label)) {}
+
+  bool is_open() const override {
+    return true;
+  }
+
+  bool good() const override {
+    return true;
+  }
+
+  size_t tell() override {
+    return pos_;
+  }
+
+  void seek(int64_t off, std::ios_base::seekdir way = std::ios_base::beg)
+      override {
+    if (way == std::ios_base::beg) {
+      pos_ = off;
+    } else if (way == std::ios_base::cur) {
+      pos_ += off;
+    } else {
+      pos_ = data_.size() + off;
+    }
+  }
+
+  void read(char* data, size_t n) override {
+    read(data, n, pos_);
+    pos_ += n;
+  }
+
+  void read(char* data, size_t n, size_t offset) override {
+    if (offset + n > data_.size()) {
+      throw std::runtime_error("[zip] Read past the end of " + label_);
+    }
+    std::copy_n(data_.data() + offset, n, data);
+  }
+
+  std::string label() const override {
+    return label_;
+  }
+
+  bool concurrent_reads() const override {
+    return true;
+  }
+
+ private:
+  std::vector<char> data_;
+  size_t pos_{0};
+  std::string label_;
+};
+
+} // namespace
+
+ZipReader::ZipReader(std::shared_ptr<Reader> in) : in_(std::move(in)) {
+  if (!in_->good() || !in_->is_open()) {
+    throw std::runtime_error("[zip] Failed to open " + in_->label());
+  }
+  in_->seek(0, std::ios_base::end);
+  size_t size = in_->tell();
+  size_ = size;
+
+  // The end of central directory record is followed by a comment of at most
+  // 64KB
+  size_t tail_size = std::min<size_t>(size, end_of_central_dir_size + max_u16);
+  std::vector<char> tail(tail_size);
+  in_->read(tail.data(), tail_size, size - tail_size);
+  int64_t loc = static_cast<int64_t>(tail_size) - end_of_central_dir_size;
+  for (; loc >= 0; --loc) {
+    if (get<uint32_t>(&tail[loc]) == end_of_central_dir_sig) {
+      break;
+    }
+  }
+  if (loc < 0) {
+    throw std::invalid_argument(
+        "[zip] Could not find a zip archive in " + in_->label() + ".");
+  }
+  const char* eocd = &tail[loc];
+  size_t eocd_pos = size - tail_size + loc;
+  uint64_t n_entries = get<uint16_t>(eocd + 10);
+  uint64_t cd_size = get<uint32_t>(eocd + 12);
+  uint64_t cd_offset = get<uint32_t>(eocd + 16);
+  size_t cd_end = eocd_pos;
+
+  // Zip64 archives keep the directory location in a record before the
+  // locator
+  if (eocd_pos >= zip64_locator_size + zip64_end_of_central_dir_size) {
+    char locator[zip64_locator_size];
+    in_->read(locator, zip64_locator_size, eocd_pos - zip64_locator_size);
+    if (get<uint32_t>(locator) == zip64_locator_sig) {
+      cd_end = eocd_pos - zip64_locator_size - zip64_end_of_central_dir_size;
+      char record[zip64_end_of_central_dir_size];
+      in_->read(record, zip64_end_of_central_dir_size, cd_end);
+      if (get<uint32_t>(record) != zip64_end_of_central_dir_sig) {
+        throw std::runtime_error(
+            "[zip] Invalid zip64 directory record in " + in_->label() + ".");
+      }
+      n_entries = get<uint64_t>(record + 32);
+      cd_size = get<uint64_t>(record + 40);
+      cd_offset = get<uint64_t>(record + 48);
+    }
+  }
+
+  // The archive may be preceded by other data, like a self extracting zip
+  if (cd_size > cd_end || cd_offset > cd_end - cd_size) {
+    throw std::runtime_error(
+        "[zip] Invalid central directory in " + in_->label() + ".");
+  }
+  base_ = cd_end - cd_size - cd_offset;
+
+  std::vector<char> cd(cd_size);
+  in_->read(cd.data(), cd_size, base_ + cd_offset);
+  size_t pos = 0;
+  for (uint64_t i = 0; i < n_entries; ++i) {
+    const char* h = cd.data() + pos;
+    if (pos + central_header_size > cd_size ||
+        get<uint32_t>(h) != central_header_sig) {
+      throw std::runtime_error(
+          "[zip] Invalid central directory in " + in_->label() + ".");
+    }
+    ZipEntry entry;
+    uint16_t flags = get<uint16_t>(h + 8);
+    entry.method = get<uint16_t>(h + 10);
+    entry.crc = get<uint32_t>(h + 16);
+    entry.compressed_size = get<uint32_t>(h + 20);
+    entry.size = get<uint32_t>(h + 24);
+    size_t name_len = get<uint16_t>(h + 28);
+    size_t extra_len = get<uint16_t>(h + 30);
+    size_t comment_len = get<uint16_t>(h + 32);
+    entry.header_offset = get<uint32_t>(h + 42);
+    size_t entry_size =
+        central_header_size + name_len + extra_len + comment_len;
+    if (pos + entry_size > cd_size) {
+      throw std::runtime_error(
+          "[zip] Invalid central directory in " + in_->label() + ".");
+    }
+    entry.name.assign(h + central_header_size, name_len);
+
+    // Fields which overflow 32 bits are kept in the zip64 extra field in
+    // this order
+    const char* extra = h + central_header_size + name_len;
+    const char* extra_end = extra + extra_len;
+    while (extra + 4 <= extra_end) {
+      uint16_t id = get<uint16_t>(extra);
+      const char* field = extra + 4;
+      const char* field_end =
+          std::min(field + get<uint16_t>(extra + 2), extra_end);
+      if (id == zip64_extra_id) {
+        for (auto v :
+             {&entry.size, &entry.compressed_size, &entry.header_offset}) {
+          if (*v == max_u32 && field + 8 <= field_end) {
+            *v = get<uint64_t>(field);
+            field += 8;
+          }
+        }
+      }
+      extra = field_end;
+    }
+
+    if (flags & 1) {
+      throw std::invalid_argument(
+          "[zip] Encrypted member " + entry.name + " in " + in_->label() +
+          " is not supported.");
+    }
+    if (entry.method != 0 && entry.method != 8) {
+      throw std::invalid_argument(
+          "[zip] Member " + entry.name + " in " + in_->label() +
+          " uses an unsupported compression method.");
+    }
+    entries_.push_back(std::move(entry));
+    pos += entry_size;
+  }
+}
+
+std::shared_ptr<Reader> ZipReader::open(const ZipEntry& entry) {
+  auto label = entry.name + " in " + in_->label();
+  if (entry.header_offset > size_ - base_ ||
+      size_ - base_ - entry.header_offset < local_header_size) {
+    throw std::runtime_error("[zip] Invalid local header for " + label);
+  }
+  char header[local_header_size];
+  in_->read(header, local_header_size, base_ + entry.header_offset);
+  if (get<uint32_t>(header) != local_header_sig) {
+    throw std::runtime_error("[zip] Invalid local header for " + label);
+  }
+  size_t offset = base_ + entry.header_offset + local_header_size +
+      get<uint16_t>(header + 26) + get<uint16_t>(header + 28);
+
+  // Check the sizes before reading or allocating anything
+  if (offset > size_ || entry.compressed_size > size_ - offset ||
+      (entry.method == 0 && entry.size != entry.compressed_size) ||
+      entry.size / max_deflate_ratio > entry.compressed_size) {
+    throw std::runtime_error("[zip] Invalid member size for " + label);
+  }
+
+  if (entry.method == 0) {
+    return std::make_shared<ZipMemberReader>(in_, offset, entry.size, label);
+  }
+
+  std::vector<char> compressed(entry.compressed_size);
+  in_->read(compressed.data(), compressed.size(), offset);
+  std::vector<char> data(entry.size);
+  detail::inflate(
+      compressed.data(), compressed.size(), data.data(), data.size());
+  if (detail::crc32(0, data.data(), data.size()) != entry.crc) {
+    throw std::runtime_error("[zip] Checksum mismatch for " + label);
+  }
+  return std::make_shared<MemoryReader>(std::move(data), label);
+}
+
+std::vector<std::shared_ptr<Reader>> ZipReader::open_all() {
+  std::vector<std::shared_ptr<Reader>> members(entries_.size());
+  auto open_range = [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      members[i] = open(entries_[i]);
+    }
+  };
+  if (in_->concurrent_reads()) {
+    parallel_for(entries_.size(), 1, open_range);
+  } else {
+    open_range(0, entries_.size());
+  }
+  return members;
+}
+
+void write_zip(
+    Writer& out,
+    const std::vector<ZipMember>& members,
+    bool compressed) {
+  if (!out.good() || !out.is_open()) {
+    throw std::runtime_error("[zip] Failed to open " + out.label());
+  }
+
+  // Offsets are relative to the start of the archive
+  size_t pos = 0;
+  auto write = [&](const char* data, size_t n) {
+    out.write(data, n);
+    pos += n;
+  };
+  auto [time, date] = dos_time();
+  uint16_t method = compressed ? 8 : 0;
+  std::string central_dir;
+
+  // Checksum and compress a batch of members at a time to bound the memory
+  // held by compressed members
+  size_t batch_size = max_threads();
+  for (size_t start = 0; start < members.size(); start += batch_size) {
+    size_t n = std::min(batch_size, members.size() - start);
+    std::vector<uint32_t> crcs(n, 0);
+    std::vector<std::vector<char>> deflated(n);
+    parallel_for(n, 1, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        for (auto [data, size] : members[start + i].chunks) {
+          crcs[i] = detail::crc32(crcs[i], data, size);
+        }
+        if (compressed) {
+          deflated[i] = detail::deflate(members[start + i].chunks);
+        }
+      }
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+      auto& member = members[start + i];
+      uint64_t size = 0;
+      for (auto [data, len] : member.chunks) {
+        size += len;
+      }
+      uint64_t compressed_size = compressed ? deflated[i].size() : size;
+      uint64_t offset = pos;
+      bool zip64 = size >= max_u32 || compressed_size >= max_u32;
+      uint16_t version = (zip64 || offset >= max_u32) ? 45 : 20;
+
+      std::string header;
+      put<uint32_t>(header, local_header_sig);
+      put<uint16_t>(header, version);
+      put<uint16_t>(header, 0);
+      put<uint16_t>(header, method);
+      put<uint16_t>(header, time);
+      put<uint16_t>(header, date);
+      put<uint32_t>(header, crcs[i]);
+      put<uint32_t>(header, zip64 ? max_u32 : compressed_size);
+      put<uint32_t>(header, zip64 ? max_u32 : size);
+      put<uint16_t>(header, member.name.size());
+      put<uint16_t>(header, zip64 ? 20 : 0);
+      header += member.name;
+      if (zip64) {
+        put<uint16_t>(header, zip64_extra_id);
+        put<uint16_t>(header, 16);
+        put<uint64_t>(header, size);
+        put<uint64_t>(header, compressed_size);
+      }
+      write(header.data(), header.size());
+      if (compressed) {
+        write(deflated[i].data(), deflated[i].size());
+        deflated[i] = {};
+      } else {
+        for (auto [data, len] : member.chunks) {
+          write(data, len);
+        }
+      }
+
+      std::string extra;
+      if (zip64) {
+        put<uint64_t>(extra, size);
+        put<uint64_t>(extra, compressed_size);
+      }
+      if (offset >= max_u32) {
+        put<uint64_t>(extra, offset);
+      }
+      put<uint32_t>(central_dir, central_header_sig);
+      put<uint16_t>(central_dir, (3 << 8) | version);
+      put<uint16_t>(central_dir, version);
+      put<uint16_t>(central_dir, 0);
+      put<uint16_t>(central_dir, method);
+      put<uint16_t>(central_dir, time);
+      put<uint16_t>(central_dir, date);
+      put<uint32_t>(central_dir, crcs[i]);
+      put<uint32_t>(central_dir, zip64 ? max_u32 : compressed_size);
+      put<uint32_t>(central_dir, zip64 ? max_u32 : size);
+      put<uint16_t>(central_dir, member.name.size());
+      put<uint16_t>(central_dir, extra.empty() ? 0 : extra.size() + 4);
+      put<uint16_t>(central_dir, 0);
+      put<uint16_t>(central_dir, 0);
+      put<uint16_t>(central_dir, 0);
+      put<uint32_t>(central_dir, 0100644u << 16);
+      put<uint32_t>(central_dir, std::min(offset, max_u32));
+      central_dir += member.name;
+      if (!extra.empty()) {
+        put<uint16_t>(central_dir, zip64_extra_id);
+        put<uint16_t>(central_dir, extra.size());
+        central_dir += extra;
+      }
+    }
+  }
+
+  uint64_t cd_offset = pos;
+  uint64_t cd_size = central_dir.size();
+  uint64_t n_entries = members.size();
+  write(central_dir.data(), central_dir.size());
+
+  std::string end;
+  if (n_entries >= max_u16 || cd_offset >= max_u32 || cd_size >= max_u32) {
+    uint64_t record_offset = pos;
+    put<uint32_t>(end, zip64_end_of_central_dir_sig);
+    put<uint64_t>(end, zip64_end_of_central_dir_size - 12);
+    put<uint16_t>(end, 45);
+    put<uint16_t>(end, 45);
+    put<uint32_t>(end, 0);
+    put<uint32_t>(end, 0);
+    put<uint64_t>(end, n_entries);
+    put<uint64_t>(end, n_entries);
+    put<uint64_t>(end, cd_size);
+    put<uint64_t>(end, cd_offset);
+    put<uint32_t>(end, zip64_locator_sig);
+    put<uint32_t>(end, 0);
+    put<uint64_t>(end, record_offset);
+    put<uint32_t>(end, 1);
+  }
+  put<uint32_t>(end, end_of_central_dir_sig);
+  put<uint16_t>(end, 0);
+  put<uint16_t>(end, 0);
+  put<uint16_t>(end, std::min(n_entries, max_u16));
+  put<uint16_t>(end, std::min(n_entries, max_u16));
+  put<uint32_t>(end, std::min(cd_size, max_u32));
+  put<uint32_t>(end, std::min(cd_offset, max_u32));
+  put<uint16_t>(end, 0);
+  write(end.data(), end.size());
+}
+
+} // namespace mlx::core::io
@@ -0,0 +1,73 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mlx/io/load.h"
+
+namespace mlx::core::io {
+
+struct ZipEntry {
+  std::string name;
+  uint16_t method;
+  uint32_t crc;
+  uint64_t compressed_size;
+  uint64_t size;
+  uint64_t header_offset;
+};
+
+// Reads the members of a stored or deflated zip archive. The archive may
+// start anywhere in the reader, offsets are resolved from the central
+// directory at its end.
+class ZipReader {
+ public:
+  explicit ZipReader(std::shared_ptr<Reader> in);
+
+  const std::vector<ZipEntry>& entries() const {
+    return entries_;
+  }
+
+  // Stored members are read in place through the archive reader, deflated
+  // members are inflated into memory
+  std::shared_ptr<Reader> open(const ZipEntry& entry);
+
+  // Open every member, inflating the deflated ones in parallel when the
+  // archive reader supports concurrent reads
+  std::vector<std::shared_ptr<Reader>> open_all();
+
+ private:
+  std::shared_ptr<Reader> in_;
+  size_t base_;
+  size_t size_;
+  std::vector<ZipEntry> entries_;
+};
+
+// A member of a zip archive to write, given as buffers written back to back
+struct ZipMember {
+  std::string name;
+  std::vector<std::pair<const char*, size_t>> chunks;
+};
+
+// Write a zip archive with the given members, deflating them if compressed
+// is set. Checksums and compression run on several threads.
+void write_zip(
+    Writer& out,
+    const std::vector<ZipMember>& members,
+    bool compressed);
+
+namespace detail {
+
+// Implemented with zlib when it is available, see deflate.cpp
+uint32_t crc32(uint32_t crc, const char* data, size_t n);
+std::vector<char> deflate(
+    const std::vector<std::pair<const char*, size_t>>& chunks);
+void inflate(const char* src, size_t src_size, char* dst, size_t dst_size);
+
+} // namespace detail
+
+} // namespace mlx::core::io
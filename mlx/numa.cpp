@@ -0,0 +1,143 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mlx/numa.h"
+
+namespace mlx::core::numa {
+
+namespace {
+
+thread_local CpuAffinity thread_affinity;
+
+// Parse a list of cores in the kernel format e.g. 0-3,8,10-11
+std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> cores;
+  std::istringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = first;
+    if (dash != std::string::npos) {
+      last = std::stoi(range.substr(dash + 1));
+    }
+    for (int c = first; c <= last; ++c) {
+      cores.push_back(c);
+    }
+  }
+  return cores;
+}
+
+std::vector<int> node_cores(int node) {
+  std::ifstream f(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (!f || !std::getline(f, list)) {
+    throw std::invalid_argument(
+        "[new_stream] NUMA node " + std::to_string(node) + " does not exist.");
+  }
+  return parse_cpu_list(list);
+}
+
+} // namespace
+
+bool is_available() {
+#ifdef __linux__
+  return true;
+#else
+  return false;
+#endif
+}
+
+CpuAffinity resolve(CpuAffinity affinity) {
+  if (!is_available()) {
+    throw std::invalid_argument(
+        "[new_stream] CPU affinity is only supported on Linux.");
+  }
+  if (affinity.numa_node < 0 && affinity.cores.empty()) {
+    throw std::invalid_argument(
+        "[new_stream] The affinity needs a NUMA node or a set of cores.");
+  }
+  if (affinity.cores.empty()) {
+    affinity.cores = node_cores(affinity.numa_node);
+  } else if (affinity.numa_node >= 0) {
+    auto allowed = node_cores(affinity.numa_node);
+    for (auto c : affinity.cores) {
+      if (std::find(allowed.begin(), allowed.end(), c) == allowed.end()) {
+        throw std::invalid_argument(
+            "[new_stream] Core " + std::to_string(c) +
+            " is not on NUMA node " + std::to_string(affinity.numa_node) +
+            ".");
+      }
+    }
+  }
+#ifdef __linux__
+  int n_cores = std::min<int>(sysconf(_SC_NPROCESSORS_CONF), CPU_SETSIZE);
+  for (auto c : affinity.cores) {
+    if (c < 0 || c >= n_cores) {
+      throw std::invalid_argument(
+          "[new_stream] Core " + std::to_string(c) + " does not exist.");
+    }
+  }
+#endif
+  std::sort(affinity.cores.begin(), affinity.cores.end());
+  affinity.cores.erase(
+      std::unique(affinity.cores.begin(), affinity.cores.end()),
+      affinity.cores.end());
+  return affinity;
+}
+
+void bind_current_thread(const CpuAffinity& affinity) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto c : affinity.cores) {
+    CPU_SET(c, &set);
+  }
+  // If the cores are not allowed for this process the thread stays unpinned
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+  thread_affinity = affinity;
+}
+
+const CpuAffinity& current_affinity() {
+  return thread_affinity;
+}
+
+void bind_memory(void* ptr, size_t size, int node) {
+#ifdef __linux__
+  constexpr int mpol_preferred = 1;
+  constexpr size_t bits = 8 * sizeof(unsigned long);
+  size_t page = sysconf(_SC_PAGESIZE);
+  auto begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page;
+  auto end = (reinterpret_cast<uintptr_t>(ptr) + size) / page * page;
+  if (node < 0 || end <= begin) {
+    return;
+  }
+  std::vector<unsigned long> mask(node / bits + 1, 0);
+  mask[node / bits] |= 1UL << (node % bits);
+  syscall(
+      SYS_mbind,
+      begin,
+      end - begin,
+      mpol_preferred,
+      mask.data(),
+      mask.size() * bits + 1,
+      0);
+#endif
+}
+
+} // namespace mlx::core::numa
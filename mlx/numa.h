@@ -0,0 +1,30 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include "mlx/stream.h"
+
+namespace mlx::core::numa {
+
+/** Check if threads can be pinned and memory bound to NUMA nodes. */
+bool is_available();
+
+/**
+ * Validate the affinity and fill in the cores of its NUMA node if no cores
+ * are given. Throws if the node or the cores do not exist.
+ */
+CpuAffinity resolve(CpuAffinity affinity);
+
+/** Pin the calling thread to the cores of a resolved affinity. */
+void bind_current_thread(const CpuAffinity& affinity);
+
+/** The affinity of the calling thread, empty if it is not pinned. */
+const CpuAffinity& current_affinity();
+
+/**
+ * Prefer the given NUMA node for the pages of the buffer which have not been
+ * touched yet. This is best effort and does nothing if it fails.
+ */
+void bind_memory(void* ptr, size_t size, int node);
+
+} // namespace mlx::core::numa
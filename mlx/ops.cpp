@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <climits>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <set>
 #include <sstream>
@@ -50,6 +51,132 @@ Dtype at_least_float(const Dtype& d) {
   return issubdtype(d, inexact) ? d : promote_types(d, float32);
 }
 
+// The (N, O..., K..., C) sliding windows of a (N, ..., C) input padded on
+// both sides of every spatial axis.
+array pool_windows(
+    const array& x,
+    const std::vector<int>& kernel_size,
+    const std::vector<int>& stride,
+    const std::vector<int>& padding,
+    const array& pad_value,
+    StreamOrDevice s) {
+  int n = kernel_size.size();
+  std::vector<int> axes(n);
+  std::iota(axes.begin(), axes.end(), 1);
+  auto padded = pad(x, axes, padding, padding, pad_value, s);
+
+  auto& shape = padded.shape();
+  std::vector<size_t> strides(shape.size(), 1);
+  for (int i = shape.size() - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * shape[i + 1];
+  }
+  std::vector<int> window_shape = {shape[0]};
+  std::vector<size_t> window_strides = {strides[0]};
+  for (int i = 0; i < n; ++i) {
+    window_shape.push_back((shape[i + 1] - kernel_size[i]) / stride[i] + 1);
+    window_strides.push_back(strides[i + 1] * stride[i]);
+  }
+  for (int i = 0; i < n; ++i) {
+    window_shape.push_back(kernel_size[i]);
+    window_strides.push_back(strides[i + 1]);
+  }
+  window_shape.push_back(shape.back());
+  window_strides.push_back(1);
+  return as_strided(padded, window_shape, window_strides, 0, s);
+}
+
+array pool(
+    const std::string& tag,
+    Pooling::PoolType pool_type,
+    array x,
+    std::vector<int> kernel_size,
+    std::vector<int> stride,
+    std::vector<int> padding,
+    StreamOrDevice s) {
+  int n = kernel_size.size();
+  if (n < 1 || n > 3) {
+    std::ostringstream msg;
+    msg << "[" << tag << "] Only 1D, 2D and 3D pooling is supported but the "
+        << "kernel size " << kernel_size << " has " << n << " dimensions.";
+    throw std::invalid_argument(msg.str());
+  }
+  if (x.ndim() != n + 2) {
+    std::ostringstream msg;
+    msg << "[" << tag << "] Expected an input of shape (N, ..., C) with " << n
+        << " spatial dimensions but got shape " << x.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (stride.empty()) {
+    stride = kernel_size;
+  }
+  if (padding.empty()) {
+    padding = std::vector<int>(n, 0);
+  }
+  if (stride.size() != n || padding.size() != n) {
+    std::ostringstream msg;
+    msg << "[" << tag << "] The stride " << stride << " and padding "
+        << padding << " must have one entry per spatial dimension.";
+    throw std::invalid_argument(msg.str());
+  }
+  std::vector<int> out_shape = {x.shape(0)};
+  for (int i = 0; i < n; ++i) {
+    if (kernel_size[i] < 1 || stride[i] < 1 || padding[i] < 0) {
+      std::ostringstream msg;
+      msg << "[" << tag << "] Invalid kernel size " << kernel_size
+          << ", stride " << stride << " or padding " << padding << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    int size = x.shape(i + 1) + 2 * padding[i] - kernel_size[i];
+    if (size < 0) {
+      std::ostringstream msg;
+      msg << "[" << tag << "] The kernel size " << kernel_size
+          << " is larger than the padded input of shape " << x.shape() << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    out_shape.push_back(size / stride[i] + 1);
+  }
+  out_shape.push_back(x.shape(-1));
+  if (issubdtype(x.dtype(), complexfloating)) {
+    throw std::invalid_argument(
+        "[" + tag + "] Pooling is not supported for complex types.");
+  }
+
+  bool is_max = pool_type == Pooling::Max;
+  if (!is_max) {
+    x = astype(x, at_least_float(x.dtype()), s);
+  }
+
+  // The GPU has no pooling kernels so reduce over the sliding windows
+  auto stream = to_stream(s);
+  if (stream.device == Device::gpu) {
+    std::vector<int> axes(n);
+    std::iota(axes.begin(), axes.end(), n + 1);
+    if (is_max) {
+      auto pad_value = issubdtype(x.dtype(), floating)
+          ? array(-std::numeric_limits<float>::infinity(), x.dtype())
+          : min(x, false, s);
+      auto windows =
+          pool_windows(x, kernel_size, stride, padding, pad_value, s);
+      return max(windows, axes, false, s);
+    }
+    auto windows =
+        pool_windows(x, kernel_size, stride, padding, array(0, x.dtype()), s);
+    return mean(windows, axes, false, s);
+  }
+
+  auto dtype = x.dtype();
+  return array(
+      std::move(out_shape),
+      dtype,
+      std::make_shared<Pooling>(
+          stream,
+          pool_type,
+          std::move(kernel_size),
+          std::move(stride),
+          std::move(padding)),
+      {std::move(x)});
+}
+
 array indices_or_default(
     std::optional<array> indices,
     const array& x,
@@ -107,6 +234,20 @@ std::pair<int, int> extract_quantized_matmul_dims(
     throw std::invalid_argument(msg.str());
   }
 
+  // Check that the w matrix will fill up a whole SIMD.
+  // This is an implementation detail of the matmul kernels which should be
+  // removed in the future but at least we bail out early which will result
+  // in a nice readable error. Smaller matrices (e.g. attention heads in a
+  // quantized KV cache) can still be quantized and dequantized.
+  if (w.shape(-1) < 32) {
+    std::ostringstream msg;
+    msg << "[" << tag << "] The feature dimension (2nd dimension of the "
+        << "matrix) is too small for quantized matmul. We support >=512 for "
+        << "2 bits, >= 256 for 4 bits and >= 128 for 8 bits. The provided "
+        << "quantized matrix has shape " << w.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+
   int x_inner_dims = x.shape(-1);
 
   // Calculate the expanded w's dims
@@ -815,6 +956,27 @@ array clip(
   if (!a_min.has_value() && !a_max.has_value()) {
     throw std::invalid_argument("At most one of a_min and a_max may be None");
   }
+  std::vector<array> inputs = {a};
+  for (auto& bound : {a_min, a_max}) {
+    if (bound) {
+      inputs.push_back(*bound);
+    }
+  }
+  auto out_dtype = result_type(inputs);
+  auto stream = to_stream(s);
+  if (stream.device == Device::cpu && out_dtype != complex64) {
+    for (auto& in : inputs) {
+      in = astype(in, out_dtype, s);
+    }
+    inputs = broadcast_arrays(inputs, s);
+    auto shape = inputs[0].shape();
+    return array(
+        std::move(shape),
+        out_dtype,
+        std::make_shared<Clip>(stream, a_min.has_value(), a_max.has_value()),
+        std::move(inputs));
+  }
+
   array result = astype(a, a.dtype(), s);
   if (a_min.has_value()) {
     result = maximum(result, a_min.value(), s);
@@ -3180,9 +3342,14 @@ array conv_general(
     bool flip /* = false */,
     StreamOrDevice s /* = {} */) {
   // Run checks
-  if (groups != 1 && in.ndim() != 3) {
+  if (groups != 1 && in.ndim() > 4) {
+    throw std::invalid_argument(
+        "[conv] Can only handle groups != 1 in 1D or 2D convolutions.");
+  }
+
+  if (groups != 1 && in.ndim() == 4 && to_stream(s).device == Device::gpu) {
     throw std::invalid_argument(
-        "[conv] Can only handle groups != 1 in 1D convolutions.");
+        "[conv] Can only handle groups != 1 in 2D convolutions on the CPU.");
   }
 
   int spatial_dims = in.ndim() - 2;
@@ -3272,6 +3439,7 @@ array conv_general(
           to_stream(s),
           stride,
           padding_lo,
+          padding_hi,
           kernel_dilation,
           input_dilation,
           groups,
@@ -3279,6 +3447,131 @@ array conv_general(
       {in, wt});
 }
 
+array max_pool(
+    const array& x,
+    std::vector<int> kernel_size,
+    std::vector<int> stride /* = {} */,
+    std::vector<int> padding /* = {} */,
+    StreamOrDevice s /* = {} */) {
+  return pool(
+      "max_pool",
+      Pooling::Max,
+      x,
+      std::move(kernel_size),
+      std::move(stride),
+      std::move(padding),
+      s);
+}
+
+array avg_pool(
+    const array& x,
+    std::vector<int> kernel_size,
+    std::vector<int> stride /* = {} */,
+    std::vector<int> padding /* = {} */,
+    StreamOrDevice s /* = {} */) {
+  return pool(
+      "avg_pool",
+      Pooling::Avg,
+      x,
+      std::move(kernel_size),
+      std::move(stride),
+      std::move(padding),
+      s);
+}
+
+array upsample(
+    const array& x,
+    std::vector<double> scale_factor,
+    const std::string& mode /* = "nearest" */,
+    bool align_corners /* = false */,
+    StreamOrDevice s /* = {} */) {
+  int n = static_cast<int>(x.ndim()) - 2;
+  if (n < 1) {
+    std::ostringstream msg;
+    msg << "[upsample] Expected an input of shape (N, ..., C) with at least "
+        << "one spatial dimension but got shape " << x.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  if (scale_factor.size() != n) {
+    std::ostringstream msg;
+    msg << "[upsample] Expected one scale factor per spatial dimension but "
+        << "got " << scale_factor.size() << " for an input of shape "
+        << x.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  Upsample::Mode upsample_mode;
+  if (mode == "nearest") {
+    upsample_mode = Upsample::Nearest;
+  } else if (mode == "linear") {
+    upsample_mode = Upsample::Linear;
+  } else if (mode == "cubic") {
+    upsample_mode = Upsample::Cubic;
+  } else {
+    throw std::invalid_argument(
+        "[upsample] Unsupported mode " + mode +
+        ", expected \"nearest\", \"linear\" or \"cubic\".");
+  }
+  if (issubdtype(x.dtype(), complexfloating)) {
+    throw std::invalid_argument(
+        "[upsample] Upsampling is not supported for complex types.");
+  }
+  auto out_shape = x.shape();
+  bool empty = x.size() == 0;
+  for (int i = 0; i < n; ++i) {
+    if (!(scale_factor[i] > 0)) {
+      std::ostringstream msg;
+      msg << "[upsample] The scale factors must be positive but got "
+          << scale_factor[i] << " for spatial dimension " << i << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    out_shape[i + 1] = static_cast<int>(scale_factor[i] * x.shape(i + 1));
+    empty |= out_shape[i + 1] == 0;
+  }
+
+  // Interpolation produces floating point values
+  auto dtype = upsample_mode == Upsample::Nearest ? x.dtype()
+                                                  : at_least_float(x.dtype());
+  auto stream = to_stream(s);
+  auto primitive = std::make_shared<Upsample>(
+      stream, upsample_mode, std::move(scale_factor), align_corners);
+  if (empty) {
+    return zeros(out_shape, dtype, s);
+  }
+  if (stream.device == Device::cpu) {
+    return array(
+        std::move(out_shape), dtype, primitive, {astype(x, dtype, s)});
+  }
+
+  // The GPU has no upsampling kernel so gather and weigh the taps of one
+  // spatial axis at a time
+  auto out = astype(x, dtype, s);
+  for (int i = 0; i < n; ++i) {
+    int out_size = out_shape[i + 1];
+    auto taps = primitive->taps(i, out.shape(i + 1), out_size);
+    std::vector<int> weight_shape(n + 1 - i, 1);
+    weight_shape[0] = out_size;
+    std::optional<array> acc;
+    for (int t = 0; t < taps.size; ++t) {
+      std::vector<int> indices(out_size);
+      std::vector<float> weights(out_size);
+      for (int j = 0; j < out_size; ++j) {
+        indices[j] = taps.indices[j * taps.size + t];
+        weights[j] = taps.weights[j * taps.size + t];
+      }
+      auto sample = take(out, array(indices.begin(), {out_size}), i + 1, s);
+      if (upsample_mode == Upsample::Nearest) {
+        acc = sample;
+        break;
+      }
+      auto w = astype(array(weights.begin(), weight_shape), dtype, s);
+      sample = multiply(w, sample, s);
+      acc = acc ? add(*acc, sample, s) : sample;
+    }
+    out = *acc;
+  }
+  return out;
+}
+
 array quantized_matmul(
     const array& x,
     const array& w,
@@ -3322,6 +3615,57 @@ array quantized_matmul(
        astype(biases, dtype, s)});
 }
 
+array dynamic_quantized_matmul(
+    const array& x,
+    const array& w,
+    const array& scales,
+    const array& biases,
+    int group_size /* = 64 */,
+    StreamOrDevice s /* = {} */) {
+  auto [w_inner_dims, w_outer_dims] = extract_quantized_matmul_dims(
+      "dynamic_quantized_matmul",
+      x,
+      w,
+      scales,
+      biases,
+      /* transpose= */ true,
+      group_size,
+      /* bits= */ 8);
+
+  if (w.ndim() != 2) {
+    std::ostringstream msg;
+    msg << "[dynamic_quantized_matmul] Batched quantized matmul is not "
+        << "supported for now received w with shape " << w.shape();
+    throw std::invalid_argument(msg.str());
+  }
+
+  auto dtype = result_type(x, scales, biases);
+  if (!issubdtype(dtype, floating)) {
+    std::ostringstream msg;
+    msg << "[dynamic_quantized_matmul] Only real floating types are supported "
+        << "but the passed types where x.dtype() == " << x.dtype()
+        << ", scales.dtype() == " << scales.dtype()
+        << " and biases.dtype() == " << biases.dtype();
+    throw std::invalid_argument(msg.str());
+  }
+
+  auto out_shape = x.shape();
+  out_shape.back() = w_outer_dims;
+  return array(
+      std::move(out_shape),
+      dtype,
+      std::make_shared<QuantizedMatmul>(
+          to_stream(s),
+          group_size,
+          /* bits= */ 8,
+          /* transpose= */ true,
+          /* quantize_activations= */ true),
+      {astype(x, dtype, s),
+       w,
+       astype(scales, dtype, s),
+       astype(biases, dtype, s)});
+}
+
 std::tuple<array, array, array> quantize(
     const array& w,
     int group_size /* = 64 */,
@@ -3364,20 +3708,6 @@ std::tuple<array, array, array> quantize(
   array shifts = power(array(2, uint32), arange(0, 32, bits, uint32, s), s);
   shifts = reshape(shifts, {1, 1, -1}, s);
 
-  // Check that the w matrix will fill up a whole SIMD.
-  // This is an implementation detail which should be removed in the future but
-  // at least we bail out early which will result in a nice readable error.
-  //
-  // Hopefully nobody is quantizing matrices that small anyway.
-  if (w.shape(-1) < 32 * el_per_int) {
-    std::ostringstream msg;
-    msg << "[quantize] The feature dimension (2nd dimension of the matrix) is "
-        << "too small for quantization. We support >=512 for 2 bits, "
-        << ">= 256 for 4 bits and >= 128 for 8 bits. The provided matrix has "
-        << "shape " << w.shape() << ".";
-    throw std::invalid_argument(msg.str());
-  }
-
   // Prepare the shape for the outputs.
   auto wshape = w.shape();
   wshape.back() = -1;
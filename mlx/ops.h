@@ -1130,6 +1130,40 @@ array conv3d(
     int groups = 1,
     StreamOrDevice s = {});
 
+/**
+ * Max pooling over the spatial axes of a (N, ..., C) input. The stride
+ * defaults to the kernel size and the padding, which acts as -inf, to 0.
+ */
+array max_pool(
+    const array& x,
+    std::vector<int> kernel_size,
+    std::vector<int> stride = {},
+    std::vector<int> padding = {},
+    StreamOrDevice s = {});
+
+/**
+ * Average pooling over the spatial axes of a (N, ..., C) input. The padding
+ * counts as zeros in the average.
+ */
+array avg_pool(
+    const array& x,
+    std::vector<int> kernel_size,
+    std::vector<int> stride = {},
+    std::vector<int> padding = {},
+    StreamOrDevice s = {});
+
+/**
+ * Upsample the spatial axes of a (N, ..., C) input with "nearest", "linear"
+ * or "cubic" interpolation. A spatial axis of size n becomes
+ * int(scale_factor * n) long.
+ */
+array upsample(
+    const array& x,
+    std::vector<double> scale_factor,
+    const std::string& mode = "nearest",
+    bool align_corners = false,
+    StreamOrDevice s = {});
+
 /** Quantized matmul multiplies x with a quantized matrix w*/
 array quantized_matmul(
     const array& x,
@@ -1141,6 +1175,19 @@ array quantized_matmul(
     int bits = 4,
     StreamOrDevice s = {});
 
+/**
+ * Multiply x with a matrix w quantized to 8 bits and transposed. The rows of
+ * x are quantized to int8 on the fly, each with its own scale, so the product
+ * is computed with integer arithmetic on the CPU.
+ */
+array dynamic_quantized_matmul(
+    const array& x,
+    const array& w,
+    const array& scales,
+    const array& biases,
+    int group_size = 64,
+    StreamOrDevice s = {});
+
 /** Quantize a matrix along its last axis */
 std::tuple<array, array, array> quantize(
     const array& w,
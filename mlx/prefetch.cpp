@@ -0,0 +1,173 @@
+// Copyright © 2024 Apple Inc.
+
+#include <algorithm>
+#include <sstream>
+
+#include "mlx/prefetch.h"
+#include "mlx/transforms.h"
+#include "mlx/utils.h"
+
+namespace mlx::core {
+
+Prefetcher::Prefetcher(Producer producer, int depth, int num_workers)
+    : producer_(std::move(producer)),
+      depth_(depth),
+      pool_(std::make_shared<BufferPool>()) {
+  if (depth < 1 || num_workers < 1) {
+    std::ostringstream msg;
+    msg << "[Prefetcher] The depth and the number of workers must be "
+        << "positive but got depth=" << depth
+        << " and num_workers=" << num_workers << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  // More workers than batches in flight would only wait
+  num_workers = std::min(num_workers, depth);
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&Prefetcher::worker, this);
+  }
+}
+
+Prefetcher::~Prefetcher() {
+  stop();
+}
+
+void Prefetcher::stop() {
+  {
+    std::unique_lock<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  consumed_.notify_all();
+  produced_.notify_all();
+  for (auto& t : workers_) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+
+  // Arrays freed from now on release their buffers directly
+  std::lock_guard<std::mutex> lk(pool_->mtx);
+  pool_->closed = true;
+  for (auto& [_, buffer] : pool_->buffers) {
+    allocator::free(buffer);
+  }
+  pool_->buffers.clear();
+}
+
+array Prefetcher::empty(std::vector<int> shape, Dtype dtype) {
+  size_t nbytes = size_of(dtype);
+  for (auto s : shape) {
+    if (s < 0) {
+      std::ostringstream msg;
+      msg << "[Prefetcher::empty] Negative dimensions not allowed in shape "
+          << shape << ".";
+      throw std::invalid_argument(msg.str());
+    }
+    nbytes *= s;
+  }
+
+  allocator::Buffer buffer{nullptr};
+  {
+    std::lock_guard<std::mutex> lk(pool_->mtx);
+    if (auto it = pool_->buffers.find(nbytes); it != pool_->buffers.end()) {
+      buffer = it->second;
+      pool_->buffers.erase(it);
+    }
+  }
+  if (!buffer.ptr()) {
+    buffer = allocator::malloc_or_wait(nbytes);
+  }
+  return array(
+      buffer,
+      std::move(shape),
+      dtype,
+      [pool = pool_, nbytes](allocator::Buffer buffer) {
+        std::lock_guard<std::mutex> lk(pool->mtx);
+        if (pool->closed) {
+          allocator::free(buffer);
+        } else {
+          pool->buffers.emplace(nbytes, buffer);
+        }
+      });
+}
+
+void Prefetcher::worker() {
+  while (true) {
+    int index;
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      consumed_.wait(lk, [this] {
+        return stop_ || claimed_ >= end_ ||
+            claimed_ < consumed_count_ + depth_;
+      });
+      if (stop_ || claimed_ >= end_) {
+        return;
+      }
+      index = claimed_++;
+    }
+
+    std::optional<std::vector<array>> batch;
+    std::exception_ptr error;
+    try {
+      batch = producer_(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::unique_lock<std::mutex> lk(mtx_);
+      if (batch) {
+        ready_.emplace(index, std::move(*batch));
+      } else if (index < end_) {
+        // The first missing batch ends the stream. Workers may finish out of
+        // order so keep the error of the earliest one.
+        end_ = index;
+        error_ = error;
+      }
+    }
+    produced_.notify_all();
+    consumed_.notify_all();
+  }
+}
+
+std::optional<std::vector<array>> Prefetcher::next() {
+  std::vector<array> batch;
+  std::vector<array> to_launch;
+  {
+    std::unique_lock<std::mutex> lk(mtx_);
+    produced_.wait(lk, [this] {
+      return stop_ || consumed_count_ >= end_ ||
+          ready_.find(consumed_count_) != ready_.end();
+    });
+    auto it = ready_.find(consumed_count_);
+    if (stop_ || it == ready_.end()) {
+      if (stop_ || !error_) {
+        return std::nullopt;
+      }
+      auto error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+    batch = std::move(it->second);
+    ready_.erase(it);
+    consumed_count_++;
+
+    // Start evaluating the handed out batch and the ones which arrived
+    // after it so their remaining work overlaps with the current step.
+    if (launched_ < consumed_count_) {
+      to_launch = batch;
+      launched_ = consumed_count_;
+    }
+    for (auto r = ready_.find(launched_); r != ready_.end();
+         r = ready_.find(++launched_)) {
+      to_launch.insert(to_launch.end(), r->second.begin(), r->second.end());
+    }
+  }
+  consumed_.notify_all();
+
+  if (!to_launch.empty()) {
+    async_eval(std::move(to_launch));
+  }
+  return batch;
+}
+
+} // namespace mlx::core
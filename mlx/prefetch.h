@@ -0,0 +1,91 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "mlx/array.h"
+
+namespace mlx::core {
+
+/**
+ * Prepares batches on background threads ahead of the training loop.
+ *
+ * The producer is called with the index of the batch to make and returns
+ * std::nullopt once there are no more batches. Several workers may call it
+ * concurrently with different indices but the batches are always handed out
+ * in order. At most `depth` batches are in flight or waiting at a time so
+ * the workers block when the consumer falls behind.
+ *
+ * Batches are passed to async_eval as soon as the consumer sees them so any
+ * lazy work left in them overlaps with the running step.
+ *
+ * The producer can fill arrays made with empty(). Their buffers go back to a
+ * pool owned by the prefetcher when they are freed and are reused for later
+ * arrays of the same size, so steady state batches skip the allocator.
+ */
+class Prefetcher {
+ public:
+  using Producer = std::function<std::optional<std::vector<array>>(int)>;
+
+  explicit Prefetcher(Producer producer, int depth = 2, int num_workers = 1);
+  ~Prefetcher();
+
+  Prefetcher(const Prefetcher&) = delete;
+  Prefetcher& operator=(const Prefetcher&) = delete;
+
+  /**
+   * Wait for the next batch. Returns std::nullopt when the producer is
+   * exhausted and rethrows the exception of a failed producer call when its
+   * batch is reached.
+   */
+  std::optional<std::vector<array>> next();
+
+  /** Stop the workers and drop the prepared batches. */
+  void stop();
+
+  /**
+   * An uninitialized array backed by a pooled buffer. It is safe to call
+   * from the producer.
+   */
+  array empty(std::vector<int> shape, Dtype dtype);
+
+ private:
+  // Free buffers by size in bytes. The deleters of arrays made by empty()
+  // share the pool since the arrays may outlive the prefetcher.
+  struct BufferPool {
+    std::mutex mtx;
+    std::multimap<size_t, allocator::Buffer> buffers;
+    bool closed{false};
+  };
+
+  void worker();
+
+  Producer producer_;
+  int depth_;
+
+  std::mutex mtx_;
+  std::condition_variable produced_;
+  std::condition_variable consumed_;
+  std::map<int, std::vector<array>> ready_;
+  std::exception_ptr error_;
+  int claimed_{0};
+  int consumed_count_{0};
+  int launched_{0};
+  int end_{std::numeric_limits<int>::max()};
+  bool stop_{false};
+
+  std::shared_ptr<BufferPool> pool_;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace mlx::core
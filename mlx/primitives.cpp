@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
@@ -17,6 +18,28 @@ namespace mlx::core {
 
 namespace {
 
+// The lowest value of a type, -inf for floating point types
+array lowest_value(Dtype dtype) {
+  switch (dtype) {
+    case bool_:
+    case uint8:
+    case uint16:
+    case uint32:
+    case uint64:
+      return array(0, dtype);
+    case int8:
+      return array(std::numeric_limits<int8_t>::lowest(), dtype);
+    case int16:
+      return array(std::numeric_limits<int16_t>::lowest(), dtype);
+    case int32:
+      return array(std::numeric_limits<int32_t>::lowest(), dtype);
+    case int64:
+      return array(std::numeric_limits<int64_t>::lowest(), dtype);
+    default:
+      return array(-std::numeric_limits<float>::infinity(), dtype);
+  }
+}
+
 std::tuple<array, array, int> vmap_binary_op(
     const std::vector<array>& inputs,
     const std::vector<int>& axes,
@@ -105,6 +128,31 @@ std::tuple<array, array, array, int> vmap_ternary_op(
   return {a, b, c, to_ax};
 }
 
+// Move the vmapped axis of each index array to the front and pad the
+// remaining dimensions so the index arrays broadcast with a leading batch
+// axis. Index arrays which are not vmapped broadcast against the batch as is.
+// Returns the number of dimensions of the unbatched index arrays.
+int vmap_indices(
+    std::vector<array>& indices,
+    const std::vector<int>& axes,
+    const Stream& stream) {
+  int idx_ndim = 0;
+  for (int i = 0; i < indices.size(); ++i) {
+    int ndim = indices[i].ndim() - (axes[i] >= 0);
+    idx_ndim = std::max(idx_ndim, ndim);
+  }
+  for (int i = 0; i < indices.size(); ++i) {
+    if (axes[i] < 0) {
+      continue;
+    }
+    auto idx = moveaxis(indices[i], axes[i], 0, stream);
+    auto shape = idx.shape();
+    shape.insert(shape.begin() + 1, idx_ndim + 1 - idx.ndim(), 1);
+    indices[i] = reshape(idx, shape, stream);
+  }
+  return idx_ndim;
+}
+
 } // namespace
 
 std::vector<array> Primitive::jvp(
@@ -585,6 +633,18 @@ std::vector<array> AsStrided::jvp(
   return {as_strided(tangents[0], shape_, strides_, offset_, stream())};
 }
 
+std::pair<std::vector<array>, std::vector<int>> AsStrided::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  // The input is flat, so each batch element is a contiguous row
+  auto in = moveaxis(inputs[0], axes[0], 0, stream());
+  auto shape = shape_;
+  auto strides = strides_;
+  shape.insert(shape.begin(), in.shape(0));
+  strides.insert(strides.begin(), in.shape(1));
+  return {{as_strided(in, shape, strides, offset_, stream())}, {0}};
+}
+
 bool AsStrided::is_equivalent(const Primitive& other) const {
   const AsStrided& a_other = static_cast<const AsStrided&>(other);
   return shape_ == a_other.shape_ && strides_ == a_other.strides_ &&
@@ -708,6 +768,79 @@ std::pair<std::vector<array>, std::vector<int>> Ceil::vmap(
   return {{ceil(inputs[0], stream())}, axes};
 }
 
+array Clip::derivative_mask(const std::vector<array>& primals, int arg) {
+  // The masks match maximum with a_min followed by minimum with a_max
+  auto& x = primals[0];
+  std::optional<array> lo, hi;
+  if (has_min_) {
+    lo = primals[1];
+  }
+  if (has_max_) {
+    hi = primals[has_min_ ? 2 : 1];
+  }
+  auto m = lo ? maximum(x, *lo, stream()) : x;
+  std::optional<array> mask;
+  if (arg == 0 && lo) {
+    mask = greater(x, *lo, stream());
+  } else if (arg == 1 && lo) {
+    mask = less_equal(x, *lo, stream());
+  } else if (arg == 0) {
+    return less(x, *hi, stream());
+  } else {
+    return greater_equal(m, *hi, stream());
+  }
+  if (hi) {
+    mask = logical_and(*mask, less(m, *hi, stream()), stream());
+  }
+  return *mask;
+}
+
+std::vector<array> Clip::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>&) {
+  std::vector<array> vjps;
+  for (auto arg : argnums) {
+    vjps.push_back(
+        multiply(cotangents[0], derivative_mask(primals, arg), stream()));
+  }
+  return vjps;
+}
+
+std::vector<array> Clip::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  auto jvp_fun = [&](int i) {
+    return multiply(
+        tangents[i], derivative_mask(primals, argnums[i]), stream());
+  };
+  auto out = jvp_fun(0);
+  for (int i = 1; i < argnums.size(); i++) {
+    out = add(out, jvp_fun(i), stream());
+  }
+  return {out};
+}
+
+std::pair<std::vector<array>, std::vector<int>> Clip::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  std::optional<array> lo, hi;
+  if (inputs.size() == 2) {
+    auto [x, bound, to_ax] = vmap_binary_op(inputs, axes, stream());
+    (has_min_ ? lo : hi) = bound;
+    return {{clip(x, lo, hi, stream())}, {to_ax}};
+  }
+  auto [x, a_min, a_max, to_ax] = vmap_ternary_op(inputs, axes, stream());
+  return {{clip(x, a_min, a_max, stream())}, {to_ax}};
+}
+
+bool Clip::is_equivalent(const Primitive& other) const {
+  const Clip& c_other = static_cast<const Clip&>(other);
+  return has_min_ == c_other.has_min_ && has_max_ == c_other.has_max_;
+}
+
 std::vector<array> Concatenate::vjp(
     const std::vector<array>& primals,
     const std::vector<array>& cotangents,
@@ -998,9 +1131,106 @@ std::vector<array> Convolution::vjp(
   return grads;
 }
 
+std::pair<std::vector<array>, std::vector<int>> Convolution::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  auto& in = inputs[0];
+  auto& wt = inputs[1];
+  int batch_size = axes[0] >= 0 ? in.shape(axes[0]) : wt.shape(axes[1]);
+
+  auto conv = [&](const array& in, const array& wt, int groups) {
+    return conv_general(
+        in,
+        wt,
+        kernel_strides_,
+        padding_,
+        padding_hi_,
+        kernel_dilation_,
+        input_dilation_,
+        groups,
+        flip_,
+        stream());
+  };
+
+  // Fold the batch axis into the leading dimension
+  auto fold = [&](const array& x, int ax) {
+    auto shape = x.shape();
+    shape.erase(shape.begin() + ax);
+    shape[0] *= batch_size;
+    return reshape(moveaxis(x, ax, 0, stream()), shape, stream());
+  };
+
+  // Split the batch out of the output channels, which are ordered as
+  // (batch, channels)
+  auto unfold_channels = [&](const array& out) {
+    auto shape = out.shape();
+    shape.back() /= batch_size;
+    shape.insert(shape.end() - 1, batch_size);
+    return reshape(out, shape, stream());
+  };
+  int out_ax = in.ndim() - (axes[0] >= 0) - 1;
+
+  if (axes[1] < 0) {
+    // A shared weight convolves the batch folded into the input batch
+    auto out = conv(fold(in, axes[0]), wt, groups_);
+    auto shape = out.shape();
+    shape[0] /= batch_size;
+    shape.insert(shape.begin(), batch_size);
+    return {{reshape(out, shape, stream())}, {0}};
+  }
+
+  if (axes[0] < 0) {
+    // A shared input is convolved with the batch folded into the output
+    // channels. Each group keeps its own block of output channels.
+    auto w = moveaxis(wt, axes[1], 0, stream());
+    if (groups_ == 1) {
+      return {{unfold_channels(conv(in, fold(w, 0), 1))}, {out_ax}};
+    }
+    auto shape = w.shape();
+    shape[1] /= groups_;
+    shape.insert(shape.begin() + 1, groups_);
+    w = swapaxes(reshape(w, shape, stream()), 0, 1, stream());
+    shape = w.shape();
+    shape.erase(shape.begin(), shape.begin() + 2);
+    shape[0] *= groups_ * batch_size;
+    auto out = conv(in, reshape(w, shape, stream()), groups_);
+    shape = out.shape();
+    shape.back() /= groups_ * batch_size;
+    shape.insert(shape.end() - 1, {groups_, batch_size});
+    out = swapaxes(reshape(out, shape, stream()), -3, -2, stream());
+    shape = out.shape();
+    shape.erase(shape.end() - 2);
+    shape.back() *= groups_;
+    return {{reshape(out, shape, stream())}, {out_ax}};
+  }
+
+  // Separate inputs and weights per batch element become separate groups
+  int spatial_dims = in.ndim() - 3;
+  if (spatial_dims == 1 ||
+      (spatial_dims == 2 && stream().device == Device::cpu)) {
+    auto x = moveaxis(in, axes[0], -2, stream());
+    auto shape = x.shape();
+    shape.erase(shape.end() - 2);
+    shape.back() *= batch_size;
+    x = reshape(x, shape, stream());
+    auto out = conv(x, fold(wt, axes[1]), groups_ * batch_size);
+    return {{unfold_channels(out)}, {out_ax}};
+  }
+
+  // Grouped convolutions are not available here, convolve each element
+  std::vector<array> outs;
+  for (int i = 0; i < batch_size; ++i) {
+    outs.push_back(conv(
+        take(in, array(i), axes[0], stream()),
+        take(wt, array(i), axes[1], stream()),
+        groups_));
+  }
+  return {{stack(outs, 0, stream())}, {0}};
+}
+
 bool Convolution::is_equivalent(const Primitive& other) const {
   const Convolution& c_other = static_cast<const Convolution&>(other);
-  return padding_ == c_other.padding_ &&
+  return padding_ == c_other.padding_ && padding_hi_ == c_other.padding_hi_ &&
       kernel_strides_ == c_other.kernel_strides_ &&
       kernel_dilation_ == c_other.kernel_dilation_ &&
       input_dilation_ == c_other.input_dilation_ &&
@@ -1538,51 +1768,49 @@ std::pair<std::vector<array>, std::vector<int>> Gather::vmap(
     const std::vector<int>& axes) {
   auto& src = inputs[0];
   std::vector<array> indices(inputs.begin() + 1, inputs.end());
+  std::vector<int> idx_axes(axes.begin() + 1, axes.end());
   auto gather_axes = axes_;
   auto slice_sizes = slice_sizes_;
   auto src_vmapped = axes[0] >= 0;
-  auto indices_vmapped =
-      std::any_of(axes.begin() + 1, axes.end(), [](int a) { return a >= 0; });
-  auto out_ax =
-      *std::find_if(axes.begin(), axes.end(), [](int a) { return a >= 0; });
-
-  // Reorder all the index arrays so the vmap axis is in the same spot.
-  for (int i = 1; i < axes.size(); ++i) {
-    if (out_ax != axes[i] && axes[i] >= 0) {
-      indices[i - 1] = moveaxis(indices[i - 1], axes[i], out_ax, stream());
-    }
-  }
+  auto indices_vmapped = std::any_of(
+      idx_axes.begin(), idx_axes.end(), [](int a) { return a >= 0; });
+
+  // The batch leads the broadcasted indices so it leads the output as well
+  int idx_ndim = vmap_indices(indices, idx_axes, stream());
+  int out_ax = 0;
 
   if (src_vmapped) {
-    int max_dims = 0;
-    for (auto& idx : indices) {
-      max_dims = std::max(static_cast<int>(idx.ndim()), max_dims);
-    }
+    // Shift the gather axes past the batch axis of the source, which stays
+    // where it is
     auto new_ax_loc =
-        std::find_if(gather_axes.begin(), gather_axes.end(), [&out_ax](int a) {
-          return a >= out_ax;
+        std::find_if(gather_axes.begin(), gather_axes.end(), [&axes](int a) {
+          return a >= axes[0];
         });
-    for (; new_ax_loc < gather_axes.end(); new_ax_loc++) {
-      (*new_ax_loc)++;
+    for (auto it = new_ax_loc; it < gather_axes.end(); it++) {
+      (*it)++;
     }
     if (indices_vmapped) {
-      // Make a new index array for the vmapped dimension
-      // Reshape it so it broadcasts with other index arrays
-      // Update gather axes and slice sizes accordingly
-      auto shape = std::vector<int>(max_dims - out_ax, 1);
-      auto vmap_inds = arange(0, src.shape(out_ax), stream());
-      shape[0] = vmap_inds.shape(0);
-      vmap_inds = reshape(vmap_inds, shape, stream());
-      slice_sizes.insert(slice_sizes.begin() + out_ax, 1);
+      // Select the matching source for each batch element with an extra
+      // index array which broadcasts against the others
+      std::vector<int> shape(idx_ndim + 1, 1);
+      shape[0] = src.shape(axes[0]);
+      auto vmap_inds = reshape(arange(shape[0], stream()), shape, stream());
+      slice_sizes.insert(slice_sizes.begin() + axes[0], 1);
       auto new_ax_idx = new_ax_loc - gather_axes.begin();
-      gather_axes.insert(new_ax_loc, out_ax);
+      gather_axes.insert(new_ax_loc, axes[0]);
       indices.insert(indices.begin() + new_ax_idx, vmap_inds);
     } else {
+      // Take the whole batch in every slice
       slice_sizes.insert(slice_sizes.begin() + axes[0], src.shape(axes[0]));
-      out_ax = max_dims + axes[0];
+      out_ax = idx_ndim + axes[0];
     }
   }
-  return {{gather(src, indices, gather_axes, slice_sizes, stream())}, {out_ax}};
+  auto out = gather(src, indices, gather_axes, slice_sizes, stream());
+  if (src_vmapped && indices_vmapped) {
+    // Drop the unit slice of the batch axis
+    out = squeeze(out, idx_ndim + 1 + axes[0], stream());
+  }
+  return {{out}, {out_ax}};
 }
 
 std::vector<array> Gather::vjp(
@@ -2208,9 +2436,9 @@ std::vector<array> Pad::vjp(
   std::vector<int> start(cotan.ndim(), 0);
   std::vector<int> stop = cotan.shape();
 
-  for (auto i : axes_) {
-    start[i] = low_pad_size_[i];
-    stop[i] -= high_pad_size_[i];
+  for (int i = 0; i < axes_.size(); ++i) {
+    start[axes_[i]] = low_pad_size_[i];
+    stop[axes_[i]] -= high_pad_size_[i];
   }
 
   auto out = slice(cotan, start, stop, stream());
@@ -2236,7 +2464,22 @@ std::vector<array> Pad::jvp(
 std::pair<std::vector<array>, std::vector<int>> Pad::vmap(
     const std::vector<array>& inputs,
     const std::vector<int>& axes) {
-  throw std::runtime_error("Pad vmap is NYI.");
+  if (axes[1] >= 0) {
+    throw std::invalid_argument("[pad] vmap over the pad value is NYI.");
+  }
+  // Leave the batch axis unpadded
+  auto pad_axes = axes_;
+  for (auto& ax : pad_axes) {
+    ax += (ax >= axes[0]);
+  }
+  return {
+      {pad(inputs[0],
+           pad_axes,
+           low_pad_size_,
+           high_pad_size_,
+           inputs[1],
+           stream())},
+      {axes[0]}};
 }
 
 bool Pad::is_equivalent(const Primitive& other) const {
@@ -2280,6 +2523,105 @@ bool Partition::is_equivalent(const Primitive& other) const {
   return axis_ == r_other.axis_ && kth_ == r_other.kth_;
 }
 
+std::vector<array> Pooling::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>&,
+    const std::vector<array>&) {
+  auto& x = primals[0];
+  return {array(
+      x.shape(),
+      cotangents[0].dtype(),
+      std::make_shared<PoolingVJP>(
+          stream(), pool_type_, kernel_size_, stride_, padding_),
+      {x, cotangents[0]})};
+}
+
+std::vector<array> Pooling::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>&) {
+  if (pool_type_ == Avg) {
+    return {avg_pool(tangents[0], kernel_size_, stride_, padding_, stream())};
+  }
+
+  // Pick the tangent at the first maximum of every window. The padding takes
+  // the lowest value of the type like in the forward kernel and is masked
+  // out so that it never ties with an input equal to that value.
+  int n = kernel_size_.size();
+  auto windows = [&](const array& a, const array& pad_value) {
+    std::vector<int> axes(n);
+    std::iota(axes.begin(), axes.end(), 1);
+    auto padded = pad(a, axes, padding_, padding_, pad_value, stream());
+    auto& shape = padded.shape();
+    std::vector<size_t> strides(shape.size(), 1);
+    for (int i = shape.size() - 2; i >= 0; --i) {
+      strides[i] = strides[i + 1] * shape[i + 1];
+    }
+    std::vector<int> window_shape = {shape[0]};
+    std::vector<size_t> window_strides = {strides[0]};
+    int window_size = 1;
+    for (int i = 0; i < n; ++i) {
+      int size = (shape[i + 1] - kernel_size_[i]) / stride_[i] + 1;
+      window_shape.push_back(size);
+      window_strides.push_back(strides[i + 1] * stride_[i]);
+    }
+    for (int i = 0; i < n; ++i) {
+      window_shape.push_back(kernel_size_[i]);
+      window_strides.push_back(strides[i + 1]);
+      window_size *= kernel_size_[i];
+    }
+    window_shape.push_back(shape.back());
+    window_strides.push_back(1);
+    auto w = as_strided(padded, window_shape, window_strides, 0, stream());
+    std::vector<int> flat_shape(
+        window_shape.begin(), window_shape.end() - n - 1);
+    flat_shape.push_back(window_size);
+    flat_shape.push_back(shape.back());
+    return reshape(w, std::move(flat_shape), stream());
+  };
+  auto& x = primals[0];
+  auto w = windows(x, lowest_value(x.dtype()));
+  auto valid = windows(full(x.shape(), array(true), stream()), array(false));
+  auto is_max = logical_and(
+      equal(w, max(w, -2, true, stream()), stream()), valid, stream());
+  auto idx = argmax(astype(is_max, uint8, stream()), -2, true, stream());
+  auto t = windows(tangents[0], array(0, tangents[0].dtype()));
+  return {squeeze(take_along_axis(t, idx, -2, stream()), -2, stream())};
+}
+
+std::pair<std::vector<array>, std::vector<int>> Pooling::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  // Fold the vmapped axis into the batch axis
+  auto x = moveaxis(inputs[0], axes[0], 0, stream());
+  auto shape = x.shape();
+  shape[1] *= shape[0];
+  shape.erase(shape.begin());
+  x = reshape(x, std::move(shape), stream());
+  auto out = pool_type_ == Max
+      ? max_pool(x, kernel_size_, stride_, padding_, stream())
+      : avg_pool(x, kernel_size_, stride_, padding_, stream());
+  auto out_shape = out.shape();
+  out_shape[0] /= inputs[0].shape(axes[0]);
+  out_shape.insert(out_shape.begin(), inputs[0].shape(axes[0]));
+  return {{reshape(out, std::move(out_shape), stream())}, {0}};
+}
+
+bool Pooling::is_equivalent(const Primitive& other) const {
+  const Pooling& p_other = static_cast<const Pooling&>(other);
+  return pool_type_ == p_other.pool_type_ &&
+      kernel_size_ == p_other.kernel_size_ && stride_ == p_other.stride_ &&
+      padding_ == p_other.padding_;
+}
+
+bool PoolingVJP::is_equivalent(const Primitive& other) const {
+  const PoolingVJP& p_other = static_cast<const PoolingVJP&>(other);
+  return pool_type_ == p_other.pool_type_ &&
+      kernel_size_ == p_other.kernel_size_ && stride_ == p_other.stride_ &&
+      padding_ == p_other.padding_;
+}
+
 std::vector<array> Power::vjp(
     const std::vector<array>& primals,
     const std::vector<array>& cotangents,
@@ -2373,7 +2715,8 @@ std::vector<array> QuantizedMatmul::jvp(
 bool QuantizedMatmul::is_equivalent(const Primitive& other) const {
   const QuantizedMatmul& qm_other = static_cast<const QuantizedMatmul&>(other);
   return group_size_ == qm_other.group_size_ && bits_ == qm_other.bits_ &&
-      transpose_ == qm_other.transpose_;
+      transpose_ == qm_other.transpose_ &&
+      quantize_activations_ == qm_other.quantize_activations_;
 }
 
 std::pair<std::vector<array>, std::vector<int>> BlockSparseQMM::vmap(
@@ -2871,6 +3214,79 @@ std::vector<array> Scatter::vjp(
   return vjps;
 }
 
+std::pair<std::vector<array>, std::vector<int>> Scatter::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  auto src = inputs[0];
+  auto updates = inputs.back();
+  std::vector<array> indices(inputs.begin() + 1, inputs.end() - 1);
+  std::vector<int> idx_axes(axes.begin() + 1, axes.end() - 1);
+  auto scatter_axes = axes_;
+  auto indices_vmapped = std::any_of(
+      idx_axes.begin(), idx_axes.end(), [](int a) { return a >= 0; });
+
+  int batch_size = 0;
+  for (int i = 0; i < axes.size(); ++i) {
+    if (axes[i] >= 0) {
+      batch_size = inputs[i].shape(axes[i]);
+      break;
+    }
+  }
+
+  // The output batch leads. A source without one is broadcast, which costs
+  // nothing extra since the scatter copies the source into the output.
+  if (axes[0] >= 0) {
+    src = moveaxis(src, axes[0], 0, stream());
+  } else {
+    auto shape = src.shape();
+    shape.insert(shape.begin(), batch_size);
+    src = broadcast_to(expand_dims(src, 0, stream()), shape, stream());
+  }
+  for (auto& ax : scatter_axes) {
+    ax++;
+  }
+
+  // The updates are laid out as the broadcasted indices followed by one
+  // slice dimension per source dimension
+  int idx_ndim = vmap_indices(indices, idx_axes, stream());
+  auto batch_updates = [&](int to_ax) {
+    if (axes.back() >= 0) {
+      return moveaxis(updates, axes.back(), to_ax, stream());
+    }
+    auto shape = updates.shape();
+    shape.insert(shape.begin() + to_ax, batch_size);
+    return broadcast_to(
+        expand_dims(updates, to_ax, stream()), shape, stream());
+  };
+
+  if (indices_vmapped) {
+    // Route each batch element to its own output with an extra index array
+    std::vector<int> shape(idx_ndim + 1, 1);
+    shape[0] = batch_size;
+    auto vmap_inds = reshape(arange(batch_size, stream()), shape, stream());
+    indices.insert(indices.begin(), vmap_inds);
+    scatter_axes.insert(scatter_axes.begin(), 0);
+    updates = expand_dims(batch_updates(0), idx_ndim + 1, stream());
+  } else {
+    // Every update slice spans the whole batch
+    updates = batch_updates(idx_ndim);
+  }
+  auto& s = stream();
+  switch (reduce_type_) {
+    case Scatter::None:
+      return {{scatter(src, indices, updates, scatter_axes, s)}, {0}};
+    case Scatter::Sum:
+      return {{scatter_add(src, indices, updates, scatter_axes, s)}, {0}};
+    case Scatter::Prod:
+      return {{scatter_prod(src, indices, updates, scatter_axes, s)}, {0}};
+    case Scatter::Max:
+      return {{scatter_max(src, indices, updates, scatter_axes, s)}, {0}};
+    case Scatter::Min:
+    default:
+      return {{scatter_min(src, indices, updates, scatter_axes, s)}, {0}};
+  }
+}
+
 std::vector<array> Scatter::jvp(
     const std::vector<array>& primals,
     const std::vector<array>& tangents,
@@ -3274,11 +3690,62 @@ bool Sort::is_equivalent(const Primitive& other) const {
   return axis_ == r_other.axis_;
 }
 
+std::vector<array> SparseMatmul::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>& argnums,
+    const std::vector<array>&) {
+  std::vector<array> vjps;
+  for (auto arg : argnums) {
+    if (arg != 3) {
+      throw std::invalid_argument(
+          "[SparseMatmul::vjp] Gradients are only supported for the dense "
+          "operand.");
+    }
+    // The gradient of A @ B wrt B is A^T @ cotan which is the same product
+    // with the sparse matrix transposed.
+    auto& b = primals[3];
+    vjps.push_back(array(
+        b.shape(),
+        cotangents[0].dtype(),
+        std::make_shared<SparseMatmul>(
+            stream(), format_, rows_, cols_, !transpose_),
+        {primals[0], primals[1], primals[2], cotangents[0]}));
+  }
+  return vjps;
+}
+
+std::vector<array> SparseMatmul::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>& argnums) {
+  if (argnums.size() != 1 || argnums[0] != 3) {
+    throw std::invalid_argument(
+        "[SparseMatmul::jvp] Gradients are only supported for the dense "
+        "operand.");
+  }
+  auto out_rows = transpose_ ? cols_ : rows_;
+  return {array(
+      {out_rows, tangents[0].shape(1)},
+      tangents[0].dtype(),
+      std::make_shared<SparseMatmul>(
+          stream(), format_, rows_, cols_, transpose_),
+      {primals[0], primals[1], primals[2], tangents[0]})};
+}
+
+bool SparseMatmul::is_equivalent(const Primitive& other) const {
+  const SparseMatmul& s_other = static_cast<const SparseMatmul&>(other);
+  return format_ == s_other.format_ && rows_ == s_other.rows_ &&
+      cols_ == s_other.cols_ && transpose_ == s_other.transpose_;
+}
+
 std::pair<std::vector<array>, std::vector<int>> Split::vmap(
     const std::vector<array>& inputs,
     const std::vector<int>& axes) {
   int axis_left = axes[0] >= 0 && axes[0] <= axis_;
-  return {{split(inputs[0], indices_, axis_ + axis_left, stream())}, axes};
+  auto outputs = split(inputs[0], indices_, axis_ + axis_left, stream());
+  std::vector<int> out_axes(outputs.size(), axes[0]);
+  return {outputs, out_axes};
 }
 
 std::vector<array> Split::vjp(
@@ -3626,6 +4093,145 @@ bool Transpose::is_equivalent(const Primitive& other) const {
   return axes_ == t_other.axes_;
 }
 
+namespace {
+
+const char* upsample_mode_name(Upsample::Mode mode) {
+  switch (mode) {
+    case Upsample::Nearest:
+      return "nearest";
+    case Upsample::Linear:
+      return "linear";
+    default:
+      return "cubic";
+  }
+}
+
+} // namespace
+
+std::vector<array> Upsample::vjp(
+    const std::vector<array>& primals,
+    const std::vector<array>& cotangents,
+    const std::vector<int>&,
+    const std::vector<array>&) {
+  auto& x = primals[0];
+  if (!issubdtype(x.dtype(), inexact)) {
+    return {zeros_like(x, stream())};
+  }
+  return {array(
+      x.shape(),
+      x.dtype(),
+      std::make_shared<UpsampleVJP>(
+          stream(), mode_, scale_factor_, align_corners_),
+      {astype(cotangents[0], x.dtype(), stream())})};
+}
+
+std::vector<array> Upsample::jvp(
+    const std::vector<array>& primals,
+    const std::vector<array>& tangents,
+    const std::vector<int>&) {
+  return {upsample(
+      tangents[0],
+      scale_factor_,
+      upsample_mode_name(mode_),
+      align_corners_,
+      stream())};
+}
+
+std::pair<std::vector<array>, std::vector<int>> Upsample::vmap(
+    const std::vector<array>& inputs,
+    const std::vector<int>& axes) {
+  // Fold the vmapped axis into the batch axis
+  auto x = moveaxis(inputs[0], axes[0], 0, stream());
+  auto shape = x.shape();
+  shape[1] *= shape[0];
+  shape.erase(shape.begin());
+  x = reshape(x, std::move(shape), stream());
+  auto out = upsample(
+      x, scale_factor_, upsample_mode_name(mode_), align_corners_, stream());
+  auto out_shape = out.shape();
+  out_shape[0] /= inputs[0].shape(axes[0]);
+  out_shape.insert(out_shape.begin(), inputs[0].shape(axes[0]));
+  return {{reshape(out, std::move(out_shape), stream())}, {0}};
+}
+
+Upsample::Taps Upsample::taps(int axis, int in_size, int out_size) const {
+  double scale = scale_factor_[axis];
+
+  // The input coordinate sampled by every output position
+  auto source = [&](int i) {
+    if (align_corners_ || mode_ == Nearest) {
+      double ratio =
+          out_size > 1 ? static_cast<double>(in_size - 1) / (out_size - 1) : 0;
+      return i * static_cast<float>(ratio);
+    }
+    double step = 1.0 / scale;
+    double start = ((out_size - 1) * step - in_size + 1) / 2;
+    return i * static_cast<float>(step) - static_cast<float>(start);
+  };
+  auto clamp_index = [in_size](float j) {
+    return std::clamp(static_cast<int>(j), 0, in_size - 1);
+  };
+
+  Taps taps;
+  taps.size = mode_ == Nearest ? 1 : (mode_ == Linear ? 2 : 4);
+  taps.indices.reserve(out_size * taps.size);
+  taps.weights.reserve(out_size * taps.size);
+  auto push = [&taps](int index, float weight) {
+    taps.indices.push_back(index);
+    taps.weights.push_back(weight);
+  };
+
+  if (mode_ == Nearest) {
+    // Integer scale factors repeat every input position while other scale
+    // factors sample the input with aligned corners
+    bool integer_scales = std::all_of(
+        scale_factor_.begin(), scale_factor_.end(), [](double s) {
+          return s == std::floor(s);
+        });
+    for (int i = 0; i < out_size; ++i) {
+      push(
+          integer_scales ? std::min(i / static_cast<int>(scale), in_size - 1)
+                         : clamp_index(source(i)),
+          1.0f);
+    }
+  } else if (mode_ == Linear) {
+    for (int i = 0; i < out_size; ++i) {
+      float x = std::clamp(source(i), 0.0f, static_cast<float>(in_size - 1));
+      float l = std::floor(x);
+      float w = x - l;
+      push(l, 1 - w);
+      push(std::ceil(x), w);
+    }
+  } else {
+    // The cubic convolution kernel with a = -0.75 as in OpenCV and PyTorch.
+    // Positions past the border repeat the border.
+    constexpr float a = -0.75f;
+    auto near = [a](float x) { return ((a + 2) * x - (a + 3)) * x * x + 1; };
+    auto far = [a](float x) { return (((x - 5) * x + 8) * x - 4) * a; };
+    for (int i = 0; i < out_size; ++i) {
+      float x = source(i);
+      float l = std::floor(x);
+      push(clamp_index(l), near(x - l));
+      push(clamp_index(l + 1), near(l + 1 - x));
+      push(clamp_index(l - 1), far(x - l + 1));
+      push(clamp_index(l + 2), far(l + 2 - x));
+    }
+  }
+  return taps;
+}
+
+bool Upsample::is_equivalent(const Primitive& other) const {
+  const Upsample& u_other = static_cast<const Upsample&>(other);
+  return mode_ == u_other.mode_ && scale_factor_ == u_other.scale_factor_ &&
+      align_corners_ == u_other.align_corners_;
+}
+
+bool UpsampleVJP::is_equivalent(const Primitive& other) const {
+  const UpsampleVJP& u_other = static_cast<const UpsampleVJP&>(other);
+  return mode_ == u_other.mode_ && scale_factor_ == u_other.scale_factor_ &&
+      align_corners_ == u_other.align_corners_;
+}
+
 std::pair<std::vector<array>, std::vector<int>> NumberOfElements::vmap(
     const std::vector<array>& inputs,
     const std::vector<int>& axes) {
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <optional>
 #include <unordered_set>
 
 #include "mlx/array.h"
@@ -205,6 +206,10 @@ class AddMM : public UnaryPrimitive {
 
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<float, float> state() const {
+    return {alpha_, beta_};
+  }
+
  private:
   const float alpha_;
   const float beta_;
@@ -221,6 +226,10 @@ class Arange : public UnaryPrimitive {
   DEFINE_PRINT(Arange)
   bool is_equivalent(const Primitive& other) const override;
 
+  std::tuple<double, double, double> state() const {
+    return {start_, stop_, step_};
+  }
+
  private:
   double start_;
   double stop_;
@@ -361,6 +370,10 @@ class ArgPartition : public UnaryPrimitive {
   DEFINE_INPUT_OUTPUT_SHAPE()
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<int, int> state() const {
+    return {kth_, axis_};
+  }
+
  private:
   int kth_;
   int axis_;
@@ -387,6 +400,10 @@ class ArgReduce : public UnaryPrimitive {
   std::vector<std::vector<int>> output_shapes(
       const std::vector<array>& inputs) override;
 
+  std::pair<ReduceType, int> state() const {
+    return {reduce_type_, axis_};
+  }
+
  private:
   ReduceType reduce_type_;
   int axis_;
@@ -407,6 +424,10 @@ class ArgSort : public UnaryPrimitive {
   DEFINE_INPUT_OUTPUT_SHAPE()
   bool is_equivalent(const Primitive& other) const override;
 
+  int state() const {
+    return axis_;
+  }
+
  private:
   int axis_;
 
@@ -427,6 +448,10 @@ class AsType : public UnaryPrimitive {
   DEFINE_INPUT_OUTPUT_SHAPE()
   bool is_equivalent(const Primitive& other) const override;
 
+  Dtype state() const {
+    return dtype_;
+  }
+
  private:
   Dtype dtype_;
 
@@ -448,6 +473,7 @@ class AsStrided : public UnaryPrimitive {
   void eval_cpu(const std::vector<array>& inputs, array& out) override;
   void eval_gpu(const std::vector<array>& inputs, array& out) override;
 
+  DEFINE_VMAP()
   DEFINE_GRADS()
   DEFINE_PRINT(AsStrided)
   bool is_equivalent(const Primitive& other) const override;
@@ -534,6 +560,9 @@ class Broadcast : public UnaryPrimitive {
   DEFINE_GRADS()
   DEFINE_PRINT(Broadcast)
   bool is_equivalent(const Primitive& other) const override;
+  const std::vector<int>& state() const {
+    return shape_;
+  }
 
  private:
   std::vector<int> shape_;
@@ -558,6 +587,36 @@ class Ceil : public UnaryPrimitive {
   void eval(const std::vector<array>& inputs, array& out);
 };
 
+// Clip x to [a_min, a_max] in one pass. The inputs are x followed by the
+// bounds that are given, all broadcast to the output shape.
+class Clip : public UnaryPrimitive {
+ public:
+  explicit Clip(Stream stream, bool has_min, bool has_max)
+      : UnaryPrimitive(stream), has_min_(has_min), has_max_(has_max) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_VMAP()
+  DEFINE_GRADS()
+  DEFINE_PRINT(Clip)
+  bool is_equivalent(const Primitive& other) const override;
+  DEFINE_INPUT_OUTPUT_SHAPE()
+
+  auto state() const {
+    return std::make_pair(has_min_, has_max_);
+  }
+
+ private:
+  bool has_min_;
+  bool has_max_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+
+  // The derivative of the output with respect to input arg
+  array derivative_mask(const std::vector<array>& primals, int arg);
+};
+
 class Compiled : public Primitive {
  public:
   /*
@@ -614,6 +673,10 @@ class Concatenate : public UnaryPrimitive {
   DEFINE_PRINT(Concatenate)
   bool is_equivalent(const Primitive& other) const override;
 
+  int state() const {
+    return axis_;
+  }
+
  private:
   int axis_;
 
@@ -641,13 +704,15 @@ class Convolution : public UnaryPrimitive {
   explicit Convolution(
       Stream stream,
       const std::vector<int>& kernel_strides,
-      const std::vector<int>& padding,
+      const std::vector<int>& padding_lo,
+      const std::vector<int>& padding_hi,
       const std::vector<int>& kernel_dilation,
       const std::vector<int>& input_dilation,
       const int groups = 1,
       const bool flip = false)
       : UnaryPrimitive(stream),
-        padding_(padding),
+        padding_(padding_lo),
+        padding_hi_(padding_hi),
         kernel_strides_(kernel_strides),
         kernel_dilation_(kernel_dilation),
         input_dilation_(input_dilation),
@@ -663,11 +728,24 @@ class Convolution : public UnaryPrimitive {
       const std::vector<int>& argnums,
       const std::vector<array>& outputs) override;
 
+  DEFINE_VMAP()
   DEFINE_PRINT(Convolution)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(
+        kernel_strides_,
+        padding_,
+        padding_hi_,
+        kernel_dilation_,
+        input_dilation_,
+        groups_,
+        flip_);
+  }
+
  private:
   std::vector<int> padding_;
+  std::vector<int> padding_hi_;
   std::vector<int> kernel_strides_;
   std::vector<int> kernel_dilation_;
   std::vector<int> input_dilation_;
@@ -876,6 +954,10 @@ class Equal : public UnaryPrimitive {
     }
   }
 
+  bool state() const {
+    return equal_nan_;
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& out);
   bool equal_nan_;
@@ -966,6 +1048,10 @@ class FFT : public UnaryPrimitive {
 
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(axes_, inverse_, real_);
+  }
+
  private:
   std::vector<size_t> axes_;
   bool inverse_;
@@ -1023,6 +1109,10 @@ class Gather : public UnaryPrimitive {
   DEFINE_PRINT(Gather)
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<std::vector<int>, std::vector<int>> state() const {
+    return {axes_, slice_sizes_};
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& out);
   std::vector<int> axes_;
@@ -1099,15 +1189,19 @@ class LessEqual : public UnaryPrimitive {
 
 class Load : public UnaryPrimitive {
  public:
+  // If the stored type differs from the output type the data is converted
+  // chunk by chunk while it is read
   explicit Load(
       Stream stream,
       std::shared_ptr<io::Reader> reader,
       size_t offset,
-      bool swap_endianness = false)
+      bool swap_endianness = false,
+      std::optional<Dtype> stored_dtype = std::nullopt)
       : UnaryPrimitive(stream),
         reader_(reader),
         offset_(offset),
-        swap_endianness_(swap_endianness) {};
+        swap_endianness_(swap_endianness),
+        stored_dtype_(stored_dtype) {};
 
   void eval_cpu(const std::vector<array>& inputs, array& out) override;
   void eval_gpu(const std::vector<array>& inputs, array& out) override;
@@ -1119,6 +1213,44 @@ class Load : public UnaryPrimitive {
   std::shared_ptr<io::Reader> reader_;
   size_t offset_;
   bool swap_endianness_;
+  std::optional<Dtype> stored_dtype_;
+};
+
+// Loads a matrix and quantizes it while it is read, producing the same
+// packed weights, scales and biases as quantize()
+class LoadQuantized : public Primitive {
+ public:
+  explicit LoadQuantized(
+      Stream stream,
+      std::shared_ptr<io::Reader> reader,
+      size_t offset,
+      Dtype stored_dtype,
+      int group_size,
+      int bits,
+      bool swap_endianness = false)
+      : Primitive(stream),
+        reader_(reader),
+        offset_(offset),
+        stored_dtype_(stored_dtype),
+        group_size_(group_size),
+        bits_(bits),
+        swap_endianness_(swap_endianness) {};
+
+  void eval_cpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+  void eval_gpu(const std::vector<array>& inputs, std::vector<array>& outputs)
+      override;
+
+  DEFINE_PRINT(LoadQuantized)
+
+ private:
+  void eval(const std::vector<array>& inputs, std::vector<array>& outputs);
+  std::shared_ptr<io::Reader> reader_;
+  size_t offset_;
+  Dtype stored_dtype_;
+  int group_size_;
+  int bits_;
+  bool swap_endianness_;
 };
 
 class Log : public UnaryPrimitive {
@@ -1150,6 +1282,10 @@ class Log : public UnaryPrimitive {
     }
   }
 
+  Base state() const {
+    return base_;
+  }
+
  private:
   Base base_;
   void eval(const std::vector<array>& inputs, array& out);
@@ -1365,6 +1501,10 @@ class NumberOfElements : public UnaryPrimitive {
     return {{}};
   }
 
+  auto state() const {
+    return std::make_tuple(axes_, inverted_, dtype_);
+  }
+
  private:
   std::vector<int> axes_;
   bool inverted_;
@@ -1393,6 +1533,10 @@ class Pad : public UnaryPrimitive {
   DEFINE_PRINT(Pad)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(axes_, low_pad_size_, high_pad_size_);
+  }
+
  private:
   std::vector<int> axes_;
   std::vector<int> low_pad_size_;
@@ -1415,6 +1559,10 @@ class Partition : public UnaryPrimitive {
   DEFINE_INPUT_OUTPUT_SHAPE()
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<int, int> state() const {
+    return {kth_, axis_};
+  }
+
  private:
   int kth_;
   int axis_;
@@ -1422,6 +1570,80 @@ class Partition : public UnaryPrimitive {
   void eval(const std::vector<array>& inputs, array& out);
 };
 
+// Max or average pooling over the spatial axes of a (N, ..., C) input.
+class Pooling : public UnaryPrimitive {
+ public:
+  enum PoolType { Max, Avg };
+
+  explicit Pooling(
+      Stream stream,
+      PoolType pool_type,
+      const std::vector<int>& kernel_size,
+      const std::vector<int>& stride,
+      const std::vector<int>& padding)
+      : UnaryPrimitive(stream),
+        pool_type_(pool_type),
+        kernel_size_(kernel_size),
+        stride_(stride),
+        padding_(padding) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_VMAP()
+  DEFINE_GRADS()
+  DEFINE_PRINT(Pooling)
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(pool_type_, kernel_size_, stride_, padding_);
+  }
+
+ private:
+  PoolType pool_type_;
+  std::vector<int> kernel_size_;
+  std::vector<int> stride_;
+  std::vector<int> padding_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+};
+
+// The gradient of Pooling with respect to its input. The inputs are the
+// pooled array and the cotangent. Max pooling sends each cotangent to the
+// first maximum of its window.
+class PoolingVJP : public UnaryPrimitive {
+ public:
+  explicit PoolingVJP(
+      Stream stream,
+      Pooling::PoolType pool_type,
+      const std::vector<int>& kernel_size,
+      const std::vector<int>& stride,
+      const std::vector<int>& padding)
+      : UnaryPrimitive(stream),
+        pool_type_(pool_type),
+        kernel_size_(kernel_size),
+        stride_(stride),
+        padding_(padding) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_PRINT(PoolingVJP)
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(pool_type_, kernel_size_, stride_, padding_);
+  }
+
+ private:
+  Pooling::PoolType pool_type_;
+  std::vector<int> kernel_size_;
+  std::vector<int> stride_;
+  std::vector<int> padding_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+};
+
 class Power : public UnaryPrimitive {
  public:
   explicit Power(Stream stream) : UnaryPrimitive(stream) {};
@@ -1445,11 +1667,13 @@ class QuantizedMatmul : public UnaryPrimitive {
       Stream stream,
       int group_size,
       int bits,
-      bool transpose)
+      bool transpose,
+      bool quantize_activations = false)
       : UnaryPrimitive(stream),
         group_size_(group_size),
         bits_(bits),
-        transpose_(transpose) {};
+        transpose_(transpose),
+        quantize_activations_(quantize_activations) {};
 
   void eval_cpu(const std::vector<array>& inputs, array& out) override;
   void eval_gpu(const std::vector<array>& inputs, array& out) override;
@@ -1459,10 +1683,17 @@ class QuantizedMatmul : public UnaryPrimitive {
   DEFINE_PRINT(QuantizedMatmul)
   bool is_equivalent(const Primitive& other) const override;
 
+  std::tuple<int, int, bool, bool> state() const {
+    return {group_size_, bits_, transpose_, quantize_activations_};
+  }
+
  private:
   int group_size_;
   int bits_;
   bool transpose_;
+  // Quantize x to int8 per row and compute the product with integers. Only
+  // used by the CPU with 8 bit transposed weights.
+  bool quantize_activations_;
 
   void eval(const std::vector<array>& inputs, array& out);
 };
@@ -1507,6 +1738,10 @@ class RandomBits : public UnaryPrimitive {
   DEFINE_PRINT(RandomBits)
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<std::vector<int>, int> state() const {
+    return {shape_, width_};
+  }
+
  private:
   std::vector<int> shape_;
   int width_;
@@ -1526,6 +1761,9 @@ class Reshape : public UnaryPrimitive {
   DEFINE_GRADS()
   DEFINE_PRINT(Reshape)
   bool is_equivalent(const Primitive& other) const override;
+  const std::vector<int>& state() const {
+    return shape_;
+  }
 
  private:
   std::vector<int> shape_;
@@ -1589,6 +1827,10 @@ class Reduce : public UnaryPrimitive {
   }
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<ReduceType, std::vector<int>> state() const {
+    return {reduce_type_, axes_};
+  }
+
  private:
   ReduceType reduce_type_;
   std::vector<int> axes_;
@@ -1655,6 +1897,10 @@ class Scan : public UnaryPrimitive {
   }
   bool is_equivalent(const Primitive& other) const override;
 
+  std::tuple<ReduceType, int, bool, bool> state() const {
+    return {reduce_type_, axis_, reverse_, inclusive_};
+  }
+
  private:
   ReduceType reduce_type_;
   int axis_;
@@ -1677,6 +1923,7 @@ class Scatter : public UnaryPrimitive {
   void eval_cpu(const std::vector<array>& inputs, array& out) override;
   void eval_gpu(const std::vector<array>& inputs, array& out) override;
 
+  DEFINE_VMAP();
   DEFINE_GRADS();
   void print(std::ostream& os) override {
     os << "Scatter";
@@ -1699,6 +1946,10 @@ class Scatter : public UnaryPrimitive {
   }
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<ReduceType, std::vector<int>> state() const {
+    return {reduce_type_, axes_};
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& out);
   ReduceType reduce_type_;
@@ -1793,6 +2044,10 @@ class Slice : public UnaryPrimitive {
   DEFINE_PRINT(Slice)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(start_indices_, end_indices_, strides_);
+  }
+
  private:
   std::vector<int> start_indices_;
   std::vector<int> end_indices_;
@@ -1829,6 +2084,10 @@ class SliceUpdate : public UnaryPrimitive {
   DEFINE_PRINT(SliceUpdate)
   bool is_equivalent(const Primitive& other) const override;
 
+  auto state() const {
+    return std::make_tuple(start_indices_, end_indices_, strides_);
+  }
+
  private:
   std::vector<int> start_indices_;
   std::vector<int> end_indices_;
@@ -1854,6 +2113,10 @@ class Softmax : public UnaryPrimitive {
 
   bool is_equivalent(const Primitive& other) const override;
 
+  bool state() const {
+    return precise_;
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& out);
   bool precise_;
@@ -1873,12 +2136,56 @@ class Sort : public UnaryPrimitive {
   DEFINE_INPUT_OUTPUT_SHAPE()
   bool is_equivalent(const Primitive& other) const override;
 
+  int state() const {
+    return axis_;
+  }
+
  private:
   int axis_;
 
   void eval(const std::vector<array>& inputs, array& out);
 };
 
+/* Product of a 2D sparse matrix, given by its values, rows and columns in
+ * CSR or COO format, and a dense matrix. The inputs are the values, the row
+ * offsets (CSR) or row indices (COO), the column indices and the dense
+ * matrix. With transpose the sparse matrix is transposed first. */
+class SparseMatmul : public UnaryPrimitive {
+ public:
+  enum Format { CSR, COO };
+
+  explicit SparseMatmul(
+      Stream stream,
+      Format format,
+      int rows,
+      int cols,
+      bool transpose)
+      : UnaryPrimitive(stream),
+        format_(format),
+        rows_(rows),
+        cols_(cols),
+        transpose_(transpose) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_GRADS()
+  DEFINE_PRINT(SparseMatmul)
+  bool is_equivalent(const Primitive& other) const override;
+
+  std::tuple<Format, int, int, bool> state() const {
+    return {format_, rows_, cols_, transpose_};
+  }
+
+ private:
+  Format format_;
+  int rows_;
+  int cols_;
+  bool transpose_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+};
+
 class Split : public Primitive {
  public:
   explicit Split(Stream stream, const std::vector<int>& indices, int axis)
@@ -1894,6 +2201,10 @@ class Split : public Primitive {
   DEFINE_PRINT(Split)
   bool is_equivalent(const Primitive& other) const override;
 
+  std::pair<std::vector<int>, int> state() const {
+    return {indices_, axis_};
+  }
+
  private:
   void eval(const std::vector<array>& inputs, std::vector<array>& outputs);
 
@@ -1939,6 +2250,10 @@ class Sqrt : public UnaryPrimitive {
     }
   }
 
+  bool state() const {
+    return recip_;
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& out);
   bool recip_;
@@ -2038,6 +2353,9 @@ class Transpose : public UnaryPrimitive {
   DEFINE_GRADS()
   DEFINE_PRINT(Transpose)
   bool is_equivalent(const Primitive& other) const override;
+  const std::vector<int>& state() const {
+    return axes_;
+  }
 
  private:
   std::vector<int> axes_;
@@ -2045,6 +2363,82 @@ class Transpose : public UnaryPrimitive {
   void eval(const std::vector<array>& inputs, array& out);
 };
 
+class Upsample : public UnaryPrimitive {
+ public:
+  enum Mode { Nearest, Linear, Cubic };
+
+  explicit Upsample(
+      Stream stream,
+      Mode mode,
+      const std::vector<double>& scale_factor,
+      bool align_corners)
+      : UnaryPrimitive(stream),
+        mode_(mode),
+        scale_factor_(scale_factor),
+        align_corners_(align_corners) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_VMAP()
+  DEFINE_GRADS()
+  DEFINE_PRINT(Upsample)
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(mode_, scale_factor_, align_corners_);
+  }
+
+  // The input positions and weights that make up each output position along
+  // a spatial axis. Output position i reads indices[i * size + t] with weight
+  // weights[i * size + t] for t < size.
+  struct Taps {
+    int size;
+    std::vector<int> indices;
+    std::vector<float> weights;
+  };
+  Taps taps(int axis, int in_size, int out_size) const;
+
+ private:
+  Mode mode_;
+  std::vector<double> scale_factor_;
+  bool align_corners_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+};
+
+// The gradient of Upsample with respect to its input. The input is the
+// cotangent and every input position sums the cotangents it contributed to.
+class UpsampleVJP : public UnaryPrimitive {
+ public:
+  explicit UpsampleVJP(
+      Stream stream,
+      Upsample::Mode mode,
+      const std::vector<double>& scale_factor,
+      bool align_corners)
+      : UnaryPrimitive(stream),
+        mode_(mode),
+        scale_factor_(scale_factor),
+        align_corners_(align_corners) {};
+
+  void eval_cpu(const std::vector<array>& inputs, array& out) override;
+  void eval_gpu(const std::vector<array>& inputs, array& out) override;
+
+  DEFINE_PRINT(UpsampleVJP)
+  bool is_equivalent(const Primitive& other) const override;
+
+  auto state() const {
+    return std::make_tuple(mode_, scale_factor_, align_corners_);
+  }
+
+ private:
+  Upsample::Mode mode_;
+  std::vector<double> scale_factor_;
+  bool align_corners_;
+
+  void eval(const std::vector<array>& inputs, array& out);
+};
+
 /* QR Factorization primitive. */
 class QRF : public Primitive {
  public:
@@ -2104,6 +2498,10 @@ class Cholesky : public UnaryPrimitive {
   DEFINE_VMAP()
   DEFINE_PRINT(Cholesky)
 
+  bool state() const {
+    return upper_;
+  }
+
  private:
   void eval(const std::vector<array>& inputs, array& output);
   bool upper_;
@@ -29,6 +29,15 @@ Stream new_stream(Device d) {
   return scheduler::scheduler().new_stream(d);
 }
 
+Stream new_stream(Device d, CpuAffinity affinity) {
+  if (d != Device::cpu) {
+    throw std::invalid_argument(
+        "[new_stream] Only CPU streams can have a CPU affinity.");
+  }
+  return scheduler::scheduler().new_stream(
+      d, numa::resolve(std::move(affinity)));
+}
+
 Stream new_stream() {
   return scheduler::scheduler().new_stream(default_device());
 }
@@ -11,6 +11,7 @@
 #include "mlx/backend/metal/metal.h"
 #include "mlx/backend/metal/metal_impl.h"
 #include "mlx/device.h"
+#include "mlx/numa.h"
 #include "mlx/stream.h"
 
 namespace mlx::core::scheduler {
@@ -21,10 +22,14 @@ struct StreamThread {
   std::condition_variable cond;
   bool stop;
   Stream stream;
+  CpuAffinity affinity;
   std::thread thread;
 
-  StreamThread(Stream stream)
-      : stop(false), stream(stream), thread(&StreamThread::thread_fn, this) {
+  StreamThread(Stream stream, CpuAffinity affinity = {})
+      : stop(false),
+        stream(stream),
+        affinity(std::move(affinity)),
+        thread(&StreamThread::thread_fn, this) {
     metal::new_stream(stream);
   }
 
@@ -39,6 +44,9 @@ struct StreamThread {
   }
 
   void thread_fn() {
+    if (!affinity.cores.empty()) {
+      numa::bind_current_thread(affinity);
+    }
     while (true) {
       std::function<void()> task;
       {
@@ -84,9 +92,9 @@ class Scheduler {
   Scheduler& operator=(const Scheduler&) = delete;
   Scheduler& operator=(Scheduler&&) = delete;
 
-  Stream new_stream(const Device& d) {
+  Stream new_stream(const Device& d, CpuAffinity affinity = {}) {
     auto stream = Stream(streams_.size(), d);
-    streams_.push_back(new StreamThread{stream});
+    streams_.push_back(new StreamThread{stream, std::move(affinity)});
     return stream;
   }
 
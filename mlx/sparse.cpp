@@ -0,0 +1,345 @@
+// Copyright © 2024 Apple Inc.
+
+#include <limits>
+#include <sstream>
+
+#include "mlx/ops.h"
+#include "mlx/primitives.h"
+#include "mlx/sparse.h"
+#include "mlx/transforms.h"
+#include "mlx/utils.h"
+
+namespace mlx::core::sparse {
+
+namespace {
+
+void check_shape(const std::vector<int>& shape, const std::string& tag) {
+  if (shape.size() != 2 || shape[0] < 0 || shape[1] < 0) {
+    throw std::invalid_argument(
+        tag + " Sparse arrays must have a 2D shape with non-negative sizes.");
+  }
+}
+
+void check_indices(
+    const array& indices,
+    int size,
+    const std::string& name,
+    const std::string& tag) {
+  if (indices.ndim() != 1 || !issubdtype(indices.dtype(), integer)) {
+    throw std::invalid_argument(
+        tag + " The " + name + " must be a 1D array of integers.");
+  }
+  if (indices.size() != size) {
+    std::ostringstream msg;
+    msg << tag << " Expected " << size << " " << name << " but got "
+        << indices.size() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+}
+
+// The kernels address memory with the indices so they are checked against
+// the shape up front. This evaluates the indices.
+void check_range(
+    const array& indices,
+    int size,
+    const std::string& name,
+    const std::string& tag) {
+  if (indices.size() == 0) {
+    return;
+  }
+  auto idx = astype(indices, int64);
+  auto valid = logical_and(
+      all(greater_equal(idx, array(0, int64))),
+      all(less(idx, array(size, int64))));
+  if (!valid.item<bool>()) {
+    std::ostringstream msg;
+    msg << tag << " The " << name << " must be in [0, " << size << ").";
+    throw std::invalid_argument(msg.str());
+  }
+}
+
+// Row offsets start at 0, never decrease and end at the number of entries
+void check_row_ptr(const array& row_ptr, int nnz, const std::string& tag) {
+  auto p = astype(row_ptr, int64);
+  int n = p.size();
+  auto valid = logical_and(
+      equal(slice(p, {0}, {1}), array(0, int64)),
+      equal(slice(p, {n - 1}, {n}), array(nnz, int64)));
+  if (n > 1) {
+    auto steps = subtract(slice(p, {1}, {n}), slice(p, {0}, {n - 1}));
+    valid = logical_and(valid, all(greater_equal(steps, array(0, int64))));
+  }
+  if (!all(valid).item<bool>()) {
+    throw std::invalid_argument(
+        tag +
+        " The row offsets must start at 0, be non-decreasing and end at "
+        "the number of non zeros.");
+  }
+}
+
+// The row of every entry of a CSR matrix. Mark where each row after the
+// first starts and count the marks up to each entry.
+array expand_row_ptr(const SparseArray& a, StreamOrDevice s) {
+  int nnz = a.nnz();
+  int n_rows = a.shape(0);
+  if (n_rows <= 1 || nnz == 0) {
+    return zeros({nnz}, uint32, s);
+  }
+  auto starts = slice(a.row_ptr(), {1}, {n_rows}, s);
+  auto marks = scatter_add(
+      zeros({nnz + 1}, uint32, s),
+      starts,
+      ones({n_rows - 1, 1}, uint32, s),
+      0,
+      s);
+  return slice(cumsum(marks, 0, false, true, s), {0}, {nnz}, s);
+}
+
+array sparse_matmul(
+    const SparseArray& a,
+    const array& b,
+    bool transpose,
+    Dtype dtype,
+    StreamOrDevice s) {
+  auto format =
+      a.format() == Format::CSR ? SparseMatmul::CSR : SparseMatmul::COO;
+  auto rows = a.format() == Format::CSR ? a.row_ptr() : a.row_indices();
+  int out_rows = transpose ? a.shape(1) : a.shape(0);
+  auto stream = to_stream(s);
+  return array(
+      {out_rows, b.shape(1)},
+      dtype,
+      std::make_shared<SparseMatmul>(
+          stream, format, a.shape(0), a.shape(1), transpose),
+      {astype(a.values(), dtype, stream),
+       astype(rows, uint32, stream),
+       astype(a.col_indices(), uint32, stream),
+       astype(b, dtype, stream)});
+}
+
+Dtype matmul_type(const SparseArray& a, const array& b) {
+  auto dtype = promote_types(a.dtype(), b.dtype());
+  return issubdtype(dtype, floating) ? dtype : promote_types(dtype, float32);
+}
+
+} // namespace
+
+const array& SparseArray::row_ptr() const {
+  if (format_ != Format::CSR) {
+    throw std::invalid_argument(
+        "[SparseArray::row_ptr] Only CSR matrices have row offsets.");
+  }
+  return rows_;
+}
+
+const array& SparseArray::row_indices() const {
+  if (format_ != Format::COO) {
+    throw std::invalid_argument(
+        "[SparseArray::row_indices] Only COO matrices have row indices.");
+  }
+  return rows_;
+}
+
+SparseArray csr_array(
+    const array& values,
+    const array& col_indices,
+    const array& row_ptr,
+    const std::vector<int>& shape) {
+  const std::string tag = "[sparse::csr_array]";
+  check_shape(shape, tag);
+  if (values.ndim() != 1) {
+    throw std::invalid_argument(tag + " The values must be a 1D array.");
+  }
+  check_indices(col_indices, values.size(), "column indices", tag);
+  check_indices(row_ptr, shape[0] + 1, "row offsets", tag);
+  check_range(col_indices, shape[1], "column indices", tag);
+  check_row_ptr(row_ptr, values.size(), tag);
+  return SparseArray(Format::CSR, values, row_ptr, col_indices, shape);
+}
+
+SparseArray coo_array(
+    const array& values,
+    const array& row_indices,
+    const array& col_indices,
+    const std::vector<int>& shape) {
+  const std::string tag = "[sparse::coo_array]";
+  check_shape(shape, tag);
+  if (values.ndim() != 1) {
+    throw std::invalid_argument(tag + " The values must be a 1D array.");
+  }
+  check_indices(row_indices, values.size(), "row indices", tag);
+  check_indices(col_indices, values.size(), "column indices", tag);
+  check_range(row_indices, shape[0], "row indices", tag);
+  check_range(col_indices, shape[1], "column indices", tag);
+  return SparseArray(Format::COO, values, row_indices, col_indices, shape);
+}
+
+SparseArray from_dense(const array& a, Format format, StreamOrDevice s) {
+  if (a.ndim() != 2) {
+    throw std::invalid_argument(
+        "[sparse::from_dense] Only 2D arrays can be made sparse.");
+  }
+  if (a.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::invalid_argument(
+        "[sparse::from_dense] The array has too many elements.");
+  }
+  int n_rows = a.shape(0);
+  int n_cols = a.shape(1);
+
+  // Reshape copies non contiguous masks so the flat mask is contiguous
+  auto mask = flatten(not_equal(a, zeros({}, a.dtype(), s), s), s);
+  eval(mask);
+  auto mask_ptr = mask.data<bool>();
+
+  std::vector<uint32_t> flat;
+  std::vector<uint32_t> row_indices;
+  std::vector<uint32_t> col_indices;
+  std::vector<uint32_t> row_ptr(n_rows + 1, 0);
+  for (int i = 0; i < n_rows; ++i) {
+    for (int j = 0; j < n_cols; ++j) {
+      size_t idx = static_cast<size_t>(i) * n_cols + j;
+      if (mask_ptr[idx]) {
+        flat.push_back(idx);
+        row_indices.push_back(i);
+        col_indices.push_back(j);
+      }
+    }
+    row_ptr[i + 1] = flat.size();
+  }
+  int nnz = flat.size();
+
+  auto values = take(flatten(a, s), array(flat.begin(), {nnz}, uint32), s);
+  array cols(col_indices.begin(), {nnz}, uint32);
+  if (format == Format::CSR) {
+    return SparseArray(
+        Format::CSR,
+        values,
+        array(row_ptr.begin(), {n_rows + 1}, uint32),
+        cols,
+        a.shape());
+  } else {
+    return SparseArray(
+        Format::COO,
+        values,
+        array(row_indices.begin(), {nnz}, uint32),
+        cols,
+        a.shape());
+  }
+}
+
+SparseArray to_csr(const SparseArray& a, StreamOrDevice s) {
+  if (a.format() == Format::CSR) {
+    return a;
+  }
+  int nnz = a.nnz();
+  int n_rows = a.shape(0);
+  if (nnz == 0) {
+    return SparseArray(
+        Format::CSR,
+        a.values(),
+        zeros({n_rows + 1}, uint32, s),
+        astype(a.col_indices(), uint32, s),
+        a.shape());
+  }
+
+  // Sort the entries by row and then by column
+  auto rows = astype(a.row_indices(), uint64, s);
+  auto cols = astype(a.col_indices(), uint64, s);
+  auto keys = add(multiply(rows, array(a.shape(1), uint64), s), cols, s);
+  auto order = argsort(keys, 0, s);
+
+  auto counts = scatter_add(
+      zeros({n_rows}, uint32, s),
+      a.row_indices(),
+      ones({nnz, 1}, uint32, s),
+      0,
+      s);
+  auto row_ptr = concatenate(
+      {zeros({1}, uint32, s), cumsum(counts, 0, false, true, s)}, 0, s);
+  return SparseArray(
+      Format::CSR,
+      take(a.values(), order, s),
+      row_ptr,
+      take(astype(a.col_indices(), uint32, s), order, s),
+      a.shape());
+}
+
+SparseArray to_coo(const SparseArray& a, StreamOrDevice s) {
+  if (a.format() == Format::COO) {
+    return a;
+  }
+  return SparseArray(
+      Format::COO,
+      a.values(),
+      expand_row_ptr(a, s),
+      a.col_indices(),
+      a.shape());
+}
+
+array to_dense(const SparseArray& a, StreamOrDevice s) {
+  auto out = zeros(a.shape(), a.dtype(), s);
+  if (a.nnz() == 0) {
+    return out;
+  }
+  auto coo = to_coo(a, s);
+  return scatter_add(
+      out,
+      {coo.row_indices(), coo.col_indices()},
+      reshape(coo.values(), {a.nnz(), 1, 1}, s),
+      {0, 1},
+      s);
+}
+
+SparseArray transpose(const SparseArray& a) {
+  auto coo = to_coo(a);
+  return SparseArray(
+      Format::COO,
+      coo.values(),
+      coo.col_indices(),
+      coo.row_indices(),
+      {a.shape(1), a.shape(0)});
+}
+
+array matmul(const SparseArray& a, const array& b, StreamOrDevice s) {
+  if (b.ndim() != 1 && b.ndim() != 2) {
+    throw std::invalid_argument(
+        "[sparse::matmul] The dense operand must be 1D or 2D.");
+  }
+  if (b.shape(0) != a.shape(1)) {
+    std::ostringstream msg;
+    msg << "[sparse::matmul] Last dimension of first input with shape "
+        << a.shape() << " must match first dimension of second input with "
+        << "shape " << b.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  auto dtype = matmul_type(a, b);
+  if (b.ndim() == 1) {
+    auto out = sparse_matmul(a, reshape(b, {-1, 1}, s), false, dtype, s);
+    return reshape(out, {-1}, s);
+  }
+  return sparse_matmul(a, b, false, dtype, s);
+}
+
+array matmul(const array& a, const SparseArray& b, StreamOrDevice s) {
+  if (a.ndim() != 1 && a.ndim() != 2) {
+    throw std::invalid_argument(
+        "[sparse::matmul] The dense operand must be 1D or 2D.");
+  }
+  if (a.shape(-1) != b.shape(0)) {
+    std::ostringstream msg;
+    msg << "[sparse::matmul] Last dimension of first input with shape "
+        << a.shape() << " must match first dimension of second input with "
+        << "shape " << b.shape() << ".";
+    throw std::invalid_argument(msg.str());
+  }
+  // a @ b = (b^T @ a^T)^T
+  auto dtype = matmul_type(b, a);
+  if (a.ndim() == 1) {
+    auto out = sparse_matmul(b, reshape(a, {-1, 1}, s), true, dtype, s);
+    return reshape(out, {-1}, s);
+  }
+  return core::transpose(
+      sparse_matmul(b, core::transpose(a, s), true, dtype, s), s);
+}
+
+} // namespace mlx::core::sparse
@@ -0,0 +1,129 @@
+// Copyright © 2024 Apple Inc.
+
+#pragma once
+
+#include "mlx/array.h"
+#include "mlx/device.h"
+#include "mlx/stream.h"
+
+namespace mlx::core::sparse {
+
+enum class Format { CSR, COO };
+
+/**
+ * A 2D sparse matrix stored as dense arrays holding its non zero entries.
+ *
+ * - CSR: ``values`` and ``col_indices`` have one entry per non zero ordered
+ *   by row and ``row_ptr`` has ``rows + 1`` entries such that the non zeros
+ *   of row ``i`` are in ``[row_ptr[i], row_ptr[i + 1])``.
+ * - COO: ``values``, ``row_indices`` and ``col_indices`` have one entry per
+ *   non zero in any order. Repeated coordinates are summed.
+ */
+class SparseArray {
+ public:
+  SparseArray(
+      Format format,
+      array values,
+      array rows,
+      array col_indices,
+      std::vector<int> shape)
+      : format_(format),
+        values_(std::move(values)),
+        rows_(std::move(rows)),
+        col_indices_(std::move(col_indices)),
+        shape_(std::move(shape)) {};
+
+  Format format() const {
+    return format_;
+  }
+
+  const std::vector<int>& shape() const {
+    return shape_;
+  }
+
+  int shape(int dim) const {
+    return shape_.at(dim < 0 ? dim + 2 : dim);
+  }
+
+  /** The number of stored entries. */
+  int nnz() const {
+    return values_.size();
+  }
+
+  Dtype dtype() const {
+    return values_.dtype();
+  }
+
+  const array& values() const {
+    return values_;
+  }
+
+  const array& col_indices() const {
+    return col_indices_;
+  }
+
+  /** The row offsets of a CSR matrix. */
+  const array& row_ptr() const;
+
+  /** The row of every entry of a COO matrix. */
+  const array& row_indices() const;
+
+ private:
+  Format format_;
+  array values_;
+  array rows_;
+  array col_indices_;
+  std::vector<int> shape_;
+};
+
+/**
+ * Make a CSR matrix from its values, column indices and row offsets. The
+ * indices are evaluated to check them against the shape.
+ */
+SparseArray csr_array(
+    const array& values,
+    const array& col_indices,
+    const array& row_ptr,
+    const std::vector<int>& shape);
+
+/**
+ * Make a COO matrix from its values and row and column indices. The indices
+ * are evaluated to check them against the shape.
+ */
+SparseArray coo_array(
+    const array& values,
+    const array& row_indices,
+    const array& col_indices,
+    const std::vector<int>& shape);
+
+/**
+ * Make a sparse matrix from the non zero entries of a dense 2D array. The
+ * number of non zeros depends on the data so the input is evaluated.
+ */
+SparseArray from_dense(
+    const array& a,
+    Format format = Format::CSR,
+    StreamOrDevice s = {});
+
+/** Convert a sparse matrix to CSR, sorting COO entries by row and column. */
+SparseArray to_csr(const SparseArray& a, StreamOrDevice s = {});
+
+/** Convert a sparse matrix to COO. */
+SparseArray to_coo(const SparseArray& a, StreamOrDevice s = {});
+
+/** Make a dense array from a sparse matrix. */
+array to_dense(const SparseArray& a, StreamOrDevice s = {});
+
+/** Transpose a sparse matrix. The result is in COO format. */
+SparseArray transpose(const SparseArray& a);
+
+/**
+ * Multiply a sparse matrix with a dense matrix or vector. The work and the
+ * memory scale with the number of non zeros of ``a``.
+ */
+array matmul(const SparseArray& a, const array& b, StreamOrDevice s = {});
+
+/** Multiply a dense matrix or vector with a sparse matrix. */
+array matmul(const array& a, const SparseArray& b, StreamOrDevice s = {});
+
+} // namespace mlx::core::sparse
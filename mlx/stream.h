@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mlx/device.h"
 
 namespace mlx::core {
@@ -21,6 +23,20 @@ void set_default_stream(Stream s);
 /** Make a new stream on the given device. */
 Stream new_stream(Device d);
 
+/**
+ * Placement of the work of a CPU stream. The stream thread and the threads
+ * it uses for parallel kernels run on the given cores, or on the cores of the
+ * NUMA node when no cores are given. Memory allocated by the stream is bound
+ * to the NUMA node.
+ */
+struct CpuAffinity {
+  int numa_node{-1};
+  std::vector<int> cores;
+};
+
+/** Make a new CPU stream pinned to a NUMA node or a set of cores. */
+Stream new_stream(Device d, CpuAffinity affinity);
+
 inline bool operator==(const Stream& lhs, const Stream& rhs) {
   return lhs.index == rhs.index;
 }
@@ -1,6 +1,5 @@
 # Copyright © 2023 Apple Inc.
 
-import math
 from functools import partial
 from typing import Any
 
@@ -129,7 +128,7 @@ def silu(x):
     Applies :math:`x \sigma(x)` element wise, where :math:`\sigma(\cdot)` is
     the logistic sigmoid.
     """
-    return x * mx.sigmoid(x)
+    return mx.fast.silu(x)
 
 
 @partial(mx.compile, shapeless=True)
@@ -153,7 +152,7 @@ def gelu(x) -> mx.array:
     See also :func:`gelu_approx` and :func:`gelu_fast_approx` for faster
     approximations.
     """
-    return x * (1 + mx.erf(x / math.sqrt(2))) / 2
+    return mx.fast.gelu(x)
 
 
 @partial(mx.compile, shapeless=True)
@@ -170,7 +169,7 @@ def gelu_approx(x):
         x = 0.5 * x * \left(1 + \text{Tanh}\left((\sqrt{2 / \pi} * \left(x + 0.044715 * x^3\right)\right)\right)
 
     """
-    return 0.5 * x * (1 + mx.tanh(math.sqrt(2 / math.pi) * (x + 0.044715 * x**3)))
+    return mx.fast.gelu_approx(x)
 
 
 @partial(mx.compile, shapeless=True)
@@ -272,7 +271,7 @@ def mish(x: mx.array) -> mx.array:
         \text{Mish}(x) = x * \text{Tanh}(\text{Softplus}(x))
 
     """
-    return x * mx.tanh(softplus(x))
+    return mx.fast.mish(x)
 
 
 @partial(mx.compile, shapeless=True)
@@ -159,41 +159,7 @@ class GRU(Module):
         else:
             x = x @ self.Wx
 
-        x_rz = x[..., : -self.hidden_size]
-        x_n = x[..., -self.hidden_size :]
-
-        all_hidden = []
-
-        for idx in range(x.shape[-2]):
-            rz = x_rz[..., idx, :]
-            if hidden is not None:
-                h_proj = hidden @ self.Wh
-                h_proj_rz = h_proj[..., : -self.hidden_size]
-                h_proj_n = h_proj[..., -self.hidden_size :]
-
-                if self.bhn is not None:
-                    h_proj_n += self.bhn
-
-                rz = rz + h_proj_rz
-
-            rz = mx.sigmoid(rz)
-
-            r, z = mx.split(rz, 2, axis=-1)
-
-            n = x_n[..., idx, :]
-
-            if hidden is not None:
-                n = n + r * h_proj_n
-            n = mx.tanh(n)
-
-            if hidden is not None:
-                hidden = (1 - z) * n + z * hidden
-            else:
-                hidden = (1 - z) * n
-
-            all_hidden.append(hidden)
-
-        return mx.stack(all_hidden, axis=-2)
+        return mx.fast.gru(x, self.Wh, self.bhn, hidden)
 
 
 class LSTM(Module):
@@ -263,27 +229,4 @@ class LSTM(Module):
         else:
             x = x @ self.Wx
 
-        all_hidden = []
-        all_cell = []
-
-        for idx in range(x.shape[-2]):
-            ifgo = x[..., idx, :]
-            if hidden is not None:
-                ifgo = ifgo + hidden @ self.Wh
-            i, f, g, o = mx.split(ifgo, 4, axis=-1)
-
-            i = mx.sigmoid(i)
-            f = mx.sigmoid(f)
-            g = mx.tanh(g)
-            o = mx.sigmoid(o)
-
-            if cell is not None:
-                cell = f * cell + i * g
-            else:
-                cell = i * g
-            hidden = o * mx.tanh(cell)
-
-            all_cell.append(cell)
-            all_hidden.append(hidden)
-
-        return mx.stack(all_hidden, axis=-2), mx.stack(all_cell, axis=-2)
+        return mx.fast.lstm(x, self.Wh, hidden, cell)
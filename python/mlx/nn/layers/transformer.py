@@ -25,7 +25,14 @@ class MultiHeadAttention(Module):
     ``MultiHeadAttention`` also takes an optional additive attention mask that
     should be broadcastable with ``(batch, num_heads, # queries, # keys)``. The
     mask should have ``-inf`` or very large negative numbers at the positions
-    that should *not* be attended to.
+    that should *not* be attended to. Passing ``mask="causal"`` masks out the
+    keys after every query without building a mask.
+
+    The attention itself runs through
+    :func:`mlx.core.fast.scaled_dot_product_attention` so the scores of all
+    the heads are not materialized at once. Setting ``num_kv_heads`` below
+    ``num_heads`` projects the keys and values to fewer heads which are
+    shared by groups of query heads (grouped query attention).
 
     Args:
         dims (int): The model dimensions. This is also the default
@@ -43,6 +50,8 @@ class MultiHeadAttention(Module):
             be projected to. Default: ``dims``.
         bias (bool, optional): Whether or not to use a bias in the projections.
             Default: ``False``.
+        num_kv_heads (int, optional): The number of key and value heads. It
+            should divide ``num_heads``. Default: ``num_heads``.
     """
 
     def __init__(
@@ -55,6 +64,7 @@ class MultiHeadAttention(Module):
         value_dims: Optional[int] = None,
         value_output_dims: Optional[int] = None,
         bias: bool = False,
+        num_kv_heads: Optional[int] = None,
     ):
         super().__init__()
 
@@ -63,17 +73,26 @@ class MultiHeadAttention(Module):
                 "The input feature dimensions should be divisible by the "
                 f"number of heads ({dims} % {num_heads}) != 0"
             )
+        num_kv_heads = num_kv_heads or num_heads
+        if (num_heads % num_kv_heads) != 0:
+            raise ValueError(
+                "The number of heads should be divisible by the number of "
+                f"key and value heads ({num_heads} % {num_kv_heads}) != 0"
+            )
 
         query_input_dims = query_input_dims or dims
         key_input_dims = key_input_dims or dims
         value_input_dims = value_input_dims or key_input_dims
         value_dims = value_dims or dims
         value_output_dims = value_output_dims or dims
+        kv_dims = dims // num_heads * num_kv_heads
+        kv_value_dims = value_dims // num_heads * num_kv_heads
 
         self.num_heads = num_heads
+        self.num_kv_heads = num_kv_heads
         self.query_proj = Linear(query_input_dims, dims, bias=bias)
-        self.key_proj = Linear(key_input_dims, dims, bias=bias)
-        self.value_proj = Linear(value_input_dims, value_dims, bias=bias)
+        self.key_proj = Linear(key_input_dims, kv_dims, bias=bias)
+        self.value_proj = Linear(value_input_dims, kv_value_dims, bias=bias)
         self.out_proj = Linear(value_dims, value_output_dims, bias=bias)
 
     def __call__(self, queries, keys, values, mask=None):
@@ -82,19 +101,25 @@ class MultiHeadAttention(Module):
         values = self.value_proj(values)
 
         num_heads = self.num_heads
+        num_kv_heads = self.num_kv_heads
         B, L, D = queries.shape
         _, S, _ = keys.shape
         queries = queries.reshape(B, L, num_heads, -1).transpose(0, 2, 1, 3)
-        keys = keys.reshape(B, S, num_heads, -1).transpose(0, 2, 3, 1)
-        values = values.reshape(B, S, num_heads, -1).transpose(0, 2, 1, 3)
+        keys = keys.reshape(B, S, num_kv_heads, -1).transpose(0, 2, 1, 3)
+        values = values.reshape(B, S, num_kv_heads, -1).transpose(0, 2, 1, 3)
+
+        causal = isinstance(mask, str)
+        if causal:
+            if mask != "causal":
+                raise ValueError(f"[MultiHeadAttention] Unknown mask {mask!r}")
+            mask = None
 
         # Dimensions are [batch x num heads x sequence x hidden dim]
         scale = math.sqrt(1 / queries.shape[-1])
-        scores = (queries * scale) @ keys
-        if mask is not None:
-            scores = scores + mask.astype(scores.dtype)
-        scores = mx.softmax(scores, axis=-1)
-        values_hat = (scores @ values).transpose(0, 2, 1, 3).reshape(B, L, -1)
+        values_hat = mx.fast.scaled_dot_product_attention(
+            queries, keys, values, scale=scale, mask=mask, causal=causal
+        )
+        values_hat = values_hat.transpose(0, 2, 1, 3).reshape(B, L, -1)
 
         return self.out_proj(values_hat)
 
@@ -1,9 +1,11 @@
 # Copyright © 2023-2024 Apple Inc.
 
 from functools import wraps
-from typing import Callable
+from itertools import accumulate
+from typing import Any, Callable, Optional
 
 import mlx.core as mx
+from mlx.utils import tree_flatten, tree_map, tree_unflatten
 
 from .layers.base import Module
 
@@ -68,3 +70,76 @@ def checkpoint(module: Module, fn: Callable = None):
         return checkpointed_fn(module.trainable_parameters(), *args, **kwargs)
 
     return wrapped_checkpointed_fn
+
+
+def average_gradients(
+    gradients: Any,
+    group: Optional[mx.distributed.Group] = None,
+    all_reduce_size: int = 32 * 1024**2,
+):
+    """Average the gradients across the processes of the distributed group.
+
+    Small gradients are packed in buckets of about ``all_reduce_size`` bytes
+    which are averaged with a single :func:`mlx.core.distributed.all_sum`.
+    Every bucket is a separate node of the graph so its communication can
+    start as soon as the gradients it contains are computed, overlapping with
+    the rest of the backward pass.
+
+    Args:
+        gradients (Any): The Python tree containing the gradients (it should
+            have the same structure across processes).
+        group (Optional[mlx.core.distributed.Group]): The group of processes to
+            average the gradients across. If set to ``None`` the global group
+            is used. Default: ``None``.
+        all_reduce_size (int): Group arrays until their size in bytes exceeds
+            this number. Perform one communication step per group of arrays.
+            If less or equal to 0 array grouping is disabled. Default: ``32MiB``.
+
+    Returns:
+        The tree of averaged gradients.
+    """
+    group = group or mx.distributed.init()
+    N = group.size()
+
+    if N == 1:
+        return gradients
+
+    def _average(x):
+        return mx.distributed.all_sum(x, group=group) / N
+
+    if all_reduce_size <= 0:
+        return tree_map(_average, gradients)
+
+    flat_grads = tree_flatten(gradients)
+    if len(flat_grads) == 0:
+        return gradients
+
+    # Bucket the gradients of the same type in the order they appear
+    buckets = {}
+    averaged = [None] * len(flat_grads)
+
+    def _flush(dtype):
+        indices = buckets.pop(dtype)[0]
+        if len(indices) == 1:
+            i = indices[0]
+            averaged[i] = _average(flat_grads[i][1])
+            return
+        shapes = [flat_grads[i][1].shape for i in indices]
+        sizes = [flat_grads[i][1].size for i in indices]
+        big = mx.concatenate([flat_grads[i][1].reshape(-1) for i in indices])
+        big = _average(big)
+        offsets = list(accumulate(sizes))[:-1]
+        for i, shape, part in zip(indices, shapes, mx.split(big, offsets)):
+            averaged[i] = part.reshape(shape)
+
+    for i, (_, g) in enumerate(flat_grads):
+        indices, nbytes = buckets.setdefault(g.dtype, ([], 0))
+        indices.append(i)
+        nbytes += g.nbytes
+        buckets[g.dtype] = (indices, nbytes)
+        if nbytes >= all_reduce_size:
+            _flush(g.dtype)
+    for dtype in list(buckets.keys()):
+        _flush(dtype)
+
+    return tree_unflatten([(k, a) for (k, _), a in zip(flat_grads, averaged)])
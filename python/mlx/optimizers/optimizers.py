@@ -84,8 +84,39 @@ class Optimizer:
         # Increment the step
         self.state["step"] = self.step + 1
 
+        # Gather the leaves so that the update can be applied to all of them
+        # at once
+        grads, params, states = [], [], []
+
+        def collect(gradient, parameter, state):
+            grads.append(gradient)
+            params.append(parameter)
+            states.append(state)
+            return len(grads) - 1
+
+        indices = tree_map(collect, gradients, parameters, self.state)
+
         # Apply the update
-        return tree_map(self.apply_single, gradients, parameters, self.state)
+        updated = self.apply_multi(grads, params, states)
+        return tree_map(lambda i: updated[i], indices)
+
+    def apply_multi(
+        self, gradients: List[mx.array], parameters: List[mx.array], states: List[dict]
+    ):
+        """Apply the update to a list of parameters and return the updated
+        parameters.
+
+        By default :meth:`apply_single` is called for each parameter. Derived
+        classes can override it to update all the parameters at once.
+
+        Args:
+            gradients (list(mx.array)): The gradient of each parameter.
+            parameters (list(mx.array)): The parameters to update.
+            states (list(dict)): The optimizer's state of each parameter.
+        """
+        return [
+            self.apply_single(g, p, s) for g, p, s in zip(gradients, parameters, states)
+        ]
 
     def apply_single(self, gradient: mx.array, parameter: mx.array, state: dict):
         """To be extended by derived classes to implement the optimizer's update.
@@ -198,6 +229,30 @@ class SGD(Optimizer):
         state["v"] = v
         return parameter - self.learning_rate.astype(gradient.dtype) * update
 
+    def apply_multi(
+        self, gradients: List[mx.array], parameters: List[mx.array], states: List[dict]
+    ):
+        """Performs the SGD update of all the parameters at once with
+        :func:`mlx.core.fast.sgd_update`."""
+        if type(self).apply_single is not SGD.apply_single:
+            return super().apply_multi(gradients, parameters, states)
+
+        momentum = self.momentum > 0
+        updated = mx.fast.sgd_update(
+            parameters,
+            gradients,
+            [s["v"] for s in states] if momentum else [],
+            self.learning_rate,
+            self.momentum,
+            self.weight_decay,
+            self.dampening,
+            self.nesterov,
+        )
+        if momentum:
+            for state, v in zip(states, updated[1]):
+                state["v"] = v
+        return updated[0]
+
 
 class RMSprop(Optimizer):
     r"""The RMSprop optimizer [1].
@@ -429,6 +484,33 @@ class Adam(Optimizer):
 
         return parameter - lr * m / (mx.sqrt(v) + eps)
 
+    def apply_multi(
+        self, gradients: List[mx.array], parameters: List[mx.array], states: List[dict]
+    ):
+        """Performs the Adam update of all the parameters at once with
+        :func:`mlx.core.fast.adam_update`."""
+        if type(self).apply_single is not Adam.apply_single:
+            return super().apply_multi(gradients, parameters, states)
+        return self._adam_update(gradients, parameters, states, 0.0)
+
+    def _adam_update(self, gradients, parameters, states, weight_decay):
+        b1, b2 = self.betas
+        parameters, m, v = mx.fast.adam_update(
+            parameters,
+            gradients,
+            [s["m"] for s in states],
+            [s["v"] for s in states],
+            self.learning_rate,
+            b1,
+            b2,
+            self.eps,
+            weight_decay,
+        )
+        for state, m_i, v_i in zip(states, m, v):
+            state["m"] = m_i
+            state["v"] = v_i
+        return parameters
+
 
 class AdamW(Adam):
     r"""The AdamW optimizer [1].
@@ -477,6 +559,15 @@ class AdamW(Adam):
             gradient, parameter * (1 - lr * self.weight_decay), state
         )
 
+    def apply_multi(
+        self, gradients: List[mx.array], parameters: List[mx.array], states: List[dict]
+    ):
+        """Performs the AdamW update of all the parameters at once with
+        :func:`mlx.core.fast.adam_update`."""
+        if type(self).apply_single is not AdamW.apply_single:
+            return Optimizer.apply_multi(self, gradients, parameters, states)
+        return self._adam_update(gradients, parameters, states, self.weight_decay)
+
 
 class Adamax(Adam):
     r"""The Adamax optimizer, a variant of Adam based on the infinity norm [1].
@@ -594,6 +685,28 @@ class Lion(Optimizer):
             parameter = (1 - lr * weight_decay) * parameter
         return parameter - lr * mx.sign(c)
 
+    def apply_multi(
+        self, gradients: List[mx.array], parameters: List[mx.array], states: List[dict]
+    ):
+        """Performs the Lion update of all the parameters at once with
+        :func:`mlx.core.fast.lion_update`."""
+        if type(self).apply_single is not Lion.apply_single:
+            return super().apply_multi(gradients, parameters, states)
+
+        b1, b2 = self.betas
+        parameters, m = mx.fast.lion_update(
+            parameters,
+            gradients,
+            [s["m"] for s in states],
+            self.learning_rate,
+            b1,
+            b2,
+            self.weight_decay,
+        )
+        for state, m_i in zip(states, m):
+            state["m"] = m_i
+        return parameters
+
 
 class Adafactor(Optimizer):
     r"""The Adafactor optimizer.
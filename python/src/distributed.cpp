@@ -0,0 +1,165 @@
+// Copyright © 2024 Apple Inc.
+
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/shared_ptr.h>
+#include <nanobind/stl/variant.h>
+
+#include "mlx/distributed/distributed.h"
+#include "mlx/distributed/ops.h"
+
+namespace nb = nanobind;
+using namespace nb::literals;
+using namespace mlx::core;
+
+void init_distributed(nb::module_& parent_module) {
+  auto m = parent_module.def_submodule(
+      "distributed", "mlx.core.distributed: Communication operations");
+
+  nb::class_<distributed::Group>(
+      m,
+      "Group",
+      R"pbcopy(
+        An :class:`mlx.core.distributed.Group` represents a group of independent mlx
+        processes that can communicate.
+      )pbcopy")
+      .def("rank", &distributed::Group::rank, "Get the rank of this process")
+      .def("size", &distributed::Group::size, "Get the size of the group");
+
+  m.def(
+      "is_available",
+      &distributed::is_available,
+      R"pbdoc(
+        Check if a communication backend is available.
+      )pbdoc");
+
+  m.def(
+      "init",
+      &distributed::init,
+      R"pbdoc(
+        Initialize the communication backend and create the global communication group.
+
+        The group is configured with the environment variables
+        ``MLX_WORLD_SIZE`` and ``MLX_RANK``. Without them the group contains
+        only this process. ``MLX_DISTRIBUTED_BACKEND`` selects ``shm``
+        (default) for processes on a single host, or ``tcp``. The ``tcp``
+        backend reads the address of every rank from the comma separated
+        ``MLX_DISTRIBUTED_HOSTS`` and defaults to consecutive ports on the
+        localhost starting from ``MLX_DISTRIBUTED_PORT``.
+
+        Returns:
+          Group: The global communication group.
+      )pbdoc");
+
+  m.def(
+      "all_sum",
+      &distributed::all_sum,
+      "x"_a,
+      nb::kw_only(),
+      "group"_a = nb::none(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def all_sum(x: array, *, group: Optional[Group] = None, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        All reduce sum.
+
+        Sum the ``x`` arrays from all processes in the group.
+
+        Args:
+          x (array): Input array.
+          group (Group): The group of processes that will participate in the
+            reduction. If set to ``None`` the global group is used. Default:
+            ``None``.
+          stream (Stream, optional): Stream or device. Defaults to ``None``
+            in which case a dedicated communication stream is used.
+
+        Returns:
+          array: The sum of all ``x`` arrays.
+      )pbdoc");
+
+  m.def(
+      "all_gather",
+      &distributed::all_gather,
+      "x"_a,
+      nb::kw_only(),
+      "group"_a = nb::none(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def all_gather(x: array, *, group: Optional[Group] = None, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Gather arrays from all processes.
+
+        Gather the ``x`` arrays from all processes in the group and concatenate
+        them along the first axis. The arrays should all have the same shape.
+
+        Args:
+          x (array): Input array.
+          group (Group): The group of processes that will participate in the
+            gather. If set to ``None`` the global group is used. Default:
+            ``None``.
+          stream (Stream, optional): Stream or device. Defaults to ``None``
+            in which case a dedicated communication stream is used.
+
+        Returns:
+          array: The concatenation of all ``x`` arrays.
+      )pbdoc");
+
+  m.def(
+      "reduce_scatter",
+      &distributed::reduce_scatter,
+      "x"_a,
+      nb::kw_only(),
+      "group"_a = nb::none(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def reduce_scatter(x: array, *, group: Optional[Group] = None, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Reduce scatter sum.
+
+        Sum the ``x`` arrays from all processes in the group and split the
+        result along the first axis. Each process receives the block of rows
+        matching its rank. The first axis of ``x`` must be divisible by the
+        size of the group.
+
+        Args:
+          x (array): Input array.
+          group (Group): The group of processes that will participate in the
+            reduction. If set to ``None`` the global group is used. Default:
+            ``None``.
+          stream (Stream, optional): Stream or device. Defaults to ``None``
+            in which case a dedicated communication stream is used.
+
+        Returns:
+          array: The block of the sum belonging to this process.
+      )pbdoc");
+
+  m.def(
+      "broadcast",
+      &distributed::broadcast,
+      "x"_a,
+      "root"_a = 0,
+      nb::kw_only(),
+      "group"_a = nb::none(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def broadcast(x: array, root: int = 0, *, group: Optional[Group] = None, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Broadcast an array from one process.
+
+        Every process receives the ``x`` array of the ``root`` process. The
+        arrays of the other processes only provide the shape and type.
+
+        Args:
+          x (array): Input array.
+          root (int): The rank of the process to broadcast from. Default:
+            ``0``.
+          group (Group): The group of processes that will participate in the
+            broadcast. If set to ``None`` the global group is used. Default:
+            ``None``.
+          stream (Stream, optional): Stream or device. Defaults to ``None``
+            in which case a dedicated communication stream is used.
+
+        Returns:
+          array: The ``x`` array of the root process.
+      )pbdoc");
+}
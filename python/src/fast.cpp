@@ -2,7 +2,9 @@
 
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/optional.h>
+#include <nanobind/stl/pair.h>
 #include <nanobind/stl/variant.h>
+#include <nanobind/stl/vector.h>
 
 #include "mlx/fast.h"
 #include "mlx/ops.h"
@@ -104,16 +106,24 @@ void init_fast(nb::module_& parent_module) {
 
   m.def(
       "scaled_dot_product_attention",
-      &fast::scaled_dot_product_attention,
+      nb::overload_cast<
+          const array&,
+          const array&,
+          const array&,
+          const float,
+          const std::optional<array>&,
+          bool,
+          StreamOrDevice>(&fast::scaled_dot_product_attention),
       "q"_a,
       "k"_a,
       "v"_a,
       nb::kw_only(),
       "scale"_a,
       "mask"_a = nb::none(),
+      "causal"_a = false,
       "stream"_a = nb::none(),
       nb::sig(
-          "def scaled_dot_product_attention(q: array, k: array, v: array, *, scale: float,  mask: Union[None, array] = None, stream: Union[None, Stream, Device] = None) -> array"),
+          "def scaled_dot_product_attention(q: array, k: array, v: array, *, scale: float,  mask: Union[None, array] = None, causal: bool = False, stream: Union[None, Stream, Device] = None) -> array"),
       R"pbdoc(
         A fast implementation of multi-head attention: ``O = softmax(Q @ K.T, dim=-1) @ V``.
 
@@ -135,8 +145,350 @@ void init_fast(nb::module_& parent_module) {
             v (array): Input values array.
             scale (float): Scale for queries (typically ``1.0 / sqrt(q.shape(-1)``)
             mask (array, optional): An additive mask to apply to the query-key scores.
+            causal (bool, optional): Only let every query attend to the keys
+              up to its own position, with the last query aligned to the
+              last key. The mask is implied and never materialized.
+              Default: ``False``.
 
         Returns:
             array: The output array.
       )pbdoc");
+
+  m.def(
+      "quantized_scaled_dot_product_attention",
+      &fast::quantized_scaled_dot_product_attention,
+      "q"_a,
+      "k"_a,
+      "k_scales"_a,
+      "k_biases"_a,
+      "v"_a,
+      "v_scales"_a,
+      "v_biases"_a,
+      nb::kw_only(),
+      "scale"_a,
+      "mask"_a = nb::none(),
+      "group_size"_a = 64,
+      "bits"_a = 4,
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def quantized_scaled_dot_product_attention(q: array, k: array, k_scales: array, k_biases: array, v: array, v_scales: array, v_biases: array, *, scale: float, mask: Union[None, array] = None, group_size: int = 64, bits: int = 4, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Multi-head attention with quantized keys and values.
+
+        Computes the same result as :func:`scaled_dot_product_attention`
+        with ``k`` and ``v`` replaced by
+        ``dequantize(k, k_scales, k_biases, group_size, bits)`` and the same
+        for ``v``. The keys and values are given in the format returned by
+        :func:`mlx.core.quantize` so a KV cache can be stored in 4 or 8 bits.
+
+        On the CPU the quantized keys and values are dequantized one row at
+        a time inside the attention loop. Other devices dequantize them
+        first.
+
+        Args:
+            q (array): Input query array.
+            k (array): Quantized keys array.
+            k_scales (array): The scales of the keys.
+            k_biases (array): The biases of the keys.
+            v (array): Quantized values array.
+            v_scales (array): The scales of the values.
+            v_biases (array): The biases of the values.
+            scale (float): Scale for queries (typically ``1.0 / sqrt(q.shape(-1)``)
+            mask (array, optional): An additive mask to apply to the query-key scores.
+            group_size (int, optional): The group size used to quantize the
+              keys and values. Default: ``64``.
+            bits (int, optional): The number of bits used to quantize the
+              keys and values, ``4`` or ``8``. Default: ``4``.
+
+        Returns:
+            array: The output array.
+      )pbdoc");
+
+  m.def(
+      "lstm",
+      [](const array& x,
+         const array& w_h,
+         const std::optional<array>& hidden,
+         const std::optional<array>& cell,
+         StreamOrDevice s) {
+        auto out = fast::lstm(x, w_h, hidden, cell, s);
+        return std::make_pair(out[0], out[1]);
+      },
+      "x"_a,
+      "w_h"_a,
+      "hidden"_a = nb::none(),
+      "cell"_a = nb::none(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def lstm(x: array, w_h: array, hidden: Union[None, array] = None, cell: Union[None, array] = None, *, stream: Union[None, Stream, Device] = None) -> Tuple[array, array]"),
+      R"pbdoc(
+        Run an LSTM over a whole sequence.
+
+        ``x`` is the input projection of every step, for instance
+        ``x @ W_x + b``, with shape ``(..., L, 4 * H)`` and the gates in
+        ``(i, f, g, o)`` order. The result is the same as the step by step
+        loop of :class:`mlx.nn.LSTM`.
+
+        On the CPU the recurrence runs in a single kernel with the gate math
+        fused into each step and the gradient is computed by a single
+        backpropagation through time kernel. Other devices run the loop of
+        operations.
+
+        Args:
+            x (array): The projected input of shape ``(..., L, 4 * H)``.
+            w_h (array): The hidden weights of shape ``(H, 4 * H)``.
+            hidden (array, optional): The initial hidden state of shape
+              ``(..., H)``. Default: zeros.
+            cell (array, optional): The initial cell state of shape
+              ``(..., H)``. Default: zeros.
+
+        Returns:
+            tuple(array, array): The hidden and cell states of every step,
+            both of shape ``(..., L, H)``.
+      )pbdoc");
+
+  m.def(
+      "gru",
+      &fast::gru,
+      "x"_a,
+      "w_h"_a,
+      "b_hn"_a = nb::none(),
+      "hidden"_a = nb::none(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def gru(x: array, w_h: array, b_hn: Union[None, array] = None, hidden: Union[None, array] = None, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Run a GRU over a whole sequence.
+
+        ``x`` is the input projection of every step with shape
+        ``(..., L, 3 * H)`` and the gates in ``(r, z, n)`` order. The result
+        is the same as the step by step loop of :class:`mlx.nn.GRU`.
+
+        On the CPU the recurrence runs in a single kernel with the gate math
+        fused into each step and the gradient is computed by a single
+        backpropagation through time kernel. Other devices run the loop of
+        operations.
+
+        Args:
+            x (array): The projected input of shape ``(..., L, 3 * H)``.
+            w_h (array): The hidden weights of shape ``(H, 3 * H)``.
+            b_hn (array, optional): The bias added to the hidden projection
+              of the candidate gate, of shape ``(H,)``. Default: ``None``.
+            hidden (array, optional): The initial hidden state of shape
+              ``(..., H)``. Without it the first step has no hidden
+              projection. Default: ``None``.
+
+        Returns:
+            array: The hidden state of every step of shape ``(..., L, H)``.
+      )pbdoc");
+
+  m.def(
+      "gelu",
+      &fast::gelu,
+      "x"_a,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def gelu(x: array, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Gaussian Error Linear Unit.
+
+        Computes :math:`x \Phi(x)` where :math:`\Phi` is the Gaussian CDF
+        in a single pass over ``x``, see :func:`mlx.nn.gelu`.
+        The gradient is computed in a single pass as well. Integer inputs
+        are cast to ``float32``.
+
+        Args:
+            x (array): Input array.
+
+        Returns:
+            array: The output array.
+      )pbdoc");
+  m.def(
+      "gelu_approx",
+      &fast::gelu_approx,
+      "x"_a,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def gelu_approx(x: array, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        The tanh approximation of the Gaussian Error Linear Unit.
+
+        Computes :math:`0.5 x (1 + \tanh(\sqrt{2 / \pi} (x + 0.044715
+        x^3)))` in a single pass over ``x``, see :func:`mlx.nn.gelu_approx`.
+        The gradient is computed in a single pass as well. Integer inputs
+        are cast to ``float32``.
+
+        Args:
+            x (array): Input array.
+
+        Returns:
+            array: The output array.
+      )pbdoc");
+  m.def(
+      "silu",
+      &fast::silu,
+      "x"_a,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def silu(x: array, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Sigmoid Linear Unit.
+
+        Computes :math:`x \sigma(x)` in a single pass over ``x``, see
+        :func:`mlx.nn.silu`.
+        The gradient is computed in a single pass as well. Integer inputs
+        are cast to ``float32``.
+
+        Args:
+            x (array): Input array.
+
+        Returns:
+            array: The output array.
+      )pbdoc");
+  m.def(
+      "mish",
+      &fast::mish,
+      "x"_a,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def mish(x: array, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Mish activation.
+
+        Computes :math:`x \tanh(\text{softplus}(x))` in a single pass over
+        ``x``, see :func:`mlx.nn.mish`.
+        The gradient is computed in a single pass as well. Integer inputs
+        are cast to ``float32``.
+
+        Args:
+            x (array): Input array.
+
+        Returns:
+            array: The output array.
+      )pbdoc");
+  m.def(
+      "sgd_update",
+      &fast::sgd_update,
+      "params"_a,
+      "grads"_a,
+      "v"_a,
+      "learning_rate"_a,
+      "momentum"_a = 0.0,
+      "weight_decay"_a = 0.0,
+      "dampening"_a = 0.0,
+      "nesterov"_a = false,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def sgd_update(params: List[array], grads: List[array], v: List[array], learning_rate: array, momentum: float = 0.0, weight_decay: float = 0.0, dampening: float = 0.0, nesterov: bool = False, *, stream: Union[None, Stream, Device] = None) -> List[List[array]]"),
+      R"pbdoc(
+        Apply one step of SGD to a list of parameters.
+
+        The update matches :class:`mlx.optimizers.SGD`. On the CPU every
+        parameter whose gradient and momentum share its floating point type
+        is updated by a single kernel which reads each element once and
+        writes the results in place when the old buffers are no longer
+        referenced. Other devices apply the update with operations.
+
+        Args:
+            params (list(array)): The parameters.
+            grads (list(array)): The gradient of each parameter.
+            v (list(array)): The momentum buffer of each parameter. It is
+              ignored, and can be empty, when ``momentum`` is not positive.
+            learning_rate (array): The scalar learning rate.
+            momentum (float, optional): The momentum strength. Default: ``0``.
+            weight_decay (float, optional): The weight decay (L2 penalty).
+              Default: ``0``.
+            dampening (float, optional): Dampening for momentum.
+              Default: ``0``.
+            nesterov (bool, optional): Enables Nesterov momentum.
+              Default: ``False``.
+
+        Returns:
+            list(list(array)): The new parameters followed, when
+            ``momentum`` is positive, by the new momentum buffers.
+      )pbdoc");
+  m.def(
+      "adam_update",
+      &fast::adam_update,
+      "params"_a,
+      "grads"_a,
+      "m"_a,
+      "v"_a,
+      "learning_rate"_a,
+      "beta1"_a = 0.9,
+      "beta2"_a = 0.999,
+      "eps"_a = 1e-8,
+      "weight_decay"_a = 0.0,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def adam_update(params: List[array], grads: List[array], m: List[array], v: List[array], learning_rate: array, beta1: float = 0.9, beta2: float = 0.999, eps: float = 1e-8, weight_decay: float = 0.0, *, stream: Union[None, Stream, Device] = None) -> List[List[array]]"),
+      R"pbdoc(
+        Apply one step of Adam to a list of parameters.
+
+        The update matches :class:`mlx.optimizers.Adam` and, with a
+        ``weight_decay``, :class:`mlx.optimizers.AdamW`. See
+        :func:`sgd_update` for when the update is fused.
+
+        Args:
+            params (list(array)): The parameters.
+            grads (list(array)): The gradient of each parameter.
+            m (list(array)): The first moment of each parameter.
+            v (list(array)): The second moment of each parameter.
+            learning_rate (array): The scalar learning rate.
+            beta1 (float, optional): The first moment coefficient.
+              Default: ``0.9``.
+            beta2 (float, optional): The second moment coefficient.
+              Default: ``0.999``.
+            eps (float, optional): The term added to the denominator.
+              Default: ``1e-8``.
+            weight_decay (float, optional): The decoupled weight decay.
+              Default: ``0``.
+
+        Returns:
+            list(list(array)): The new parameters, first moments and second
+            moments.
+      )pbdoc");
+  m.def(
+      "lion_update",
+      &fast::lion_update,
+      "params"_a,
+      "grads"_a,
+      "m"_a,
+      "learning_rate"_a,
+      "beta1"_a = 0.9,
+      "beta2"_a = 0.99,
+      "weight_decay"_a = 0.0,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def lion_update(params: List[array], grads: List[array], m: List[array], learning_rate: array, beta1: float = 0.9, beta2: float = 0.99, weight_decay: float = 0.0, *, stream: Union[None, Stream, Device] = None) -> List[List[array]]"),
+      R"pbdoc(
+        Apply one step of Lion to a list of parameters.
+
+        The update matches :class:`mlx.optimizers.Lion`. See
+        :func:`sgd_update` for when the update is fused.
+
+        Args:
+            params (list(array)): The parameters.
+            grads (list(array)): The gradient of each parameter.
+            m (list(array)): The momentum of each parameter.
+            learning_rate (array): The scalar learning rate.
+            beta1 (float, optional): The update direction coefficient.
+              Default: ``0.9``.
+            beta2 (float, optional): The momentum coefficient.
+              Default: ``0.99``.
+            weight_decay (float, optional): The weight decay.
+              Default: ``0``.
+
+        Returns:
+            list(list(array)): The new parameters and momentum buffers.
+      )pbdoc");
 }
@@ -1,13 +1,16 @@
 // Copyright © 2023-2024 Apple Inc.
 
 #include <nanobind/stl/vector.h>
+#include <unistd.h>
 #include <cstring>
 #include <fstream>
+#include <mutex>
 #include <stdexcept>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "mlx/io.h"
 #include "mlx/io/load.h"
 #include "mlx/ops.h"
 #include "mlx/utils.h"
@@ -32,55 +35,19 @@ bool is_ostream_object(const nb::object& file) {
       nb::hasattr(file, "tell") && nb::hasattr(file, "closed");
 }
 
-bool is_zip_file(const nb::module_& zipfile, const nb::object& file) {
-  if (is_istream_object(file)) {
-    auto st_pos = file.attr("tell")();
-    bool r = nb::cast<bool>(zipfile.attr("is_zipfile")(file));
-    file.attr("seek")(st_pos, 0);
-    return r;
+// Duplicate the descriptor backing a Python file object so it can be read or
+// written natively without the GIL. Returns -1 if there is none.
+int dup_fileno(const nb::object& file) {
+  if (!nb::hasattr(file, "fileno")) {
+    return -1;
   }
-  return nb::cast<bool>(zipfile.attr("is_zipfile")(file));
-}
-
-class ZipFileWrapper {
- public:
-  ZipFileWrapper(
-      const nb::module_& zipfile,
-      const nb::object& file,
-      char mode = 'r',
-      int compression = 0)
-      : zipfile_module_(zipfile),
-        zipfile_object_(zipfile.attr("ZipFile")(
-            file,
-            "mode"_a = mode,
-            "compression"_a = compression,
-            "allowZip64"_a = true)),
-        files_list_(zipfile_object_.attr("namelist")()),
-        open_func_(zipfile_object_.attr("open")),
-        read_func_(zipfile_object_.attr("read")),
-        close_func_(zipfile_object_.attr("close")) {}
-
-  std::vector<std::string> namelist() const {
-    return nb::cast<std::vector<std::string>>(files_list_);
-  }
-
-  nb::object open(const std::string& key, char mode = 'r') {
-    // Following numpy :
-    // https://github.com/numpy/numpy/blob/db4f43983cb938f12c311e1f5b7165e270c393b4/numpy/lib/npyio.py#L742C36-L742C47
-    if (mode == 'w') {
-      return open_func_(key, "mode"_a = mode, "force_zip64"_a = true);
-    }
-    return open_func_(key, "mode"_a = mode);
+  try {
+    return dup(nb::cast<int>(file.attr("fileno")()));
+  } catch (const nb::python_error&) {
+    // io.BytesIO and friends raise io.UnsupportedOperation
+    return -1;
   }
-
- private:
-  nb::module_ zipfile_module_;
-  nb::object zipfile_object_;
-  nb::list files_list_;
-  nb::object open_func_;
-  nb::object read_func_;
-  nb::object close_func_;
-};
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // Loading
@@ -146,11 +113,27 @@ class PyFileReader : public io::Reader {
     }
   }
 
+  // Zip members are read from several threads so serialize the seeks
+  void read(char* data, size_t n, size_t offset) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nb::gil_scoped_acquire gil;
+    auto pos = tell_func_();
+    seek_func_(offset, (int)std::ios_base::beg);
+    auto memview = PyMemoryView_FromMemory(data, n, PyBUF_WRITE);
+    nb::object bytes_read = readinto_func_(nb::handle(memview));
+    seek_func_(pos, (int)std::ios_base::beg);
+
+    if (bytes_read.is_none() || nb::cast<size_t>(bytes_read) < n) {
+      throw std::runtime_error("[load] Failed to read from python stream");
+    }
+  }
+
   std::string label() const override {
     return "python file object";
   }
 
  private:
+  std::mutex mutex_;
   nb::object pyistream_;
   nb::object readinto_func_;
   nb::object seek_func_;
@@ -179,6 +162,16 @@ mlx_load_safetensor_helper(nb::object file, StreamOrDevice s) {
       "[load_safetensors] Input must be a file-like object, or string");
 }
 
+// Only paths are accepted since the tensors are read when the loaded arrays
+// are evaluated, possibly after a Python file object has been closed.
+Checkpoint mlx_open_safetensors_helper(nb::object file) {
+  if (nb::isinstance<nb::str>(file)) { // Assume .safetensors file path string
+    return open_safetensors(nb::cast<std::string>(file));
+  }
+
+  throw std::invalid_argument("[open_safetensors] Input must be a string");
+}
+
 GGUFLoad mlx_load_gguf_helper(nb::object file, StreamOrDevice s) {
   if (nb::isinstance<nb::str>(file)) { // Assume .gguf file path string
     return load_gguf(nb::cast<std::string>(file), s);
@@ -190,43 +183,30 @@ GGUFLoad mlx_load_gguf_helper(nb::object file, StreamOrDevice s) {
 std::unordered_map<std::string, array> mlx_load_npz_helper(
     nb::object file,
     StreamOrDevice s) {
-  bool own_file = nb::isinstance<nb::str>(file);
-
-  nb::module_ zipfile = nb::module_::import_("zipfile");
-  if (!is_zip_file(zipfile, file)) {
+  if (nb::isinstance<nb::str>(file)) { // Assume .npz file path string
+    auto fname = nb::cast<std::string>(file);
+    nb::gil_scoped_release gil;
+    return load_npz(fname, s);
+  } else if (!is_istream_object(file)) {
     throw std::invalid_argument(
-        "[load_npz] Input must be a zip file or a file-like object that can be "
-        "opened with zipfile.ZipFile");
+        "[load_npz] Input must be a file-like object, or string");
   }
-  // Output dictionary filename in zip -> loaded array
-  std::unordered_map<std::string, array> array_dict;
-
-  // Create python ZipFile object
-  ZipFileWrapper zipfile_object(zipfile, file);
-  for (const std::string& st : zipfile_object.namelist()) {
-    // Open zip file as a python file stream
-    nb::object sub_file = zipfile_object.open(st);
-
-    // Create array from python file stream
-    auto arr = load(std::make_shared<PyFileReader>(sub_file), s);
-
-    // Remove .npy from file if it is there
-    auto key = st;
-    if (st.length() > 4 && st.substr(st.length() - 4, 4) == ".npy")
-      key = st.substr(0, st.length() - 4);
 
-    // Add array to dict
-    array_dict.insert({key, arr});
+  // Read through the file descriptor when there is one, otherwise go through
+  // the python methods
+  std::shared_ptr<io::Reader> reader;
+  if (int fd = dup_fileno(file); fd >= 0) {
+    reader = std::make_shared<io::ParallelFileReader>(fd, "python file object");
+  } else {
+    reader = std::make_shared<PyFileReader>(file);
   }
 
   // If we don't own the stream and it was passed to us, eval immediately
-  if (!own_file) {
-    nb::gil_scoped_release gil;
-    for (auto& [key, arr] : array_dict) {
-      arr.eval();
-    }
+  nb::gil_scoped_release gil;
+  auto array_dict = load_npz(reader, s);
+  for (auto& [key, arr] : array_dict) {
+    arr.eval();
   }
-
   return array_dict;
 }
 
@@ -423,25 +403,31 @@ void mlx_savez_helper(
     arrays_dict.insert({arr_name, arrays_list[i]});
   }
 
-  // Create python ZipFile object depending on compression
-  nb::module_ zipfile = nb::module_::import_("zipfile");
-  int compression = nb::cast<int>(
-      compressed ? zipfile.attr("ZIP_DEFLATED") : zipfile.attr("ZIP_STORED"));
-  char mode = 'w';
-  ZipFileWrapper zipfile_object(zipfile, file, mode, compression);
-
-  // Save each array
-  for (auto [k, a] : arrays_dict) {
-    std::string fname = k + ".npy";
-    auto py_ostream = zipfile_object.open(fname, 'w');
-    auto writer = std::make_shared<PyFileWriter>(py_ostream);
+  if (nb::isinstance<nb::str>(file)) {
+    auto fname = nb::cast<std::string>(file);
+    nb::gil_scoped_release nogil;
+    save_npz(fname, arrays_dict, compressed);
+  } else if (!is_ostream_object(file)) {
+    throw std::invalid_argument(
+        "[savez] Input must be a file-like object, or string");
+  } else if (int fd = dup_fileno(file); fd >= 0) {
+    // Write behind python's buffer and move the file past what was written
+    file.attr("flush")();
+    auto offset = nb::cast<size_t>(file.attr("tell")());
+    auto writer = std::make_shared<io::ParallelFileWriter>(
+        fd, offset, "python file object");
     {
       nb::gil_scoped_release nogil;
-      save(writer, a);
+      save_npz(writer, arrays_dict, compressed);
+    }
+    file.attr("seek")(writer->tell(), 0);
+  } else {
+    auto writer = std::make_shared<PyFileWriter>(file);
+    {
+      nb::gil_scoped_release nogil;
+      save_npz(writer, arrays_dict, compressed);
     }
   }
-
-  return;
 }
 
 void mlx_save_safetensor_helper(
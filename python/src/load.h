@@ -31,6 +31,8 @@ void mlx_save_safetensor_helper(
 
 GGUFLoad mlx_load_gguf_helper(nb::object file, StreamOrDevice s);
 
+Checkpoint mlx_open_safetensors_helper(nb::object file);
+
 void mlx_save_gguf_helper(
     nb::object file,
     nb::dict d,
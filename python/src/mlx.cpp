@@ -18,6 +18,9 @@ void init_fft(nb::module_&);
 void init_linalg(nb::module_&);
 void init_constants(nb::module_&);
 void init_fast(nb::module_&);
+void init_distributed(nb::module_&);
+void init_sparse(nb::module_&);
+void init_prefetch(nb::module_&);
 
 NB_MODULE(core, m) {
   m.doc() = "mlx: A framework for machine learning on Apple silicon.";
@@ -37,6 +40,9 @@ NB_MODULE(core, m) {
   init_linalg(m);
   init_constants(m);
   init_fast(m);
+  init_distributed(m);
+  init_sparse(m);
+  init_prefetch(m);
 
   m.attr("__version__") = TOSTRING(_VERSION_);
 }
@@ -39,6 +39,16 @@ double scalar_to_double(Scalar s) {
   }
 }
 
+// Expand an int to one entry per spatial axis of a (N, ..., C) input
+std::vector<int> spatial_vector(const IntOrVec& v, const array& x) {
+  if (auto pv = std::get_if<int>(&v); pv) {
+    return std::vector<int>(std::max(static_cast<int>(x.ndim()) - 2, 0), *pv);
+  } else if (auto pv = std::get_if<std::vector<int>>(&v); pv) {
+    return *pv;
+  }
+  return {};
+}
+
 void init_ops(nb::module_& m) {
   m.def(
       "reshape",
@@ -3210,7 +3220,7 @@ void init_ops(nb::module_& m) {
       R"pbdoc(
         2D convolution over an input with several channels
 
-        Note: Only the default ``groups=1`` is currently supported.
+        Note: ``groups > 1`` is currently only supported on the CPU.
 
         Args:
             input (array): input array of shape ``(N, H, W, C_in)``
@@ -3410,6 +3420,139 @@ void init_ops(nb::module_& m) {
         Returns:
             array: The convolved array.
       )pbdoc");
+  m.def(
+      "max_pool",
+      [](const array& x,
+         const IntOrVec& kernel_size,
+         const IntOrVec& stride,
+         const IntOrVec& padding,
+         StreamOrDevice s) {
+        return max_pool(
+            x,
+            spatial_vector(kernel_size, x),
+            spatial_vector(stride, x),
+            spatial_vector(padding, x),
+            s);
+      },
+      nb::arg(),
+      "kernel_size"_a,
+      "stride"_a = nb::none(),
+      "padding"_a = 0,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def max_pool(x: array, /, kernel_size: Union[int, Sequence[int]], stride: Union[None, int, Sequence[int]] = None, padding: Union[int, Sequence[int]] = 0, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Max pooling over the spatial dimensions of an input with channels
+        last.
+
+        The padding acts as negative infinity. The gradient of every output
+        goes to the first maximum of its window.
+
+        Args:
+            x (array): Input array of shape ``(N, ..., C)`` with 1, 2 or 3
+              spatial dimensions.
+            kernel_size (int or list(int)): The size of the pooling window.
+              All spatial dimensions get the same size if only one number is
+              specified.
+            stride (int or list(int), optional): The stride of the pooling
+              window. Default: ``kernel_size``.
+            padding (int or list(int), optional): The padding applied to
+              both sides of every spatial dimension. Default: ``0``.
+
+        Returns:
+            array: The pooled array.
+      )pbdoc");
+  m.def(
+      "avg_pool",
+      [](const array& x,
+         const IntOrVec& kernel_size,
+         const IntOrVec& stride,
+         const IntOrVec& padding,
+         StreamOrDevice s) {
+        return avg_pool(
+            x,
+            spatial_vector(kernel_size, x),
+            spatial_vector(stride, x),
+            spatial_vector(padding, x),
+            s);
+      },
+      nb::arg(),
+      "kernel_size"_a,
+      "stride"_a = nb::none(),
+      "padding"_a = 0,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def avg_pool(x: array, /, kernel_size: Union[int, Sequence[int]], stride: Union[None, int, Sequence[int]] = None, padding: Union[int, Sequence[int]] = 0, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Average pooling over the spatial dimensions of an input with channels
+        last.
+
+        The padding counts as zeros so every window is divided by the full
+        kernel size.
+
+        Args:
+            x (array): Input array of shape ``(N, ..., C)`` with 1, 2 or 3
+              spatial dimensions.
+            kernel_size (int or list(int)): The size of the pooling window.
+              All spatial dimensions get the same size if only one number is
+              specified.
+            stride (int or list(int), optional): The stride of the pooling
+              window. Default: ``kernel_size``.
+            padding (int or list(int), optional): The padding applied to
+              both sides of every spatial dimension. Default: ``0``.
+
+        Returns:
+            array: The pooled array.
+      )pbdoc");
+  m.def(
+      "upsample",
+      [](const array& x,
+         const std::variant<double, std::vector<double>>& scale_factor,
+         const std::string& mode,
+         bool align_corners,
+         StreamOrDevice s) {
+        std::vector<double> scales;
+        if (auto pv = std::get_if<double>(&scale_factor); pv) {
+          scales.assign(std::max(static_cast<int>(x.ndim()) - 2, 0), *pv);
+        } else {
+          scales = std::get<std::vector<double>>(scale_factor);
+        }
+        return upsample(x, std::move(scales), mode, align_corners, s);
+      },
+      nb::arg(),
+      "scale_factor"_a,
+      "mode"_a = "nearest",
+      "align_corners"_a = false,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def upsample(x: array, /, scale_factor: Union[float, Sequence[float]], mode: str = 'nearest', align_corners: bool = False, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Upsample the spatial dimensions of an input with channels last.
+
+        A spatial dimension of size ``n`` becomes ``int(scale_factor * n)``
+        long. The interpolation is separable so every spatial dimension is
+        resampled in turn with precomputed indices and weights. See
+        :class:`mlx.nn.Upsample` for the details of each mode.
+
+        Args:
+            x (array): Input array of shape ``(N, ..., C)`` with at least one
+              spatial dimension.
+            scale_factor (float or list(float)): The multiplier of each
+              spatial size. All spatial dimensions get the same factor if
+              only one number is specified.
+            mode (str, optional): The interpolation, either ``"nearest"``,
+              ``"linear"`` or ``"cubic"``. Default: ``"nearest"``.
+            align_corners (bool, optional): Whether the corners of the input
+              and the output match for ``"linear"`` and ``"cubic"``
+              interpolation. Default: ``False``.
+
+        Returns:
+            array: The upsampled array. Linear and cubic interpolation
+            return a floating point type.
+      )pbdoc");
   m.def(
       "save",
       &mlx_save_helper,
@@ -3512,6 +3655,165 @@ void init_ops(nb::module_& m) {
           When loading unsupported quantization formats from GGUF, tensors
           will automatically cast to ``mx.float16``
       )pbdoc");
+  nb::class_<TensorInfo>(
+      m,
+      "TensorInfo",
+      R"pbdoc(
+      The shape, type and byte range of a tensor stored in a
+      :class:`Checkpoint`.
+      )pbdoc")
+      .def_prop_ro(
+          "shape",
+          [](const TensorInfo& info) {
+            return nb::tuple(nb::cast(info.shape));
+          },
+          R"pbdoc(The shape of the tensor.)pbdoc")
+      .def_ro("dtype", &TensorInfo::dtype, R"pbdoc(The stored type.)pbdoc")
+      .def_ro(
+          "offset",
+          &TensorInfo::offset,
+          R"pbdoc(The position of the data in the file.)pbdoc")
+      .def_ro(
+          "nbytes",
+          &TensorInfo::nbytes,
+          R"pbdoc(The size of the data in bytes.)pbdoc");
+  nb::class_<Checkpoint>(
+      m,
+      "Checkpoint",
+      R"pbdoc(
+      A checkpoint opened with :func:`open_safetensors`.
+
+      Only the header of the file has been read. Arrays are created for the
+      requested tensors and their bytes are read from the file when they are
+      evaluated.
+      )pbdoc")
+      .def(
+          "keys",
+          [](const Checkpoint& c) {
+            std::vector<std::string> keys;
+            keys.reserve(c.tensors().size());
+            for (auto& [key, info] : c.tensors()) {
+              keys.push_back(key);
+            }
+            return keys;
+          },
+          R"pbdoc(The names of the stored tensors in sorted order.)pbdoc")
+      .def(
+          "info",
+          [](const Checkpoint& c, const std::string& key) {
+            auto it = c.tensors().find(key);
+            if (it == c.tensors().end()) {
+              throw nb::key_error(key.c_str());
+            }
+            return it->second;
+          },
+          "key"_a,
+          R"pbdoc(The :class:`TensorInfo` of the tensor named ``key``.)pbdoc")
+      .def_prop_ro(
+          "metadata",
+          &Checkpoint::metadata,
+          R"pbdoc(The metadata stored in the file.)pbdoc")
+      .def("__len__", [](const Checkpoint& c) { return c.tensors().size(); })
+      .def("__contains__", &Checkpoint::contains, "key"_a)
+      .def(
+          "load",
+          [](const Checkpoint& c,
+             const std::string& key,
+             std::optional<Dtype> dtype,
+             StreamOrDevice s) {
+            return dtype ? c.load(key, *dtype, s) : c.load(key, s);
+          },
+          "key"_a,
+          "dtype"_a = nb::none(),
+          nb::kw_only(),
+          "stream"_a = nb::none(),
+          nb::sig(
+              "def load(self, key: str, dtype: Optional[Dtype] = None, *, stream: Union[None, Stream, Device] = None) -> array"),
+          R"pbdoc(
+          Load a single tensor.
+
+          Args:
+              key (str): The name of the tensor.
+              dtype (Dtype, optional): Convert the tensor to this type while
+                it is read. Default: ``None``.
+
+          Returns:
+              array: The tensor.
+          )pbdoc")
+      .def(
+          "load",
+          [](const Checkpoint& c,
+             const std::vector<std::string>& keys,
+             StreamOrDevice s) { return c.load(keys, s); },
+          "keys"_a,
+          nb::kw_only(),
+          "stream"_a = nb::none(),
+          nb::sig(
+              "def load(self, keys: List[str], *, stream: Union[None, Stream, Device] = None) -> Dict[str, array]"),
+          R"pbdoc(
+          Load the tensors named in ``keys``.
+
+          Returns:
+              dict(str, array): The tensors by name.
+          )pbdoc")
+      .def(
+          "load_prefix",
+          &Checkpoint::load_prefix,
+          "prefix"_a,
+          nb::kw_only(),
+          "stream"_a = nb::none(),
+          nb::sig(
+              "def load_prefix(self, prefix: str, *, stream: Union[None, Stream, Device] = None) -> Dict[str, array]"),
+          R"pbdoc(
+          Load the tensors whose name starts with ``prefix``.
+
+          Returns:
+              dict(str, array): The tensors by name.
+          )pbdoc")
+      .def(
+          "load_quantized",
+          &Checkpoint::load_quantized,
+          "key"_a,
+          "group_size"_a = 64,
+          "bits"_a = 4,
+          "dtype"_a = nb::none(),
+          nb::kw_only(),
+          "stream"_a = nb::none(),
+          nb::sig(
+              "def load_quantized(self, key: str, group_size: int = 64, bits: int = 4, dtype: Optional[Dtype] = None, *, stream: Union[None, Stream, Device] = None) -> Tuple[array, array, array]"),
+          R"pbdoc(
+          Load a matrix quantized as with :func:`quantize` while it is read.
+
+          Args:
+              key (str): The name of the tensor.
+              group_size (int, optional): The size of the group in the last
+                dimension that shares a scale and bias. Default: ``64``.
+              bits (int, optional): The number of bits per element.
+                Default: ``4``.
+              dtype (Dtype, optional): The type of the scales and biases.
+                Default: ``None`` in which case the stored type is used.
+
+          Returns:
+              tuple: The quantized matrix, scales and biases.
+          )pbdoc");
+  m.def(
+      "open_safetensors",
+      &mlx_open_safetensors_helper,
+      "file"_a,
+      nb::sig("def open_safetensors(file: str) -> Checkpoint"),
+      R"pbdoc(
+        Open a ``.safetensors`` file without loading any tensor.
+
+        Only the header is parsed. Use the returned :class:`Checkpoint` to
+        list the stored tensors and load a subset of them, for instance
+        the layers of one pipeline stage.
+
+        Args:
+            file (str): Path of the file.
+
+        Returns:
+            Checkpoint: The opened checkpoint.
+      )pbdoc");
   m.def(
       "save_safetensors",
       &mlx_save_safetensor_helper,
@@ -3652,6 +3954,39 @@ void init_ops(nb::module_& m) {
         Returns:
           result (array): The result of the multiplication of ``x`` with ``w``.
       )pbdoc");
+  m.def(
+      "dynamic_quantized_matmul",
+      &dynamic_quantized_matmul,
+      nb::arg(),
+      nb::arg(),
+      "scales"_a,
+      "biases"_a,
+      "group_size"_a = 64,
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def dynamic_quantized_matmul(x: array, w: array, /, scales: array, biases: array, group_size: int = 64, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Perform ``x @ w.T`` with 8 bit weights and 8 bit activations.
+
+        ``w`` must be quantized with ``bits=8``. Each row of ``x`` is
+        quantized to ``int8`` on the fly with its own scale and the product is
+        computed with integer arithmetic, which is faster than
+        :func:`quantized_matmul` on CPUs with int8 dot product instructions.
+        The result is rescaled to the floating point type of ``x``. Other
+        devices compute the product in floating point.
+
+        Args:
+          x (array): Input array
+          w (array): Matrix quantized to 8 bits packed in unsigned integers
+          scales (array): The scales to use per ``group_size`` elements of ``w``
+          biases (array): The biases to use per ``group_size`` elements of ``w``
+          group_size (int, optional): The size of the group in ``w`` that
+            shares a scale and bias. (default: ``64``)
+
+        Returns:
+          result (array): The result of the multiplication of ``x`` with ``w.T``.
+      )pbdoc");
   m.def(
       "quantize",
       &quantize,
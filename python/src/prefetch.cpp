@@ -0,0 +1,114 @@
+// Copyright © 2024 Apple Inc.
+
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/vector.h>
+
+#include "mlx/prefetch.h"
+
+namespace nb = nanobind;
+using namespace nb::literals;
+
+using namespace mlx::core;
+
+namespace {
+
+// The workers call back into Python so the GIL has to be released while
+// waiting for them, including when the prefetcher is destroyed.
+class PyPrefetcher {
+ public:
+  PyPrefetcher(nb::callable producer, int depth, int num_workers)
+      : prefetcher_(wrap(std::move(producer)), depth, num_workers) {}
+
+  ~PyPrefetcher() {
+    nb::gil_scoped_release nogil;
+    prefetcher_.stop();
+  }
+
+  std::vector<array> next() {
+    std::optional<std::vector<array>> batch;
+    {
+      nb::gil_scoped_release nogil;
+      batch = prefetcher_.next();
+    }
+    if (!batch) {
+      throw nb::stop_iteration();
+    }
+    return std::move(*batch);
+  }
+
+  void stop() {
+    nb::gil_scoped_release nogil;
+    prefetcher_.stop();
+  }
+
+ private:
+  static Prefetcher::Producer wrap(nb::callable producer) {
+    return [producer = std::move(producer)](
+               int index) -> std::optional<std::vector<array>> {
+      nb::gil_scoped_acquire gil;
+      auto out = producer(index);
+      if (out.is_none()) {
+        return std::nullopt;
+      }
+      if (nb::isinstance<array>(out)) {
+        return std::vector<array>{nb::cast<array>(out)};
+      }
+      return nb::cast<std::vector<array>>(out);
+    };
+  }
+
+  Prefetcher prefetcher_;
+};
+
+} // namespace
+
+void init_prefetch(nb::module_& m) {
+  nb::class_<PyPrefetcher>(
+      m,
+      "Prefetcher",
+      R"pbdoc(
+      Prepare batches on background threads ahead of the training loop.
+
+      ``producer`` is called with the index of the batch to make and returns
+      an array, a list of arrays or ``None`` once there are no more batches.
+      The workers call it concurrently with different indices but the
+      batches are returned in order. At most ``depth`` batches are prepared
+      ahead of the consumer.
+
+      Every batch is passed to :func:`async_eval` when it is handed out so
+      lazy work left in it overlaps with the running step. Exceptions raised
+      by ``producer`` are raised when their batch is reached.
+
+      Args:
+          producer (Callable[[int], Union[None, array, List[array]]]): Makes
+            the batch with the given index.
+          depth (int, optional): The maximum number of batches prepared
+            ahead. Default: ``2``.
+          num_workers (int, optional): The number of threads calling
+            ``producer``. Default: ``1``.
+
+      Example:
+
+        >>> def load(i):
+        ...     if i == 100:
+        ...         return None
+        ...     return mx.array(np.load(f"batch_{i}.npy"))
+        ...
+        >>> for (x,) in mx.Prefetcher(load, depth=4, num_workers=2):
+        ...     loss = step(x)
+      )pbdoc")
+      .def(
+          nb::init<nb::callable, int, int>(),
+          "producer"_a,
+          "depth"_a = 2,
+          "num_workers"_a = 1)
+      .def("__iter__", [](nb::handle self) { return self; })
+      .def("__next__", &PyPrefetcher::next)
+      .def(
+          "stop",
+          &PyPrefetcher::stop,
+          R"pbdoc(
+            Stop the workers and drop the prepared batches.
+          )pbdoc");
+}
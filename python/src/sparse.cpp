@@ -0,0 +1,280 @@
+// Copyright © 2024 Apple Inc.
+
+#include <sstream>
+#include <variant>
+
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/variant.h>
+#include <nanobind/stl/vector.h>
+
+#include "mlx/sparse.h"
+#include "mlx/utils.h"
+
+namespace nb = nanobind;
+using namespace nb::literals;
+
+using namespace mlx::core;
+using namespace mlx::core::sparse;
+
+namespace {
+
+Format to_format(const std::string& format) {
+  if (format == "csr") {
+    return Format::CSR;
+  } else if (format == "coo") {
+    return Format::COO;
+  }
+  throw std::invalid_argument(
+      "[sparse] Unknown sparse format '" + format +
+      "', expected 'csr' or 'coo'.");
+}
+
+std::string format_name(Format format) {
+  return format == Format::CSR ? "csr" : "coo";
+}
+
+using DenseOrSparse = std::variant<array, SparseArray>;
+
+array matmul_helper(
+    const DenseOrSparse& a,
+    const DenseOrSparse& b,
+    StreamOrDevice s) {
+  if (auto pa = std::get_if<SparseArray>(&a); pa) {
+    if (std::holds_alternative<SparseArray>(b)) {
+      throw std::invalid_argument(
+          "[sparse.matmul] One of the operands must be dense.");
+    }
+    return sparse::matmul(*pa, std::get<array>(b), s);
+  }
+  if (auto pb = std::get_if<SparseArray>(&b); pb) {
+    return sparse::matmul(std::get<array>(a), *pb, s);
+  }
+  throw std::invalid_argument(
+      "[sparse.matmul] One of the operands must be sparse.");
+}
+
+} // namespace
+
+void init_sparse(nb::module_& parent_module) {
+  auto m = parent_module.def_submodule(
+      "sparse", "mlx.core.sparse: sparse matrices and products.");
+
+  nb::class_<SparseArray>(
+      m,
+      "SparseArray",
+      R"pbdoc(
+      A 2D sparse matrix stored in CSR or COO format.
+
+      The non zero entries are kept in dense arrays. In CSR format
+      ``col_indices`` holds the column of each value and ``row_ptr`` the
+      offset of the first value of each row. In COO format ``row_indices``
+      and ``col_indices`` hold the coordinates of each value.
+      )pbdoc")
+      .def_prop_ro(
+          "format",
+          [](const SparseArray& a) { return format_name(a.format()); },
+          R"pbdoc(The storage format, ``"csr"`` or ``"coo"``.)pbdoc")
+      .def_prop_ro(
+          "shape",
+          [](const SparseArray& a) { return nb::tuple(nb::cast(a.shape())); },
+          R"pbdoc(The shape of the matrix.)pbdoc")
+      .def_prop_ro(
+          "nnz",
+          &SparseArray::nnz,
+          R"pbdoc(The number of stored entries.)pbdoc")
+      .def_prop_ro(
+          "dtype",
+          &SparseArray::dtype,
+          R"pbdoc(The data type of the values.)pbdoc")
+      .def_prop_ro(
+          "values",
+          &SparseArray::values,
+          R"pbdoc(The stored values.)pbdoc")
+      .def_prop_ro(
+          "col_indices",
+          &SparseArray::col_indices,
+          R"pbdoc(The column of each value.)pbdoc")
+      .def_prop_ro(
+          "row_ptr",
+          &SparseArray::row_ptr,
+          R"pbdoc(The row offsets of a CSR matrix.)pbdoc")
+      .def_prop_ro(
+          "row_indices",
+          &SparseArray::row_indices,
+          R"pbdoc(The row of each value of a COO matrix.)pbdoc")
+      .def_prop_ro(
+          "T",
+          [](const SparseArray& a) { return transpose(a); },
+          R"pbdoc(The transposed matrix in COO format.)pbdoc")
+      .def(
+          "to_dense",
+          [](const SparseArray& a, StreamOrDevice s) { return to_dense(a, s); },
+          nb::kw_only(),
+          "stream"_a = nb::none(),
+          R"pbdoc(Make a dense array from the matrix.)pbdoc")
+      .def(
+          "__matmul__",
+          [](const SparseArray& a, const array& b) {
+            return sparse::matmul(a, b);
+          },
+          "other"_a)
+      .def(
+          "__rmatmul__",
+          [](const SparseArray& a, const array& b) {
+            return sparse::matmul(b, a);
+          },
+          "other"_a)
+      .def("__repr__", [](const SparseArray& a) {
+        std::ostringstream os;
+        os << "SparseArray(format=" << format_name(a.format())
+           << ", shape=" << a.shape() << ", nnz=" << a.nnz()
+           << ", dtype=" << a.dtype() << ")";
+        return os.str();
+      });
+
+  m.def(
+      "csr_array",
+      &csr_array,
+      "values"_a,
+      "col_indices"_a,
+      "row_ptr"_a,
+      "shape"_a,
+      nb::sig(
+          "def csr_array(values: array, col_indices: array, row_ptr: array, shape: Sequence[int]) -> SparseArray"),
+      R"pbdoc(
+        Make a CSR matrix.
+
+        Args:
+            values (array): The non zero values ordered by row.
+            col_indices (array): The column of each value.
+            row_ptr (array): Offsets such that the values of row ``i`` are
+              ``values[row_ptr[i]:row_ptr[i + 1]]``.
+            shape (tuple(int)): The shape of the matrix.
+
+        Returns:
+            SparseArray: The sparse matrix.
+      )pbdoc");
+  m.def(
+      "coo_array",
+      &coo_array,
+      "values"_a,
+      "row_indices"_a,
+      "col_indices"_a,
+      "shape"_a,
+      nb::sig(
+          "def coo_array(values: array, row_indices: array, col_indices: array, shape: Sequence[int]) -> SparseArray"),
+      R"pbdoc(
+        Make a COO matrix.
+
+        Args:
+            values (array): The non zero values in any order. Values with the
+              same coordinates are summed.
+            row_indices (array): The row of each value.
+            col_indices (array): The column of each value.
+            shape (tuple(int)): The shape of the matrix.
+
+        Returns:
+            SparseArray: The sparse matrix.
+      )pbdoc");
+  m.def(
+      "from_dense",
+      [](const array& a, const std::string& format, StreamOrDevice s) {
+        return from_dense(a, to_format(format), s);
+      },
+      nb::arg(),
+      "format"_a = "csr",
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def from_dense(a: array, /, format: str = 'csr', *, stream: Union[None, Stream, Device] = None) -> SparseArray"),
+      R"pbdoc(
+        Make a sparse matrix from the non zero entries of a 2D array.
+
+        The number of non zeros depends on the data so ``a`` is evaluated.
+
+        Args:
+            a (array): The dense matrix.
+            format (str, optional): ``"csr"`` or ``"coo"``. Default:
+              ``"csr"``.
+
+        Returns:
+            SparseArray: The sparse matrix.
+      )pbdoc");
+  m.def(
+      "to_csr",
+      &to_csr,
+      nb::arg(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def to_csr(a: SparseArray, /, *, stream: Union[None, Stream, Device] = None) -> SparseArray"),
+      R"pbdoc(
+        Convert a sparse matrix to CSR format.
+
+        COO entries are sorted by row and column.
+
+        Args:
+            a (SparseArray): The sparse matrix.
+
+        Returns:
+            SparseArray: The matrix in CSR format.
+      )pbdoc");
+  m.def(
+      "to_coo",
+      &to_coo,
+      nb::arg(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def to_coo(a: SparseArray, /, *, stream: Union[None, Stream, Device] = None) -> SparseArray"),
+      R"pbdoc(
+        Convert a sparse matrix to COO format.
+
+        Args:
+            a (SparseArray): The sparse matrix.
+
+        Returns:
+            SparseArray: The matrix in COO format.
+      )pbdoc");
+  m.def(
+      "to_dense",
+      &to_dense,
+      nb::arg(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def to_dense(a: SparseArray, /, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Make a dense array from a sparse matrix.
+
+        Args:
+            a (SparseArray): The sparse matrix.
+
+        Returns:
+            array: The dense matrix.
+      )pbdoc");
+  m.def(
+      "matmul",
+      &matmul_helper,
+      nb::arg(),
+      nb::arg(),
+      nb::kw_only(),
+      "stream"_a = nb::none(),
+      nb::sig(
+          "def matmul(a: Union[array, SparseArray], b: Union[array, SparseArray], /, *, stream: Union[None, Stream, Device] = None) -> array"),
+      R"pbdoc(
+        Multiply a sparse matrix with a dense matrix or vector.
+
+        Exactly one of ``a`` and ``b`` must be sparse and the dense operand
+        must be 1D or 2D. The cost scales with the number of non zeros of the
+        sparse operand. Gradients flow to the dense operand.
+
+        Args:
+            a (array or SparseArray): The left operand.
+            b (array or SparseArray): The right operand.
+
+        Returns:
+            array: The dense product.
+      )pbdoc");
+}
@@ -5,6 +5,7 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/optional.h>
 #include <nanobind/stl/variant.h>
+#include <nanobind/stl/vector.h>
 
 #include "mlx/stream.h"
 #include "mlx/utils.h"
@@ -82,9 +83,39 @@ void init_stream(nb::module_& m) {
       )pbdoc");
   m.def(
       "new_stream",
-      &new_stream,
+      [](const Device& d,
+         std::optional<int> numa_node,
+         std::optional<std::vector<int>> cores) {
+        if (!numa_node && !cores) {
+          return new_stream(d);
+        }
+        CpuAffinity affinity;
+        affinity.numa_node = numa_node.value_or(-1);
+        affinity.cores = cores.value_or(std::vector<int>{});
+        return new_stream(d, std::move(affinity));
+      },
       "device"_a,
-      R"pbdoc(Make a new stream on the given device.)pbdoc");
+      "numa_node"_a = nb::none(),
+      "cores"_a = nb::none(),
+      nb::sig(
+          "def new_stream(device: Device, numa_node: Optional[int] = None, cores: Optional[list[int]] = None) -> Stream"),
+      R"pbdoc(
+        Make a new stream on the given device.
+
+        CPU streams can be pinned to a NUMA node or a set of cores (Linux
+        only). The stream's thread and the workers it uses for parallel
+        kernels run on those cores, and large buffers allocated from them
+        are placed in the node's memory.
+
+        Args:
+            device (Device): The device for the stream.
+            numa_node (int, optional): Run on the cores of this NUMA node.
+            cores (list(int), optional): Run on these cores. If given with
+              ``numa_node`` the cores must belong to the node.
+
+        Returns:
+            Stream: The new stream.
+      )pbdoc");
 
   nb::class_<PyStreamContext>(m, "StreamContext", R"pbdoc(
         A context manager for setting the current device and stream.
@@ -13,6 +13,7 @@
 
 #include "mlx/array.h"
 #include "mlx/compile.h"
+#include "mlx/export.h"
 #include "mlx/graph_utils.h"
 #include "mlx/transforms.h"
 #include "mlx/transforms_impl.h"
@@ -947,6 +948,58 @@ void init_transforms(nb::module_& m) {
             callable: A compiled function which has the same input arguments
             as ``fun`` and returns the the same output(s).
       )pbdoc");
+  m.def(
+      "export_function",
+      [](const std::string& file,
+         const nb::callable& fun,
+         const nb::args& args) {
+        auto inputs = tree_flatten(args);
+        auto export_fun = [&fun, &args](const std::vector<array>& a) {
+          return tree_flatten(fun(*tree_unflatten(args, a)));
+        };
+        export_function(file, export_fun, inputs);
+      },
+      "file"_a,
+      "fun"_a,
+      "args"_a,
+      nb::sig("def export_function(file: str, fun: callable, *args) -> None"),
+      R"pbdoc(
+        Export the computation graph of ``fun`` to a file.
+
+        The function is traced with the given example arguments and the
+        resulting graph, including any arrays captured by ``fun``, is saved
+        to ``file``. The graph can be loaded with :func:`import_function`
+        from Python or from C++ without the original Python code.
+
+        Args:
+            file (str): The file to save the graph to.
+            fun (callable): A function which takes a variable number of
+              :class:`array` or trees of :class:`array` and returns
+              a variable number of :class:`array` or trees of :class:`array`.
+            *args: Example arguments for ``fun``. The exported graph only
+              accepts arrays with the same shapes and types.
+      )pbdoc");
+  m.def(
+      "import_function",
+      [](const std::string& file) {
+        auto fun = import_function(file);
+        return nb::cpp_function(
+            [fun = std::move(fun)](const nb::args& args) {
+              return fun(tree_flatten(args));
+            });
+      },
+      "file"_a,
+      R"pbdoc(
+        Import a function exported with :func:`export_function`.
+
+        Args:
+            file (str): The file containing the exported graph.
+
+        Returns:
+            callable: A compiled function which takes the arrays of the
+            example arguments used for the export, flattened in order, and
+            returns a list with the flattened outputs.
+      )pbdoc");
   m.def(
       "disable_compile",
       &disable_compile,
@@ -1,6 +1,8 @@
 # Copyright © 2023-2024 Apple Inc.
 
 import io
+import os
+import tempfile
 import unittest
 from functools import partial
 
@@ -691,6 +693,28 @@ class TestCompile(mlx_tests.MLXTestCase):
         out = mx.compile(fn)(mx.array(10.0), mx.array(20.0))
         self.assertEqual(out.item(), 10.0)
 
+    def test_export_import_function(self):
+        w = mx.random.uniform(shape=(4, 3))
+
+        def fn(x, y):
+            return mx.softmax(x @ w, axis=-1) + y, mx.sum(x, axis=1)
+
+        x = mx.random.uniform(shape=(2, 4))
+        y = mx.array(1.0)
+        with tempfile.TemporaryDirectory() as test_dir:
+            path = os.path.join(test_dir, "fn.mlxfn")
+            mx.export_function(path, fn, x, y)
+            imported = mx.import_function(path)
+
+        out = imported(x, y)
+        expected = fn(x, y)
+        self.assertEqual(len(out), 2)
+        self.assertTrue(mx.allclose(out[0], expected[0]))
+        self.assertTrue(mx.allclose(out[1], expected[1]))
+
+        with self.assertRaises(ValueError):
+            imported(mx.zeros((3, 4)), y)
+
     def test_compile_multi_output(self):
         def fn(x):
             ys = [x]
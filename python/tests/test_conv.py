@@ -291,7 +291,9 @@ class TestConv(mlx_tests.MLXTestCase):
                 kH, kW = kdim
                 scale = 1.0 / math.sqrt(kH * kW * C)
                 in_np = np.random.normal(0.0, scale, (N, iH, iW, C)).astype(np_dtype)
-                wt_np = np.random.normal(0.0, 1.0, (O, kH, kW, C)).astype(np_dtype)
+                wt_np = np.random.normal(0.0, 1.0, (O, kH, kW, C // groups)).astype(
+                    np_dtype
+                )
 
                 in_mx, wt_mx = map(mx.array, (in_np, wt_np))
                 in_pt, wt_pt = map(
@@ -334,6 +336,27 @@ class TestConv(mlx_tests.MLXTestCase):
                 ):
                     run_conv2D(N, C, O, idim, kdim, stride, padding, dtype=dtype)
 
+        # Groups tests (grouped 2D convolutions are CPU only for now)
+        with mx.stream(mx.cpu):
+            N, C, O = (4, 32, 64)
+            for idim, kdim, stride, padding, dilation in (
+                ((31, 31), (3, 3), (1, 1), (1, 1), (1, 1)),
+                ((15, 17), (5, 3), (2, 1), (2, 0), (1, 1)),
+                ((15, 15), (3, 3), (1, 1), (2, 2), (2, 2)),
+            ):
+                for group in (2, 4, 8, 32):
+                    run_conv2D(
+                        N,
+                        C,
+                        O if group != C else C,
+                        idim,
+                        kdim,
+                        stride,
+                        padding,
+                        dilation=dilation,
+                        groups=group,
+                    )
+
     @unittest.skipIf(not has_torch, "requires Torch")
     def test_torch_conv_2D_grad(self):
         def run_conv2D_grad(
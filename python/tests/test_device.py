@@ -1,5 +1,6 @@
 # Copyright © 2023 Apple Inc.
 
+import sys
 import unittest
 
 import mlx.core as mx
@@ -93,6 +94,19 @@ class TestStream(mlx_tests.MLXTestCase):
             with self.assertRaises(ValueError):
                 mx.new_stream(mx.gpu)
 
+    @unittest.skipIf(sys.platform != "linux", "CPU affinity needs Linux")
+    def test_stream_affinity(self):
+        s = mx.new_stream(mx.cpu, cores=[0])
+        self.assertEqual(s.device, mx.cpu)
+        x = mx.random.uniform(shape=(64, 64))
+        y = mx.matmul(x, x, stream=s)
+        self.assertTrue(mx.allclose(y, mx.matmul(x, x, stream=mx.cpu)))
+
+        with self.assertRaises(ValueError):
+            mx.new_stream(mx.cpu, cores=[-1])
+        with self.assertRaises(ValueError):
+            mx.new_stream(mx.cpu, numa_node=100000)
+
     def test_op_on_stream(self):
         x = mx.array(1.0)
         y = mx.array(1.0)
@@ -0,0 +1,95 @@
+# Copyright © 2024 Apple Inc.
+
+import os
+import subprocess
+import sys
+import textwrap
+import unittest
+
+import mlx.core as mx
+import mlx_tests
+
+# Run by every process of the group, exits with a non-zero code on failure
+WORKER = textwrap.dedent(
+    """
+    import mlx.core as mx
+    import mlx.nn as nn
+    from mlx.nn.utils import average_gradients
+
+    group = mx.distributed.init()
+    rank, size = group.rank(), group.size()
+
+    x = mx.full((4, 3), rank + 1.0)
+    assert mx.allclose(mx.distributed.all_sum(x), mx.full((4, 3), size * (size + 1) / 2))
+
+    big = mx.full((1024, 2048), float(rank))
+    assert mx.allclose(mx.distributed.all_sum(big), mx.full(big.shape, size * (size - 1) / 2))
+
+    g = mx.distributed.all_gather(mx.array([[rank, rank]]))
+    assert mx.array_equal(g, mx.repeat(mx.arange(size)[:, None], 2, axis=1))
+
+    y = mx.arange(2 * size * 3).reshape(2 * size, 3)
+    out = mx.distributed.reduce_scatter(y)
+    assert mx.array_equal(out, size * y[2 * rank : 2 * rank + 2])
+
+    b = mx.distributed.broadcast(mx.array([rank] * 5), root=size - 1)
+    assert mx.array_equal(b, mx.array([size - 1] * 5))
+
+    # Every rank uses the whole gathered array, so each slice sums size ones
+    f = lambda x: mx.distributed.all_gather(x).sum()
+    assert mx.array_equal(mx.grad(f)(mx.ones((2, 3))), mx.full((2, 3), float(size)))
+
+    # Only the root's input reaches the broadcast outputs
+    f = lambda x: mx.distributed.broadcast(x, root=0).sum()
+    expected = float(size) if rank == 0 else 0.0
+    assert mx.array_equal(mx.grad(f)(mx.ones(4)), mx.full((4,), expected))
+
+    grads = {"w": mx.full((10, 10), float(rank)), "b": [mx.array(float(rank))] * 3}
+    avg = average_gradients(grads, all_reduce_size=64)
+    expected = (size - 1) / 2
+    assert mx.allclose(avg["w"], mx.full((10, 10), expected))
+    assert all(mx.allclose(a, mx.array(expected)) for a in avg["b"])
+    """
+)
+
+
+class TestDistributed(mlx_tests.MLXTestCase):
+    def test_single_process_group(self):
+        group = mx.distributed.init()
+        self.assertTrue(mx.distributed.is_available())
+        self.assertEqual(group.rank(), 0)
+        self.assertEqual(group.size(), 1)
+
+        x = mx.array([1.0, 2.0])
+        self.assertTrue(mx.array_equal(mx.distributed.all_sum(x), x))
+        self.assertTrue(mx.array_equal(mx.distributed.all_gather(x), x))
+        self.assertTrue(mx.array_equal(mx.distributed.broadcast(x), x))
+
+        with self.assertRaises(ValueError):
+            mx.distributed.broadcast(x, root=1)
+
+    def run_group(self, backend, size, port):
+        procs = []
+        for rank in range(size):
+            env = dict(os.environ)
+            env.update(
+                {
+                    "MLX_WORLD_SIZE": str(size),
+                    "MLX_RANK": str(rank),
+                    "MLX_DISTRIBUTED_BACKEND": backend,
+                    "MLX_DISTRIBUTED_PORT": str(port),
+                }
+            )
+            procs.append(subprocess.Popen([sys.executable, "-c", WORKER], env=env))
+        for p in procs:
+            self.assertEqual(p.wait(timeout=120), 0)
+
+    def test_shared_memory_backend(self):
+        self.run_group("shm", 3, 33100)
+
+    def test_tcp_backend(self):
+        self.run_group("tcp", 3, 33200)
+
+
+if __name__ == "__main__":
+    unittest.main()
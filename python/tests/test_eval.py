@@ -103,6 +103,39 @@ class TestEval(mlx_tests.MLXTestCase):
         z = mx.add(y, x, stream=mx.cpu)
         self.assertTrue(mx.allclose(z, mx.full((8000,), 22.0)))
 
+    def test_prefetcher(self):
+        def producer(i):
+            if i == 10:
+                return None
+            x = mx.array(i)
+            return [x, 2 * x]
+
+        batches = list(mx.Prefetcher(producer, depth=3, num_workers=2))
+        self.assertEqual(len(batches), 10)
+        for i, (x, y) in enumerate(batches):
+            self.assertEqual(x.item(), i)
+            self.assertEqual(y.item(), 2 * i)
+
+        # Single arrays and an early stop
+        prefetcher = mx.Prefetcher(lambda i: mx.array(i))
+        self.assertEqual(next(prefetcher)[0].item(), 0)
+        self.assertEqual(next(prefetcher)[0].item(), 1)
+        prefetcher.stop()
+        with self.assertRaises(StopIteration):
+            next(prefetcher)
+
+        # Errors are raised in order
+        def failing(i):
+            if i == 2:
+                raise ValueError("bad batch")
+            return mx.array(i)
+
+        prefetcher = mx.Prefetcher(failing)
+        self.assertEqual(next(prefetcher)[0].item(), 0)
+        self.assertEqual(next(prefetcher)[0].item(), 1)
+        with self.assertRaises(ValueError):
+            next(prefetcher)
+
 
 if __name__ == "__main__":
     unittest.main()
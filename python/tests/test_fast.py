@@ -57,6 +57,29 @@ def layer_norm(x, weight, bias, eps):
     return x
 
 
+def lstm_orig(x, w_h, hidden, cell):
+    hs, cs = [], []
+    for t in range(x.shape[-2]):
+        i, f, g, o = mx.split(x[..., t, :] + hidden @ w_h, 4, axis=-1)
+        cell = mx.sigmoid(f) * cell + mx.sigmoid(i) * mx.tanh(g)
+        hidden = mx.sigmoid(o) * mx.tanh(cell)
+        hs.append(hidden)
+        cs.append(cell)
+    return mx.stack(hs, axis=-2), mx.stack(cs, axis=-2)
+
+
+def gru_orig(x, w_h, b_hn, hidden):
+    H = w_h.shape[0]
+    hs = []
+    for t in range(x.shape[-2]):
+        h_proj = hidden @ w_h
+        r, z = mx.split(mx.sigmoid(x[..., t, : 2 * H] + h_proj[..., : 2 * H]), 2, -1)
+        n = mx.tanh(x[..., t, 2 * H :] + r * (h_proj[..., 2 * H :] + b_hn))
+        hidden = (1 - z) * n + z * hidden
+        hs.append(hidden)
+    return mx.stack(hs, axis=-2)
+
+
 class TestFast(mlx_tests.MLXTestCase):
     def test_rope(self):
         T = 4
@@ -440,5 +463,121 @@ class TestFast(mlx_tests.MLXTestCase):
         self.assertTrue(mx.allclose(vmap_out, vmap_fast_out))
 
 
+    def test_lstm(self):
+        N, L, H = 3, 9, 16
+        x = mx.random.normal((N, L, 4 * H))
+        w_h = 0.3 * mx.random.normal((H, 4 * H))
+        h0 = mx.random.normal((N, H))
+        c0 = mx.random.normal((N, H))
+
+        hs, cs = mx.fast.lstm(x, w_h, h0, c0)
+        hs_ref, cs_ref = lstm_orig(x, w_h, h0, c0)
+        self.assertTrue(mx.allclose(hs, hs_ref, atol=1e-5))
+        self.assertTrue(mx.allclose(cs, cs_ref, atol=1e-5))
+
+        # Missing states start from zeros
+        zeros = mx.zeros((N, H))
+        hs, cs = mx.fast.lstm(x, w_h)
+        self.assertTrue(mx.allclose(hs, lstm_orig(x, w_h, zeros, zeros)[0], atol=1e-5))
+
+        # Gradients of every input
+        def loss(fn):
+            def f(x, w_h, h0, c0):
+                hs, cs = fn(x, w_h, h0, c0)
+                return (hs * hs).sum() + cs.sum()
+
+            return mx.grad(f, argnums=(0, 1, 2, 3))
+
+        grads = loss(mx.fast.lstm)(x, w_h, h0, c0)
+        grads_ref = loss(lstm_orig)(x, w_h, h0, c0)
+        for g, g_ref in zip(grads, grads_ref):
+            self.assertTrue(mx.allclose(g, g_ref, atol=1e-4))
+
+        # Unbatched, vmapped and half precision inputs
+        hs, _ = mx.fast.lstm(x[0], w_h, h0[0], c0[0])
+        self.assertTrue(mx.allclose(hs, lstm_orig(x, w_h, h0, c0)[0][0], atol=1e-5))
+        hs = mx.vmap(lambda x: mx.fast.lstm(x, w_h)[0])(x[:, None])
+        self.assertTrue(mx.allclose(hs[:, 0], mx.fast.lstm(x, w_h)[0], atol=1e-5))
+        hs, cs = mx.fast.lstm(x.astype(mx.float16), w_h.astype(mx.float16))
+        self.assertEqual(hs.dtype, mx.float16)
+
+    def test_gru(self):
+        N, L, H = 3, 9, 16
+        x = mx.random.normal((N, L, 3 * H))
+        w_h = 0.3 * mx.random.normal((H, 3 * H))
+        b_hn = mx.random.normal((H,))
+        h0 = mx.random.normal((N, H))
+
+        hs = mx.fast.gru(x, w_h, b_hn, h0)
+        self.assertTrue(mx.allclose(hs, gru_orig(x, w_h, b_hn, h0), atol=1e-5))
+
+        # Without an initial state the first step ignores the hidden bias
+        hs = mx.fast.gru(x, w_h, b_hn)
+        h1 = gru_orig(x[:, :1], w_h, mx.zeros((H,)), mx.zeros((N, H)))
+        rest = gru_orig(x[:, 1:], w_h, b_hn, h1[:, -1])
+        self.assertTrue(mx.allclose(hs[:, :1], h1, atol=1e-5))
+        self.assertTrue(mx.allclose(hs[:, 1:], rest, atol=1e-5))
+
+        def loss(fn):
+            return mx.grad(lambda *args: (fn(*args) ** 2).sum(), argnums=(0, 1, 2, 3))
+
+        grads = loss(mx.fast.gru)(x, w_h, b_hn, h0)
+        grads_ref = loss(gru_orig)(x, w_h, b_hn, h0)
+        for g, g_ref in zip(grads, grads_ref):
+            self.assertTrue(mx.allclose(g, g_ref, atol=1e-4))
+
+        with self.assertRaises(ValueError):
+            mx.fast.gru(x, mx.zeros((H, 4 * H)))
+        with self.assertRaises(ValueError):
+            mx.fast.gru(x, w_h, mx.zeros((H + 1,)))
+
+    def test_activations(self):
+        def gelu(x):
+            return x * (1 + mx.erf(x / math.sqrt(2))) / 2
+
+        def gelu_approx(x):
+            u = math.sqrt(2 / math.pi) * (x + 0.044715 * x**3)
+            return 0.5 * x * (1 + mx.tanh(u))
+
+        def silu(x):
+            return x * mx.sigmoid(x)
+
+        def mish(x):
+            return x * mx.tanh(mx.logaddexp(x, 0))
+
+        references = {
+            mx.fast.gelu: gelu,
+            mx.fast.gelu_approx: gelu_approx,
+            mx.fast.silu: silu,
+            mx.fast.mish: mish,
+        }
+        x = mx.concatenate([6 * mx.random.normal((1000,)), mx.array([30.0, -30.0])])
+        cotan = mx.random.normal(x.shape)
+        for fn, ref in references.items():
+            self.assertTrue(mx.allclose(fn(x), ref(x), atol=1e-6, rtol=1e-5))
+
+            _, vjp = mx.vjp(fn, [x], [cotan])
+            _, expected = mx.vjp(ref, [x], [cotan])
+            self.assertTrue(mx.allclose(vjp[0], expected[0], atol=1e-5, rtol=1e-4))
+
+            # Second derivatives go through the composed implementation
+            d2 = mx.grad(lambda x: mx.grad(lambda x: fn(x).sum())(x).sum())(x)
+            e2 = mx.grad(lambda x: mx.grad(lambda x: ref(x).sum())(x).sum())(x)
+            self.assertTrue(mx.allclose(d2, e2, atol=1e-4, rtol=1e-3))
+
+            y = fn(x.astype(mx.float16))
+            self.assertEqual(y.dtype, mx.float16)
+            self.assertTrue(mx.allclose(y, ref(x), atol=1e-2, rtol=1e-2))
+
+            # Integers are promoted to float32
+            y = fn(mx.arange(-3, 3))
+            self.assertEqual(y.dtype, mx.float32)
+            self.assertTrue(mx.allclose(y, ref(mx.arange(-3, 3).astype(mx.float32))))
+
+        # Strided inputs are read in place
+        x = mx.random.normal((8, 6)).T
+        self.assertTrue(mx.allclose(mx.fast.gelu(x), gelu(x)))
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -98,6 +98,158 @@ class TestFastSDPA(mlx_tests.MLXTestCase):
 
                     self.assertTrue(mx.allclose(o_mlx, reference, rtol=rtol, atol=atol))
 
+    def test_sdpa_masks(self):
+        D = 32
+        scale = 1.0 / math.sqrt(D)
+        for n_kv_heads, L, S in [(4, 1, 37), (2, 70, 200), (1, 33, 33)]:
+            q = mx.random.normal(shape=(2, 4, L, D))
+            k = mx.random.normal(shape=(2, n_kv_heads, S, D))
+            v = mx.random.normal(shape=(2, n_kv_heads, S, D))
+            mask = mx.random.normal(shape=(L, S))
+            causal_mask = mx.triu(mx.full((L, S), -float("inf")), k=S - L + 1)
+            for m, causal in [(mask, False), (None, True), (mask, True)]:
+                reference_mask = causal_mask if causal else 0
+                if m is not None:
+                    reference_mask = reference_mask + m
+                reference = mx.fast.scaled_dot_product_attention(
+                    q, k, v, scale=scale, mask=reference_mask
+                )
+                out = mx.fast.scaled_dot_product_attention(
+                    q, k, v, scale=scale, mask=m, causal=causal
+                )
+                self.assertTrue(mx.allclose(out, reference, atol=1e-4))
+
+        # Queries, keys and values in the (B, L, H, D) layout of the
+        # projections are read in place
+        q = mx.random.normal(shape=(2, 9, 4, D)).transpose(0, 2, 1, 3)
+        k = mx.random.normal(shape=(2, 9, 2, D)).transpose(0, 2, 1, 3)
+        v = mx.random.normal(shape=(2, 9, 2, D)).transpose(0, 2, 1, 3)
+        reference = mlx_primitives_sdpa_with_gqa(q, k, v, scale)
+        out = mx.fast.scaled_dot_product_attention(q, k, v, scale=scale)
+        self.assertTrue(mx.allclose(out, reference, atol=1e-4))
+
+        # Gradients go through the composed implementation
+        def loss(q, k, v):
+            out = mx.fast.scaled_dot_product_attention(
+                q, k, v, scale=scale, causal=True
+            )
+            return (out * out).sum()
+
+        def reference_loss(q, k, v):
+            mask = mx.triu(mx.full((9, 9), -float("inf")), k=1)
+            k, v = (mx.repeat(a, 2, axis=1) for a in (k, v))
+            scores = mx.softmax((q * scale) @ k.swapaxes(-1, -2) + mask, axis=-1)
+            out = scores @ v
+            return (out * out).sum()
+
+        grads = mx.grad(loss, argnums=(0, 1, 2))(q, k, v)
+        expected = mx.grad(reference_loss, argnums=(0, 1, 2))(q, k, v)
+        for g, e in zip(grads, expected):
+            self.assertTrue(mx.allclose(g, e, atol=1e-4))
+
+    def test_sdpa_shape_checks(self):
+        q = mx.random.normal(shape=(1, 4, 3, 32))
+        k = mx.random.normal(shape=(1, 2, 8, 32))
+        v = mx.random.normal(shape=(1, 2, 8, 32))
+
+        # Keys and values of different sequence lengths
+        with self.assertRaises(ValueError):
+            mx.fast.scaled_dot_product_attention(q, k, v[:, :, :5], scale=1.0)
+        with self.assertRaises(ValueError):
+            mx.fast.scaled_dot_product_attention(q, k[:, :, :5], v, scale=1.0)
+
+        # Queries and keys of different head dimensions
+        with self.assertRaises(ValueError):
+            mx.fast.scaled_dot_product_attention(q, k[..., :16], v, scale=1.0)
+
+        # Values may have their own head dimension
+        out = mx.fast.scaled_dot_product_attention(q, k, v[..., :16], scale=1.0)
+        self.assertEqual(out.shape, (1, 4, 3, 16))
+
+    def test_quantized_sdpa(self):
+        def quantized_kv(B, H, S, D, group_size, bits):
+            k = mx.random.normal(shape=(B, H, S, D))
+            v = mx.random.normal(shape=(B, H, S, D))
+            k_q = mx.quantize(k, group_size, bits)
+            v_q = mx.quantize(v, group_size, bits)
+            k_hat = mx.dequantize(*k_q, group_size, bits)
+            v_hat = mx.dequantize(*v_q, group_size, bits)
+            return k_q, v_q, k_hat, v_hat
+
+        D = 64
+        scale = 1.0 / math.sqrt(D)
+        for bits in [4, 8]:
+            for group_size in [32, 64]:
+                for n_kv_heads, L in [(4, 1), (2, 5)]:
+                    q = mx.random.normal(shape=(2, 4, L, D))
+                    k_q, v_q, k_hat, v_hat = quantized_kv(
+                        2, n_kv_heads, 37, D, group_size, bits
+                    )
+                    reference = mx.fast.scaled_dot_product_attention(
+                        q, k_hat, v_hat, scale=scale
+                    )
+                    out = mx.fast.quantized_scaled_dot_product_attention(
+                        q,
+                        *k_q,
+                        *v_q,
+                        scale=scale,
+                        group_size=group_size,
+                        bits=bits,
+                    )
+                    self.assertEqual(out.shape, reference.shape)
+                    self.assertTrue(mx.allclose(out, reference, atol=1e-4))
+
+        # Masks and caches sliced out of a larger buffer
+        q = mx.random.normal(shape=(1, 4, 3, D))
+        k_q, v_q, k_hat, v_hat = quantized_kv(1, 4, 40, D, 64, 4)
+        k_q = [a[:, :, :20] for a in k_q]
+        v_q = [a[:, :, :20] for a in v_q]
+        mask = mx.random.normal(shape=(3, 20))
+        reference = mx.fast.scaled_dot_product_attention(
+            q, k_hat[:, :, :20], v_hat[:, :, :20], scale=scale, mask=mask
+        )
+        out = mx.fast.quantized_scaled_dot_product_attention(
+            q, *k_q, *v_q, scale=scale, mask=mask
+        )
+        self.assertTrue(mx.allclose(out, reference, atol=1e-4))
+
+        # Half precision queries
+        out = mx.fast.quantized_scaled_dot_product_attention(
+            q.astype(mx.float16),
+            k_q[0],
+            *[a.astype(mx.float16) for a in k_q[1:]],
+            v_q[0],
+            *[a.astype(mx.float16) for a in v_q[1:]],
+            scale=scale,
+            mask=mask,
+        )
+        self.assertEqual(out.dtype, mx.float16)
+        self.assertTrue(mx.allclose(out, reference, atol=1e-2))
+
+        # Gradients with respect to the queries
+        def loss(q):
+            return mx.fast.quantized_scaled_dot_product_attention(
+                q, *k_q, *v_q, scale=scale
+            ).sum()
+
+        def reference_loss(q):
+            return mx.fast.scaled_dot_product_attention(
+                q, k_hat[:, :, :20], v_hat[:, :, :20], scale=scale
+            ).sum()
+
+        self.assertTrue(
+            mx.allclose(mx.grad(loss)(q), mx.grad(reference_loss)(q), atol=1e-4)
+        )
+
+        with self.assertRaises(ValueError):
+            mx.fast.quantized_scaled_dot_product_attention(
+                q, *k_q, *v_q, scale=scale, bits=2
+            )
+        with self.assertRaises(ValueError):
+            mx.fast.quantized_scaled_dot_product_attention(
+                q, *k_q, *v_q, scale=scale, bits=8
+            )
+
 
 if __name__ == "__main__":
     unittest.main(failfast=True)
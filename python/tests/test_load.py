@@ -1,5 +1,6 @@
 # Copyright © 2023 Apple Inc.
 
+import io
 import os
 import tempfile
 import unittest
@@ -103,6 +104,60 @@ class TestLoad(mlx_tests.MLXTestCase):
                             mx.array_equal(load_dict["test"], save_dict["test"])
                         )
 
+    def test_open_safetensors(self):
+        if not os.path.isdir(self.test_dir):
+            os.mkdir(self.test_dir)
+
+        save_file = os.path.join(self.test_dir, "checkpoint.safetensors")
+        weights = {
+            "layers.0.w": mx.random.normal((64, 128)),
+            "layers.0.b": mx.arange(8, dtype=mx.int32),
+            "layers.1.w": mx.random.normal((32, 64)),
+            "head": mx.ones((4,), dtype=mx.float16),
+        }
+        mx.save_safetensors(save_file, weights, {"format": "mlx"})
+
+        ckpt = mx.open_safetensors(save_file)
+        self.assertEqual(len(ckpt), 4)
+        self.assertEqual(ckpt.keys(), sorted(weights.keys()))
+        self.assertEqual(ckpt.metadata, {"format": "mlx"})
+        self.assertTrue("head" in ckpt)
+        self.assertFalse("tail" in ckpt)
+
+        info = ckpt.info("layers.1.w")
+        self.assertEqual(info.shape, (32, 64))
+        self.assertEqual(info.dtype, mx.float32)
+        self.assertEqual(info.nbytes, 32 * 64 * 4)
+        with self.assertRaises(KeyError):
+            ckpt.info("tail")
+
+        self.assertTrue(mx.array_equal(ckpt.load("head"), weights["head"]))
+        with self.assertRaises(ValueError):
+            ckpt.load("tail")
+
+        shard = ckpt.load_prefix("layers.0.")
+        self.assertEqual(sorted(shard.keys()), ["layers.0.b", "layers.0.w"])
+        for k, v in shard.items():
+            self.assertTrue(mx.array_equal(v, weights[k]))
+
+        some = ckpt.load(["head", "layers.1.w"])
+        self.assertEqual(sorted(some.keys()), ["head", "layers.1.w"])
+        self.assertTrue(mx.array_equal(some["layers.1.w"], weights["layers.1.w"]))
+
+        w = ckpt.load("layers.0.w", mx.float16)
+        self.assertEqual(w.dtype, mx.float16)
+        self.assertTrue(mx.array_equal(w, weights["layers.0.w"].astype(mx.float16)))
+
+        wq, scales, biases = ckpt.load_quantized("layers.0.w", 64, 4)
+        expected = mx.quantize(weights["layers.0.w"], 64, 4)
+        self.assertTrue(mx.array_equal(wq, expected[0]))
+        self.assertTrue(mx.allclose(scales, expected[1]))
+        self.assertTrue(mx.allclose(biases, expected[2]))
+
+        with open(save_file, "rb") as f:
+            with self.assertRaises(ValueError):
+                mx.open_safetensors(f)
+
     def test_save_and_load_gguf(self):
         if not os.path.isdir(self.test_dir):
             os.mkdir(self.test_dir)
@@ -329,6 +384,50 @@ class TestLoad(mlx_tests.MLXTestCase):
                     for k, v in load_arr_mlx_npy.items():
                         self.assertTrue(np.array_equal(save_arrs_npy[k], v))
 
+    def test_savez_and_loadz_file_objects(self):
+        if not os.path.isdir(self.test_dir):
+            os.mkdir(self.test_dir)
+
+        save_arrs = {
+            "a": mx.random.normal((32, 16)),
+            "b": mx.arange(100).astype(mx.int16),
+            "c": mx.array([True, False]),
+        }
+
+        def check(loaded):
+            self.assertEqual(loaded.keys(), save_arrs.keys())
+            for k, v in loaded.items():
+                self.assertTrue(mx.array_equal(save_arrs[k], v))
+
+        for savez in (mx.savez, mx.savez_compressed):
+            # Real files are read and written through their descriptor, also
+            # when the archive does not start at the beginning of the file
+            save_file = os.path.join(self.test_dir, "file_object.npz")
+            with open(save_file, "wb") as f:
+                f.write(b"prefix")
+                savez(f, **save_arrs)
+                f.write(b"suffix")
+            with open(save_file, "rb") as f:
+                self.assertEqual(f.read(6), b"prefix")
+            with open(save_file, "rb") as f:
+                f.seek(6)
+                data = f.read()[:-6]
+            check(mx.load(io.BytesIO(data), format="npz"))
+
+            with open(save_file, "wb") as f:
+                savez(f, **save_arrs)
+            with open(save_file, "rb") as f:
+                check(mx.load(f))
+            check({k: mx.array(v) for k, v in np.load(save_file).items()})
+
+            # In memory buffers go through the python methods
+            buffer = io.BytesIO()
+            savez(buffer, **save_arrs)
+            buffer.seek(0)
+            check(mx.load(buffer, format="npz"))
+            buffer.seek(0)
+            check({k: mx.array(v) for k, v in np.load(buffer).items()})
+
     def test_non_contiguous(self):
         if not os.path.isdir(self.test_dir):
             os.mkdir(self.test_dir)
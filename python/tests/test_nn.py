@@ -1,5 +1,6 @@
 # Copyright © 2023-2024 Apple Inc.
 
+import math
 import os
 import tempfile
 import unittest
@@ -1518,6 +1519,20 @@ class TestLayers(mlx_tests.MLXTestCase):
                 expected_irregular_average_pool_output,
             )
         )
+        # Test 3d pooling
+        x = mx.arange(2 * 4 * 4 * 4 * 3, dtype=mx.float32).reshape(2, 4, 4, 4, 3)
+        x_np = np.array(x).reshape(2, 2, 2, 2, 2, 2, 2, 3)
+        self.assertTrue(
+            np.array_equal(
+                nn.MaxPool3d(kernel_size=2)(x), x_np.max(axis=(2, 4, 6))
+            )
+        )
+        self.assertTrue(
+            np.allclose(nn.AvgPool3d(kernel_size=2)(x), x_np.mean(axis=(2, 4, 6)))
+        )
+        y = nn.MaxPool3d(kernel_size=3, stride=(1, 2, 3), padding=1)(x)
+        self.assertEqual(y.shape, (2, 4, 2, 2, 3))
+        self.assertEqual(y[0, 0, 0, 0].tolist(), x[0, 1, 1, 1].tolist())
         # Test repr
         self.assertEqual(
             str(nn.MaxPool1d(kernel_size=3, padding=2)),
@@ -1535,6 +1550,10 @@ class TestLayers(mlx_tests.MLXTestCase):
             str(nn.AvgPool2d(kernel_size=(1, 2), stride=2, padding=(1, 2))),
             "AvgPool2d(kernel_size=(1, 2), stride=(2, 2), padding=(1, 2))",
         )
+        self.assertEqual(
+            str(nn.MaxPool3d(kernel_size=2, padding=(0, 1, 0))),
+            "MaxPool3d(kernel_size=(2, 2, 2), stride=(2, 2, 2), padding=(0, 1, 0))",
+        )
 
     def test_set_dtype(self):
         def assert_dtype(layer, dtype):
@@ -1559,6 +1578,38 @@ class TestLayers(mlx_tests.MLXTestCase):
         layer.set_dtype(mx.int16, lambda x: mx.issubdtype(x, mx.integer))
         assert_dtype(layer, mx.int16)
 
+    def test_multi_head_attention(self):
+        def reference(layer, x, mask):
+            B, L, _ = x.shape
+            H = layer.num_heads
+            q = layer.query_proj(x).reshape(B, L, H, -1).transpose(0, 2, 1, 3)
+            k, v = (
+                p(x).reshape(B, L, layer.num_kv_heads, -1).transpose(0, 2, 1, 3)
+                for p in (layer.key_proj, layer.value_proj)
+            )
+            k, v = (mx.repeat(a, H // layer.num_kv_heads, axis=1) for a in (k, v))
+            scale = math.sqrt(1 / q.shape[-1])
+            scores = mx.softmax((q * scale) @ k.swapaxes(-1, -2) + mask, axis=-1)
+            out = (scores @ v).transpose(0, 2, 1, 3).reshape(B, L, -1)
+            return layer.out_proj(out)
+
+        x = mx.random.normal((2, 10, 32))
+        causal_mask = nn.MultiHeadAttention.create_additive_causal_mask(10)
+        for num_kv_heads in [None, 2, 1]:
+            layer = nn.MultiHeadAttention(32, 4, num_kv_heads=num_kv_heads)
+            expected = reference(layer, x, causal_mask)
+            out = layer(x, x, x, mask=causal_mask)
+            self.assertEqual(out.shape, (2, 10, 32))
+            self.assertTrue(mx.allclose(out, expected, atol=1e-4))
+            out = layer(x, x, x, mask="causal")
+            self.assertTrue(mx.allclose(out, expected, atol=1e-4))
+        self.assertEqual(layer.key_proj.weight.shape, (8, 32))
+
+        with self.assertRaises(ValueError):
+            nn.MultiHeadAttention(32, 4, num_kv_heads=3)
+        with self.assertRaises(ValueError):
+            layer(x, x, x, mask="full")
+
     def test_rnn(self):
         layer = nn.RNN(input_size=5, hidden_size=12, bias=True)
         inp = mx.random.normal((2, 25, 5))
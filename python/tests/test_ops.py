@@ -1633,6 +1633,107 @@ class TestOps(mlx_tests.MLXTestCase):
         _, df = mx.vjp(f, [a_fwd], [a_bwd])
         self.assertTrue(mx.allclose(a_bwd[4:-2, 2:-4], df[0]).item())
 
+    def test_pool(self):
+        def windows(x, kernel_size, stride, padding, value):
+            pad = [(0, 0)] + [(p, p) for p in padding] + [(0, 0)]
+            x = np.pad(x, pad, constant_values=value)
+            for i, (k, s) in enumerate(zip(kernel_size, stride)):
+                x = np.lib.stride_tricks.sliding_window_view(x, k, axis=i + 1)
+                idx = [slice(None)] * x.ndim
+                idx[i + 1] = slice(None, None, s)
+                x = x[tuple(idx)]
+            return x
+
+        np.random.seed(0)
+        for shape, kernel_size, stride, padding in [
+            ((2, 11, 5), [3], [2], [1]),
+            ((2, 9, 8, 3), [3, 2], [1, 2], [1, 0]),
+            ((1, 5, 6, 7, 4), [2, 3, 2], [2, 1, 2], [0, 1, 1]),
+        ]:
+            a_np = np.random.randn(*shape).astype(np.float32)
+            a = mx.array(a_np)
+            axes = tuple(range(-len(kernel_size), 0))
+            with self.subTest(shape=shape, kernel_size=kernel_size):
+                out = mx.max_pool(a, kernel_size, stride, padding)
+                w = windows(a_np, kernel_size, stride, padding, -np.inf)
+                self.assertTrue(np.array_equal(out, w.max(axis=axes)))
+
+                out = mx.avg_pool(a, kernel_size, stride, padding)
+                w = windows(a_np, kernel_size, stride, padding, 0)
+                self.assertTrue(np.allclose(out, w.mean(axis=axes), atol=1e-6))
+
+        # Grads match pooling over explicit windows
+        a = mx.random.normal((2, 8, 8, 3))
+
+        def ref_pool(x, reduce, value):
+            x = mx.pad(x, [(0, 0), (1, 1), (1, 1), (0, 0)], value)
+            x = mx.stack([x[:, :, i : i + 7 : 2] for i in range(3)], axis=-1)
+            x = mx.stack([x[:, i : i + 7 : 2] for i in range(3)], axis=-1)
+            return reduce(x, axis=(-2, -1))
+
+        for op, reduce, value in [
+            (mx.max_pool, mx.max, -float("inf")),
+            (mx.avg_pool, mx.mean, 0),
+        ]:
+            g = mx.grad(lambda x: (op(x, 3, 2, 1) ** 2).sum())(a)
+            g_ref = mx.grad(lambda x: (ref_pool(x, reduce, value) ** 2).sum())(a)
+            self.assertTrue(mx.allclose(g, g_ref, atol=1e-5))
+
+        # Integer max pooling keeps the dtype, average pooling promotes
+        a = mx.arange(16).reshape(1, 16, 1)
+        self.assertEqual(mx.max_pool(a, 4).dtype, mx.int32)
+        self.assertEqual(mx.max_pool(a, 4).flatten().tolist(), [3, 7, 11, 15])
+        self.assertEqual(mx.avg_pool(a, 4).dtype, mx.float32)
+
+        with self.assertRaises(ValueError):
+            mx.max_pool(mx.zeros((4, 4)), [2, 2])
+        with self.assertRaises(ValueError):
+            mx.avg_pool(mx.zeros((1, 4, 4, 1)), [5, 1])
+
+    def test_upsample(self):
+        a = mx.arange(1, 5).reshape(1, 2, 2, 1)
+        out = mx.upsample(a, 2.0)
+        self.assertEqual(out.dtype, mx.int32)
+        expected = np.repeat(np.repeat(np.array(a), 2, axis=1), 2, axis=2)
+        self.assertTrue(np.array_equal(out, expected))
+
+        # Output sizes are computed in double precision
+        self.assertEqual(mx.upsample(mx.zeros((1, 100, 1)), 0.29).shape[1], 28)
+        self.assertEqual(mx.upsample(mx.zeros((1, 100, 1)), 0.53).shape[1], 53)
+
+        out = mx.upsample(a, 2.0, mode="linear")
+        self.assertEqual(out.dtype, mx.float32)
+        expected = [[1, 1.25, 1.75, 2], [1.5, 1.75, 2.25, 2.5]]
+        self.assertTrue(np.allclose(out.squeeze()[:2], expected))
+
+        # Half precision inputs keep their type
+        a = mx.random.normal((2, 5, 6, 3)).astype(mx.float16)
+        for mode in ["nearest", "linear", "cubic"]:
+            out = mx.upsample(a, (1.5, 2.0), mode=mode)
+            self.assertEqual(out.shape, (2, 7, 12, 3))
+            self.assertEqual(out.dtype, mx.float16)
+
+        # The gradient is the adjoint of the upsampling map
+        x = mx.random.normal((2, 5, 4, 3))
+        y = mx.random.normal((2, 10, 12, 3))
+        for mode in ["nearest", "linear", "cubic"]:
+            for align_corners in [False, True]:
+
+                def up(x):
+                    return mx.upsample(x, (2.0, 3.0), mode, align_corners)
+
+                g = mx.grad(lambda x: (up(x) * y).sum())(x)
+                self.assertTrue(
+                    mx.allclose((up(x) * y).sum(), (g * x).sum(), rtol=1e-4)
+                )
+
+        with self.assertRaises(ValueError):
+            mx.upsample(mx.zeros((4, 4)), 2.0)
+        with self.assertRaises(ValueError):
+            mx.upsample(mx.zeros((1, 4, 4, 1)), [2.0])
+        with self.assertRaises(ValueError):
+            mx.upsample(mx.zeros((1, 4, 1)), 2.0, mode="area")
+
     def test_where(self):
         self.assertCmpNumpy([True, mx.array([[1, 2], [3, 4]]), 1], mx.where, np.where)
         self.assertCmpNumpy([True, 1, mx.array([[1, 2], [3, 4]])], mx.where, np.where)
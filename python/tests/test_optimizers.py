@@ -204,6 +204,42 @@ class TestOptimizers(mlx_tests.MLXTestCase):
             )
         )
 
+    def test_fused_updates(self):
+        params = {
+            "first": [mx.random.normal((10,)), mx.random.normal((3, 4)).T],
+            "second": mx.random.normal((5,)).astype(mx.float16),
+            "third": mx.random.normal((70, 300)),
+        }
+        grads = tree_map(lambda x: mx.random.normal(x.shape).astype(x.dtype), params)
+        # A gradient of another type goes through the unfused update
+        grads["first"][0] = grads["first"][0].astype(mx.float16)
+
+        optimizers = [
+            partial(opt.SGD, momentum=0.0, weight_decay=0.1),
+            partial(opt.SGD, momentum=0.9, dampening=0.1),
+            partial(opt.SGD, momentum=0.9, weight_decay=0.01, nesterov=True),
+            partial(opt.Adam, betas=[0.8, 0.9]),
+            partial(opt.AdamW, weight_decay=0.1),
+            partial(opt.Lion, weight_decay=0.1),
+        ]
+        for optim_class in optimizers:
+            fused = optim_class(learning_rate=1e-2)
+            unfused = optim_class(learning_rate=1e-2)
+            unfused.apply_multi = partial(opt.Optimizer.apply_multi, unfused)
+            fused_params = params
+            unfused_params = params
+            for _ in range(3):
+                fused_params = fused.apply_gradients(grads, fused_params)
+                unfused_params = unfused.apply_gradients(grads, unfused_params)
+                mx.eval(fused_params, unfused_params, fused.state, unfused.state)
+
+            for a, b in zip(tree_flatten(fused_params), tree_flatten(unfused_params)):
+                self.assertEqual(a[1].dtype, b[1].dtype)
+                atol = 1e-2 if a[1].dtype == mx.float16 else 1e-5
+                self.assertTrue(mx.allclose(a[1], b[1], atol=atol, rtol=atol))
+            for a, b in zip(tree_flatten(fused.state), tree_flatten(unfused.state)):
+                self.assertTrue(mx.allclose(a[1], b[1], atol=1e-2, rtol=1e-2))
+
     def test_adafactor(self):
         x = mx.zeros((5, 5))
         grad = mx.ones_like(x)
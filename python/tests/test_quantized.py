@@ -55,6 +55,25 @@ class TestQuantized(mlx_tests.MLXTestCase):
                 self.assertEqual(y_q.shape, y_hat.shape)
                 self.assertLess((y_q - y_hat).abs().max(), 1e-3)
 
+    def test_dynamic_qmm(self):
+        key = mx.random.key(0)
+        k1, k2 = mx.random.split(key)
+        w = mx.random.normal(shape=(128, 512), key=k2)
+        for group_size in [32, 64, 128]:
+            with self.subTest(group_size=group_size):
+                w_q, scales, biases = mx.quantize(w, group_size, 8)
+                w_hat = mx.dequantize(w_q, scales, biases, group_size, 8)
+                x = mx.random.normal(shape=(9, 512), key=k1)
+                y_q = mx.dynamic_quantized_matmul(x, w_q, scales, biases, group_size)
+                y_hat = x @ w_hat.T
+                self.assertEqual(y_q.shape, y_hat.shape)
+                tol = 0.02 * y_hat.abs().max()
+                self.assertLess((y_q - y_hat).abs().max(), tol)
+
+        w_q, scales, biases = mx.quantize(w, 64, 4)
+        with self.assertRaises(ValueError):
+            mx.dynamic_quantized_matmul(x, w_q, scales, biases)
+
     def test_qmm_vjp(self):
         key = mx.random.key(0)
         k1, k2 = mx.random.split(key)
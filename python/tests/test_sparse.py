@@ -0,0 +1,87 @@
+# Copyright © 2024 Apple Inc.
+
+import unittest
+
+import mlx.core as mx
+import mlx_tests
+import numpy as np
+
+
+class TestSparse(mlx_tests.MLXTestCase):
+    def random_sparse(self, shape, density=0.2):
+        a = mx.random.uniform(shape=shape)
+        return mx.where(a < density, a, 0.0)
+
+    def test_conversions(self):
+        a = mx.array([[0.0, 1.0, 0.0], [2.0, 0.0, 0.0], [3.0, 0.0, 4.0]])
+        csr = mx.sparse.from_dense(a)
+        self.assertEqual(csr.format, "csr")
+        self.assertEqual(csr.shape, (3, 3))
+        self.assertEqual(csr.nnz, 4)
+        self.assertEqual(csr.values.tolist(), [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(csr.col_indices.tolist(), [1, 0, 0, 2])
+        self.assertEqual(csr.row_ptr.tolist(), [0, 1, 2, 4])
+        self.assertTrue(mx.array_equal(csr.to_dense(), a))
+
+        coo = mx.sparse.to_coo(csr)
+        self.assertEqual(coo.format, "coo")
+        self.assertEqual(coo.row_indices.tolist(), [0, 1, 2, 2])
+        self.assertTrue(mx.array_equal(mx.sparse.to_dense(coo), a))
+        self.assertTrue(mx.array_equal(coo.T.to_dense(), a.T))
+
+        coo = mx.sparse.coo_array(
+            mx.array([4.0, 1.0, 3.0, 2.0]),
+            mx.array([2, 0, 2, 1]),
+            mx.array([2, 1, 0, 0]),
+            (3, 3),
+        )
+        csr = mx.sparse.to_csr(coo)
+        self.assertEqual(csr.row_ptr.tolist(), [0, 1, 2, 4])
+        self.assertEqual(csr.col_indices.tolist(), [1, 0, 0, 2])
+        self.assertTrue(mx.array_equal(csr.to_dense(), a))
+
+        with self.assertRaises(ValueError):
+            mx.sparse.from_dense(a, format="csc")
+        with self.assertRaises(ValueError):
+            mx.sparse.from_dense(mx.zeros((2, 2, 2)))
+        with self.assertRaises(ValueError):
+            csr.row_indices
+
+    def test_matmul(self):
+        dense = self.random_sparse((32, 24))
+        b = mx.random.normal((24, 7))
+        for fmt in ["csr", "coo"]:
+            a = mx.sparse.from_dense(dense, format=fmt)
+            self.assertTrue(mx.allclose(a @ b, dense @ b, atol=1e-5))
+
+            v = mx.random.normal((24,))
+            self.assertTrue(mx.allclose(mx.sparse.matmul(a, v), dense @ v, atol=1e-5))
+
+            c = mx.random.normal((3, 32))
+            self.assertTrue(mx.allclose(c @ a, c @ dense, atol=1e-5))
+
+        a_np = np.array(dense)
+        out = mx.sparse.matmul(mx.sparse.from_dense(dense), b)
+        self.assertTrue(np.allclose(out, a_np @ np.array(b), atol=1e-5))
+
+        with self.assertRaises(ValueError):
+            mx.sparse.matmul(b, b)
+        with self.assertRaises(ValueError):
+            mx.sparse.matmul(mx.sparse.from_dense(dense), mx.zeros((3, 3)))
+
+    def test_matmul_grad(self):
+        dense = self.random_sparse((16, 12))
+        a = mx.sparse.from_dense(dense)
+        b = mx.random.normal((12, 5))
+
+        def loss(b):
+            return (mx.sparse.matmul(a, b) ** 2).sum()
+
+        def dense_loss(b):
+            return ((dense @ b) ** 2).sum()
+
+        self.assertTrue(mx.allclose(mx.grad(loss)(b), mx.grad(dense_loss)(b)))
+
+
+if __name__ == "__main__":
+    unittest.main()
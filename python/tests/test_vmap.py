@@ -312,6 +312,44 @@ class TestVmap(mlx_tests.MLXTestCase):
         expected = mx.addmm(mx.moveaxis(c, 2, 0), a, mx.moveaxis(b, 1, 0))
         self.assertTrue(mx.allclose(out, expected))
 
+    def test_vmap_scatter(self):
+        x = mx.zeros((3, 5, 2))
+        idx = mx.array([[0, 4, 4], [1, 2, 2], [3, 0, 1]])
+        updates = mx.random.normal((3, 3, 2))
+
+        add = lambda x, idx, u: x.at[idx].add(u)
+        expected = mx.stack([add(x[i], idx[i], updates[i]) for i in range(3)])
+        out = mx.vmap(add)(x, idx, updates)
+        self.assertTrue(mx.allclose(out, expected))
+
+        out = mx.vmap(add, in_axes=(None, 0, 0))(x[0], idx, updates)
+        self.assertTrue(mx.allclose(out, expected))
+
+        out = mx.vmap(add, in_axes=(0, None, 1))(x, idx[0], updates.swapaxes(0, 1))
+        expected = mx.stack([add(x[i], idx[0], updates[:, i]) for i in range(3)])
+        self.assertTrue(mx.allclose(out, expected))
+
+    def test_vmap_conv(self):
+        x = mx.random.normal((3, 2, 9, 4))
+        w = mx.random.normal((3, 6, 3, 4))
+
+        conv = lambda x, w: mx.conv1d(x, w, padding=1)
+        expected = mx.stack([conv(x[i], w[i]) for i in range(3)])
+        out = mx.vmap(conv)(x, w)
+        self.assertTrue(mx.allclose(out, expected, atol=1e-5))
+
+        out = mx.vmap(conv, in_axes=(None, 0))(x[0], w)
+        expected = mx.stack([conv(x[0], w[i]) for i in range(3)])
+        self.assertTrue(mx.allclose(out, expected, atol=1e-5))
+
+        # Per example gradients with a shared weight
+        def loss(w, x):
+            return conv(x[None], w).square().sum()
+
+        grads = mx.vmap(mx.grad(loss), in_axes=(None, 0))(w[0], x[:, 0])
+        expected = mx.stack([mx.grad(loss)(w[0], x[i, 0]) for i in range(3)])
+        self.assertTrue(mx.allclose(grads, expected, atol=1e-4))
+
     def test_vmap_svd(self):
         a = mx.random.uniform(shape=(3, 4, 2))
 
@@ -108,3 +108,64 @@ TEST_CASE("test matmul") {
   out = matmul(transpose(a, {0, 2, 1}), transpose(b, {0, 2, 1}));
   CHECK(array_equal(out, full({2, 4, 4}, 2.0f)).item<bool>());
 }
+
+TEST_CASE("test matmul broadcast batches") {
+  // Grouped query attention shapes with the keys broadcast over the heads
+  // of every group
+  auto q = random::normal({2, 3, 4, 5, 8});
+  auto k = random::normal({2, 3, 1, 8, 7});
+  auto expected = matmul(q, repeat(k, 4, 2));
+  CHECK(allclose(matmul(q, k), expected, 1e-5, 1e-5).item<bool>());
+  CHECK(allclose(matmul(q, broadcast_to(k, {2, 3, 4, 8, 7})), expected)
+            .item<bool>());
+
+  // Transposed keys and a broadcast axis in the middle of the batch
+  auto kt = swapaxes(random::normal({2, 1, 3, 7, 8}), -1, -2);
+  expected = matmul(transpose(q, {0, 2, 1, 3, 4}), repeat(kt, 4, 1));
+  CHECK(allclose(matmul(transpose(q, {0, 2, 1, 3, 4}), kt), expected)
+            .item<bool>());
+
+  // Single rows and columns are used whatever their strides
+  auto x = random::normal({6, 4, 8});
+  auto row = slice(transpose(x, {1, 0, 2}), {0, 0, 0}, {1, 6, 8});
+  auto w = random::normal({8, 3});
+  expected = matmul(slice(x, {0, 0, 0}, {6, 1, 8}), w);
+  CHECK(allclose(matmul(swapaxes(row, 0, 1), w), expected).item<bool>());
+  auto col = random::normal({1, 8, 1});
+  expected = matmul(x, repeat(col, 6, 0));
+  CHECK(allclose(matmul(x, broadcast_to(col, {6, 8, 1})), expected)
+            .item<bool>());
+}
+
+TEST_CASE("test matmul strided operands") {
+  // Reference product which does not go through the GEMM
+  auto reference = [](const array& a, const array& b) {
+    return sum(multiply(expand_dims(a, -1), expand_dims(b, -3)), -2);
+  };
+
+  // Slices of larger matrices have rows further apart than their length
+  auto x = random::normal({3, 9, 12});
+  auto a = slice(x, {0, 1, 2}, {3, 6, 10});
+  auto b = slice(random::normal({11, 6}), {1, 0}, {9, 4});
+  CHECK(allclose(matmul(a, b), reference(a, b), 1e-5, 1e-5).item<bool>());
+  auto at = swapaxes(slice(x, {0, 0, 0}, {3, 8, 5}), -1, -2);
+  CHECK(allclose(matmul(at, b), reference(at, b), 1e-5, 1e-5).item<bool>());
+  auto bt = slice(random::normal({2, 10, 8}), {0, 0, 0}, {2, 3, 8});
+  bt = swapaxes(bt, -1, -2);
+  auto a2 = slice(random::normal({2, 4, 9}), {0, 0, 1}, {2, 4, 9});
+  CHECK(allclose(matmul(a2, bt), reference(a2, bt), 1e-5, 1e-5).item<bool>());
+
+  // Strided rows and columns are gathered, once for a broadcast operand
+  auto y = random::normal({64});
+  auto irregular = as_strided(y, {5, 6}, {7, 2}, 0);
+  auto c = random::normal({4, 6, 3});
+  CHECK(allclose(matmul(irregular, c), reference(irregular, c), 1e-5, 1e-5)
+            .item<bool>());
+  auto d = random::normal({4, 3, 5});
+  CHECK(allclose(matmul(d, irregular), reference(d, irregular), 1e-5, 1e-5)
+            .item<bool>());
+  auto c0 = reshape(slice(c, {0, 0, 0}, {1, 6, 3}), {6, 3});
+  auto out = addmm(ones({5, 3}), irregular, c0, 2.0f, 0.5f);
+  auto expected = add(full({5, 3}, 0.5f), 2.0f * reference(irregular, c0));
+  CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+}
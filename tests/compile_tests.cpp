@@ -719,3 +719,66 @@ TEST_CASE("test compile strides") {
     CHECK_EQ(out.strides().size(), 3);
   }
 }
+
+auto fold_constants(const std::vector<array>& inputs) {
+  auto c = exp(array({1.0f, 2.0f}));
+  return std::vector<array>{inputs[0] * c};
+}
+
+auto double_transpose(const std::vector<array>& inputs) {
+  auto x = transpose(inputs[0], {1, 2, 0});
+  auto y = transpose(x, {2, 0, 1});
+  auto z = transpose(transpose(inputs[0], {1, 0, 2}), {0, 2, 1});
+  return std::vector<array>{exp(y), z};
+}
+
+auto reshape_chain(const std::vector<array>& inputs) {
+  auto x = reshape(reshape(inputs[0], {4, 6}), {2, 12});
+  return std::vector<array>{reshape(x, {3, 8})};
+}
+
+auto transpose_matmul(const std::vector<array>& inputs) {
+  auto x = matmul(inputs[0], inputs[1]);
+  return std::vector<array>{transpose(x, {0, 2, 1})};
+}
+
+TEST_CASE("test compile rewrite") {
+  set_compile_mode(CompileMode::no_fuse);
+  {
+    auto x = array({3.0f, 4.0f});
+    auto out = compile(fold_constants)({x})[0];
+    CHECK(!out.inputs()[1].has_primitive());
+    CHECK(allclose(out, fold_constants({x})[0]).item<bool>());
+  }
+
+  {
+    auto x = reshape(arange(24.0f), {2, 3, 4});
+    auto out = compile(double_transpose)({x});
+    // The first transposes cancel out
+    CHECK_EQ(out[0].inputs()[0].id(), x.id());
+    CHECK(array_equal(out[0], exp(x)).item<bool>());
+
+    // The second ones merge into a single transpose
+    CHECK_EQ(typeid(out[1].primitive()), typeid(Transpose));
+    CHECK_EQ(out[1].inputs()[0].id(), x.id());
+    CHECK(array_equal(out[1], double_transpose({x})[1]).item<bool>());
+  }
+
+  {
+    auto x = arange(24.0f);
+    auto out = compile(reshape_chain)({x})[0];
+    CHECK_EQ(typeid(out.primitive()), typeid(Reshape));
+    CHECK_EQ(out.inputs()[0].id(), x.id());
+    CHECK(array_equal(out, reshape(x, {3, 8})).item<bool>());
+  }
+
+  {
+    auto a = random::uniform({2, 3, 4});
+    auto b = random::uniform({2, 4, 5});
+    auto out = compile(transpose_matmul)({a, b})[0];
+    CHECK_EQ(typeid(out.primitive()), typeid(Matmul));
+    CHECK_EQ(out.shape(), std::vector<int>{2, 5, 3});
+    CHECK(allclose(out, transpose_matmul({a, b})[0]).item<bool>());
+  }
+  set_compile_mode(CompileMode::enabled);
+}
@@ -0,0 +1,24 @@
+// Copyright © 2024 Apple Inc.
+
+#include "doctest/doctest.h"
+
+#include "mlx/mlx.h"
+
+using namespace mlx::core;
+
+TEST_CASE("test single process group") {
+  auto group = distributed::init();
+  CHECK(distributed::is_available());
+  CHECK_EQ(group.rank(), 0);
+  CHECK_EQ(group.size(), 1);
+
+  // Collectives of a single process are the identity
+  auto x = array({1.0f, 2.0f, 3.0f});
+  CHECK(array_equal(distributed::all_sum(x), x).item<bool>());
+  CHECK(array_equal(distributed::all_gather(x), x).item<bool>());
+  CHECK(array_equal(distributed::reduce_scatter(x), x).item<bool>());
+  CHECK(array_equal(distributed::broadcast(x, 0), x).item<bool>());
+
+  CHECK_THROWS_AS(distributed::broadcast(x, 1), std::invalid_argument);
+  CHECK_THROWS_AS(distributed::broadcast(x, -1), std::invalid_argument);
+}
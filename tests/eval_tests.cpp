@@ -1,5 +1,9 @@
 // Copyright © 2023 Apple Inc.
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "doctest/doctest.h"
 
 #include "mlx/mlx.h"
@@ -91,3 +95,101 @@ TEST_CASE("test eval graph retention when not tracing") {
   CHECK(!a.has_primitive());
   CHECK(a.is_available());
 }
+
+TEST_CASE("test prefetcher") {
+  // Batches come out in order even with several workers
+  {
+    auto producer = [](int i) -> std::optional<std::vector<array>> {
+      if (i == 10) {
+        return std::nullopt;
+      }
+      auto x = array(i);
+      return std::vector<array>{x, x * array(2)};
+    };
+    Prefetcher prefetcher(producer, 3, 4);
+    for (int i = 0; i < 10; ++i) {
+      auto batch = prefetcher.next();
+      CHECK(batch.has_value());
+      CHECK_EQ((*batch)[0].item<int>(), i);
+      CHECK_EQ((*batch)[1].item<int>(), 2 * i);
+    }
+    CHECK(!prefetcher.next().has_value());
+    CHECK(!prefetcher.next().has_value());
+  }
+
+  // The workers wait for the consumer, a batch is only started once the
+  // consumer has asked for the one depth batches before it
+  {
+    std::mutex mtx;
+    std::condition_variable cv;
+    int produced = 0;
+    std::atomic<int> requested{0};
+    std::atomic<bool> too_early{false};
+    auto producer = [&](int i) -> std::optional<std::vector<array>> {
+      if (i >= requested.load() + 2) {
+        too_early = true;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        produced++;
+      }
+      cv.notify_all();
+      return std::vector<array>{array(i)};
+    };
+    auto wait_for = [&](int n) {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [&] { return produced >= n; });
+    };
+    Prefetcher prefetcher(producer, 2, 2);
+    wait_for(2);
+    for (int i = 0; i < 5; ++i) {
+      requested++;
+      CHECK_EQ(prefetcher.next()->at(0).item<int>(), i);
+      wait_for(i + 3);
+    }
+    CHECK(!too_early);
+  }
+
+  // Errors are raised when their batch is reached
+  {
+    auto producer = [](int i) -> std::optional<std::vector<array>> {
+      if (i == 3) {
+        throw std::runtime_error("bad batch");
+      }
+      return std::vector<array>{array(i)};
+    };
+    Prefetcher prefetcher(producer);
+    for (int i = 0; i < 3; ++i) {
+      CHECK_EQ(prefetcher.next()->at(0).item<int>(), i);
+    }
+    CHECK_THROWS_AS(prefetcher.next(), std::runtime_error);
+    CHECK(!prefetcher.next().has_value());
+  }
+
+  // Producers can fill pooled buffers which are reused once freed
+  {
+    Prefetcher prefetcher(
+        [&prefetcher](int i) -> std::optional<std::vector<array>> {
+          if (i == 4) {
+            return std::nullopt;
+          }
+          auto x = prefetcher.empty({2, 3}, int32);
+          std::fill_n(x.data<int>(), x.size(), i);
+          return std::vector<array>{x};
+        });
+    for (int i = 0; i < 4; ++i) {
+      auto batch = prefetcher.next();
+      CHECK(array_equal(batch->at(0), full({2, 3}, i)).item<bool>());
+    }
+    CHECK(!prefetcher.next().has_value());
+
+    auto x = prefetcher.empty({4}, float32);
+    auto ptr = x.data<float>();
+    x = array(0.0f);
+    CHECK_EQ(prefetcher.empty({2, 2}, int32).data<void>(), ptr);
+    CHECK_NE(prefetcher.empty({3}, float32).data<void>(), ptr);
+  }
+
+  CHECK_THROWS_AS(
+      Prefetcher([](int) { return std::nullopt; }, 0), std::invalid_argument);
+}
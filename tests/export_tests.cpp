@@ -0,0 +1,228 @@
+// Copyright © 2024 Apple Inc.
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "mlx/fast_primitives.h"
+#include "mlx/mlx.h"
+
+using namespace mlx::core;
+
+std::string get_export_file(const std::string& name) {
+  return std::filesystem::temp_directory_path().append(name);
+}
+
+std::vector<array> mlp_fun(const std::vector<array>& inputs) {
+  auto w1 = reshape(arange(12.0f), {4, 3}) / 10.0f;
+  auto w2 = array({1.0f, -1.0f, 0.5f}, {3, 1});
+  auto h = maximum(matmul(inputs[0], w1), array(0.0f));
+  auto out = matmul(h, w2) + inputs[1];
+  return {softmax(transpose(out), -1), sum(h, 1)};
+}
+
+std::vector<array> split_fun(const std::vector<array>& inputs) {
+  auto parts = split(inputs[0], 2, 1);
+  auto y = astype(cumsum(parts[0], 1), int32);
+  return {y, exp(slice(parts[1], {0, 0}, {2, 2}))};
+}
+
+std::vector<array> strided_fun(const std::vector<array>& inputs) {
+  return {as_strided(inputs[0], {2, 2}, {1, 1}, 0)};
+}
+
+std::vector<array> indexing_fun(const std::vector<array>& inputs) {
+  auto& x = inputs[0];
+  auto y = scatter_add(x, array({0, 1}), ones({2, 1, 8}), 0);
+  y = slice_update(y, astype(argpartition(x, 3, 1), float32), {0, 0}, {2, 8});
+  auto bits = random::bits({2, 3}, 4, inputs[1]);
+  return {y, fft::rfft(x, -1), bits};
+}
+
+std::vector<array> attention_fun(const std::vector<array>& inputs) {
+  auto w = array({1.0f, 0.5f, 2.0f, 1.0f});
+  auto x = fast::rms_norm(inputs[0], w, 1e-5f);
+  auto q = fast::rope(x, 4, false, 10000.0f, 1.0f, 0);
+  auto k = fast::rope(inputs[1], 4, false, 10000.0f, 1.0f, 0);
+  return {fast::scaled_dot_product_attention(q, k, inputs[1], 0.5f)};
+}
+
+TEST_CASE("test export import function") {
+  auto file = get_export_file("test_mlp.mlxfn");
+  {
+    auto x = random::normal({5, 4});
+    auto b = array(0.5f);
+    export_function(file, mlp_fun, {x, b});
+
+    auto fn = import_function(file);
+    x = random::normal({5, 4});
+    auto out = fn({x, b});
+    auto expected = mlp_fun({x, b});
+    CHECK_EQ(out.size(), 2);
+    CHECK(allclose(out[0], expected[0]).item<bool>());
+    CHECK(allclose(out[1], expected[1]).item<bool>());
+
+    // Calling again reuses the compiled graph
+    out = fn({x, array(1.0f)});
+    expected = mlp_fun({x, array(1.0f)});
+    CHECK(allclose(out[0], expected[0]).item<bool>());
+
+    // The inputs must match the exported shapes and types
+    CHECK_THROWS_AS(fn({random::normal({4, 4}), b}), std::invalid_argument);
+    CHECK_THROWS_AS(fn({x, array(1)}), std::invalid_argument);
+    CHECK_THROWS_AS(fn({x}), std::invalid_argument);
+  }
+
+  {
+    // Multi-output primitives and primitives with parameters
+    file = get_export_file("test_split.mlxfn");
+    auto x = reshape(arange(16.0f), {2, 8});
+    export_function(file, split_fun, {x});
+    auto out = import_function(file)({x});
+    auto expected = split_fun({x});
+    CHECK_EQ(out[0].dtype(), int32);
+    CHECK(array_equal(out[0], expected[0]).item<bool>());
+    CHECK(allclose(out[1], expected[1]).item<bool>());
+  }
+
+  {
+    auto x = reshape(arange(16.0f), {2, 8});
+    CHECK_THROWS_AS(
+        export_function(
+            get_export_file("test_unsupported.mlxfn"), strided_fun, {x}),
+        std::invalid_argument);
+  }
+
+  {
+    file = get_export_file("test_indexing.mlxfn");
+    auto x = random::normal({2, 8});
+    auto key = random::key(3);
+    export_function(file, indexing_fun, {x, key});
+    auto out = import_function(file)({x, key});
+    auto expected = indexing_fun({x, key});
+    CHECK(allclose(out[0], expected[0]).item<bool>());
+    CHECK(allclose(out[1], expected[1]).item<bool>());
+    CHECK(array_equal(out[2], expected[2]).item<bool>());
+  }
+
+  {
+    // Attention blocks built from the fast ops
+    file = get_export_file("test_attention.mlxfn");
+    auto x = random::normal({1, 2, 3, 4});
+    auto y = random::normal({1, 2, 5, 4});
+    export_function(file, attention_fun, {x, y});
+    auto out = import_function(file)({x, y});
+    CHECK(allclose(out[0], attention_fun({x, y})[0]).item<bool>());
+
+    // Only some of the fast ops have CPU kernels, the others are checked to
+    // round trip without being evaluated
+    file = get_export_file("test_fast.mlxfn");
+    auto fun = [](const std::vector<array>& inputs) {
+      auto s = default_stream(Device::cpu);
+      auto& x = inputs[0];
+      auto norm = array(
+          x.shape(),
+          x.dtype(),
+          std::make_shared<fast::RMSNorm>(s, nullptr, 1e-5f),
+          {x, inputs[1]});
+      return std::vector<array>{array(
+          x.shape(),
+          x.dtype(),
+          std::make_shared<fast::RoPE>(
+              s, nullptr, 4, true, 500.0f, 2.0f, 3, true),
+          {norm})};
+    };
+    auto w = ones({4});
+    export_function(file, fun, {x, w});
+    auto imported = import_function(file)({x, w})[0];
+    auto rope = fun({x, w})[0];
+    CHECK(imported.primitive().is_equivalent(rope.primitive()));
+    CHECK(imported.inputs()[0].primitive().is_equivalent(
+        rope.inputs()[0].primitive()));
+  }
+
+  {
+    // Captured arrays are evaluated and saved, not traced to their producer
+    file = get_export_file("test_captured.mlxfn");
+    auto w = random::uniform({4, 3});
+    auto fun = [w](const std::vector<array>& inputs) {
+      return std::vector<array>{matmul(inputs[0], w) + sum(sin(w), 0)};
+    };
+    auto x = random::normal({2, 4});
+    export_function(file, fun, {x});
+    auto out = import_function(file)({x});
+    CHECK(allclose(out[0], fun({x})[0]).item<bool>());
+
+    // Corrupt sizes are rejected before anything is allocated
+    std::string bytes;
+    {
+      std::ifstream is(file, std::ios::binary);
+      bytes.assign(
+          (std::istreambuf_iterator<char>(is)),
+          std::istreambuf_iterator<char>());
+    }
+    for (size_t cut : {bytes.size() / 2, bytes.size() - 4}) {
+      std::ofstream os(file, std::ios::binary);
+      os.write(bytes.data(), cut);
+      os.close();
+      CHECK_THROWS_AS(import_function(file), std::invalid_argument);
+    }
+    {
+      // The input count is followed by the shape size of the first input
+      auto corrupt = bytes;
+      std::fill_n(corrupt.begin() + 20, 8, '\x7f');
+      std::ofstream os(file, std::ios::binary);
+      os.write(corrupt.data(), corrupt.size());
+      os.close();
+      CHECK_THROWS_AS(import_function(file), std::invalid_argument);
+    }
+  }
+
+  {
+    // Nodes must have as many inputs as their primitive takes and the saved
+    // shapes must match the ones the primitive infers
+    file = get_export_file("test_exp.mlxfn");
+    auto x = random::normal({2, 3});
+    export_function(
+        file,
+        [](const std::vector<array>& inputs) {
+          return std::vector<array>{exp(inputs[0])};
+        },
+        {x});
+    std::string bytes;
+    {
+      std::ifstream is(file, std::ios::binary);
+      bytes.assign(
+          (std::istreambuf_iterator<char>(is)),
+          std::istreambuf_iterator<char>());
+    }
+    auto write = [&file](const std::string& b) {
+      std::ofstream os(file, std::ios::binary);
+      os.write(b.data(), b.size());
+    };
+    auto name = bytes.find("Exp");
+
+    auto corrupt = bytes;
+    corrupt.replace(name, 3, "Add");
+    write(corrupt);
+    CHECK_THROWS_AS(import_function(file), std::invalid_argument);
+
+    // The name is followed by the input ids, the number of outputs and the
+    // size of the first output shape
+    corrupt = bytes;
+    int dim = 5;
+    std::memcpy(corrupt.data() + name + 3 + 16 + 8 + 8, &dim, sizeof(int));
+    write(corrupt);
+    auto fn = import_function(file);
+    CHECK_THROWS_AS(fn({x}), std::invalid_argument);
+
+    write(bytes);
+    CHECK(allclose(import_function(file)({x})[0], exp(x)).item<bool>());
+  }
+
+  CHECK_THROWS(import_function(get_export_file("does_not_exist.mlxfn")));
+}
@@ -1,12 +1,15 @@
 // Copyright © 2023 Apple Inc.
 
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <vector>
 
 #include "doctest/doctest.h"
 
+#include "mlx/io/load.h"
 #include "mlx/mlx.h"
+#include "mlx/primitives.h"
 
 using namespace mlx::core;
 
@@ -40,6 +43,145 @@ TEST_CASE("test save_safetensors") {
   CHECK(array_equal(test2, ones({2, 2})).item<bool>());
 }
 
+TEST_CASE("test open_safetensors") {
+  std::string file_path = get_temp_file("test_checkpoint.safetensors");
+  std::unordered_map<std::string, array> map = {
+      {"layers.0.w", reshape(arange(6, float32), {2, 3})},
+      {"layers.0.b", array({1, 2, 3})},
+      {"layers.1.w", astype(ones({4, 2}), float16)},
+      {"layers.10.w", zeros({5}, int8)},
+      {"head", array(2.0f)}};
+  save_safetensors(file_path, map, {{"format", "mlx"}});
+
+  auto checkpoint = open_safetensors(file_path);
+  CHECK_EQ(checkpoint.metadata().at("format"), "mlx");
+  CHECK_EQ(checkpoint.tensors().size(), map.size());
+  for (auto& [k, v] : map) {
+    CHECK(checkpoint.contains(k));
+    auto& info = checkpoint.tensors().at(k);
+    CHECK_EQ(info.shape, v.shape());
+    CHECK_EQ(info.dtype, v.dtype());
+    CHECK_EQ(info.nbytes, v.nbytes());
+  }
+
+  auto w = checkpoint.load("layers.1.w");
+  CHECK(array_equal(w, map.at("layers.1.w")).item<bool>());
+
+  auto layer = checkpoint.load_prefix("layers.1.");
+  CHECK_EQ(layer.size(), 1);
+  CHECK_EQ(layer.count("layers.1.w"), 1);
+  CHECK_EQ(checkpoint.load_prefix("layers.1").size(), 2);
+  CHECK_EQ(checkpoint.load_prefix("layers.").size(), 4);
+  CHECK_EQ(checkpoint.load_prefix("").size(), map.size());
+  CHECK_EQ(checkpoint.load_prefix("missing").size(), 0);
+
+  auto some = checkpoint.load(std::vector<std::string>{"head", "layers.0.b"});
+  CHECK_EQ(some.size(), 2);
+  CHECK(array_equal(some.at("head"), map.at("head")).item<bool>());
+  CHECK(array_equal(some.at("layers.0.b"), map.at("layers.0.b")).item<bool>());
+
+  auto weights = checkpoint.load([](const std::string& k) {
+    return k.size() > 2 && k.substr(k.size() - 2) == ".w";
+  });
+  CHECK_EQ(weights.size(), 3);
+  for (auto& [k, v] : weights) {
+    CHECK(array_equal(v, map.at(k)).item<bool>());
+  }
+
+  CHECK_THROWS_AS(checkpoint.load("missing"), std::invalid_argument);
+}
+
+TEST_CASE("test load with conversion") {
+  std::string file_path = get_temp_file("test_convert.safetensors");
+  auto w = random::normal({1100, 1024});
+  std::unordered_map<std::string, array> map = {
+      {"w", astype(w, bfloat16)},
+      {"w32", w},
+      {"v", astype(arange(1500000), int16)},
+      {"b", array({1.0f, 2.0f})}};
+  save_safetensors(file_path, map);
+  auto checkpoint = open_safetensors(file_path);
+
+  // Conversions span several chunks
+  for (auto& [k, dtype] : std::vector<std::pair<std::string, Dtype>>{
+           {"w", float32}, {"w", float16}, {"v", float32}, {"b", int32}}) {
+    auto a = checkpoint.load(k, dtype);
+    CHECK_EQ(a.dtype(), dtype);
+    CHECK(array_equal(a, astype(map.at(k), dtype)).item<bool>());
+  }
+
+  // Quantizing on read matches quantize
+  for (auto& [k, dtype, group_size, bits] :
+       std::vector<std::tuple<std::string, Dtype, int, int>>{
+           {"w32", float32, 64, 4},
+           {"w32", float32, 32, 2},
+           {"w", float16, 128, 8},
+           {"w", bfloat16, 64, 4}}) {
+    auto [wq, scales, biases] =
+        checkpoint.load_quantized(k, group_size, bits, dtype);
+    auto [wq_ref, scales_ref, biases_ref] =
+        quantize(astype(map.at(k), dtype), group_size, bits);
+    CHECK_EQ(wq.shape(), wq_ref.shape());
+    CHECK_EQ(scales.dtype(), dtype);
+    CHECK(array_equal(wq, wq_ref).item<bool>());
+    CHECK(array_equal(scales, scales_ref).item<bool>());
+    CHECK(array_equal(biases, biases_ref).item<bool>());
+  }
+
+  // The stored type is kept by default
+  auto [wq, scales, biases] = checkpoint.load_quantized("w");
+  CHECK_EQ(scales.dtype(), bfloat16);
+
+  CHECK_THROWS_AS(checkpoint.load_quantized("b"), std::invalid_argument);
+  CHECK_THROWS_AS(checkpoint.load_quantized("v"), std::invalid_argument);
+  CHECK_THROWS_AS(
+      checkpoint.load_quantized("w", 64, 4, int32), std::invalid_argument);
+  CHECK_THROWS_AS(checkpoint.load_quantized("w", 48), std::invalid_argument);
+}
+
+TEST_CASE("test save_npz") {
+  std::string file_path = get_temp_file("test_arr.npz");
+  std::unordered_map<std::string, array> map = {
+      {"a", array({1.0f, 2.0f, 3.0f, 4.0f})},
+      {"b", transpose(reshape(arange(12, int32), {3, 4}))},
+      {"c", array({true, false, true})},
+      {"d", astype(random::normal({33, 65}), float16)},
+      {"e", astype(arange(1000), int8)}};
+
+  for (bool compressed : {false, true}) {
+    save_npz(file_path, map, compressed);
+    auto loaded = load_npz(file_path);
+    CHECK_EQ(loaded.size(), map.size());
+    for (auto& [k, v] : map) {
+      CHECK_EQ(loaded.count(k), 1);
+      auto& l = loaded.at(k);
+      CHECK_EQ(l.dtype(), v.dtype());
+      CHECK_EQ(l.shape(), v.shape());
+      CHECK(array_equal(l, v).item<bool>());
+    }
+  }
+
+  // The .npz extension is added if missing
+  save_npz(get_temp_file("test_arr_1"), map);
+  CHECK_EQ(load_npz(get_temp_file("test_arr_1.npz")).size(), map.size());
+
+  CHECK_THROWS(load_npz(get_temp_file("test_arr.safetensors")));
+
+  // A member size past the end of the archive is rejected before reading
+  for (bool compressed : {false, true}) {
+    save_npz(file_path, {{"a", arange(10)}}, compressed);
+    std::fstream fs(file_path, std::ios::in | std::ios::out | std::ios::binary);
+    std::string bytes(
+        (std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    auto pos = bytes.find("PK\x01\x02");
+    CHECK_NE(pos, std::string::npos);
+    fs.seekp(pos + 20);
+    fs.write("\xf0\xff\xff\x7f\xf0\xff\xff\x7f", 8);
+    fs.close();
+    CHECK_THROWS_AS(load_npz(file_path), std::runtime_error);
+  }
+}
+
 TEST_CASE("test gguf") {
   std::string file_path = get_temp_file("test_arr.gguf");
   using dict = std::unordered_map<std::string, array>;
@@ -201,6 +343,59 @@ TEST_CASE("test gguf metadata") {
   }
 }
 
+TEST_CASE("test load big endian") {
+  // Write a 1D array to .npy with its bytes swapped
+  auto save_big_endian = [](const std::string& path, array a, char kind) {
+    a.eval();
+    std::ostringstream header;
+    header << "{'descr': '>" << kind << a.itemsize()
+           << "', 'fortran_order': False, 'shape': (" << a.size() << ",), }";
+    auto h = header.str();
+    h += std::string(63 - (h.size() + 10) % 64, ' ') + "\n";
+    std::ofstream os(path, std::ios::binary);
+    uint16_t len = h.size();
+    os.write("\x93NUMPY\x01\x00", 8);
+    os.write(reinterpret_cast<char*>(&len), 2);
+    os << h;
+    std::vector<char> data(a.data<char>(), a.data<char>() + a.nbytes());
+    for (size_t i = 0; i < data.size(); i += a.itemsize()) {
+      std::reverse(data.begin() + i, data.begin() + i + a.itemsize());
+    }
+    os.write(data.data(), data.size());
+  };
+
+  std::string file_path = get_temp_file("test_big_endian.npy");
+  for (auto& [a, kind] : std::vector<std::pair<array, char>>{
+           {astype(arange(5000003), int16), 'i'},
+           {astype(arange(-1000001, 1000000), int32), 'i'},
+           {random::normal({37}), 'f'},
+           {astype(arange(3), float16), 'f'},
+           {astype(arange(4000001), uint64) * array(1000003, uint64), 'u'},
+           {array({true, false, true}), 'b'}}) {
+    save_big_endian(file_path, a, kind);
+    auto b = load(file_path);
+    CHECK_EQ(b.dtype(), a.dtype());
+    CHECK(array_equal(a, b).item<bool>());
+  }
+}
+
+TEST_CASE("test load truncated file") {
+  // Data for several read chunks, but the file ends in the second one
+  std::string file_path = get_temp_file("test_truncated.bin");
+  {
+    std::ofstream os(file_path, std::ios::binary);
+    std::vector<char> data(10 << 20, 1);
+    os.write(data.data(), data.size());
+  }
+
+  // Evaluate the primitive on this thread so the error can be caught
+  auto reader = std::make_shared<io::ParallelFileReader>(file_path);
+  auto load_prim =
+      std::make_shared<Load>(default_stream(Device::cpu), reader, 0);
+  array out({1 << 22}, float32, load_prim, {});
+  CHECK_THROWS_AS(load_prim->eval_cpu({}, out), std::runtime_error);
+}
+
 TEST_CASE("test single array serialization") {
   // Basic test
   {
@@ -2304,6 +2304,57 @@ TEST_CASE("test pad") {
   CHECK_EQ(pad(x, 1).shape(), std::vector<int>{3, 4, 5});
   CHECK_EQ(pad(x, {0, 1}).shape(), std::vector<int>{2, 3, 4});
   CHECK_EQ(pad(x, {{1, 1}, {1, 2}, {3, 1}}).shape(), std::vector<int>{3, 5, 7});
+
+  // The input lands in the interior and every other element is the value
+  auto check_pad = [](array x, std::vector<std::pair<int, int>> widths) {
+    auto y = pad(x, widths, array(-1, x.dtype()));
+    std::vector<int> start, stop;
+    for (int i = 0; i < x.ndim(); i++) {
+      start.push_back(widths[i].first);
+      stop.push_back(widths[i].first + x.shape(i));
+    }
+    CHECK(array_equal(slice(y, start, stop), x).item<bool>());
+    auto n_vals = sum(equal(y, array(-1, x.dtype()))).item<int>();
+    CHECK_EQ(n_vals, y.size() - x.size());
+  };
+  x = reshape(arange(24, int32), {2, 3, 4});
+  check_pad(x, {{1, 2}, {0, 1}, {2, 0}});
+  check_pad(x, {{0, 0}, {0, 0}, {3, 1}});
+  check_pad(x, {{2, 1}, {0, 0}, {0, 0}});
+  check_pad(transpose(x), {{1, 1}, {2, 2}, {0, 3}});
+  check_pad(astype(x, float16), {{1, 0}, {1, 0}, {1, 0}});
+  check_pad(astype(x, int8), {{0, 1}, {1, 0}, {0, 1}});
+  check_pad(arange(100000, float32), {{1000, 7}});
+  check_pad(reshape(arange(300000, float32), {300, 1000}), {{3, 2}, {1, 1}});
+  check_pad(zeros({0, 3}), {{1, 1}, {1, 1}});
+}
+
+TEST_CASE("test concatenate values") {
+  auto check_concat = [](std::vector<array> xs, int axis) {
+    auto y = concatenate(xs, axis);
+    std::vector<int> start(y.ndim(), 0);
+    auto stop = y.shape();
+    for (auto& x : xs) {
+      stop[axis] = start[axis] + x.shape(axis);
+      CHECK(array_equal(slice(y, start, stop), x).item<bool>());
+      start[axis] = stop[axis];
+    }
+  };
+  auto x = reshape(arange(24, float32), {2, 3, 4});
+  for (int axis = 0; axis < 3; axis++) {
+    check_concat({x, x + 100, x + 200}, axis);
+  }
+  auto xt = transpose(reshape(arange(30, float32), {2, 5, 3}), {0, 2, 1});
+  check_concat({x, xt, x}, 2);
+  check_concat({x, astype(x, int32)}, 1);
+  check_concat({x, zeros({2, 0, 4})}, 1);
+  auto big = reshape(arange(600000, float32), {600, 1000});
+  check_concat({big, big + 1, ones({600, 1})}, 1);
+  check_concat({big, ones({1, 1000})}, 0);
+
+  auto y = concatenate({array({true}), array({1.5f})});
+  CHECK_EQ(y.dtype(), float32);
+  CHECK(array_equal(y, array({1.0f, 1.5f})).item<bool>());
 }
 
 TEST_CASE("test power") {
@@ -2394,6 +2445,31 @@ TEST_CASE("test where") {
   CHECK(array_equal(where(condition, x, y), array({inf, 20.0, -inf}))
             .item<bool>());
 
+  // Large inputs go through the flat and row wise kernels
+  auto mask = random::bernoulli(array(0.5f), {4, 64, 300});
+  auto scores = random::normal({2, 4, 64, 300});
+  auto blend = [](const array& c, const array& x, const array& y) {
+    auto cf = astype(c, float32);
+    return add(multiply(cf, x), multiply(subtract(array(1.0f), cf), y));
+  };
+  CHECK(array_equal(
+            where(mask, scores, array(0.0f)),
+            blend(mask, scores, array(0.0f)))
+            .item<bool>());
+  auto row_mask = random::bernoulli(array(0.5f), {64, 300});
+  CHECK(array_equal(
+            where(row_mask, scores, array(-1.0f)),
+            blend(row_mask, scores, array(-1.0f)))
+            .item<bool>());
+  auto big = random::normal({2, 4, 64, 300});
+  CHECK(array_equal(where(mask, scores, big), blend(mask, scores, big))
+            .item<bool>());
+  auto ints = astype(scores, int64);
+  CHECK(array_equal(
+            where(row_mask, ints, array(7, int64)),
+            astype(blend(row_mask, astype(ints, float32), array(7.0f)), int64))
+            .item<bool>());
+
   // 4-dim optimized case.
   condition = array({false});
   x = array({1, 2}, {2, 1, 1, 1});
@@ -2588,6 +2664,93 @@ TEST_CASE("test clipping with only max") {
   CHECK(array_equal(clipped, expected).item<bool>());
 }
 
+TEST_CASE("test clipping broadcast bounds") {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  auto clip_ref = [](const array& a,
+                     const std::optional<array>& a_min,
+                     const std::optional<array>& a_max) {
+    auto out = a_min ? maximum(a, *a_min) : a;
+    return a_max ? minimum(out, *a_max) : out;
+  };
+
+  // Array bounds broadcast against the input
+  auto a = random::normal({3, 40000});
+  auto lo = array({-1.0f, 0.0f, -0.5f}, {3, 1});
+  auto hi = random::uniform({40000});
+  CHECK(array_equal(clip(a, lo, hi), clip_ref(a, lo, hi)).item<bool>());
+  CHECK(array_equal(clip(a, lo, std::nullopt), clip_ref(a, lo, std::nullopt))
+            .item<bool>());
+  CHECK(array_equal(clip(a, std::nullopt, hi), clip_ref(a, std::nullopt, hi))
+            .item<bool>());
+  auto at = transpose(reshape(a, {200, 600}));
+  CHECK(array_equal(clip(at, array(-0.5f), array(0.5f)),
+                    clip_ref(at, array(-0.5f), array(0.5f)))
+            .item<bool>());
+
+  // NaNs in the input or the bounds propagate like maximum and minimum
+  a = array({nan, 1.0f, 2.0f, 3.0f});
+  lo = array({0.0f, nan, 0.0f, 0.0f});
+  hi = array({5.0f, 5.0f, nan, 2.5f});
+  CHECK(array_equal(clip(a, lo, hi), clip_ref(a, lo, hi), true).item<bool>());
+
+  // Integer inputs and type promotion
+  auto ai = array({-5, 0, 5, 10});
+  CHECK(array_equal(clip(ai, array(0), array(6)), array({0, 0, 5, 6}))
+            .item<bool>());
+  CHECK_EQ(clip(ai, array(0.5f), std::nullopt).dtype(), float32);
+
+  // Gradients match the composed maximum and minimum
+  a = array({-2.0f, 0.0f, 1.0f, 3.0f, 4.0f});
+  lo = array(0.0f);
+  hi = array({3.0f, 3.0f, 3.0f, 3.0f, 3.0f});
+  auto fn = [](const std::vector<array>& in) {
+    return std::vector<array>{clip(in[0], in[1], in[2])};
+  };
+  auto ref = [&clip_ref](const std::vector<array>& in) {
+    return std::vector<array>{clip_ref(in[0], in[1], in[2])};
+  };
+  auto cotan = array({1.0f, 2.0f, 3.0f, 4.0f, 5.0f});
+  auto grads = vjp(fn, {a, lo, hi}, {cotan}).second;
+  auto expected = vjp(ref, {a, lo, hi}, {cotan}).second;
+  for (int i = 0; i < 3; i++) {
+    CHECK(array_equal(grads[i], expected[i]).item<bool>());
+  }
+  auto tangents = jvp(fn, {a, lo, hi}, {cotan, array(1.0f), cotan}).second;
+  auto expected_tangents =
+      jvp(ref, {a, lo, hi}, {cotan, array(1.0f), cotan}).second;
+  CHECK(array_equal(tangents[0], expected_tangents[0]).item<bool>());
+
+  // A single bound
+  auto max_fn = [](const std::vector<array>& in) {
+    return std::vector<array>{clip(in[0], std::nullopt, in[1])};
+  };
+  auto max_ref = [](const std::vector<array>& in) {
+    return std::vector<array>{minimum(in[0], in[1])};
+  };
+  grads = vjp(max_fn, {a, hi}, {cotan}).second;
+  expected = vjp(max_ref, {a, hi}, {cotan}).second;
+  CHECK(array_equal(grads[0], array({1.0f, 2.0f, 3.0f, 0.0f, 0.0f}))
+            .item<bool>());
+  CHECK(array_equal(grads[0], expected[0]).item<bool>());
+  CHECK(array_equal(grads[1], expected[1]).item<bool>());
+  auto min_fn = [](const std::vector<array>& in) {
+    return std::vector<array>{clip(in[0], in[1], std::nullopt)};
+  };
+  grads = vjp(min_fn, {a, lo}, {cotan}).second;
+  CHECK(array_equal(grads[0], array({0.0f, 0.0f, 3.0f, 4.0f, 5.0f}))
+            .item<bool>());
+
+  // Batched bounds
+  auto vfn = [](const std::vector<array>& in) {
+    return std::vector<array>{clip(in[0], in[1], std::nullopt)};
+  };
+  auto x = reshape(arange(6.0f), {2, 3});
+  auto bounds = array({1.0f, 4.0f});
+  auto out = vmap(vfn, {0, 0})({x, bounds})[0];
+  CHECK(array_equal(out, array({1.0f, 1.0f, 2.0f, 4.0f, 4.0f, 5.0f}, {2, 3}))
+            .item<bool>());
+}
+
 TEST_CASE("test linspace") {
   auto x = linspace(0, 10, 5);
   auto expected = array({0.0f, 2.5f, 5.0f, 7.5f, 10.0f}, {5});
@@ -2620,6 +2783,46 @@ TEST_CASE("test quantize dequantize") {
   }
 }
 
+TEST_CASE("test dynamic quantized matmul") {
+  auto w = random::normal({96, 256});
+  for (int group_size : {32, 64, 128}) {
+    auto [w_q, scales, biases] = quantize(w, group_size, 8);
+    auto w_hat = dequantize(w_q, scales, biases, group_size, 8);
+
+    // Rows with integer values and a maximum of 127 are quantized exactly
+    auto x = floor(random::uniform(-127.0f, 127.0f, {7, 256}));
+    x = concatenate({full({7, 1}, 127.0f), slice(x, {0, 1}, {7, 256})}, 1);
+    auto out = dynamic_quantized_matmul(x, w_q, scales, biases, group_size);
+    auto expected = matmul(x, transpose(w_hat));
+    CHECK_EQ(out.shape(), std::vector<int>{7, 96});
+    CHECK(allclose(out, expected, 1e-4, 1e-2).item<bool>());
+
+    // In general the error is bounded by the activation quantization
+    x = random::normal({2, 3, 256});
+    out = dynamic_quantized_matmul(x, w_q, scales, biases, group_size);
+    expected = matmul(x, transpose(w_hat));
+    CHECK_EQ(out.shape(), std::vector<int>{2, 3, 96});
+    auto tol = 0.02f * max(abs(expected)).item<float>();
+    CHECK(allclose(out, expected, 0.0, tol).item<bool>());
+
+    out = dynamic_quantized_matmul(
+        astype(x, float16),
+        w_q,
+        astype(scales, float16),
+        astype(biases, float16),
+        group_size);
+    CHECK_EQ(out.dtype(), float16);
+    CHECK(allclose(astype(out, float32), expected, 0.0, 2 * tol)
+              .item<bool>());
+  }
+
+  // Only 8 bit weights are supported
+  auto [w_q, scales, biases] = quantize(w, 64, 4);
+  CHECK_THROWS_AS(
+      dynamic_quantized_matmul(ones({2, 256}), w_q, scales, biases, 64),
+      std::invalid_argument);
+}
+
 TEST_CASE("test repeat") {
   auto data = array({13, 3, 16, 6, 14, 4, 15, 5, 11, 1, 12, 2}, {3, 2, 2});
   auto repeat_axis_0 = repeat(data, 2, 0);
@@ -3327,3 +3530,442 @@ TEST_CASE("test conv1d") {
     CHECK(allclose(out, expected, /* rtol = */ 1.0e-3).item<bool>());
   }
 }
+
+TEST_CASE("test conv2d groups") {
+  auto in = random::normal({2, 9, 11, 8});
+  auto check_groups = [&](int O,
+                          int groups,
+                          std::pair<int, int> stride,
+                          std::pair<int, int> padding,
+                          std::pair<int, int> dilation) {
+    int C_per_group = 8 / groups;
+    int O_per_group = O / groups;
+    auto wt = random::normal({O, 3, 3, C_per_group});
+    auto out = conv2d(in, wt, stride, padding, dilation, groups, Device::cpu);
+
+    // Compare against one ungrouped convolution per group
+    std::vector<array> outs;
+    for (int g = 0; g < groups; ++g) {
+      auto in_g = slice(
+          in, {0, 0, 0, g * C_per_group}, {2, 9, 11, (g + 1) * C_per_group});
+      auto wt_g = slice(
+          wt,
+          {g * O_per_group, 0, 0, 0},
+          {(g + 1) * O_per_group, 3, 3, C_per_group});
+      outs.push_back(conv2d(in_g, wt_g, stride, padding, dilation, 1));
+    }
+    auto expected = concatenate(outs, 3);
+    CHECK_EQ(out.shape(), expected.shape());
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  };
+
+  // Depthwise
+  check_groups(8, 8, {1, 1}, {1, 1}, {1, 1});
+  check_groups(8, 8, {2, 1}, {0, 2}, {1, 2});
+
+  // Grouped
+  check_groups(16, 8, {1, 1}, {1, 1}, {1, 1});
+  check_groups(6, 2, {1, 2}, {1, 0}, {1, 1});
+  check_groups(4, 4, {1, 1}, {1, 1}, {2, 1});
+
+  // Grouped with more padding after than before each spatial axis
+  {
+    auto wt = random::normal({6, 3, 3, 4});
+    auto out = conv_general(
+        in, wt, {1, 2}, {0, 1}, {2, 3}, {1, 1}, {1, 1}, 2, false, Device::cpu);
+    std::vector<array> outs;
+    for (int g = 0; g < 2; ++g) {
+      outs.push_back(conv_general(
+          slice(in, {0, 0, 0, 4 * g}, {2, 9, 11, 4 * (g + 1)}),
+          slice(wt, {3 * g, 0, 0, 0}, {3 * (g + 1), 3, 3, 4}),
+          {1, 2},
+          {0, 1},
+          {2, 3},
+          {1, 1},
+          {1, 1},
+          1,
+          false,
+          Device::cpu));
+    }
+    auto expected = concatenate(outs, 3);
+    CHECK_EQ(out.shape(), expected.shape());
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  }
+
+  // Depthwise 1D
+  auto in_1d = random::normal({2, 13, 6});
+  auto wt_1d = random::normal({6, 5, 1});
+  auto out_1d = conv1d(in_1d, wt_1d, 2, 2, 1, 6, Device::cpu);
+  std::vector<array> outs_1d;
+  for (int c = 0; c < 6; ++c) {
+    outs_1d.push_back(conv1d(
+        slice(in_1d, {0, 0, c}, {2, 13, c + 1}),
+        slice(wt_1d, {c, 0, 0}, {c + 1, 5, 1}),
+        2,
+        2));
+  }
+  CHECK(allclose(out_1d, concatenate(outs_1d, 2), 1e-5, 1e-5).item<bool>());
+}
+
+TEST_CASE("test conv with input dilation") {
+  // Compare against a convolution of the explicitly dilated input
+  auto check_conv = [](const array& in,
+                       const array& wt,
+                       std::vector<int> stride,
+                       std::vector<int> padding_lo,
+                       std::vector<int> padding_hi,
+                       std::vector<int> kernel_dilation,
+                       std::vector<int> input_dilation,
+                       bool flip) {
+    auto out = conv_general(
+        in,
+        wt,
+        stride,
+        padding_lo,
+        padding_hi,
+        kernel_dilation,
+        input_dilation,
+        1,
+        flip,
+        Device::cpu);
+
+    int n_dims = in.ndim() - 2;
+    auto dil_shape = in.shape();
+    std::vector<int> starts(in.ndim(), 0);
+    std::vector<int> strides(in.ndim(), 1);
+    auto wt_ref = wt;
+    for (int i = 0; i < n_dims; ++i) {
+      dil_shape[i + 1] = 1 + input_dilation[i] * (in.shape(i + 1) - 1);
+      strides[i + 1] = input_dilation[i];
+      if (flip) {
+        int k = wt.shape(i + 1);
+        wt_ref = take(wt_ref, arange(k - 1, -1, -1), i + 1);
+      }
+    }
+    auto in_dil = slice_update(
+        zeros(dil_shape, in.dtype()), in, starts, dil_shape, strides);
+    auto expected = conv_general(
+        in_dil,
+        wt_ref,
+        stride,
+        padding_lo,
+        padding_hi,
+        kernel_dilation,
+        {1},
+        1,
+        false,
+        Device::cpu);
+
+    CHECK_EQ(out.shape(), expected.shape());
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  };
+
+  for (bool flip : {false, true}) {
+    auto in_1d = random::normal({2, 7, 3});
+    auto wt_1d = random::normal({5, 3, 3});
+    check_conv(in_1d, wt_1d, {1}, {2}, {2}, {1}, {2}, flip);
+    check_conv(in_1d, wt_1d, {2}, {1}, {0}, {2}, {3}, flip);
+
+    auto in_2d = random::normal({2, 5, 6, 3});
+    auto wt_2d = random::normal({4, 3, 2, 3});
+    check_conv(in_2d, wt_2d, {1, 1}, {2, 1}, {2, 1}, {1, 1}, {2, 2}, flip);
+    check_conv(in_2d, wt_2d, {1, 2}, {1, 2}, {0, 1}, {1, 2}, {2, 3}, flip);
+
+    auto in_3d = random::normal({1, 3, 4, 3, 2});
+    auto wt_3d = random::normal({3, 2, 2, 2, 2});
+    check_conv(
+        in_3d,
+        wt_3d,
+        {1, 1, 1},
+        {1, 1, 1},
+        {1, 1, 1},
+        {1, 1, 1},
+        {2, 2, 2},
+        flip);
+  }
+
+  // Input gradient of a strided convolution (a transposed convolution)
+  auto in = random::normal({2, 9, 8, 3});
+  auto wt = random::normal({4, 3, 3, 3});
+  auto fn = [&wt](array x) {
+    return sum(conv2d(x, wt, {2, 2}, {1, 1}, {1, 1}, 1, Device::cpu));
+  };
+  auto grad = mlx::core::grad(fn)(in);
+
+  // Each input pixel gets the sum of the kernel taps that touch it. Tap
+  // (kh, kw) of the 5x4 outputs lands on every other pixel of the padded
+  // input starting at (kh, kw).
+  auto taps = sum(wt, 0);
+  auto expected = zeros({2, 11, 10, 3});
+  for (int kh = 0; kh < 3; ++kh) {
+    for (int kw = 0; kw < 3; ++kw) {
+      std::vector<int> start = {0, kh, kw, 0};
+      std::vector<int> stop = {2, kh + 9, kw + 7, 3};
+      std::vector<int> strides = {1, 2, 2, 1};
+      auto tap = slice(taps, {kh, kw, 0}, {kh + 1, kw + 1, 3});
+      expected = slice_update(
+          expected,
+          slice(expected, start, stop, strides) + reshape(tap, {3}),
+          start,
+          stop,
+          strides);
+    }
+  }
+  expected = slice(expected, {0, 1, 1, 0}, {2, 10, 9, 3});
+  CHECK_EQ(grad.shape(), in.shape());
+  CHECK(allclose(grad, expected, 1e-4, 1e-4).item<bool>());
+}
+
+TEST_CASE("test pooling") {
+  // Reference pooling over explicit (N, H_out, W_out, C, kh, kw) windows
+  auto windows = [](array x, int k, int s, int p, array pad_value) {
+    x = pad(x, {1, 2}, {p, p}, {p, p}, pad_value);
+    int n_out = (x.shape(1) - k) / s + 1;
+    std::vector<array> rows;
+    for (int i = 0; i < k; ++i) {
+      std::vector<array> cols;
+      for (int j = 0; j < k; ++j) {
+        cols.push_back(slice(
+            x,
+            {0, i, j, 0},
+            {x.shape(0),
+             i + (n_out - 1) * s + 1,
+             j + (n_out - 1) * s + 1,
+             x.shape(3)},
+            {1, s, s, 1}));
+      }
+      rows.push_back(stack(cols, -1));
+    }
+    return stack(rows, -2);
+  };
+  auto ninf = array(-std::numeric_limits<float>::infinity());
+
+  auto x = random::normal({2, 9, 9, 5});
+  for (auto [k, s, p] : std::vector<std::array<int, 3>>{
+           {2, 2, 0}, {3, 2, 1}, {3, 1, 1}, {4, 3, 2}}) {
+    auto expected = max(windows(x, k, s, p, ninf), {-2, -1});
+    auto out = max_pool(x, {k, k}, {s, s}, {p, p});
+    CHECK_EQ(out.shape(), expected.shape());
+    CHECK(array_equal(out, expected).item<bool>());
+
+    expected = mean(windows(x, k, s, p, array(0.0f)), {-2, -1});
+    out = avg_pool(x, {k, k}, {s, s}, {p, p});
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  }
+
+  // Gradients match the ones of the reference
+  auto max_fn = [](array x) {
+    return sum(square(max_pool(x, {3, 3}, {2, 2}, {1, 1})));
+  };
+  auto max_ref = [&](array x) {
+    return sum(square(max(windows(x, 3, 2, 1, ninf), {-2, -1})));
+  };
+  CHECK(allclose(grad(max_fn)(x), grad(max_ref)(x), 1e-5, 1e-5).item<bool>());
+  auto avg_fn = [](array x) {
+    return sum(square(avg_pool(x, {3, 3}, {2, 2}, {1, 1})));
+  };
+  auto avg_ref = [&](array x) {
+    return sum(square(mean(windows(x, 3, 2, 1, array(0.0f)), {-2, -1})));
+  };
+  CHECK(allclose(grad(avg_fn)(x), grad(avg_ref)(x), 1e-5, 1e-5).item<bool>());
+
+  // Forward mode agrees with reverse mode, <jvp(t), u> = <t, vjp(u)>
+  auto t = random::normal(x.shape());
+  auto pool_fn = [](const std::vector<array>& in) {
+    return std::vector<array>{max_pool(in[0], {3, 3}, {2, 2}, {1, 1})};
+  };
+  auto jout = jvp(pool_fn, {x}, {t}).second[0];
+  auto u = random::normal(jout.shape());
+  auto vout = vjp(pool_fn, {x}, {u}).second[0];
+  CHECK(allclose(sum(jout * u), sum(t * vout), 1e-4, 1e-4).item<bool>());
+
+  // 1D and 3D pooling
+  auto x1 = reshape(arange(12.0f), {1, 6, 2});
+  CHECK(array_equal(
+            max_pool(x1, {2}),
+            array({2.0f, 3.0f, 6.0f, 7.0f, 10.0f, 11.0f}, {1, 3, 2}))
+            .item<bool>());
+  auto x3 = random::normal({2, 4, 4, 4, 3});
+  auto r3 = reshape(x3, {2, 2, 2, 2, 2, 2, 2, 3});
+  CHECK(array_equal(max_pool(x3, {2, 2, 2}), max(r3, {2, 4, 6})).item<bool>());
+  CHECK(allclose(avg_pool(x3, {2, 2, 2}), mean(r3, {2, 4, 6}), 1e-5, 1e-5)
+            .item<bool>());
+
+  // Integer inputs
+  auto xi = reshape(arange(16), {1, 4, 4, 1});
+  auto yi = max_pool(xi, {2, 2}, {2, 2}, {1, 1});
+  CHECK_EQ(yi.dtype(), int32);
+  auto yi_expected = array({0, 2, 3, 8, 10, 11, 12, 14, 15}, {1, 3, 3, 1});
+  CHECK(array_equal(yi, yi_expected).item<bool>());
+  CHECK_EQ(avg_pool(xi, {2, 2}).dtype(), float32);
+
+  // The padding of integer inputs never wins over an input value
+  auto ipool_fn = [](const std::vector<array>& in) {
+    return std::vector<array>{max_pool(in[0], {2}, {2}, {1})};
+  };
+  for (auto dtype : {int32, uint8}) {
+    auto xp = astype(array({0, 7, 2, 0}, {1, 4, 1}), dtype);
+    auto tp = astype(array({1, 2, 3, 4}, {1, 4, 1}), dtype);
+    auto jp = jvp(ipool_fn, {xp}, {tp}).second[0];
+    CHECK(array_equal(jp, array({1, 2, 4}, {1, 3, 1})).item<bool>());
+  }
+  auto xmin = array({std::numeric_limits<int32_t>::lowest(), 1}, {1, 2, 1});
+  auto jmin = jvp(ipool_fn, {xmin}, {array({5, 6}, {1, 2, 1})}).second[0];
+  CHECK(array_equal(jmin, array({5, 6}, {1, 2, 1})).item<bool>());
+
+  // vmap over a leading axis
+  auto xv = random::normal({3, 2, 6, 6, 2});
+  auto vfn = [](const std::vector<array>& in) {
+    return std::vector<array>{max_pool(in[0], {2, 2}, {1, 1}, {1, 1})};
+  };
+  auto vmapped = vmap(vfn, {1}, {0})({xv})[0];
+  auto vexpected = stack(
+      {vfn({take(xv, array(0), 1)})[0], vfn({take(xv, array(1), 1)})[0]});
+  CHECK(array_equal(vmapped, vexpected).item<bool>());
+
+  CHECK_THROWS_AS(max_pool(zeros({4, 4}), {2, 2}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      avg_pool(zeros({1, 4, 4, 1}), {5, 1}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      max_pool(zeros({1, 4, 4, 1}), {2, 2}, {1}), std::invalid_argument);
+}
+
+TEST_CASE("test upsample") {
+  // Known values for a 2x2 image
+  auto x = reshape(arange(1.0f, 5.0f), {1, 2, 2, 1});
+  auto out = upsample(x, {2.0f, 2.0f}, "nearest");
+  auto expected = array(
+      {1.0f, 1.0f, 2.0f, 2.0f, 1.0f, 1.0f, 2.0f, 2.0f,
+       3.0f, 3.0f, 4.0f, 4.0f, 3.0f, 3.0f, 4.0f, 4.0f},
+      {1, 4, 4, 1});
+  CHECK(array_equal(out, expected).item<bool>());
+  out = upsample(x, {2.0f, 2.0f}, "linear");
+  expected = array(
+      {1.0f, 1.25f, 1.75f, 2.0f, 1.5f, 1.75f, 2.25f, 2.5f,
+       2.5f, 2.75f, 3.25f, 3.5f, 3.0f, 3.25f, 3.75f, 4.0f},
+      {1, 4, 4, 1});
+  CHECK(allclose(out, expected).item<bool>());
+
+  // Non integer nearest scales sample with aligned corners
+  auto x1 = reshape(arange(4.0f), {1, 4, 1});
+  CHECK(array_equal(
+            upsample(x1, {1.5f}, "nearest"),
+            array({0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 3.0f}, {1, 6, 1}))
+            .item<bool>());
+
+  // Linear interpolation reproduces a ramp, cubic uses the a = -0.75 kernel
+  // and both reproduce a constant
+  auto ramp = upsample(x1, {2.0f}, "linear", true);
+  CHECK(allclose(ramp, reshape(arange(8.0f) * (3.0f / 7.0f), {1, 8, 1}))
+            .item<bool>());
+  auto cubic = upsample(x1, {2.0f}, "cubic");
+  auto interior = slice(cubic, {0, 3, 0}, {1, 5, 1});
+  CHECK(allclose(interior, array({1.296875f, 1.703125f}, {1, 2, 1}))
+            .item<bool>());
+  for (auto mode : {"nearest", "linear", "cubic"}) {
+    auto c = upsample(full({2, 3, 5, 2}, 3.0f), {2.5f, 1.5f}, mode);
+    CHECK_EQ(c.shape(), std::vector<int>{2, 7, 7, 2});
+    CHECK(allclose(c, full(c.shape(), 3.0f)).item<bool>());
+  }
+
+  // Every spatial axis is resampled independently
+  auto x2 = random::normal({2, 5, 7, 3});
+  for (auto mode : {"nearest", "linear", "cubic"}) {
+    auto both = upsample(x2, {2.5f, 1.5f}, mode);
+    auto h = upsample(reshape(x2, {2, 5, 21}), {2.5f}, mode);
+    h = reshape(h, {24, 7, 3});
+    auto w = reshape(upsample(h, {1.5f}, mode), {2, 12, 10, 3});
+    CHECK(allclose(both, w, 1e-5, 1e-5).item<bool>());
+  }
+
+  // The gradient is the adjoint of the upsampling
+  for (auto mode : {"nearest", "linear", "cubic"}) {
+    auto fn = [mode](const std::vector<array>& in) {
+      return std::vector<array>{upsample(in[0], {2.0f, 1.5f}, mode, true)};
+    };
+    auto t = random::normal(x2.shape());
+    auto jout = jvp(fn, {x2}, {t}).second[0];
+    CHECK(allclose(jout, fn({t})[0]).item<bool>());
+    auto u = random::normal(jout.shape());
+    auto vout = vjp(fn, {x2}, {u}).second[0];
+    CHECK_EQ(vout.shape(), x2.shape());
+    CHECK(allclose(sum(jout * u), sum(t * vout), 1e-4, 1e-4).item<bool>());
+  }
+
+  // Types
+  auto xi = reshape(arange(4), {1, 2, 2, 1});
+  CHECK_EQ(upsample(xi, {2.0f, 2.0f}).dtype(), int32);
+  CHECK_EQ(upsample(xi, {2.0f, 2.0f}, "linear").dtype(), float32);
+  auto xh = astype(x2, float16);
+  auto yh = upsample(xh, {2.0f, 1.5f}, "cubic");
+  CHECK_EQ(yh.dtype(), float16);
+  CHECK(allclose(yh, upsample(x2, {2.0f, 1.5f}, "cubic"), 1e-2, 1e-2)
+            .item<bool>());
+
+  // vmap over a leading axis
+  auto xv = random::normal({3, 2, 4, 4, 2});
+  auto vfn = [](const std::vector<array>& in) {
+    return std::vector<array>{upsample(in[0], {2.0f, 2.0f}, "linear")};
+  };
+  auto vmapped = vmap(vfn, {1}, {0})({xv})[0];
+  auto vexpected = stack(
+      {vfn({take(xv, array(0), 1)})[0], vfn({take(xv, array(1), 1)})[0]});
+  CHECK(allclose(vmapped, vexpected).item<bool>());
+
+  // Output sizes are computed in double precision
+  CHECK_EQ(upsample(zeros({1, 100, 1}), {0.29}).shape(1), 28);
+  CHECK_EQ(upsample(zeros({1, 100, 1}), {0.53}).shape(1), 53);
+
+  CHECK_THROWS_AS(upsample(zeros({4, 4}), {2.0f}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      upsample(zeros({1, 4, 4, 1}), {2.0f}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      upsample(zeros({1, 4, 1}), {2.0f}, "area"), std::invalid_argument);
+  CHECK_THROWS_AS(
+      upsample(zeros({1, 4, 1}), {-1.0f}), std::invalid_argument);
+}
+
+TEST_CASE("test scaled dot product attention") {
+  auto q = random::normal({1, 2, 3, 4});
+  auto k = random::normal({1, 2, 5, 4});
+  auto v = random::normal({1, 2, 5, 4});
+
+  // The signature without causal still takes the stream after the mask
+  auto out = fast::scaled_dot_product_attention(
+      q, k, v, 0.5f, std::nullopt, Device::cpu);
+  auto expected =
+      matmul(softmax(matmul(q, swapaxes(k, -1, -2)) * 0.5f, -1), v);
+  CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  out = fast::scaled_dot_product_attention(
+      q, k, v, 0.5f, std::nullopt, false, Device::cpu);
+  CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+
+  // Query i sees keys 0 to i + 2
+  auto visible = greater_equal(
+      expand_dims(arange(2, 5), 1), expand_dims(arange(5), 0));
+  auto mask = where(visible, array(0.0f), array(-1e9f));
+  out = fast::scaled_dot_product_attention(
+      q, k, v, 0.5f, std::nullopt, true, Device::cpu);
+  expected = fast::scaled_dot_product_attention(
+      q, k, v, 0.5f, mask, Device::cpu);
+  CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+}
+
+TEST_CASE("test fast activations") {
+  // NaN goes through the clamped exponential unchanged
+  auto x = array({std::nanf(""), 1.0f});
+  auto expected = array({true, false});
+  for (auto& fn : {fast::gelu_approx, fast::silu, fast::mish}) {
+    CHECK(array_equal(isnan(fn(x, Device::cpu)), expected).item<bool>());
+  }
+  CHECK(array_equal(isnan(exp(x, Device::cpu)), expected).item<bool>());
+
+  // An input held only by the activation gives its buffer to the output
+  auto in = exp(random::normal({64}), Device::cpu);
+  eval(in);
+  auto ptr = in.data<float>();
+  auto y = fast::silu(in, Device::cpu);
+  in = array(0.0f);
+  eval(y);
+  CHECK_EQ(y.data<float>(), ptr);
+}
@@ -3,6 +3,7 @@
 #include "doctest/doctest.h"
 
 #include "mlx/mlx.h"
+#include "mlx/numa.h"
 #include "mlx/scheduler.h"
 
 using namespace mlx::core;
@@ -36,6 +37,40 @@ TEST_CASE("test stream management") {
   }
 }
 
+TEST_CASE("test stream affinity") {
+  CHECK_THROWS_AS(
+      new_stream(Device::gpu, CpuAffinity{-1, {0}}), std::invalid_argument);
+  if (!numa::is_available()) {
+    CHECK_THROWS_AS(
+        new_stream(Device::cpu, CpuAffinity{-1, {0}}), std::invalid_argument);
+    return;
+  }
+
+  CHECK_THROWS_AS(new_stream(Device::cpu, {}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      new_stream(Device::cpu, CpuAffinity{-1, {-1}}), std::invalid_argument);
+  CHECK_THROWS_AS(
+      new_stream(Device::cpu, CpuAffinity{100000, {}}),
+      std::invalid_argument);
+
+  auto s = new_stream(Device::cpu, CpuAffinity{-1, {0}});
+  auto x = random::uniform({256, 256});
+  auto y = matmul(x, x, s);
+  auto z = sum(exp(y, s), s);
+  CHECK(allclose(y, matmul(x, x, Device::cpu), 1e-4).item<bool>());
+  CHECK(z.item<float>() > 0.0f);
+
+  // Large buffers made on a stream pinned to a node get their own page
+  // aligned mapping bound to the node
+  auto node_s = new_stream(Device::cpu, CpuAffinity{0, {}});
+  for (int i = 0; i < 2; ++i) {
+    auto big = exp(zeros({1024, 1024}, float32, node_s), node_s);
+    eval(big);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(big.data<float>()) % 4096, 0);
+    CHECK_EQ(sum(big, node_s).item<float>(), 1024.0f * 1024.0f);
+  }
+}
+
 TEST_CASE("test asynchronous launch") {
   auto s1 = default_stream(default_device());
   auto s2 = new_stream(default_device());
@@ -0,0 +1,154 @@
+// Copyright © 2024 Apple Inc.
+
+#include "doctest/doctest.h"
+
+#include "mlx/mlx.h"
+
+using namespace mlx::core;
+
+TEST_CASE("test sparse conversions") {
+  auto a = array(
+      {0.0f, 1.0f, 0.0f, 2.0f, 0.0f, 0.0f, 3.0f, 0.0f, 4.0f}, {3, 3});
+
+  auto csr = sparse::from_dense(a);
+  CHECK_EQ(csr.format(), sparse::Format::CSR);
+  CHECK_EQ(csr.nnz(), 4);
+  CHECK(array_equal(csr.values(), array({1.0f, 2.0f, 3.0f, 4.0f}))
+            .item<bool>());
+  CHECK(array_equal(csr.col_indices(), array({1, 0, 0, 2})).item<bool>());
+  CHECK(array_equal(csr.row_ptr(), array({0, 1, 2, 4})).item<bool>());
+  CHECK(array_equal(sparse::to_dense(csr), a).item<bool>());
+  CHECK_THROWS_AS(csr.row_indices(), std::invalid_argument);
+
+  auto coo = sparse::to_coo(csr);
+  CHECK_EQ(coo.format(), sparse::Format::COO);
+  CHECK(array_equal(coo.row_indices(), array({0, 1, 2, 2})).item<bool>());
+  CHECK(array_equal(sparse::to_dense(coo), a).item<bool>());
+
+  // Unsorted COO entries with a repeated coordinate
+  coo = sparse::coo_array(
+      array({4.0f, 1.0f, 3.0f, 1.0f, 1.0f}),
+      array({2, 0, 2, 1, 1}),
+      array({2, 1, 0, 0, 0}),
+      {3, 3});
+  csr = sparse::to_csr(coo);
+  CHECK(array_equal(csr.row_ptr(), array({0, 1, 3, 5})).item<bool>());
+  CHECK(array_equal(csr.col_indices(), array({1, 0, 0, 0, 2})).item<bool>());
+  CHECK(array_equal(sparse::to_dense(csr), a).item<bool>());
+  CHECK(array_equal(sparse::to_dense(sparse::transpose(csr)), transpose(a))
+            .item<bool>());
+
+  // Empty rows and no entries at all
+  auto empty = sparse::from_dense(zeros({2, 4}));
+  CHECK_EQ(empty.nnz(), 0);
+  CHECK(array_equal(empty.row_ptr(), zeros({3}, uint32)).item<bool>());
+  CHECK(array_equal(sparse::to_dense(empty), zeros({2, 4})).item<bool>());
+
+  CHECK_THROWS_AS(sparse::from_dense(zeros({2})), std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::csr_array(array({1.0f}), array({0}), array({0, 1}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::coo_array(array({1.0f}), array({0, 1}), array({0}), {2, 2}),
+      std::invalid_argument);
+
+  // Indices and row offsets outside of the shape
+  auto v = array({1.0f, 2.0f});
+  CHECK_THROWS_AS(
+      sparse::csr_array(v, array({0, 2}), array({0, 1, 2}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::csr_array(v, array({0, -1}), array({0, 1, 2}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::csr_array(v, array({0, 1}), array({0, 2, 1}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::csr_array(v, array({0, 1}), array({0, 1, 3}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::coo_array(v, array({0, 2}), array({0, 1}), {2, 2}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::coo_array(v, array({0, 1}), array({-3, 1}), {2, 2}),
+      std::invalid_argument);
+  CHECK_EQ(
+      sparse::csr_array(v, array({1, 0}), array({0, 0, 2}), {2, 2}).nnz(), 2);
+}
+
+TEST_CASE("test sparse matmul") {
+  auto dense = random::uniform({64, 48});
+  dense = where(dense > array(0.9f), dense, zeros_like(dense));
+  auto b = random::normal({48, 33});
+  auto expected = matmul(dense, b);
+
+  for (auto format : {sparse::Format::CSR, sparse::Format::COO}) {
+    auto a = sparse::from_dense(dense, format);
+    CHECK(allclose(sparse::matmul(a, b), expected, 1e-5, 1e-5).item<bool>());
+
+    // Matrix vector products
+    auto v = random::normal({48});
+    CHECK(allclose(sparse::matmul(a, v), matmul(dense, v), 1e-5, 1e-5)
+              .item<bool>());
+    auto u = random::normal({64});
+    CHECK(allclose(sparse::matmul(u, a), matmul(u, dense), 1e-5, 1e-5)
+              .item<bool>());
+
+    // Dense times sparse and the transposed sparse matrix
+    auto c = random::normal({5, 64});
+    CHECK(allclose(sparse::matmul(c, a), matmul(c, dense), 1e-5, 1e-5)
+              .item<bool>());
+    auto at = sparse::transpose(a);
+    CHECK(allclose(
+              sparse::matmul(at, transpose(c)),
+              matmul(transpose(dense), transpose(c)),
+              1e-5,
+              1e-5)
+              .item<bool>());
+
+    // Half precision accumulates in float
+    auto a16 = sparse::from_dense(astype(dense, float16), format);
+    auto out = sparse::matmul(a16, astype(b, float16));
+    CHECK_EQ(out.dtype(), float16);
+    CHECK(allclose(astype(out, float32), expected, 1e-2, 1e-2).item<bool>());
+  }
+
+  // Large enough to split the entries across threads
+  auto big = random::uniform({2048, 512});
+  big = where(big > array(0.8f), big, zeros_like(big));
+  auto v = random::normal({2048});
+  auto a = sparse::from_dense(big, sparse::Format::COO);
+  CHECK(allclose(sparse::matmul(v, a), matmul(v, big), 1e-4, 1e-4)
+            .item<bool>());
+
+  CHECK_THROWS_AS(sparse::matmul(a, zeros({3, 4})), std::invalid_argument);
+  CHECK_THROWS_AS(
+      sparse::matmul(a, zeros({2, 512, 4})), std::invalid_argument);
+}
+
+TEST_CASE("test sparse matmul grads") {
+  auto dense = random::uniform({16, 12});
+  dense = where(dense > array(0.7f), dense, zeros_like(dense));
+  auto a = sparse::from_dense(dense);
+  auto b = random::normal({12, 5});
+  auto cotan = random::normal({16, 5});
+
+  auto fun = [&a](const array& x) { return sparse::matmul(a, x); };
+  auto dense_fun = [&dense](const array& x) { return matmul(dense, x); };
+
+  auto [out, vjp_out] = vjp(fun, b, cotan);
+  auto [dout, dvjp_out] = vjp(dense_fun, b, cotan);
+  CHECK(allclose(out, dout, 1e-5, 1e-5).item<bool>());
+  CHECK(allclose(vjp_out, dvjp_out, 1e-5, 1e-5).item<bool>());
+
+  auto tangent = random::normal({12, 5});
+  auto [jout, jvp_out] = jvp(fun, b, tangent);
+  CHECK(allclose(jvp_out, matmul(dense, tangent), 1e-5, 1e-5).item<bool>());
+
+  // Gradients through a dense times sparse product
+  auto x = random::normal({3, 16});
+  auto loss = [&a](const array& x) { return sum(sparse::matmul(x, a)); };
+  auto dense_loss = [&dense](const array& x) { return sum(matmul(x, dense)); };
+  CHECK(allclose(grad(loss)(x), grad(dense_loss)(x), 1e-5, 1e-5)
+            .item<bool>());
+}
@@ -348,6 +348,24 @@ TEST_CASE("test vmap concatenate") {
   CHECK(array_equal(out, expected).item<bool>());
 }
 
+TEST_CASE("test vmap split") {
+  auto fun = [](std::vector<array> inputs) {
+    return split(inputs[0], 3, 0);
+  };
+  auto x = reshape(arange(12), {2, 6});
+  auto out = vmap(fun)({x});
+  CHECK_EQ(out.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    auto expected = slice(x, {0, 2 * i}, {2, 2 * i + 2});
+    CHECK(array_equal(out[i], expected).item<bool>());
+  }
+  out = vmap(fun, {1})({reshape(arange(12), {6, 2})});
+  auto expected = reshape(array({0, 2, 1, 3}), {2, 2});
+  CHECK(array_equal(out[0], expected).item<bool>());
+  expected = reshape(array({8, 10, 9, 11}), {2, 2});
+  CHECK(array_equal(out[2], expected).item<bool>());
+}
+
 TEST_CASE("test vmap gather") {
   {
     auto fun = [](std::vector<array> inputs) {
@@ -445,3 +463,154 @@ TEST_CASE("test vmap SVD") {
     CHECK_EQ(Vt.shape(), std::vector<int>{a.shape(2), a.shape(1), a.shape(1)});
   }
 }
+
+namespace {
+
+// Apply fun to each batch element in turn and stack the results
+array vmap_reference(
+    const std::function<std::vector<array>(const std::vector<array>&)>& fun,
+    const std::vector<array>& inputs,
+    const std::vector<int>& in_axes) {
+  int batch_size = 0;
+  for (int i = 0; i < inputs.size(); ++i) {
+    if (in_axes[i] >= 0) {
+      batch_size = inputs[i].shape(in_axes[i]);
+    }
+  }
+  std::vector<array> outs;
+  for (int b = 0; b < batch_size; ++b) {
+    std::vector<array> args;
+    for (int i = 0; i < inputs.size(); ++i) {
+      args.push_back(
+          in_axes[i] >= 0 ? take(inputs[i], array(b), in_axes[i])
+                          : inputs[i]);
+    }
+    outs.push_back(fun(args)[0]);
+  }
+  return stack(outs);
+}
+
+} // namespace
+
+TEST_CASE("test vmap gather with mixed indices") {
+  auto fun = [](const std::vector<array>& inputs) {
+    auto out = gather(inputs[0], {inputs[1], inputs[2]}, {0, 2}, {1, 3, 1});
+    return std::vector<array>{out};
+  };
+  auto x = reshape(arange(2 * 5 * 3 * 4), {2, 5, 3, 4});
+  auto y = array({0, 4, 1, 3, 2, 2, 0, 1}, {4, 2});
+  auto z = array({0, 3, 1}, {3, 1});
+  for (auto in_axes : std::vector<std::vector<int>>{
+           {0, 1, -1}, {-1, 1, -1}, {1, -1, -1}, {2, 1, -1}}) {
+    auto x_in =
+        in_axes[0] >= 0 ? moveaxis(x, 0, in_axes[0]) : take(x, array(0), 0);
+    auto y_in = in_axes[1] >= 0 ? y : take(y, array(0), 1);
+    auto out = vmap(fun, in_axes)({x_in, y_in, z})[0];
+    auto expected = vmap_reference(fun, {x_in, y_in, z}, in_axes);
+    CHECK(array_equal(out, expected).item<bool>());
+  }
+}
+
+TEST_CASE("test vmap scatter") {
+  auto fun = [](const std::vector<array>& inputs) {
+    auto out = scatter_add(inputs[0], {inputs[1]}, inputs[2], 0);
+    return std::vector<array>{out};
+  };
+  auto x = zeros({3, 5, 4});
+  auto idx = array({0, 4, 4, 1, 2, 2, 0, 1, 3}, {3, 3});
+  auto updates = reshape(astype(arange(3 * 3 * 4), float32), {3, 3, 1, 4});
+  auto x_single = zeros({5, 4});
+  auto idx_single = array({4, 0, 4});
+  auto updates_single = take(updates, array(0), 0);
+
+  std::vector<std::pair<std::vector<array>, std::vector<int>>> cases = {
+      {{x, idx, updates}, {0, 0, 0}},
+      {{x_single, idx, updates}, {-1, 0, 0}},
+      {{x, idx_single, updates}, {0, -1, 0}},
+      {{x, idx_single, updates_single}, {0, -1, -1}},
+      {{x, idx, updates_single}, {0, 0, -1}},
+      {{transpose(x, {1, 0, 2}), idx, moveaxis(updates, 0, 2)}, {1, 0, 2}},
+  };
+  for (auto& [inputs, in_axes] : cases) {
+    auto out = vmap(fun, in_axes)(inputs)[0];
+    auto expected = vmap_reference(fun, inputs, in_axes);
+    CHECK(array_equal(out, expected).item<bool>());
+  }
+
+  // Replacing scatter
+  auto set_fun = [](const std::vector<array>& inputs) {
+    auto out = scatter(inputs[0], {inputs[1]}, inputs[2], 0);
+    return std::vector<array>{out};
+  };
+  idx = array({0, 1, 2, 3, 4, 0}, {3, 2});
+  updates = reshape(astype(arange(3 * 2 * 4), float32), {3, 2, 1, 4});
+  auto out = vmap(set_fun, {0, 0, 0})({x, idx, updates})[0];
+  auto expected = vmap_reference(set_fun, {x, idx, updates}, {0, 0, 0});
+  CHECK(array_equal(out, expected).item<bool>());
+}
+
+TEST_CASE("test vmap conv") {
+  auto conv1d_fun = [](const std::vector<array>& inputs) {
+    return std::vector<array>{
+        conv1d(inputs[0], inputs[1], /* stride = */ 2, /* padding = */ 1)};
+  };
+  auto conv2d_fun = [](const std::vector<array>& inputs) {
+    return std::vector<array>{
+        conv2d(inputs[0], inputs[1], {1, 1}, {1, 0}, {1, 2})};
+  };
+  auto grouped_fun = [](const std::vector<array>& inputs) {
+    return std::vector<array>{conv1d(inputs[0], inputs[1], 1, 0, 1, 2)};
+  };
+
+  auto x = random::normal({3, 2, 9, 4});
+  auto w = random::normal({3, 6, 3, 4});
+  auto w_grouped = random::normal({3, 6, 3, 2});
+  for (auto in_axes : std::vector<std::vector<int>>{
+           {0, 0}, {0, -1}, {-1, 0}, {2, 0}, {1, 3}}) {
+    auto batched = [&in_axes](const array& a, int i) {
+      if (in_axes[i] < 0) {
+        return take(a, array(0), 0);
+      }
+      return moveaxis(a, 0, in_axes[i]);
+    };
+    auto x_in = batched(x, 0);
+    auto w_in = batched(w, 1);
+    auto out = vmap(conv1d_fun, in_axes)({x_in, w_in})[0];
+    auto expected = vmap_reference(conv1d_fun, {x_in, w_in}, in_axes);
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+
+    w_in = batched(w_grouped, 1);
+    out = vmap(grouped_fun, in_axes)({x_in, w_in})[0];
+    expected = vmap_reference(grouped_fun, {x_in, w_in}, in_axes);
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  }
+
+  x = random::normal({2, 2, 7, 6, 3});
+  w = random::normal({2, 4, 3, 2, 3});
+  for (auto in_axes : std::vector<std::vector<int>>{{0, 0}, {0, -1}, {-1, 0}}) {
+    auto x_in = in_axes[0] >= 0 ? x : take(x, array(0), 0);
+    auto w_in = in_axes[1] >= 0 ? w : take(w, array(0), 0);
+    auto out = vmap(conv2d_fun, in_axes)({x_in, w_in})[0];
+    auto expected = vmap_reference(conv2d_fun, {x_in, w_in}, in_axes);
+    CHECK(allclose(out, expected, 1e-5, 1e-5).item<bool>());
+  }
+
+  // Per example gradients of a convolution with a shared weight
+  auto loss = [](const std::vector<array>& inputs) {
+    auto y = conv1d(expand_dims(inputs[0], 0), inputs[1], 1, 1);
+    return std::vector<array>{sum(square(y))};
+  };
+  auto grad_fun = [&loss](const std::vector<array>& inputs) {
+    return vjp(loss, inputs, {array(1.0f)}).second;
+  };
+  auto xs = random::normal({4, 8, 3});
+  auto wt = random::normal({2, 3, 3});
+  auto grads = vmap(grad_fun, {0, -1})({xs, wt});
+  for (int b = 0; b < 4; ++b) {
+    auto expected = grad_fun({take(xs, array(b), 0), wt});
+    CHECK(allclose(take(grads[0], array(b), 0), expected[0], 1e-5, 1e-5)
+              .item<bool>());
+    CHECK(allclose(take(grads[1], array(b), 0), expected[1], 1e-5, 1e-5)
+              .item<bool>());
+  }
+}